@@ -0,0 +1,1510 @@
+/********************************************************************
+	created:	2026/10/16
+	file base:	NetBench
+	file ext:	cpp
+	
+	purpose:	CNetEpoll + CNetPack ػѹ
+				˺Ϳͻ˸һCNetEpollڱػӦ㲥
+				ͳp50/p99/p999ӳ١-r 0ʱ˸CNetEpollGroup෴Ӧѡ
+				slowģʽһӴӲݣķͶб޶סڴ治
+				ringģʽ磬-c ߳Ƚ϶¼̼߳е¡
+				compressģʽ磬ϢȽϸѹ㷨İʹʱ
+				lookupģʽ磬-c עȽϰfdӵĲԭmap
+				aesģʽ磬Ƚϰ汾2ܰԭÿԿstringӽܵдڵĻԿԭؼӽܣ
+				-k ģʽ˶ѹѹǷЧϵİͷЭ̾
+				-c -s -m -v -e öŸֵ꣬
+				ӳһûյʱط0ֱӷŽCI
+*********************************************************************/
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+using namespace std;
+
+#include <map>
+#include <getopt.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include "include.h"
+#include "NetPack.h"
+#include "NetSocket.h"
+#include "NetEpoll.h"
+#include "NetEpollGroup.h"
+#include "RingQueue.h"
+#include "CTwoLockQueue.h"
+#include "ThreadGroup.h"
+#include "FileStream.h"
+#include "debugtrace.h"
+
+CDebugTrace *goDebugTrace = NULL;
+
+#define DEF_BENCH_IP "127.0.0.1"
+#define DEF_BENCH_PORT 17000
+#define DEF_BENCH_SECONDS 3
+//ֹͣͺȴ;Ϣʱ䣬
+#define DEF_BENCH_DRAIN_MS 2000
+#define DEF_BENCH_ENCRY_ID 10000
+//ֱͼÿ2پֵĸ(2^5)Լ3%
+#define DEF_HISTOGRAM_SUB_BITS 5
+#define DEF_HISTOGRAM_SUB_COUNT (1 << DEF_HISTOGRAM_SUB_BITS)
+#define DEF_HISTOGRAM_SIZE ((64 - DEF_HISTOGRAM_SUB_BITS + 1) * DEF_HISTOGRAM_SUB_COUNT)
+
+enum BENCH_MODE{
+	//ÿӦ
+	BENCH_MODE_ECHO = 0,
+	//һӷ󣬷˹㲥
+	BENCH_MODE_BROADCAST,
+	//һӴӲݣڶӷ󣬷˰Ϣͺϲ㲥
+	BENCH_MODE_SLOW,
+	//ߵ߶о
+	BENCH_MODE_RING,
+	//ѹ㷨
+	BENCH_MODE_COMPRESS,
+	//fdӣ
+	BENCH_MODE_LOOKUP,
+	//ܰ¾дԱȣ
+	BENCH_MODE_AES
+};
+
+//slowģʽÿӵķͶ޶Ϣ
+#define DEF_BENCH_SLOW_QUEUE_BYTES (256*1024)
+#define DEF_BENCH_SLOW_TYPES 8
+//slowģʽ˷Ͷеļ
+#define DEF_BENCH_SLOW_SAMPLE_MS 10
+//ringģʽĬϵϢζһȡĸ
+#define DEF_BENCH_RING_MSGS (1 << 22)
+#define DEF_BENCH_RING_SIZE (1 << 16)
+#define DEF_BENCH_RING_BATCH 64
+//compressģʽĬÿĴ
+#define DEF_BENCH_COMPRESS_MSGS 100000
+//lookupģʽĬÿҴ˳ĳ
+#define DEF_BENCH_LOOKUP_COUNT 10000000
+#define DEF_BENCH_LOOKUP_ORDER 65536
+//aesģʽĬÿĴ
+#define DEF_BENCH_AES_MSGS 100000
+
+//Ϣͷ油뵽ָ
+struct STRU_BENCH_MSG{
+	uint32 miConn;
+	uint32 miSeq;
+	uint64 mui64SendTime;
+};
+
+//һѹ
+struct STRU_BENCH_CASE{
+	int miMode;
+	int miVersion;
+	bool mbEncry;
+	int miConns;
+	int miSize;
+	//˷ӦѸ0ΪCNetEpoll
+	int miReactors;
+	//˰ѹ㷨(ENUM_COMPRESS_TYPE)
+	int miCompress;
+};
+
+//һѹ
+struct STRU_BENCH_RESULT{
+	STRU_BENCH_RESULT(){
+		mui64Msgs = 0;
+		mdSeconds = 0;
+		mui64Lost = 0;
+		mui64Errors = 0;
+		miQueueMaxBytes = 0;
+		mui64QueueDrop = 0;
+	}
+	uint64 mui64Msgs;
+	double mdSeconds;
+	uint64 mui64Lost;
+	uint64 mui64Errors;
+	//slowģʽķ˵Ͷֽϲİ
+	int miQueueMaxBytes;
+	uint64 mui64QueueDrop;
+};
+
+static uint64 GetNowNs(){
+	struct timespec loTime;
+	clock_gettime(CLOCK_MONOTONIC, &loTime);
+	return (uint64)loTime.tv_sec * 1000000000ULL + loTime.tv_nsec;
+}
+
+/************************************************************************/
+/*
+CLatencyHistogram
+2ݷֶΡԷָӳֱͼλ
+*/
+/************************************************************************/
+class CLatencyHistogram{
+public:
+	CLatencyHistogram(){
+		Reset();
+	}
+
+	void Reset(){
+		memset(mui64Bucket, 0, sizeof(mui64Bucket));
+		mui64Count = 0;
+		mui64Max = 0;
+	}
+
+	inline void Add(uint64 aui64Value){
+		++mui64Bucket[GetIndex(aui64Value)];
+		++mui64Count;
+		if(aui64Value > mui64Max){
+			mui64Max = aui64Value;
+		}
+	}
+
+	//adPercentȡ0~100ڸмֵ
+	uint64 GetPercentile(double adPercent){
+		if(0 == mui64Count){
+			return 0;
+		}
+		uint64 lui64Rank = (uint64)(adPercent / 100.0 * mui64Count + 0.5);
+		if(lui64Rank < 1){
+			lui64Rank = 1;
+		}
+		uint64 lui64Sum = 0;
+		for(int i = 0; i < DEF_HISTOGRAM_SIZE; ++i){
+			lui64Sum += mui64Bucket[i];
+			if(lui64Sum >= lui64Rank){
+				uint64 lui64Value = GetValue(i);
+				return lui64Value < mui64Max ? lui64Value : mui64Max;
+			}
+		}
+		return mui64Max;
+	}
+
+	uint64 GetCount(){ return mui64Count; }
+	uint64 GetMax(){ return mui64Max; }
+
+private:
+	static inline int GetIndex(uint64 aui64Value){
+		if(aui64Value < DEF_HISTOGRAM_SUB_COUNT){
+			return (int)aui64Value;
+		}
+		int liExp = 63 - __builtin_clzll(aui64Value);
+		int liSub = (int)(aui64Value >> (liExp - DEF_HISTOGRAM_SUB_BITS)) & (DEF_HISTOGRAM_SUB_COUNT - 1);
+		return (liExp - DEF_HISTOGRAM_SUB_BITS + 1) * DEF_HISTOGRAM_SUB_COUNT + liSub;
+	}
+
+	static inline uint64 GetValue(int aiIndex){
+		if(aiIndex < DEF_HISTOGRAM_SUB_COUNT){
+			return aiIndex;
+		}
+		int liShift = aiIndex / DEF_HISTOGRAM_SUB_COUNT - 1;
+		uint64 lui64Low = (uint64)(DEF_HISTOGRAM_SUB_COUNT + aiIndex % DEF_HISTOGRAM_SUB_COUNT) << liShift;
+		return lui64Low + ((1ULL << liShift) >> 1);
+	}
+
+private:
+	uint64 mui64Bucket[DEF_HISTOGRAM_SIZE];
+	uint64 mui64Count;
+	uint64 mui64Max;
+};
+
+static const char* GetCompressName(int aiType){
+	switch(aiType){
+	case COMPRESS_NONE: return "none";
+	case COMPRESS_ZLIB: return "zlib";
+	case COMPRESS_LZ4: return "lz4";
+	case COMPRESS_ZSTD: return "zstd";
+	default: return "unknown";
+	}
+}
+
+//Ϣ(JSONı)ѹʱֽڣѹʽӽ
+static void FillChatBody(char *apBuffer, int aiLength){
+	static const char *lszText[] = {
+		"Ϻãֱ㿪ʼ",
+		"",
+		"̫ˣһװ",
+		"սʲô",
+		"һ"
+	};
+	int liCount = sizeof(lszText) / sizeof(lszText[0]);
+	int liPos = 0;
+	for(uint32 i = 0; liPos < aiLength; ++i){
+		char lszItem[256];
+		int liLen = snprintf(lszItem, sizeof(lszItem),
+			"{\"cmd\":\"chat\",\"room\":10086,\"from\":%u,\"nick\":\"user%u\",\"to\":0,\"msg\":\"%s\",\"time\":%u},",
+			100000 + i * 7919 % 5000, i * 31 % 997, lszText[i % liCount], 1760000000 + i * 3);
+		if(liLen > aiLength - liPos){
+			liLen = aiLength - liPos;
+		}
+		memcpy(apBuffer + liPos, lszItem, liLen);
+		liPos += liLen;
+	}
+}
+
+static bool InitPack(CNetPack *apPack, const STRU_BENCH_CASE &aoCase){
+	if(aoCase.miCompress != COMPRESS_NONE && !apPack->SetCompress(aoCase.miCompress)){
+		return false;
+	}
+	if(!aoCase.mbEncry){
+		return true;
+	}
+	CNetPackVersion2 *lpPack = dynamic_cast<CNetPackVersion2*>(apPack);
+	if(NULL == lpPack){
+		return false;
+	}
+	lpPack->send_encry = 2;
+	lpPack->send_id = DEF_BENCH_ENCRY_ID;
+	return true;
+}
+
+static CNetPack* CreatePack(const STRU_BENCH_CASE &aoCase){
+	CNetPack *lpPack = NULL;
+	if(1 == aoCase.miVersion){
+		lpPack = new CNetPackVersion1;
+	} else {
+		lpPack = new CNetPackVersion2;
+	}
+	if(!InitPack(lpPack, aoCase)){
+		delete lpPack;
+		return NULL;
+	}
+	return lpPack;
+}
+
+/************************************************************************/
+/*
+CBenchServer
+߳EPOLL෴ӦѣӦģʽԭط㲥ģʽյ󷢸
+*/
+/************************************************************************/
+class CBenchServer : public sigslot::has_slots<>{
+public:
+	CBenchServer(){
+		m_pNetPack = NULL;
+		miMode = BENCH_MODE_ECHO;
+		mbGroup = false;
+		mui64Errors = 0;
+		moNetEpoll.RecvFrom.connect(this, &CBenchServer::OnRecvFrom);
+		moNetEpoll.OnErrorNotice.connect(this, &CBenchServer::OnErrorNotice);
+		moNetEpollGroup.RecvFrom.connect(this, &CBenchServer::OnRecvFrom);
+		moNetEpollGroup.OnErrorNotice.connect(this, &CBenchServer::OnErrorNotice);
+	}
+
+	~CBenchServer(){
+		Destroy();
+		moNetEpoll.RecvFrom.disconnect(this);
+		moNetEpoll.OnErrorNotice.disconnect(this);
+		moNetEpollGroup.RecvFrom.disconnect(this);
+		moNetEpollGroup.OnErrorNotice.disconnect(this);
+		if(m_pNetPack != NULL){
+			delete m_pNetPack;
+			m_pNetPack = NULL;
+		}
+	}
+
+	bool Init(const STRU_BENCH_CASE &aoCase, unsigned short aiPort, bool abZeroCopy){
+		miMode = aoCase.miMode;
+		m_pNetPack = CreatePack(aoCase);
+		if(NULL == m_pNetPack){
+			return false;
+		}
+		if(aoCase.miReactors > 0){
+			//ÿӦһ̣߳SO_REUSEPORTַ
+			mbGroup = true;
+			if(!moNetEpollGroup.Init(m_pNetPack, DEF_BENCH_IP, aiPort, aoCase.miReactors,
+				aoCase.miConns + 64)){
+				TRACE(1, "CBenchServer::Init Ӧѳʼʧܡport = "<<aiPort);
+				return false;
+			}
+			if(BENCH_MODE_SLOW == miMode){
+				moNetEpollGroup.SetSendQueueLimit(GetSlowLimit());
+			}
+			return moNetEpollGroup.Start(10);
+		}
+		moNetEpoll.SetPack(m_pNetPack);
+		moNetEpoll.mbZeroCopyRecv = abZeroCopy;
+		if(!moNetEpoll.Init(aoCase.miConns + 64)){
+			TRACE(1, "CBenchServer::Init EPOLLʼʧܡ");
+			return false;
+		}
+		if(BENCH_MODE_SLOW == miMode){
+			moNetEpoll.SetSendQueueLimit(GetSlowLimit());
+		}
+		moListenSocket.SetNetPack(m_pNetPack);
+		if(!moListenSocket.CreateSocket(DEF_BENCH_IP, aiPort)){
+			TRACE(1, "CBenchServer::Init 󶨶˿ʧܡport = "<<aiPort);
+			return false;
+		}
+		moListenSocket.mbListenSocket = true;
+		if(!moListenSocket.SetNoBlock() || !moListenSocket.Listen()
+			|| !moNetEpoll.Addfd(&moListenSocket)){
+			TRACE(1, "CBenchServer::Init ʧܡport = "<<aiPort);
+			return false;
+		}
+		moNetEpoll.mbHasListenFd = true;
+		return moThreadManager.Start(ServerThread, this, 1, (char*)"bench_server") == 1;
+	}
+
+	void Destroy(){
+		if(!moThreadManager.IsStop()){
+			moThreadManager.StopAll();
+		}
+		moNetEpollGroup.Destroy();
+		moNetEpoll.Destroy();
+		moListenSocket.Close();
+	}
+
+	void OnRecvFrom(int fd, char *buffer, int length){
+		//slowģʽŷͣӵĶϢ滻ͬ͵ľϢ
+		int liType = 0;
+		if(BENCH_MODE_SLOW == miMode){
+			STRU_BENCH_MSG loMsg;
+			memcpy(&loMsg, buffer, sizeof(loMsg));
+			liType = loMsg.miSeq % DEF_BENCH_SLOW_TYPES + 1;
+		}
+		if(mbGroup){
+			if(BENCH_MODE_ECHO == miMode){
+				moNetEpollGroup.SendData(fd, buffer, length);
+			} else {
+				moNetEpollGroup.SendAllData(buffer, length, liType);
+			}
+			return;
+		}
+		if(BENCH_MODE_ECHO == miMode){
+			moNetEpoll.SendData(fd, buffer, length);
+		} else {
+			moNetEpoll.SendAllData(buffer, length, liType);
+		}
+	}
+
+	//ѽܵsocket
+	unsigned int GetAcceptedSize(){
+		if(mbGroup){
+			return moNetEpollGroup.GetConnectedSize() - moNetEpollGroup.GetReactorCount();
+		}
+		return moNetEpoll.GetConnectedSize() - 1;
+	}
+
+	void GetSendQueueStat(STRU_SEND_QUEUE_STAT &aoStat){
+		if(mbGroup){
+			moNetEpollGroup.GetSendQueueStat(aoStat);
+		} else {
+			moNetEpoll.GetSendQueueStat(aoStat);
+		}
+	}
+
+	static STRU_SEND_QUEUE_LIMIT GetSlowLimit(){
+		STRU_SEND_QUEUE_LIMIT loLimit;
+		loLimit.miMaxBytes = DEF_BENCH_SLOW_QUEUE_BYTES;
+		loLimit.moPolicy = SEND_POLICY_COALESCE;
+		return loLimit;
+	}
+
+	void OnErrorNotice(int fd){
+		__sync_add_and_fetch(&mui64Errors, 1);
+	}
+
+	static unsigned int ServerThread(STRU_THREAD_CONTEXT& apContext){
+		CBenchServer *p = reinterpret_cast<CBenchServer*>(apContext.mpWorkContext);
+		ASSERT(p != NULL);
+		while(!p->moThreadManager.IsStop()){
+			int nRet = p->moNetEpoll.CheckEpollEvent(10);
+			if(nRet > 0){
+				p->moNetEpoll.ProcessEpollEvent(nRet);
+			}
+			p->moNetEpoll.ProcessTimer();
+		}
+		return 0;
+	}
+
+public:
+	uint64 mui64Errors;
+
+private:
+	CNetPack *m_pNetPack;
+	int miMode;
+	bool mbGroup;
+	CNetEpoll moNetEpoll;
+	CNetSocket moListenSocket;
+	CThreadGroup moThreadManager;
+	CNetEpollGroup moNetEpollGroup;
+};
+
+/************************************************************************/
+/*
+CBenchClient
+ڵ߳пͻӣÿ(㲥ģʽֻеһ)miDepth;
+*/
+/************************************************************************/
+class CBenchClient : public sigslot::has_slots<>{
+public:
+	CBenchClient(){
+		m_pNetPack = NULL;
+		mpSocket = NULL;
+		mbSending = false;
+		mui64Sent = 0;
+		mui64Recv = 0;
+		mui64Errors = 0;
+		moNetEpoll.RecvFrom.connect(this, &CBenchClient::OnRecvFrom);
+		moNetEpoll.OnErrorNotice.connect(this, &CBenchClient::OnErrorNotice);
+	}
+
+	~CBenchClient(){
+		moNetEpoll.Destroy();
+		moNetEpoll.RecvFrom.disconnect(this);
+		moNetEpoll.OnErrorNotice.disconnect(this);
+		if(mpSocket != NULL){
+			delete [] mpSocket;
+			mpSocket = NULL;
+		}
+		if(m_pNetPack != NULL){
+			delete m_pNetPack;
+			m_pNetPack = NULL;
+		}
+	}
+
+	bool Init(const STRU_BENCH_CASE &aoCase, unsigned short aiPort, int aiDepth, bool abZeroCopy){
+		moCase = aoCase;
+		miDepth = aiDepth;
+		m_pNetPack = CreatePack(aoCase);
+		if(NULL == m_pNetPack){
+			return false;
+		}
+		moNetEpoll.SetPack(m_pNetPack);
+		moNetEpoll.mbZeroCopyRecv = abZeroCopy;
+		if(!moNetEpoll.Init(aoCase.miConns + 64)){
+			TRACE(1, "CBenchClient::Init EPOLLʼʧܡ");
+			return false;
+		}
+		//ܰ尴AES鳤0յĳǲ
+		miRecvLength = aoCase.mbEncry ? CAESCipher::AlignLength(aoCase.miSize) : aoCase.miSize;
+		moRoundRecv.assign(aiDepth, 0);
+		moSendBuffer.assign(aoCase.miSize, 0);
+		if(aoCase.miCompress != COMPRESS_NONE){
+			FillChatBody(&moSendBuffer[sizeof(STRU_BENCH_MSG)], aoCase.miSize - sizeof(STRU_BENCH_MSG));
+		} else {
+			for(int i = sizeof(STRU_BENCH_MSG); i < aoCase.miSize; ++i){
+				moSendBuffer[i] = (char)(i * 131 + 7);
+			}
+		}
+		mpSocket = new CNetSocket[aoCase.miConns];
+		for(int i = 0; i < aoCase.miConns; ++i){
+			CNetSocket &loSocket = mpSocket[i];
+			loSocket.SetNetPack(m_pNetPack);
+			loSocket.mbClientSocket = true;
+			if(BENCH_MODE_SLOW == aoCase.miMode && 0 == i){
+				//ӣջСֻӲEPOLLӲ
+				int liRecvBuf = 4096;
+				if(!loSocket.CreateSocket()
+					|| setsockopt(loSocket.miSocket, SOL_SOCKET, SO_RCVBUF, &liRecvBuf, sizeof(liRecvBuf)) != 0
+					|| !loSocket.ConnectServer(DEF_BENCH_IP, aiPort)){
+					TRACE(1, "CBenchClient::Init ʧܡerrno = "<<errno);
+					return false;
+				}
+				continue;
+			}
+			if(!loSocket.CreateSocket() || !loSocket.ConnectServer(DEF_BENCH_IP, aiPort)
+				|| !loSocket.SetNoBlock() || !moNetEpoll.Addfd(&loSocket)){
+				TRACE(1, "CBenchClient::Init ʧܡconn = "<<i<<" errno = "<<errno);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void Start(){
+		mbSending = true;
+		if(BENCH_MODE_SLOW == moCase.miMode){
+			for(int j = 0; j < miDepth; ++j){
+				SendRequest(1, j);
+			}
+			return;
+		}
+		int liSenders = (BENCH_MODE_ECHO == moCase.miMode) ? moCase.miConns : 1;
+		for(int i = 0; i < liSenders; ++i){
+			for(int j = 0; j < miDepth; ++j){
+				SendRequest(i, j);
+			}
+		}
+	}
+
+	//ش¼
+	int Poll(int aiTimeOut){
+		int nRet = moNetEpoll.CheckEpollEvent(aiTimeOut);
+		if(nRet > 0){
+			moNetEpoll.ProcessEpollEvent(nRet);
+		}
+		return nRet;
+	}
+
+	//ûյϢ
+	uint64 GetPending(){
+		uint64 lui64Expect = mui64Sent * GetReceivers();
+		return lui64Expect > mui64Recv ? lui64Expect - mui64Recv : 0;
+	}
+
+	//ѹʱÿݵӶӷ˵İͷ￴˸㷨
+	//ûЭϵ
+	int CheckPeerCompress(){
+		int liFailed = 0;
+		if(COMPRESS_NONE == moCase.miCompress){
+			return 0;
+		}
+		for(int i = 0; i < moCase.miConns; ++i){
+			if(BENCH_MODE_SLOW == moCase.miMode && 0 == i){
+				continue;
+			}
+			if(!mpSocket[i].CanCompress(moCase.miCompress)){
+				TRACE(1, "CBenchClient::CheckPeerCompress ûЭ̵ѹ㷨conn = "<<i<<
+					" peer = "<<mpSocket[i].GetPeerCompress());
+				++liFailed;
+			}
+		}
+		return liFailed;
+	}
+
+	void OnRecvFrom(int fd, char *buffer, int length){
+		//ѹİѹԭ
+		if(length != miRecvLength && !(moCase.miCompress != COMPRESS_NONE && length == moCase.miSize)){
+			TRACE(1, "CBenchClient::OnRecvFrom ȴfd = "<<fd<<" length = "<<length);
+			++mui64Errors;
+			return;
+		}
+		STRU_BENCH_MSG loMsg;
+		memcpy(&loMsg, buffer, sizeof(loMsg));
+		uint64 lui64Now = GetNowNs();
+		moHistogram.Add(lui64Now - loMsg.mui64SendTime);
+		++mui64Recv;
+		if(BENCH_MODE_ECHO == moCase.miMode){
+			if(mbSending){
+				SendRequest(loMsg.miConn, loMsg.miSeq);
+			}
+			return;
+		}
+		//㲥һ(ӳ)յٷһ
+		uint32 liSlot = loMsg.miSeq % miDepth;
+		if(++moRoundRecv[liSlot] >= GetReceivers()){
+			moRoundRecv[liSlot] = 0;
+			if(mbSending){
+				SendRequest(loMsg.miConn, loMsg.miSeq + miDepth);
+			}
+		}
+	}
+
+	void OnErrorNotice(int fd){
+		TRACE(1, "CBenchClient::OnErrorNotice ӶϿfd = "<<fd);
+		++mui64Errors;
+	}
+
+private:
+	//ÿӦյϢ
+	int GetReceivers(){
+		if(BENCH_MODE_BROADCAST == moCase.miMode){
+			return moCase.miConns;
+		}
+		if(BENCH_MODE_SLOW == moCase.miMode){
+			return moCase.miConns - 1;
+		}
+		return 1;
+	}
+
+	void SendRequest(uint32 aiConn, uint32 aiSeq){
+		STRU_BENCH_MSG loMsg;
+		loMsg.miConn = aiConn;
+		loMsg.miSeq = aiSeq;
+		loMsg.mui64SendTime = GetNowNs();
+		memcpy(&moSendBuffer[0], &loMsg, sizeof(loMsg));
+		if(!moNetEpoll.SendData(mpSocket[aiConn].miSocket, &moSendBuffer[0], moCase.miSize)){
+			++mui64Errors;
+			return;
+		}
+		++mui64Sent;
+	}
+
+public:
+	CLatencyHistogram moHistogram;
+	//falseյӦٷ
+	bool mbSending;
+	uint64 mui64Sent;
+	uint64 mui64Recv;
+	uint64 mui64Errors;
+
+private:
+	STRU_BENCH_CASE moCase;
+	int miDepth;
+	int miRecvLength;
+	CNetPack *m_pNetPack;
+	CNetEpoll moNetEpoll;
+	CNetSocket *mpSocket;
+	vector<char> moSendBuffer;
+	//㲥ģʽÿ;յ
+	vector<int> moRoundRecv;
+};
+
+/************************************************************************/
+/*
+оѹ
+߳ͬʱ룬̵߳ߣÿߵϢ˳򵽴
+*/
+/************************************************************************/
+//Ϣ = <<32 | ڵ
+class CRingBenchMpsc{
+public:
+	static const char* GetName(){ return "mpsc_ring"; }
+	CRingBenchMpsc(){ moQueue.Init(DEF_BENCH_RING_SIZE); }
+	inline bool Push(uint64 aui64Value){ return moQueue.Push(aui64Value); }
+	inline unsigned int PopBatch(uint64 *apValue, unsigned int aiCount){
+		return moQueue.PopBatch(apValue, aiCount);
+	}
+private:
+	CMpscRingQueue<uint64> moQueue;
+};
+
+class CRingBenchTwoLock{
+public:
+	static const char* GetName(){ return "two_lock"; }
+	inline bool Push(uint64 aui64Value){ moQueue.push(aui64Value); return true; }
+	inline unsigned int PopBatch(uint64 *apValue, unsigned int aiCount){
+		unsigned int liCount = 0;
+		while(liCount < aiCount && moQueue.pop(apValue[liCount])){
+			++liCount;
+		}
+		return liCount;
+	}
+private:
+	TwoLockQueue<uint64> moQueue;
+};
+
+class CRingBenchMutex{
+public:
+	static const char* GetName(){ return "mutex_deque"; }
+	inline bool Push(uint64 aui64Value){
+		CAutoLock lock(moSection);
+		moQueue.push_back(aui64Value);
+		return true;
+	}
+	inline unsigned int PopBatch(uint64 *apValue, unsigned int aiCount){
+		CAutoLock lock(moSection);
+		unsigned int liCount = 0;
+		for(; liCount < aiCount && !moQueue.empty(); ++liCount){
+			apValue[liCount] = moQueue.front();
+			moQueue.pop_front();
+		}
+		return liCount;
+	}
+private:
+	CCriticalSection moSection;
+	deque<uint64> moQueue;
+};
+
+struct STRU_RING_RESULT{
+	STRU_RING_RESULT(){
+		mui64Msgs = 0;
+		mdSeconds = 0;
+		mui64Full = 0;
+		mui64OrderErrors = 0;
+	}
+	uint64 mui64Msgs;
+	double mdSeconds;
+	//ʱԵĴ
+	uint64 mui64Full;
+	uint64 mui64OrderErrors;
+};
+
+template <class QUEUE>
+class CRingBench{
+public:
+	CRingBench(int aiProducers, uint64 aui64PerProducer){
+		miProducers = aiProducers;
+		mui64PerProducer = aui64PerProducer;
+		miNextProducer = 0;
+		miReady = 0;
+		mbGo = false;
+		mui64Full = 0;
+	}
+
+	bool Run(STRU_RING_RESULT &aoResult){
+		if(moThreadManager.Start(ProducerThread, this, miProducers, (char*)"ring_producer") != (unsigned int)miProducers){
+			TRACE(1, "CRingBench::Run ߳ʧܡproducers = "<<miProducers);
+			return false;
+		}
+		while(miReady < miProducers){
+			sched_yield();
+		}
+		vector<uint32> loNextSeq(miProducers, 0);
+		uint64 lszValue[DEF_BENCH_RING_BATCH];
+		uint64 lui64Total = mui64PerProducer * miProducers;
+		uint64 lui64Begin = GetNowNs();
+		mbGo = true;
+		while(aoResult.mui64Msgs < lui64Total){
+			unsigned int liCount = moQueue.PopBatch(lszValue, DEF_BENCH_RING_BATCH);
+			if(0 == liCount){
+				sched_yield();
+				continue;
+			}
+			for(unsigned int i = 0; i < liCount; ++i){
+				uint32 liProducer = (uint32)(lszValue[i] >> 32);
+				uint32 liSeq = (uint32)lszValue[i];
+				if(liProducer >= (uint32)miProducers || liSeq != loNextSeq[liProducer]){
+					++aoResult.mui64OrderErrors;
+				} else {
+					++loNextSeq[liProducer];
+				}
+			}
+			aoResult.mui64Msgs += liCount;
+		}
+		aoResult.mdSeconds = (GetNowNs() - lui64Begin) / 1e9;
+		moThreadManager.StopAll();
+		aoResult.mui64Full = mui64Full;
+		return true;
+	}
+
+	static unsigned int ProducerThread(STRU_THREAD_CONTEXT& apContext){
+		CRingBench *p = reinterpret_cast<CRingBench*>(apContext.mpWorkContext);
+		ASSERT(p != NULL);
+		uint64 lui64Producer = (uint64)__sync_fetch_and_add(&p->miNextProducer, 1) << 32;
+		uint64 lui64Full = 0;
+		__sync_add_and_fetch(&p->miReady, 1);
+		while(!p->mbGo){
+			sched_yield();
+		}
+		for(uint64 i = 0; i < p->mui64PerProducer; ++i){
+			while(!p->moQueue.Push(lui64Producer | i)){
+				++lui64Full;
+				sched_yield();
+			}
+		}
+		__sync_add_and_fetch(&p->mui64Full, lui64Full);
+		return 0;
+	}
+
+private:
+	QUEUE moQueue;
+	int miProducers;
+	uint64 mui64PerProducer;
+	volatile int miNextProducer;
+	volatile int miReady;
+	volatile bool mbGo;
+	volatile uint64 mui64Full;
+	CThreadGroup moThreadManager;
+};
+
+template <class QUEUE>
+static bool RunRingCase(int aiProducers, uint64 aui64Msgs){
+	uint64 lui64PerProducer = aui64Msgs / aiProducers;
+	if(0 == lui64PerProducer){
+		lui64PerProducer = 1;
+	}
+	CRingBench<QUEUE> loBench(aiProducers, lui64PerProducer);
+	STRU_RING_RESULT loResult;
+	if(!loBench.Run(loResult)){
+		cerr<<"ѹʧܡproducers = "<<aiProducers<<endl;
+		return false;
+	}
+	double ldRate = loResult.mdSeconds > 0 ? loResult.mui64Msgs / loResult.mdSeconds : 0;
+	printf("%-11s %9d %10llu %12.0f %9.1f %10llu %6llu\n",
+		QUEUE::GetName(), aiProducers, (unsigned long long)loResult.mui64Msgs, ldRate,
+		ldRate > 0 ? 1e9 / ldRate : 0, (unsigned long long)loResult.mui64Full,
+		(unsigned long long)loResult.mui64OrderErrors);
+	fflush(stdout);
+	return 0 == loResult.mui64OrderErrors;
+}
+
+//ʧܵ
+static int RunRing(const vector<int> &aoProducers, uint64 aui64Msgs){
+	int liFailed = 0;
+	printf("%-11s %9s %10s %12s %9s %10s %6s\n",
+		"queue", "producers", "msgs", "msg/s", "ns/msg", "full", "order");
+	for(size_t i = 0; i < aoProducers.size(); ++i){
+		int liProducers = aoProducers[i];
+		if(liProducers <= 0){
+			continue;
+		}
+		liFailed += RunRingCase<CRingBenchMpsc>(liProducers, aui64Msgs) ? 0 : 1;
+		liFailed += RunRingCase<CRingBenchTwoLock>(liProducers, aui64Msgs) ? 0 : 1;
+		liFailed += RunRingCase<CRingBenchMutex>(liProducers, aui64Msgs) ? 0 : 1;
+	}
+	return liFailed;
+}
+
+/************************************************************************/
+/*
+ѹ㷨Ա
+ͬһϢİһ£Զû㷨ʱԭ
+*/
+/************************************************************************/
+static bool RunCompressCase(int aiVersion, int aiType, int aiSize, uint64 aui64Msgs){
+	STRU_BENCH_CASE loCase;
+	loCase.miMode = BENCH_MODE_COMPRESS;
+	loCase.miVersion = aiVersion;
+	loCase.mbEncry = false;
+	loCase.miConns = 1;
+	loCase.miSize = aiSize;
+	loCase.miReactors = 0;
+	loCase.miCompress = aiType;
+	CNetPack *lpSend = CreatePack(loCase);
+	CNetPack *lpRecv = CreatePack(loCase);
+	if(NULL == lpSend || NULL == lpRecv){
+		delete lpSend;
+		delete lpRecv;
+		cerr<<"ʧܡcompress = "<<GetCompressName(aiType)<<endl;
+		return false;
+	}
+	vector<char> loBody(aiSize);
+	FillChatBody(&loBody[0], aiSize);
+	vector<char> loFrame(lpSend->_max_pack_size);
+	vector<char> loOut(lpRecv->_max_pack_size);
+	bool lbOk = true;
+
+	//൱Ѵӽշİͷ￴㷨
+	lpSend->_peer_compress = lpRecv->_accept_compress;
+	int liFrameLen = 0;
+	uint64 lui64Begin = GetNowNs();
+	for(uint64 i = 0; i < aui64Msgs && lbOk; ++i){
+		liFrameLen = (int)loFrame.size();
+		lbOk = lpSend->Pack(&loBody[0], aiSize, &loFrame[0], liFrameLen) > 0;
+	}
+	uint64 lui64Pack = GetNowNs() - lui64Begin;
+
+	int liOutLen = 0;
+	lui64Begin = GetNowNs();
+	for(uint64 i = 0; i < aui64Msgs && lbOk; ++i){
+		liOutLen = (int)loOut.size();
+		int liDataLen = 0;
+		lbOk = lpRecv->Unpack(&loFrame[0], liFrameLen, &loOut[0], liOutLen, liDataLen) > 0 && liDataLen == liFrameLen;
+	}
+	uint64 lui64Unpack = GetNowNs() - lui64Begin;
+	if(lbOk && (liOutLen != aiSize || memcmp(&loOut[0], &loBody[0], aiSize) != 0)){
+		cerr<<"İ岻һ¡compress = "<<GetCompressName(aiType)<<" size = "<<aiSize<<endl;
+		lbOk = false;
+	}
+	if(lbOk && lpRecv->_recv_accept != lpSend->_accept_compress){
+		cerr<<"ͷ㷨벻ԡsend = "<<lpSend->_accept_compress<<" recv = "<<lpRecv->_recv_accept<<endl;
+		lbOk = false;
+	}
+
+	//Զûʱ뷢ԭ
+	lpSend->_peer_compress = 0;
+	int liPlainLen = (int)loFrame.size();
+	if(lbOk && (lpSend->Pack(&loBody[0], aiSize, &loFrame[0], liPlainLen) <= 0 || liPlainLen != lpSend->_min_pack_size + aiSize)){
+		cerr<<"Զû㷨ʱԱѹcompress = "<<GetCompressName(aiType)<<endl;
+		lbOk = false;
+	}
+	delete lpSend;
+	delete lpRecv;
+	if(!lbOk){
+		cerr<<"ѹѹʧܡcompress = "<<GetCompressName(aiType)<<" ver = "<<aiVersion<<" size = "<<aiSize<<endl;
+		return false;
+	}
+	double ldMsgs = aui64Msgs > 0 ? (double)aui64Msgs : 1;
+	printf("%-8s %3d %6d %6d %6.3f %10.0f %10.0f\n",
+		GetCompressName(aiType), aiVersion, aiSize, liFrameLen, (double)liFrameLen / liPlainLen,
+		lui64Pack / ldMsgs, lui64Unpack / ldMsgs);
+	fflush(stdout);
+	return true;
+}
+
+//aoTypesΪʱȽб㷨ʧܵ
+static int RunCompress(const vector<int> &aoTypes, const vector<int> &aoVersions,
+	const vector<int> &aoSizes, uint64 aui64Msgs){
+	vector<int> loTypes = aoTypes;
+	if(loTypes.empty()){
+		for(int liType = COMPRESS_NONE; liType < COMPRESS_TYPE_MAX; ++liType){
+			loTypes.push_back(liType);
+		}
+	}
+	int liFailed = 0;
+	printf("%-8s %3s %6s %6s %6s %10s %10s\n",
+		"compress", "ver", "size", "frame", "ratio", "pack(ns)", "unpack(ns)");
+	for(size_t k = 0; k < loTypes.size(); ++k)
+	for(size_t v = 0; v < aoVersions.size(); ++v)
+	for(size_t s = 0; s < aoSizes.size(); ++s){
+		if(loTypes[k] != COMPRESS_NONE && !CNetCompress::IsSupport(loTypes[k])){
+			if(0 == v && 0 == s){
+				printf("%-8s ûб\n", GetCompressName(loTypes[k]));
+			}
+			continue;
+		}
+		liFailed += RunCompressCase(aoVersions[v], loTypes[k], aoSizes[s], aui64Msgs) ? 0 : 1;
+	}
+	return liFailed;
+}
+
+/************************************************************************/
+/*
+fd
+ͬһsocket dupaiConnsfdעᵽCNetEpollFindfd
+ԭstd::map<int, CNetSocket*>ͬ
+*/
+/************************************************************************/
+//ulimit -nʱfalse
+static bool ReserveOpenFiles(int aiCount){
+	struct rlimit loLimit;
+	if(getrlimit(RLIMIT_NOFILE, &loLimit) != 0){
+		return false;
+	}
+	if(loLimit.rlim_cur >= (rlim_t)aiCount){
+		return true;
+	}
+	if(loLimit.rlim_max < (rlim_t)aiCount){
+		return false;
+	}
+	loLimit.rlim_cur = aiCount;
+	return 0 == setrlimit(RLIMIT_NOFILE, &loLimit);
+}
+
+static bool RunLookupCase(int aiConns, uint64 aui64Lookups){
+	if(!ReserveOpenFiles(aiConns + 64)){
+		printf("%-6s %8d ulimit -n\n", "lookup", aiConns);
+		fflush(stdout);
+		return true;
+	}
+	int liBaseFd = socket(AF_INET, SOCK_STREAM, 0);
+	if(liBaseFd < 0){
+		cerr<<"socketʧܡerrno = "<<errno<<endl;
+		return false;
+	}
+	CNetPackVersion2 loPack;
+	CNetEpoll loEpoll(&loPack);
+	vector<int> loFd;
+	bool lbOk = loEpoll.Init(aiConns);
+	for(int i = 0; i < aiConns && lbOk; ++i){
+		int fd = dup(liBaseFd);
+		if(fd < 0){
+			cerr<<"dupʧܡerrno = "<<errno<<" conns = "<<i<<endl;
+			lbOk = false;
+			break;
+		}
+		if(!loEpoll.Addfd(fd)){
+			close(fd);
+			cerr<<"Addfdʧܡfd = "<<fd<<endl;
+			lbOk = false;
+			break;
+		}
+		loFd.push_back(fd);
+	}
+	//ԭע
+	CCriticalSection loSection;
+	std::map<int, CNetSocket*> loMap;
+	for(size_t i = 0; i < loFd.size(); ++i){
+		loMap[loFd[i]] = (CNetSocket*)&loPack;
+	}
+	//ͬҲ˳ͬһű
+	vector<int> loOrder(DEF_BENCH_LOOKUP_ORDER);
+	uint32 liRand = 1;
+	for(size_t i = 0; i < loOrder.size() && !loFd.empty(); ++i){
+		liRand = liRand * 1103515245 + 12345;
+		loOrder[i] = loFd[(liRand >> 8) % loFd.size()];
+	}
+
+	uint64 lui64Found = 0;
+	uint64 lui64Begin = GetNowNs();
+	for(uint64 i = 0; i < aui64Lookups && lbOk; ++i){
+		lui64Found += loEpoll.Findfd(loOrder[i & (DEF_BENCH_LOOKUP_ORDER - 1)]) ? 1 : 0;
+	}
+	uint64 lui64Slot = GetNowNs() - lui64Begin;
+
+	uint64 lui64MapFound = 0;
+	lui64Begin = GetNowNs();
+	for(uint64 i = 0; i < aui64Lookups && lbOk; ++i){
+		CAutoLock lock(loSection);
+		std::map<int, CNetSocket*>::iterator iter = loMap.find(loOrder[i & (DEF_BENCH_LOOKUP_ORDER - 1)]);
+		lui64MapFound += (iter != loMap.end() && iter->second != NULL) ? 1 : 0;
+	}
+	uint64 lui64Map = GetNowNs() - lui64Begin;
+
+	loEpoll.Destroy();
+	close(liBaseFd);
+	if(lbOk && (lui64Found != aui64Lookups || lui64MapFound != aui64Lookups)){
+		cerr<<"fdû鵽slot = "<<lui64Found<<" map = "<<lui64MapFound<<" lookups = "<<aui64Lookups<<endl;
+		lbOk = false;
+	}
+	if(!lbOk){
+		cerr<<"fdѹʧܡconns = "<<aiConns<<endl;
+		return false;
+	}
+	double ldLookups = aui64Lookups > 0 ? (double)aui64Lookups : 1;
+	printf("%-6s %8d %10llu %10.1f %10.1f\n", "lookup", aiConns, (unsigned long long)aui64Lookups,
+		lui64Slot / ldLookups, lui64Map / ldLookups);
+	fflush(stdout);
+	return true;
+}
+
+//ʧܵ
+static int RunLookup(const vector<int> &aoConns, uint64 aui64Lookups){
+	int liFailed = 0;
+	printf("%-6s %8s %10s %10s %10s\n", "mode", "conns", "lookups", "slot(ns)", "map(ns)");
+	for(size_t i = 0; i < aoConns.size(); ++i){
+		if(aoConns[i] <= 0){
+			continue;
+		}
+		liFailed += RunLookupCase(aoConns[i], aui64Lookups) ? 0 : 1;
+	}
+	return liFailed;
+}
+
+/************************************************************************/
+/*
+ܰ¾дԱ
+дոǰCNetPackVersion2ÿstringstreamתûIDMD5õԿ
+忽stringCAESEncrypt(ÿչԿ)0ٿġ
+дֱӵCNetPackVersion2Pack/Unpackдֽͬİһ
+*/
+/************************************************************************/
+static string LegacyEncryKey(uint64 aui64UserId){
+	stringstream loStream;
+	loStream<<aui64UserId;
+	string lstrUserId;
+	loStream>>lstrUserId;
+	char lszMd5[33];
+	memset(lszMd5, 0, 33);
+	CCommon::MakeMD5WithBuffer32((uint8_t*)lstrUserId.c_str(), lstrUserId.length(), (uint8_t*)lszMd5);
+	char lszKey[17];
+	memset(lszKey, 0, 17);
+	memcpy(lszKey, lszMd5 + 7, 16);
+	return lszKey;
+}
+
+//֡ȣʧܷ-1
+static int LegacyEncryPack(const char *apBody, int aiLength, int aiHeadLen, char *apFrame, int aiFrameLen){
+	//ԭд0CAESEncryptĩβﲹ0ĲܺдȽ
+	string lstrBuffer(apBody, aiLength);
+	lstrBuffer.resize(CAESCipher::AlignLength(aiLength), '\0');
+	string lstrEncrypt;
+	CAESEncrypt loAES;
+	if(!loAES.Encrypt(lstrBuffer, LegacyEncryKey(DEF_BENCH_ENCRY_ID), lstrEncrypt)){
+		return -1;
+	}
+	memset(apFrame, 0, aiFrameLen);
+	memcpy(apFrame + aiHeadLen, lstrEncrypt.c_str(), lstrEncrypt.size());
+	return aiHeadLen + (int)lstrEncrypt.size();
+}
+
+//ؽĳȣʧܷ-1
+static int LegacyDecryUnpack(const char *apFrame, int aiFrameLen, int aiHeadLen, char *apOut){
+	string lstrBuffer(apFrame + aiHeadLen, aiFrameLen - aiHeadLen);
+	string lstrPlain;
+	CAESEncrypt loAES;
+	if(!loAES.Decrypt(lstrBuffer, LegacyEncryKey(DEF_BENCH_ENCRY_ID), lstrPlain)){
+		return -1;
+	}
+	memcpy(apOut, lstrPlain.c_str(), lstrPlain.size());
+	return (int)lstrPlain.size();
+}
+
+static bool RunAESCase(int aiSize, uint64 aui64Msgs){
+	STRU_BENCH_CASE loCase;
+	loCase.miMode = BENCH_MODE_AES;
+	loCase.miVersion = 2;
+	loCase.mbEncry = true;
+	loCase.miConns = 1;
+	loCase.miSize = aiSize;
+	loCase.miReactors = 0;
+	loCase.miCompress = COMPRESS_NONE;
+	CNetPack *lpSend = CreatePack(loCase);
+	CNetPack *lpRecv = CreatePack(loCase);
+	if(NULL == lpSend || NULL == lpRecv){
+		delete lpSend;
+		delete lpRecv;
+		cerr<<"ʧܡ"<<endl;
+		return false;
+	}
+	int liHeadLen = lpSend->_min_pack_size;
+	vector<char> loBody(aiSize);
+	FillChatBody(&loBody[0], aiSize);
+	vector<char> loFrame(lpSend->_max_pack_size);
+	vector<char> loLegacyFrame(lpSend->_max_pack_size);
+	vector<char> loOut(lpRecv->_max_pack_size);
+	vector<char> loLegacyOut(lpRecv->_max_pack_size);
+	bool lbOk = true;
+
+	int liLegacyLen = 0;
+	uint64 lui64Begin = GetNowNs();
+	for(uint64 i = 0; i < aui64Msgs && lbOk; ++i){
+		liLegacyLen = LegacyEncryPack(&loBody[0], aiSize, liHeadLen, &loLegacyFrame[0], (int)loLegacyFrame.size());
+		lbOk = liLegacyLen > 0;
+	}
+	uint64 lui64LegacyPack = GetNowNs() - lui64Begin;
+
+	int liFrameLen = 0;
+	lui64Begin = GetNowNs();
+	for(uint64 i = 0; i < aui64Msgs && lbOk; ++i){
+		liFrameLen = (int)loFrame.size();
+		lbOk = lpSend->Pack(&loBody[0], aiSize, &loFrame[0], liFrameLen) > 0;
+	}
+	uint64 lui64Pack = GetNowNs() - lui64Begin;
+	if(lbOk && (liFrameLen != liLegacyLen
+		|| memcmp(&loFrame[liHeadLen], &loLegacyFrame[liHeadLen], liFrameLen - liHeadLen) != 0)){
+		cerr<<"¾дĲһ¡size = "<<aiSize<<endl;
+		lbOk = false;
+	}
+
+	int liLegacyOutLen = 0;
+	lui64Begin = GetNowNs();
+	for(uint64 i = 0; i < aui64Msgs && lbOk; ++i){
+		liLegacyOutLen = LegacyDecryUnpack(&loFrame[0], liFrameLen, liHeadLen, &loLegacyOut[0]);
+		lbOk = liLegacyOutLen >= aiSize;
+	}
+	uint64 lui64LegacyUnpack = GetNowNs() - lui64Begin;
+
+	int liOutLen = 0;
+	lui64Begin = GetNowNs();
+	for(uint64 i = 0; i < aui64Msgs && lbOk; ++i){
+		liOutLen = (int)loOut.size();
+		int liDataLen = 0;
+		lbOk = lpRecv->Unpack(&loFrame[0], liFrameLen, &loOut[0], liOutLen, liDataLen) > 0 && liDataLen == liFrameLen;
+	}
+	uint64 lui64Unpack = GetNowNs() - lui64Begin;
+	if(lbOk && (liOutLen < aiSize || memcmp(&loOut[0], &loBody[0], aiSize) != 0
+		|| memcmp(&loLegacyOut[0], &loBody[0], aiSize) != 0)){
+		cerr<<"İ岻һ¡size = "<<aiSize<<endl;
+		lbOk = false;
+	}
+	delete lpSend;
+	delete lpRecv;
+	if(!lbOk){
+		cerr<<"ѹʧܡsize = "<<aiSize<<endl;
+		return false;
+	}
+	double ldMsgs = aui64Msgs > 0 ? (double)aui64Msgs : 1;
+	printf("%-6s %6d %6d %12.0f %12.0f %14.0f %14.0f\n", "aes", aiSize, liFrameLen,
+		lui64LegacyPack / ldMsgs, lui64Pack / ldMsgs, lui64LegacyUnpack / ldMsgs, lui64Unpack / ldMsgs);
+	fflush(stdout);
+	return true;
+}
+
+//ʧܵ
+static int RunAES(const vector<int> &aoSizes, uint64 aui64Msgs){
+	int liFailed = 0;
+	printf("%-6s %6s %6s %12s %12s %14s %14s\n",
+		"mode", "size", "frame", "pack_old(ns)", "pack_new(ns)", "unpack_old(ns)", "unpack_new(ns)");
+	for(size_t s = 0; s < aoSizes.size(); ++s){
+		liFailed += RunAESCase(aoSizes[s], aui64Msgs) ? 0 : 1;
+	}
+	return liFailed;
+}
+
+/************************************************************************/
+/*
+ѹ
+*/
+/************************************************************************/
+struct STRU_BENCH_OPTION{
+	STRU_BENCH_OPTION(){
+		miDepth = 1;
+		miSeconds = DEF_BENCH_SECONDS;
+		mui64Msgs = 0;
+		miPort = DEF_BENCH_PORT;
+		mbZeroCopy = false;
+	}
+	vector<int> moModes;
+	vector<int> moVersions;
+	vector<int> moEncrys;
+	vector<int> moConns;
+	vector<int> moSizes;
+	vector<int> moReactors;
+	//ѹ㷨бģʽΪʱѹcompressģʽΪʱȽȫ㷨
+	vector<int> moCompress;
+	int miDepth;
+	int miSeconds;
+	//ôϢͽ0ʾʱ
+	uint64 mui64Msgs;
+	int miPort;
+	bool mbZeroCopy;
+};
+
+static bool RunCase(const STRU_BENCH_CASE &aoCase, const STRU_BENCH_OPTION &aoOption,
+	unsigned short aiPort, STRU_BENCH_RESULT &aoResult, CLatencyHistogram &aoHistogram){
+	CBenchServer loServer;
+	if(!loServer.Init(aoCase, aiPort, aoOption.mbZeroCopy)){
+		cerr<<"˳ʼʧܡport = "<<aiPort<<endl;
+		return false;
+	}
+	CBenchClient loClient;
+	if(!loClient.Init(aoCase, aiPort, aoOption.miDepth, aoOption.mbZeroCopy)){
+		cerr<<"ͻ˳ʼʧܣulimit -nconns = "<<aoCase.miConns<<endl;
+		return false;
+	}
+
+	//ͻconnectʱ˿ܻûaccept㲥©û
+	uint64 lui64AcceptEnd = GetNowNs() + DEF_BENCH_DRAIN_MS * 1000000ULL;
+	while(loServer.GetAcceptedSize() < (unsigned int)aoCase.miConns){
+		if(GetNowNs() >= lui64AcceptEnd){
+			cerr<<"ûнȫӡaccepted = "<<loServer.GetAcceptedSize()<<" conns = "<<aoCase.miConns<<endl;
+			return false;
+		}
+		usleep(1000);
+	}
+
+	uint64 lui64Begin = GetNowNs();
+	uint64 lui64End = lui64Begin + (uint64)aoOption.miSeconds * 1000000000ULL;
+	uint64 lui64Sample = lui64Begin;
+	loClient.Start();
+	while(0 == loClient.mui64Errors){
+		loClient.Poll(1);
+		uint64 lui64Now = GetNowNs();
+		if(BENCH_MODE_SLOW == aoCase.miMode && lui64Now >= lui64Sample){
+			lui64Sample = lui64Now + DEF_BENCH_SLOW_SAMPLE_MS * 1000000ULL;
+			STRU_SEND_QUEUE_STAT loStat;
+			loServer.GetSendQueueStat(loStat);
+			if(loStat.miMaxBytes > aoResult.miQueueMaxBytes){
+				aoResult.miQueueMaxBytes = loStat.miMaxBytes;
+			}
+			aoResult.mui64QueueDrop = loStat.mui64DropCount;
+		}
+		if(aoOption.mui64Msgs > 0 ? loClient.mui64Recv >= aoOption.mui64Msgs : lui64Now >= lui64End){
+			break;
+		}
+	}
+	aoResult.mdSeconds = (GetNowNs() - lui64Begin) / 1e9;
+	aoResult.mui64Msgs = loClient.mui64Recv;
+
+	//ֹͣͣ;Ϣ
+	loClient.mbSending = false;
+	uint64 lui64DrainEnd = GetNowNs() + DEF_BENCH_DRAIN_MS * 1000000ULL;
+	while(loClient.GetPending() > 0 && 0 == loClient.mui64Errors && GetNowNs() < lui64DrainEnd){
+		loClient.Poll(1);
+	}
+	aoResult.mui64Lost = loClient.GetPending();
+	aoResult.mui64Errors = loClient.mui64Errors + loServer.mui64Errors + loClient.CheckPeerCompress();
+	aoHistogram = loClient.moHistogram;
+	return true;
+}
+
+static void PrintHead(){
+	printf("%-9s %3s %5s %5s %4s %6s %6s %5s %10s %10s %9s %9s %9s %9s %9s %6s %4s\n",
+		"mode", "ver", "encry", "react", "zip", "conns", "size", "depth", "msgs", "msg/s", "MB/s",
+		"p50(us)", "p99(us)", "p999(us)", "max(us)", "lost", "err");
+}
+
+static const char* GetModeName(int aiMode){
+	switch(aiMode){
+	case BENCH_MODE_ECHO: return "echo";
+	case BENCH_MODE_BROADCAST: return "broadcast";
+	case BENCH_MODE_SLOW: return "slow";
+	case BENCH_MODE_RING: return "ring";
+	case BENCH_MODE_COMPRESS: return "compress";
+	case BENCH_MODE_LOOKUP: return "lookup";
+	case BENCH_MODE_AES: return "aes";
+	default: return "unknown";
+	}
+}
+
+static void PrintResult(const STRU_BENCH_CASE &aoCase, int aiDepth,
+	STRU_BENCH_RESULT &aoResult, CLatencyHistogram &aoHistogram){
+	double ldRate = aoResult.mdSeconds > 0 ? aoResult.mui64Msgs / aoResult.mdSeconds : 0;
+	printf("%-9s %3d %5d %5d %4s %6d %6d %5d %10llu %10.0f %9.2f %9.1f %9.1f %9.1f %9.1f %6llu %4llu\n",
+		GetModeName(aoCase.miMode),
+		aoCase.miVersion, aoCase.mbEncry ? 1 : 0, aoCase.miReactors, GetCompressName(aoCase.miCompress),
+		aoCase.miConns, aoCase.miSize, aiDepth,
+		(unsigned long long)aoResult.mui64Msgs, ldRate, ldRate * aoCase.miSize / (1024.0 * 1024.0),
+		aoHistogram.GetPercentile(50) / 1000.0, aoHistogram.GetPercentile(99) / 1000.0,
+		aoHistogram.GetPercentile(99.9) / 1000.0, aoHistogram.GetMax() / 1000.0,
+		(unsigned long long)aoResult.mui64Lost, (unsigned long long)aoResult.mui64Errors);
+	if(BENCH_MODE_SLOW == aoCase.miMode){
+		printf("  ӷͶ %d ֽ(޶ %d)ϲ %llu \n",
+			aoResult.miQueueMaxBytes, DEF_BENCH_SLOW_QUEUE_BYTES, (unsigned long long)aoResult.mui64QueueDrop);
+	}
+	fflush(stdout);
+}
+
+//ŷָб
+static bool ParseList(const char *apText, vector<int> &aoList){
+	aoList.clear();
+	string lstrText = apText;
+	size_t liPos = 0;
+	while(liPos <= lstrText.size()){
+		size_t liEnd = lstrText.find(',', liPos);
+		if(string::npos == liEnd){
+			liEnd = lstrText.size();
+		}
+		string lstrItem = lstrText.substr(liPos, liEnd - liPos);
+		if(lstrItem == "echo"){
+			aoList.push_back(BENCH_MODE_ECHO);
+		} else if(lstrItem == "broadcast"){
+			aoList.push_back(BENCH_MODE_BROADCAST);
+		} else if(lstrItem == "slow"){
+			aoList.push_back(BENCH_MODE_SLOW);
+		} else if(lstrItem == "ring"){
+			aoList.push_back(BENCH_MODE_RING);
+		} else if(lstrItem == "compress"){
+			aoList.push_back(BENCH_MODE_COMPRESS);
+		} else if(lstrItem == "lookup"){
+			aoList.push_back(BENCH_MODE_LOOKUP);
+		} else if(lstrItem == "aes"){
+			aoList.push_back(BENCH_MODE_AES);
+		} else {
+			char *lpEnd = NULL;
+			long liValue = strtol(lstrItem.c_str(), &lpEnd, 10);
+			if(lstrItem.empty() || *lpEnd != '\0' || liValue < 0){
+				return false;
+			}
+			aoList.push_back((int)liValue);
+		}
+		liPos = liEnd + 1;
+	}
+	return !aoList.empty();
+}
+
+static void Usage(const char *apName){
+	printf("÷: %s [ѡ]\n"
+		"  -m echo,broadcast,slow,ring,compress,lookup,aes\n"
+		"                      ģʽĬechoslowΪ2ӵķͶг޶ʱ1\n"
+		"                      ring磬-cΪ߳-nΪϢ(Ĭ%d)\n"
+		"                      compress磬-k -v -sȽѹ㷨-nΪÿ(Ĭ%d)\n"
+		"                      lookup磬-cΪע-nΪÿҴ(Ĭ%d)\n"
+		"                      aes磬-sȽϼܰ¾д-nΪÿ(Ĭ%d)\n"
+		"  -v 1,2              Э汾Ĭ2\n"
+		"  -e 0,1              Ƿ(ֻа汾2֧)Ĭ0\n"
+		"  -c б       Ĭ1,64\n"
+		"  -s Ϣб     Ĭ64,1024\n"
+		"  -r Ӧб     CNetEpollGroupķӦ0ΪCNetEpollĬ0\n"
+		"  -k ѹ㷨б     0ѹ 1zlib 2lz4 3zstdģʽ˶ѹĬ0\n"
+		"                      compressģʽĬϱȽȫ㷨\n"
+		"  -d ;       ÿ(㲥Ϊÿ)Ĭ1\n"
+		"  -t              ÿѹʱ䣬Ĭ%d\n"
+		"  -n Ϣ           -t\n"
+		"  -p ˿             ʼ˿ڣÿ1Ĭ%d\n"
+		"  -z                  㿽\n"
+		"ԶŸĲУг򶪰ʱ1\n",
+		apName, DEF_BENCH_RING_MSGS, DEF_BENCH_COMPRESS_MSGS, DEF_BENCH_LOOKUP_COUNT, DEF_BENCH_AES_MSGS,
+		DEF_BENCH_SECONDS, DEF_BENCH_PORT);
+}
+
+int main(int argc, char* argv[])
+{
+	STRU_BENCH_OPTION loOption;
+	loOption.moModes.push_back(BENCH_MODE_ECHO);
+	loOption.moVersions.push_back(2);
+	loOption.moEncrys.push_back(0);
+	loOption.moConns.push_back(1);
+	loOption.moConns.push_back(64);
+	loOption.moSizes.push_back(64);
+	loOption.moSizes.push_back(1024);
+	loOption.moReactors.push_back(0);
+
+	int liOpt = 0;
+	bool lbArgOk = true;
+	while(lbArgOk && (liOpt = getopt(argc, argv, "m:v:e:c:s:r:k:d:t:n:p:zh")) != -1){
+		switch(liOpt){
+		case 'm': lbArgOk = ParseList(optarg, loOption.moModes); break;
+		case 'v': lbArgOk = ParseList(optarg, loOption.moVersions); break;
+		case 'e': lbArgOk = ParseList(optarg, loOption.moEncrys); break;
+		case 'c': lbArgOk = ParseList(optarg, loOption.moConns); break;
+		case 's': lbArgOk = ParseList(optarg, loOption.moSizes); break;
+		case 'r': lbArgOk = ParseList(optarg, loOption.moReactors); break;
+		case 'k': lbArgOk = ParseList(optarg, loOption.moCompress); break;
+		case 'd': loOption.miDepth = atoi(optarg); lbArgOk = loOption.miDepth > 0; break;
+		case 't': loOption.miSeconds = atoi(optarg); lbArgOk = loOption.miSeconds > 0; break;
+		case 'n': loOption.mui64Msgs = strtoull(optarg, NULL, 10); break;
+		case 'p': loOption.miPort = atoi(optarg); lbArgOk = loOption.miPort > 0; break;
+		case 'z': loOption.mbZeroCopy = true; break;
+		default: lbArgOk = false; break;
+		}
+	}
+	if(!lbArgOk){
+		Usage(argv[0]);
+		return 2;
+	}
+
+	//־ֻдļŽ
+	goDebugTrace = new CDebugTrace;
+	SET_TRACE_LEVEL(1);
+	unsigned liOptions = (CDebugTrace::Timestamp | CDebugTrace::LogLevel | CDebugTrace::AppendToFile);
+	SET_TRACE_OPTIONS((GET_TRACE_OPTIONS() | liOptions) & ~CDebugTrace::PrintToConsole);
+	char lszLogFileName[255];
+	CFileStream::GetAppPath(lszLogFileName, 255);
+	strcpy(strrchr(lszLogFileName, '/'), "//NetBench");
+	SET_LOG_FILENAME(lszLogFileName);
+
+	int liMaxSize = DEF_BUFFER_LEN - 64;
+	for(size_t k = 0; k < loOption.moCompress.size(); ++k){
+		if(loOption.moCompress[k] >= COMPRESS_TYPE_MAX){
+			cerr<<"ֵ֧ѹ㷨: "<<loOption.moCompress[k]<<endl;
+			return 2;
+		}
+	}
+	for(size_t v = 0; v < loOption.moVersions.size(); ++v){
+		if(loOption.moVersions[v] != 1 && loOption.moVersions[v] != 2){
+			cerr<<"ֵ֧İЭ汾: "<<loOption.moVersions[v]<<endl;
+			return 2;
+		}
+	}
+	for(size_t s = 0; s < loOption.moSizes.size(); ++s){
+		if(loOption.moSizes[s] < (int)sizeof(STRU_BENCH_MSG) || loOption.moSizes[s] > liMaxSize){
+			cerr<<"Ϣ"<<sizeof(STRU_BENCH_MSG)<<"~"<<liMaxSize<<"֮䡣"<<endl;
+			return 2;
+		}
+	}
+	int liFailed = 0;
+	//ģʽȵܣͷ
+	vector<int> loNetModes;
+	for(size_t m = 0; m < loOption.moModes.size(); ++m){
+		if(BENCH_MODE_RING == loOption.moModes[m]){
+			liFailed += RunRing(loOption.moConns, loOption.mui64Msgs > 0 ? loOption.mui64Msgs : DEF_BENCH_RING_MSGS);
+		} else if(BENCH_MODE_COMPRESS == loOption.moModes[m]){
+			liFailed += RunCompress(loOption.moCompress, loOption.moVersions, loOption.moSizes,
+				loOption.mui64Msgs > 0 ? loOption.mui64Msgs : DEF_BENCH_COMPRESS_MSGS);
+		} else if(BENCH_MODE_LOOKUP == loOption.moModes[m]){
+			liFailed += RunLookup(loOption.moConns, loOption.mui64Msgs > 0 ? loOption.mui64Msgs : DEF_BENCH_LOOKUP_COUNT);
+		} else if(BENCH_MODE_AES == loOption.moModes[m]){
+			liFailed += RunAES(loOption.moSizes, loOption.mui64Msgs > 0 ? loOption.mui64Msgs : DEF_BENCH_AES_MSGS);
+		} else {
+			loNetModes.push_back(loOption.moModes[m]);
+		}
+	}
+	loOption.moModes = loNetModes;
+	if(loOption.moCompress.empty()){
+		loOption.moCompress.push_back(COMPRESS_NONE);
+	}
+	unsigned short liPort = (unsigned short)loOption.miPort;
+	if(!loOption.moModes.empty()){
+		PrintHead();
+	}
+	for(size_t m = 0; m < loOption.moModes.size(); ++m)
+	for(size_t v = 0; v < loOption.moVersions.size(); ++v)
+	for(size_t e = 0; e < loOption.moEncrys.size(); ++e)
+	for(size_t r = 0; r < loOption.moReactors.size(); ++r)
+	for(size_t k = 0; k < loOption.moCompress.size(); ++k)
+	for(size_t c = 0; c < loOption.moConns.size(); ++c)
+	for(size_t s = 0; s < loOption.moSizes.size(); ++s){
+		STRU_BENCH_CASE loCase;
+		loCase.miMode = loOption.moModes[m];
+		loCase.miVersion = loOption.moVersions[v];
+		loCase.mbEncry = loOption.moEncrys[e] != 0;
+		loCase.miConns = loOption.moConns[c];
+		loCase.miSize = loOption.moSizes[s];
+		loCase.miReactors = loOption.moReactors[r];
+		loCase.miCompress = loOption.moCompress[k];
+		if(loCase.miReactors > DEF_MAX_REACTOR_COUNT){
+			cerr<<"Ӧܳ"<<DEF_MAX_REACTOR_COUNT<<endl;
+			return 2;
+		}
+		if(loCase.miConns <= 0){
+			cerr<<"0"<<endl;
+			return 2;
+		}
+		if(BENCH_MODE_SLOW == loCase.miMode && loCase.miConns < 2){
+			//ҪһӺһ
+			continue;
+		}
+		if(loCase.mbEncry && 1 == loCase.miVersion){
+			//汾1ûмܣ
+			continue;
+		}
+		if(loCase.miCompress != COMPRESS_NONE && !CNetCompress::IsSupport(loCase.miCompress)){
+			//ûб㷨
+			continue;
+		}
+		STRU_BENCH_RESULT loResult;
+		CLatencyHistogram loHistogram;
+		if(!RunCase(loCase, loOption, liPort++, loResult, loHistogram)){
+			++liFailed;
+			continue;
+		}
+		PrintResult(loCase, loOption.miDepth, loResult, loHistogram);
+		if(0 == loResult.mui64Msgs || loResult.mui64Lost > 0 || loResult.mui64Errors > 0){
+			++liFailed;
+		}
+		if(BENCH_MODE_SLOW == loCase.miMode && loResult.miQueueMaxBytes > DEF_BENCH_SLOW_QUEUE_BYTES){
+			++liFailed;
+		}
+	}
+	return liFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,345 @@
+/********************************************************************
+	created:	2026/10/16
+	file base:	SerializeBench
+	file ext:	cpp
+	
+	purpose:	apsdk crs_cl뿪Ա
+				ֶεCStandardSerializeľд(ԭSerialize屣ڱļ)
+				FieldSerialize.hֶαչдȡ
+				㲥2009ûϢб(-u û)ÿPack/UnPack
+				ʱǰȱȽдİֶֽͬһ£ʱط0
+				apsdkinclude.hCommonͬļֻ·apsdkͷļ
+*********************************************************************/
+#include <getopt.h>
+#include <time.h>
+#include "../adpush/apsdk/base/pack/crs_cl_strudef.h"
+
+#define DEF_SERIALIZE_BENCH_COUNT 200000
+#define DEF_SERIALIZE_BENCH_BUFFER (1024*1024)
+
+typedef unsigned long long uint64;
+
+static uint64 GetNowNs(){
+	struct timespec loTime;
+	clock_gettime(CLOCK_MONOTONIC, &loTime);
+	return (uint64)loTime.tv_sec * 1000000000ULL + loTime.tv_nsec;
+}
+
+//ֹѭŻ
+static volatile int giSink = 0;
+
+/************************************************************************/
+/*
+дԭcrs_cl_strudef.cppֶεSerializeֻ
+*/
+/************************************************************************/
+static int LegacySerialize(STRU_CHATROOM_USER_INFO_2009 &aoValue, CStandardSerialize &aoSerialize){
+	aoSerialize.Serialize(aoValue.mi64UserId);
+	aoSerialize.Serialize(aoValue.macNickName, NICK_NAME_LEN+1);
+	aoSerialize.Serialize(aoValue.mwPhotoNum);
+	aoSerialize.Serialize(aoValue.mbyPower);
+	aoSerialize.Serialize(aoValue.mlUserState);
+	aoSerialize.Serialize(aoValue.mbyVoiceState);
+	aoSerialize.Serialize(aoValue.mbyUserLanguage);
+	aoSerialize.Serialize(aoValue.miRedMemTime);
+	aoSerialize.Serialize(aoValue.mstrUniName, DEF_USER_UNINAME_LEN+1);
+	aoSerialize.Serialize(aoValue.mstrUserMood, DEF_USER_MOOD_LENGTH+1);
+	aoSerialize.Serialize(aoValue.mstrUserImageURL, URL_LINK_LEN+1);
+	aoSerialize.Serialize(aoValue.mbyUserSex);
+	aoSerialize.Serialize(aoValue.miUserOnLineTime);
+	aoSerialize.Serialize(aoValue.miUserCharm);
+	aoSerialize.Serialize(aoValue.miUserWealth);
+	aoSerialize.Serialize(aoValue.miUserActivity);
+	aoSerialize.Serialize(aoValue.mlVipRooomID);
+	aoSerialize.Serialize(aoValue.mbyShowBar);
+	aoSerialize.Serialize(aoValue.mstrUserBirthDay, DEF_USER_BIRTHDAY_LEN+1);
+	return 1;
+}
+
+static int LegacySerialize(STRU_UC_CL_CRS_USER_INFO_ID_2009 &aoValue, CStandardSerialize &aoSerialize){
+	aoSerialize.Serialize(aoValue.mlChatroomID);
+	aoSerialize.Serialize(aoValue.mwUserCount);
+	if(aoSerialize.mbyType == CStandardSerialize::LOAD){
+		//ԭдֱÿջй©ϴεбͷţдһ
+		delete [] aoValue.mpUserIDList;
+		aoValue.mpUserIDList = NULL;
+		if(aoValue.mwUserCount > 0){
+			aoValue.mpUserIDList = new STRU_CHATROOM_USER_INFO_2009[aoValue.mwUserCount];
+		}
+	}
+	for(int i = 0; i < aoValue.mwUserCount; i++){
+		LegacySerialize(aoValue.mpUserIDList[i], aoSerialize);
+	}
+	return 1;
+}
+
+static int LegacySerialize(STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY &aoValue, CStandardSerialize &aoSerialize){
+	//ԭдDEF_CONTENT_NAME_LENֳȣϷİһ
+	aoSerialize.Serialize(aoValue.mi64UserID);
+	aoSerialize.Serialize(aoValue.mszUserName, DEF_CONTENT_NAME_LEN+1);
+	aoSerialize.Serialize(aoValue.mi64DestID);
+	aoSerialize.Serialize(aoValue.mszDestName, DEF_CONTENT_NAME_LEN+1);
+	aoSerialize.Serialize(aoValue.miContentID);
+	aoSerialize.Serialize(aoValue.mszContentName, DEF_CONTENT_NAME_LEN+1);
+	aoSerialize.Serialize(aoValue.miUseCount);
+	aoSerialize.Serialize(aoValue.mlChatroomID);
+	aoSerialize.Serialize(aoValue.mstruRoomName, DEF_CONTENT_NAME_LEN+1);
+	aoSerialize.Serialize(aoValue.mstruTimeStamp);
+	aoSerialize.Serialize(aoValue.miHallIP);
+	aoSerialize.Serialize(aoValue.miHallPort);
+	aoSerialize.Serialize(aoValue.miHallProperty);
+	aoSerialize.Serialize(aoValue.miHallPropertyEx);
+	aoSerialize.Serialize(aoValue.mbyShowStar);
+	aoSerialize.Serialize(aoValue.mbyNobleman);
+	aoSerialize.Serialize(aoValue.mbyManager);
+	aoSerialize.Serialize(aoValue.mbyWeekStar);
+	aoSerialize.Serialize(aoValue.mbySell);
+	aoSerialize.Serialize(aoValue.mbyDstShowStar);
+	aoSerialize.Serialize(aoValue.mbyDstNobleman);
+	aoSerialize.Serialize(aoValue.mbyDstManager);
+	aoSerialize.Serialize(aoValue.mbyDstWeekStar);
+	aoSerialize.Serialize(aoValue.mbyDstSell);
+	aoSerialize.Serialize(aoValue.miReserved1);
+	aoSerialize.Serialize(aoValue.miReserved2);
+	return 1;
+}
+
+template<class S>
+static int LegacyPack(S &aoValue, char *apBuffer, int alLen){
+	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::STORE);
+	uint16_t lwPackType = CFieldTraits<S>::PACK_TYPE;
+	loSerialize.Serialize(lwPackType);
+	if(LegacySerialize(aoValue, loSerialize) == -1){
+		return -1;
+	}
+	return loSerialize.getDataLen();
+}
+
+template<class S>
+static int LegacyUnPack(S &aoValue, char *apBuffer, int alLen){
+	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::LOAD);
+	uint16_t lwPackType;
+	loSerialize.Serialize(lwPackType);
+	if(LegacySerialize(aoValue, loSerialize) == -1){
+		return -1;
+	}
+	return 1;
+}
+
+/************************************************************************/
+/*
+
+*/
+/************************************************************************/
+static void FillUser(STRU_CHATROOM_USER_INFO_2009 &aoUser, int aiIndex){
+	aoUser.mi64UserId = 100000000LL + aiIndex;
+	snprintf(aoUser.macNickName, sizeof(aoUser.macNickName), "nick_%d", aiIndex);
+	aoUser.mwPhotoNum = (uint16_t)(aiIndex % 100);
+	aoUser.mbyPower = (uint8_t)(aiIndex % 7);
+	aoUser.mlUserState = aiIndex * 3;
+	aoUser.mbyVoiceState = 1;
+	aoUser.mbyUserLanguage = 2;
+	aoUser.miRedMemTime = aiIndex * 60;
+	snprintf(aoUser.mstrUniName, sizeof(aoUser.mstrUniName), "uniname_%08d@example.com", aiIndex);
+	snprintf(aoUser.mstrUserMood, sizeof(aoUser.mstrUserMood), "mood of user %d", aiIndex);
+	snprintf(aoUser.mstrUserImageURL, sizeof(aoUser.mstrUserImageURL),
+		"http://img.example.com/head/%d/%d.jpg", aiIndex % 1000, aiIndex);
+	aoUser.mbyUserSex = (uint8_t)(aiIndex % 3);
+	aoUser.miUserOnLineTime = aiIndex * 3600;
+	aoUser.miUserCharm = aiIndex * 11;
+	aoUser.miUserWealth = aiIndex * 13;
+	aoUser.miUserActivity = aiIndex * 17;
+	aoUser.mlVipRooomID = aiIndex % 5 ? 0 : 5000 + aiIndex;
+	aoUser.mbyShowBar = (uint8_t)(aiIndex & 1);
+	snprintf(aoUser.mstrUserBirthDay, sizeof(aoUser.mstrUserBirthDay), "19%02d-%02d-%02d",
+		aiIndex % 100, aiIndex % 12 + 1, aiIndex % 28 + 1);
+}
+
+static void FillUserList(STRU_UC_CL_CRS_USER_INFO_ID_2009 &aoList, int aiUsers){
+	aoList.mlChatroomID = 12345;
+	aoList.mwUserCount = (uint16_t)aiUsers;
+	aoList.mpUserIDList = aiUsers > 0 ? new STRU_CHATROOM_USER_INFO_2009[aiUsers] : NULL;
+	for(int i = 0; i < aiUsers; ++i){
+		FillUser(aoList.mpUserIDList[i], i);
+	}
+}
+
+static void FillBigGift(STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY &aoGift){
+	aoGift.mi64UserID = 100000001LL;
+	strcpy(aoGift.mszUserName, "sender_nick");
+	aoGift.mi64DestID = 100000002LL;
+	strcpy(aoGift.mszDestName, "receiver_nick");
+	aoGift.miContentID = 3001;
+	strcpy(aoGift.mszContentName, "a very big and shiny gift");
+	aoGift.miUseCount = 99;
+	aoGift.mlChatroomID = 12345;
+	strcpy(aoGift.mstruRoomName, "room_12345");
+	aoGift.mstruTimeStamp = 1760600000;
+	aoGift.miHallIP = 0x0100007f;
+	aoGift.miHallPort = 8000;
+	aoGift.miHallProperty = 1;
+	aoGift.miHallPropertyEx = 2;
+	aoGift.mbyShowStar = 3;
+	aoGift.mbyNobleman = 1;
+	aoGift.mbyDstWeekStar = 2;
+	aoGift.miReserved1 = 7;
+}
+
+/************************************************************************/
+/*
+ȷԼͼʱ
+*/
+/************************************************************************/
+static bool SameUser(const STRU_CHATROOM_USER_INFO_2009 &a, const STRU_CHATROOM_USER_INFO_2009 &b){
+	return a.mi64UserId == b.mi64UserId && 0 == strcmp(a.macNickName, b.macNickName)
+		&& a.mwPhotoNum == b.mwPhotoNum && a.mbyPower == b.mbyPower && a.mlUserState == b.mlUserState
+		&& a.mbyVoiceState == b.mbyVoiceState && a.mbyUserLanguage == b.mbyUserLanguage
+		&& a.miRedMemTime == b.miRedMemTime && 0 == strcmp(a.mstrUniName, b.mstrUniName)
+		&& 0 == strcmp(a.mstrUserMood, b.mstrUserMood) && 0 == strcmp(a.mstrUserImageURL, b.mstrUserImageURL)
+		&& a.mbyUserSex == b.mbyUserSex && a.miUserOnLineTime == b.miUserOnLineTime
+		&& a.miUserCharm == b.miUserCharm && a.miUserWealth == b.miUserWealth
+		&& a.miUserActivity == b.miUserActivity && a.mlVipRooomID == b.mlVipRooomID
+		&& a.mbyShowBar == b.mbyShowBar && 0 == strcmp(a.mstrUserBirthDay, b.mstrUserBirthDay);
+}
+
+static bool SameValue(const STRU_UC_CL_CRS_USER_INFO_ID_2009 &a, const STRU_UC_CL_CRS_USER_INFO_ID_2009 &b){
+	if(a.mlChatroomID != b.mlChatroomID || a.mwUserCount != b.mwUserCount){
+		return false;
+	}
+	for(int i = 0; i < a.mwUserCount; ++i){
+		if(!SameUser(a.mpUserIDList[i], b.mpUserIDList[i])){
+			return false;
+		}
+	}
+	return true;
+}
+
+//ṹﶼǶֶҹʱ0ֽڱȽ
+static bool SameValue(const STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY &a, const STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY &b){
+	return 0 == memcmp(&a, &b, sizeof(a));
+}
+
+//дֽͬҸܽԭֵذʧܷ-1
+template<class S>
+static int Check(S &aoValue, char *apBuffer, char *apLegacy){
+	int liLen = aoValue.Pack(apBuffer, DEF_SERIALIZE_BENCH_BUFFER);
+	int liLegacyLen = LegacyPack(aoValue, apLegacy, DEF_SERIALIZE_BENCH_BUFFER);
+	if(liLen <= 0 || liLen != liLegacyLen || memcmp(apBuffer, apLegacy, liLen) != 0){
+		printf("ͬfield = %d legacy = %d\n", liLen, liLegacyLen);
+		return -1;
+	}
+	S loField;
+	S loLegacy;
+	if(loField.UnPack(apBuffer, liLen) == -1 || LegacyUnPack(loLegacy, apLegacy, liLen) == -1
+		|| !SameValue(aoValue, loField) || !SameValue(aoValue, loLegacy)){
+		printf("ͬlen = %d\n", liLen);
+		return -1;
+	}
+	//ضһֽڣдܾ
+	S loShort;
+	if(loShort.UnPack(apBuffer, liLen - 1) != -1){
+		printf("ض̵İûбܾlen = %d\n", liLen);
+		return -1;
+	}
+	return liLen;
+}
+
+template<class S>
+static void RunCase(const char *apName, int aiUsers, S &aoValue, int aiCount, char *apBuffer){
+	int liLen = aoValue.Pack(apBuffer, DEF_SERIALIZE_BENCH_BUFFER);
+	double ldNs[4];
+
+	uint64 lui64Begin = GetNowNs();
+	for(int i = 0; i < aiCount; ++i){
+		giSink += LegacyPack(aoValue, apBuffer, DEF_SERIALIZE_BENCH_BUFFER);
+	}
+	ldNs[0] = (double)(GetNowNs() - lui64Begin) / aiCount;
+
+	lui64Begin = GetNowNs();
+	for(int i = 0; i < aiCount; ++i){
+		giSink += aoValue.Pack(apBuffer, DEF_SERIALIZE_BENCH_BUFFER);
+	}
+	ldNs[1] = (double)(GetNowNs() - lui64Begin) / aiCount;
+
+	//ͬһбÿ·䣬дһ
+	S loValue;
+	lui64Begin = GetNowNs();
+	for(int i = 0; i < aiCount; ++i){
+		giSink += LegacyUnPack(loValue, apBuffer, liLen);
+	}
+	ldNs[2] = (double)(GetNowNs() - lui64Begin) / aiCount;
+
+	lui64Begin = GetNowNs();
+	for(int i = 0; i < aiCount; ++i){
+		giSink += loValue.UnPack(apBuffer, liLen);
+	}
+	ldNs[3] = (double)(GetNowNs() - lui64Begin) / aiCount;
+
+	printf("%-12s %6d %8d %12.1f %12.1f %14.1f %14.1f\n",
+		apName, aiUsers, liLen, ldNs[0], ldNs[1], ldNs[2], ldNs[3]);
+	fflush(stdout);
+}
+
+static void Usage(const char *apName){
+	printf("÷: %s [ѡ]\n"
+		"  -n              ÿıĬ%dбû\n"
+		"  -u ûб       ûϢбûŷָĬ1,50,500\n"
+		";дͬʱ1\n",
+		apName, DEF_SERIALIZE_BENCH_COUNT);
+}
+
+int main(int argc, char* argv[])
+{
+	int liCount = DEF_SERIALIZE_BENCH_COUNT;
+	vector<int> loUsers;
+	const char *lpUsers = "1,50,500";
+	int liOpt = 0;
+	while((liOpt = getopt(argc, argv, "n:u:h")) != -1){
+		switch(liOpt){
+		case 'n': liCount = atoi(optarg); break;
+		case 'u': lpUsers = optarg; break;
+		default: Usage(argv[0]); return 2;
+		}
+	}
+	for(const char *p = lpUsers; *p != '\0'; ){
+		char *lpEnd = NULL;
+		long liValue = strtol(p, &lpEnd, 10);
+		if(lpEnd == p || liValue < 0 || liValue > 0xFFFF){
+			Usage(argv[0]);
+			return 2;
+		}
+		loUsers.push_back((int)liValue);
+		p = (',' == *lpEnd) ? lpEnd + 1 : lpEnd;
+	}
+	if(liCount <= 0 || loUsers.empty()){
+		Usage(argv[0]);
+		return 2;
+	}
+
+	vector<char> loBuffer(DEF_SERIALIZE_BENCH_BUFFER);
+	vector<char> loLegacy(DEF_SERIALIZE_BENCH_BUFFER);
+	int liFailed = 0;
+	printf("%-12s %6s %8s %12s %12s %14s %14s\n",
+		"pack", "users", "bytes", "pack_old(ns)", "pack_new(ns)", "unpack_old(ns)", "unpack_new(ns)");
+
+	STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY loGift;
+	FillBigGift(loGift);
+	if(Check(loGift, &loBuffer[0], &loLegacy[0]) < 0){
+		++liFailed;
+	} else {
+		RunCase("big_gift", 0, loGift, liCount, &loBuffer[0]);
+	}
+
+	for(size_t i = 0; i < loUsers.size(); ++i){
+		STRU_UC_CL_CRS_USER_INFO_ID_2009 loList;
+		FillUserList(loList, loUsers[i]);
+		if(Check(loList, &loBuffer[0], &loLegacy[0]) < 0){
+			++liFailed;
+			continue;
+		}
+		//ÿεĹûȣʱ²
+		int liListCount = liCount / (loUsers[i] > 0 ? loUsers[i] : 1);
+		RunCase("user_info", loUsers[i], loList, liListCount > 0 ? liListCount : 1, &loBuffer[0]);
+	}
+	return liFailed > 0 ? 1 : 0;
+}
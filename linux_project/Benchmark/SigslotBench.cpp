@@ -0,0 +1,272 @@
+/********************************************************************
+	created:	2026/10/16
+	file base:	SigslotBench
+	file ext:	cpp
+	
+	purpose:	sigslot źŷ俪Ա
+				signal3ÿemitӻsignal3дʱƵcow_signal3
+				۵single_signal3ֱӵãֱ14ۣÿemit
+				-t ߳ʱ߳ͬʱͬһźemitӰ졣
+				ʱǰȼӡϿÿ۵ĵôʱط0
+*********************************************************************/
+#include <iostream>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include <getopt.h>
+#include <pthread.h>
+#include <time.h>
+#include "include.h"
+#include "sigslot.h"
+
+#define DEF_SIGSLOT_BENCH_COUNT 20000000
+#define DEF_SIGSLOT_BENCH_MAX_THREAD 64
+
+static uint64 GetNowNs(){
+	struct timespec loTime;
+	clock_gettime(CLOCK_MONOTONIC, &loTime);
+	return (uint64)loTime.tv_sec * 1000000000ULL + loTime.tv_nsec;
+}
+
+//飺ÿemitһpthread̲߳µʵ
+class CBenchMutexPolicy{
+public:
+	CBenchMutexPolicy(){
+		pthread_mutex_init(&moMutex, NULL);
+	}
+	CBenchMutexPolicy(const CBenchMutexPolicy&){
+		pthread_mutex_init(&moMutex, NULL);
+	}
+	virtual ~CBenchMutexPolicy(){
+		pthread_mutex_destroy(&moMutex);
+	}
+	virtual void lock(){
+		pthread_mutex_lock(&moMutex);
+	}
+	virtual void unlock(){
+		pthread_mutex_unlock(&moMutex);
+	}
+private:
+	pthread_mutex_t moMutex;
+};
+
+template<class mt_policy>
+class CBenchSlot : public sigslot::has_slots<mt_policy>{
+public:
+	CBenchSlot(){
+		mui64Calls = 0;
+		mbCount = false;
+	}
+	void OnRecv(int fd, char *buffer, int length){
+		//ʱʱдݣַֻ
+		if(mbCount){
+			++mui64Calls;
+		}
+	}
+	uint64 mui64Calls;
+	bool mbCount;
+};
+
+typedef CBenchSlot<sigslot::SIGSLOT_DEFAULT_MT_POLICY> CDefaultSlot;
+typedef CBenchSlot<CBenchMutexPolicy> CMutexSlot;
+
+//ֱӵãΪ
+class CDirectCall{
+public:
+	void connect(CDefaultSlot *apSlot, void (CDefaultSlot::*)(int, char*, int)){
+		moSlot.push_back(apSlot);
+	}
+	void disconnect(CDefaultSlot *apSlot){
+		for(size_t i = 0; i < moSlot.size(); ++i){
+			if(moSlot[i] == apSlot){
+				moSlot.erase(moSlot.begin() + i);
+				return;
+			}
+		}
+	}
+	void disconnect_all(){
+		moSlot.clear();
+	}
+	void emit(int fd, char *buffer, int length){
+		for(size_t i = 0; i < moSlot.size(); ++i){
+			CallSlot(moSlot[i], fd, buffer, length);
+		}
+	}
+private:
+	static void __attribute__((noinline)) CallSlot(CDefaultSlot *apSlot, int fd, char *buffer, int length){
+		apSlot->OnRecv(fd, buffer, length);
+	}
+	vector<CDefaultSlot*> moSlot;
+};
+
+template<class signal_type>
+struct STRU_EMIT_CONTEXT{
+	signal_type *mpSignal;
+	uint64 mui64Count;
+	volatile int *mpStart;
+	uint64 mui64Ns;
+};
+
+static char gszBuffer[64];
+
+template<class signal_type>
+static void* EmitThread(void *apParam){
+	STRU_EMIT_CONTEXT<signal_type> *lpContext = (STRU_EMIT_CONTEXT<signal_type>*)apParam;
+	while(0 == *lpContext->mpStart){
+	}
+	signal_type &loSignal = *lpContext->mpSignal;
+	uint64 lui64Begin = GetNowNs();
+	for(uint64 i = 0; i < lpContext->mui64Count; ++i){
+		loSignal.emit((int)i, gszBuffer, (int)i);
+	}
+	lpContext->mui64Ns = GetNowNs() - lui64Begin;
+	return NULL;
+}
+
+//aiSlotsۣȼôaiThreads߳ͬʱemitÿemitƽ-1
+template<class signal_type, class slot_type>
+static double RunCase(int aiSlots, int aiThreads, uint64 aui64Count){
+	signal_type loSignal;
+	vector<slot_type*> loSlot;
+	for(int i = 0; i < aiSlots; ++i){
+		slot_type *lpSlot = new slot_type;
+		lpSlot->mbCount = true;
+		loSignal.connect(lpSlot, &slot_type::OnRecv);
+		loSlot.push_back(lpSlot);
+	}
+
+	//ÿ۸һΣϿһٸһ
+	bool lbOk = true;
+	loSignal.emit(0, gszBuffer, 0);
+	loSignal.disconnect(loSlot.back());
+	loSignal.emit(0, gszBuffer, 0);
+	for(int i = 0; i < aiSlots; ++i){
+		uint64 lui64Expect = (i == aiSlots - 1) ? 1 : 2;
+		if(loSlot[i]->mui64Calls != lui64Expect){
+			lbOk = false;
+		}
+		loSlot[i]->mbCount = false;
+	}
+	loSignal.connect(loSlot.back(), &slot_type::OnRecv);
+
+	double ldNs = -1;
+	if(lbOk){
+		volatile int liStart = 0;
+		vector<pthread_t> loThread(aiThreads);
+		vector<STRU_EMIT_CONTEXT<signal_type> > loContext(aiThreads);
+		int liStarted = 0;
+		for(int i = 0; i < aiThreads; ++i){
+			loContext[i].mpSignal = &loSignal;
+			loContext[i].mui64Count = aui64Count;
+			loContext[i].mpStart = &liStart;
+			loContext[i].mui64Ns = 0;
+			if(0 != pthread_create(&loThread[i], NULL, EmitThread<signal_type>, &loContext[i])){
+				break;
+			}
+			++liStarted;
+		}
+		liStart = 1;
+		uint64 lui64Ns = 0;
+		for(int i = 0; i < liStarted; ++i){
+			pthread_join(loThread[i], NULL);
+			lui64Ns += loContext[i].mui64Ns;
+		}
+		if(liStarted == aiThreads){
+			ldNs = (double)lui64Ns / liStarted / aui64Count;
+		}
+	}
+
+	loSignal.disconnect_all();
+	for(int i = 0; i < aiSlots; ++i){
+		delete loSlot[i];
+	}
+	return ldNs;
+}
+
+static bool ParseList(const char *apText, vector<int> &aoList){
+	aoList.clear();
+	string lstrText = apText;
+	size_t liPos = 0;
+	while(liPos <= lstrText.size()){
+		size_t liEnd = lstrText.find(',', liPos);
+		if(string::npos == liEnd){
+			liEnd = lstrText.size();
+		}
+		int liValue = atoi(lstrText.substr(liPos, liEnd - liPos).c_str());
+		if(liValue <= 0){
+			return false;
+		}
+		aoList.push_back(liValue);
+		liPos = liEnd + 1;
+	}
+	return !aoList.empty();
+}
+
+static void Usage(const char *apName){
+	printf("÷: %s [ѡ]\n"
+		"  -s б         Ĭ1,4\n"
+		"  -t ߳б       ͬʱemit߳Ĭ1,4\n"
+		"  -n              ÿ߳emitĴĬ%d\n"
+		"ԶŸĲУôʱ1\n",
+		apName, DEF_SIGSLOT_BENCH_COUNT);
+}
+
+static void PrintResult(const char *apName, int aiSlots, int aiThreads, double adNs, int &aiFailed){
+	if(adNs < 0){
+		printf("%-16s %5d %7d %12s\n", apName, aiSlots, aiThreads, "FAILED");
+		++aiFailed;
+		return;
+	}
+	printf("%-16s %5d %7d %12.2f\n", apName, aiSlots, aiThreads, adNs);
+}
+
+int main(int argc, char* argv[])
+{
+	vector<int> loSlots;
+	loSlots.push_back(1);
+	loSlots.push_back(4);
+	vector<int> loThreads;
+	loThreads.push_back(1);
+	loThreads.push_back(4);
+	uint64 lui64Count = DEF_SIGSLOT_BENCH_COUNT;
+
+	int liOpt = 0;
+	bool lbArgOk = true;
+	while(lbArgOk && (liOpt = getopt(argc, argv, "s:t:n:h")) != -1){
+		switch(liOpt){
+		case 's': lbArgOk = ParseList(optarg, loSlots); break;
+		case 't': lbArgOk = ParseList(optarg, loThreads); break;
+		case 'n': lui64Count = strtoull(optarg, NULL, 10); lbArgOk = lui64Count > 0; break;
+		default: lbArgOk = false; break;
+		}
+	}
+	for(size_t t = 0; lbArgOk && t < loThreads.size(); ++t){
+		lbArgOk = loThreads[t] <= DEF_SIGSLOT_BENCH_MAX_THREAD;
+	}
+	if(!lbArgOk){
+		Usage(argv[0]);
+		return 2;
+	}
+
+	int liFailed = 0;
+	printf("%-16s %5s %7s %12s\n", "signal", "slots", "threads", "ns/emit");
+	for(size_t s = 0; s < loSlots.size(); ++s)
+	for(size_t t = 0; t < loThreads.size(); ++t){
+		int liSlots = loSlots[s];
+		int liThreads = loThreads[t];
+		PrintResult("signal3", liSlots, liThreads,
+			RunCase<sigslot::signal3<int, char*, int>, CDefaultSlot>(liSlots, liThreads, lui64Count), liFailed);
+		PrintResult("signal3+mutex", liSlots, liThreads,
+			RunCase<sigslot::signal3<int, char*, int, CBenchMutexPolicy>, CMutexSlot>(liSlots, liThreads, lui64Count), liFailed);
+		PrintResult("cow_signal3", liSlots, liThreads,
+			RunCase<sigslot::cow_signal3<int, char*, int>, CDefaultSlot>(liSlots, liThreads, lui64Count), liFailed);
+		if(1 == liSlots){
+			PrintResult("single_signal3", liSlots, liThreads,
+				RunCase<sigslot::single_signal3<int, char*, int>, CDefaultSlot>(liSlots, liThreads, lui64Count), liFailed);
+		}
+		PrintResult("direct", liSlots, liThreads,
+			RunCase<CDirectCall, CDefaultSlot>(liSlots, liThreads, lui64Count), liFailed);
+	}
+	return liFailed > 0 ? 1 : 0;
+}
@@ -1,15 +1,35 @@
 #ifndef _BASE_COMPRESS_H_
 #define _BASE_COMPRESS_H_
 
-CBaseCompress
-{
+#include "include.h"
+
+//ѹ㷨дڰͷѹ־0ʾδѹ
+enum ENUM_COMPRESS_TYPE{
+	COMPRESS_NONE = 0,
+	COMPRESS_ZLIB = 1,
+	COMPRESS_LZ4 = 2,
+	COMPRESS_ZSTD = 3,
+	COMPRESS_TYPE_MAX
+};
+
+//ͷѹ־4λΪѹ㷨λΪͷܽѹ㷨
+//Զֻ￴ĳ㷨Żѹϰ汾Զ˲룬յĶԭ
+#define COMPRESS_FLAG_TYPE_MASK 0x0F
+#define COMPRESS_FLAG_ACCEPT_SHIFT 4
+#define COMPRESS_ACCEPT_BIT(type) (1 << ((type) - 1))
+#define COMPRESS_ACCEPT_ALL (COMPRESS_ACCEPT_BIT(COMPRESS_TYPE_MAX) - 1)
+
+class CBaseCompress{
 public:
 	CBaseCompress(){}
 	virtual ~CBaseCompress(){}
-
+	//out_length СʵʳȣŲʱfalse
 	virtual bool Compress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length) = 0;
 	virtual bool Decompress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length) = 0;
-
+	//Ԥѵֵ䣬˱һ£ֵ֧㷨ֵֻܿ
+	virtual bool SetDictionary(const char* /*dict*/, uint32 dict_length){
+		return 0 == dict_length;
+	}
 };
 
-#endif //_BASE_COMPRESS_H_
\ No newline at end of file
+#endif //_BASE_COMPRESS_H_
@@ -2,8 +2,11 @@
 #define _BASE_ENCRYPT_H_
 
 #include <openssl/aes.h>
+#include <openssl/evp.h>
 #include "include.h"
 
+#define DEF_AES_KEY_LEN 16
+
 class CBaseEncrypt{
 public:
 	CBaseEncrypt(){}
@@ -57,4 +60,81 @@ public:
 
 private:	
 };
-#endif //_BASE_ENCRYPT_H_
\ No newline at end of file
+
+//AES-128-CBCIVCAESEncryptһ
+//ԿֻSetKeyʱչһΣ֮ÿֻIVEVPӿڣCPU֧ʱԶʹAES-NI
+//λݳȱ16ıĲɵ߲0
+class CAESCipher{
+public:
+	CAESCipher(){
+		mpEncryptCtx = NULL;
+		mpDecryptCtx = NULL;
+	}
+	~CAESCipher(){
+		Reset();
+	}
+
+	bool SetKey(const unsigned char *apKey){
+		Reset();
+		unsigned char iv[AES_BLOCK_SIZE] = {0};
+		mpEncryptCtx = EVP_CIPHER_CTX_new();
+		mpDecryptCtx = EVP_CIPHER_CTX_new();
+		if(NULL == mpEncryptCtx || NULL == mpDecryptCtx
+			|| 1 != EVP_EncryptInit_ex(mpEncryptCtx, EVP_aes_128_cbc(), NULL, apKey, iv)
+			|| 1 != EVP_DecryptInit_ex(mpDecryptCtx, EVP_aes_128_cbc(), NULL, apKey, iv)){
+			Reset();
+			return false;
+		}
+		EVP_CIPHER_CTX_set_padding(mpEncryptCtx, 0);
+		EVP_CIPHER_CTX_set_padding(mpDecryptCtx, 0);
+		return true;
+	}
+
+	//apOutԵapIn(ԭؼӽ)
+	bool Encrypt(const unsigned char *apIn, int aiLen, unsigned char *apOut){
+		unsigned char iv[AES_BLOCK_SIZE] = {0};
+		int liOutLen = 0;
+		if(NULL == mpEncryptCtx || (aiLen % AES_BLOCK_SIZE) != 0
+			|| 1 != EVP_EncryptInit_ex(mpEncryptCtx, NULL, NULL, NULL, iv)
+			|| 1 != EVP_EncryptUpdate(mpEncryptCtx, apOut, &liOutLen, apIn, aiLen)){
+			return false;
+		}
+		return liOutLen == aiLen;
+	}
+
+	bool Decrypt(const unsigned char *apIn, int aiLen, unsigned char *apOut){
+		unsigned char iv[AES_BLOCK_SIZE] = {0};
+		int liOutLen = 0;
+		if(NULL == mpDecryptCtx || (aiLen % AES_BLOCK_SIZE) != 0
+			|| 1 != EVP_DecryptInit_ex(mpDecryptCtx, NULL, NULL, NULL, iv)
+			|| 1 != EVP_DecryptUpdate(mpDecryptCtx, apOut, &liOutLen, apIn, aiLen)){
+			return false;
+		}
+		return liOutLen == aiLen;
+	}
+
+	//0ĳ
+	static inline int AlignLength(int aiLen){
+		return (aiLen + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE * AES_BLOCK_SIZE;
+	}
+
+private:
+	void Reset(){
+		if(mpEncryptCtx != NULL){
+			EVP_CIPHER_CTX_free(mpEncryptCtx);
+			mpEncryptCtx = NULL;
+		}
+		if(mpDecryptCtx != NULL){
+			EVP_CIPHER_CTX_free(mpDecryptCtx);
+			mpDecryptCtx = NULL;
+		}
+	}
+	//ɸ
+	CAESCipher(const CAESCipher&);
+	CAESCipher& operator=(const CAESCipher&);
+
+private:
+	EVP_CIPHER_CTX *mpEncryptCtx;
+	EVP_CIPHER_CTX *mpDecryptCtx;
+};
+#endif //_BASE_ENCRYPT_H_
@@ -11,6 +11,7 @@
         2 ȳ(βͷ)
         3 2,ƶд,ֻһͷ,һβ
         4 ĵ32̲ʱһqueue10% 
+        5 ÿpushҪlistڵ,̼߳䴫ϢRingQueue.hн
 
 *********************************************************************************************/
 /********************************************************************************************
@@ -107,11 +108,11 @@ public:
                         count = list.size();
 			//ȥͷĻ
 			count--;
-                        //ͷ
-                        pthread_mutex_unlock(&HMutex);
+                        //β
+                        pthread_mutex_unlock(&TMutex);
                 }
-                //β
-                pthread_mutex_unlock(&TMutex);
+                //ͷ
+                pthread_mutex_unlock(&HMutex);
 
                 return count;
         }
@@ -0,0 +1,54 @@
+/********************************************************************
+	file base:	NetChunk
+	file ext:	h
+
+	purpose:	ݿ
+				һݿ鱣һðݰü
+				ͬʱڶӵķͶ(㲥ֻһΰ)
+				ôСݿӻط䣬üΪ0ʱ黹
+*********************************************************************/
+#ifndef _NET_CHUNK_H_
+#define _NET_CHUNK_H_
+
+#include "include.h"
+#include "Pool.h"
+
+//ݿʱ
+#define DEF_NET_CHUNK_SIZE (5*1024)
+#define DEF_NET_CHUNK_POOL_SIZE 1024
+
+class CNetChunk{
+public:
+	CNetChunk();
+	~CNetChunk();
+
+	//aiSizeֽڵݿ飬üΪ1
+	static CNetChunk* Alloc(int aiSize);
+
+	inline void AddRef(){
+		__sync_add_and_fetch(&miRef, 1);
+	}
+	//üΪ0ʱ黹
+	void Release();
+
+	inline char* GetBuffer(){ return mpBuffer; }
+	inline int GetCapacity(){ return miCapacity; }
+
+	static void Dump();
+
+public:
+	//Чݳ
+	int miLength;
+	//ϢͣͶаͺϲʱʹã0ʾϲ
+	int miType;
+
+private:
+	volatile int miRef;
+	char *mpBuffer;
+	int miCapacity;
+	char mszBuffer[DEF_NET_CHUNK_SIZE];
+
+	static CPool<CNetChunk> moChunkPool;
+};
+
+#endif //_NET_CHUNK_H_
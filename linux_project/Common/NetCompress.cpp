@@ -0,0 +1,353 @@
+#include "NetCompress.h"
+#include <pthread.h>
+
+/************************************************************************/
+/*
+CZlibCompress
+*/
+/************************************************************************/
+//raw deflate32KֻмKhashȡ16K㹻ÿʱһڴ
+#define DEF_ZLIB_WINDOW_BITS 15
+#define DEF_ZLIB_MEM_LEVEL 7
+
+CZlibCompress::CZlibCompress(int aiLevel /* = Z_BEST_SPEED */){
+	memset(&moDeflate, 0, sizeof(moDeflate));
+	memset(&moInflate, 0, sizeof(moInflate));
+	mbDeflateInit = (Z_OK == deflateInit2(&moDeflate, aiLevel, Z_DEFLATED,
+		-DEF_ZLIB_WINDOW_BITS, DEF_ZLIB_MEM_LEVEL, Z_DEFAULT_STRATEGY));
+	mbInflateInit = (Z_OK == inflateInit2(&moInflate, -DEF_ZLIB_WINDOW_BITS));
+	if(!mbDeflateInit || !mbInflateInit){
+		TRACE(1, "CZlibCompress::CZlibCompress ʼʧܡ");
+	}
+}
+
+CZlibCompress::~CZlibCompress(){
+	if(mbDeflateInit){
+		deflateEnd(&moDeflate);
+	}
+	if(mbInflateInit){
+		inflateEnd(&moInflate);
+	}
+}
+
+bool CZlibCompress::Compress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length){
+	if(!mbDeflateInit || Z_OK != deflateReset(&moDeflate)){
+		return false;
+	}
+	if(!mstrDict.empty() && Z_OK != deflateSetDictionary(&moDeflate,
+		(const Bytef*)mstrDict.data(), mstrDict.size())){
+		return false;
+	}
+	moDeflate.next_in = (Bytef*)in_buffer;
+	moDeflate.avail_in = in_length;
+	moDeflate.next_out = (Bytef*)out_buffer;
+	moDeflate.avail_out = out_length;
+	//ŲʱZ_OKZ_BUF_ERROR
+	if(Z_STREAM_END != deflate(&moDeflate, Z_FINISH)){
+		return false;
+	}
+	out_length = moDeflate.total_out;
+	return true;
+}
+
+bool CZlibCompress::Decompress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length){
+	if(!mbInflateInit || Z_OK != inflateReset(&moInflate)){
+		return false;
+	}
+	//raw inflateڿʼǰֱֵ
+	if(!mstrDict.empty() && Z_OK != inflateSetDictionary(&moInflate,
+		(const Bytef*)mstrDict.data(), mstrDict.size())){
+		return false;
+	}
+	moInflate.next_in = (Bytef*)in_buffer;
+	moInflate.avail_in = in_length;
+	moInflate.next_out = (Bytef*)out_buffer;
+	moInflate.avail_out = out_length;
+	if(Z_STREAM_END != inflate(&moInflate, Z_FINISH)){
+		return false;
+	}
+	out_length = moInflate.total_out;
+	return true;
+}
+
+bool CZlibCompress::SetDictionary(const char* dict, uint32 dict_length){
+	//ڵĲòϣֻβ
+	uint32 liMax = 1 << DEF_ZLIB_WINDOW_BITS;
+	if(dict_length > liMax){
+		dict += dict_length - liMax;
+		dict_length = liMax;
+	}
+	mstrDict.assign(dict, dict_length);
+	return true;
+}
+
+#ifdef NET_COMPRESS_LZ4
+/************************************************************************/
+/*
+CLz4Compress
+*/
+/************************************************************************/
+#define DEF_LZ4_DICT_SIZE (64*1024)
+
+CLz4Compress::CLz4Compress(int aiAcceleration /* = 1 */){
+	mpStream = LZ4_createStream();
+	miAcceleration = aiAcceleration;
+	if(NULL == mpStream){
+		TRACE(1, "CLz4Compress::CLz4Compress ʼʧܡ");
+	}
+}
+
+CLz4Compress::~CLz4Compress(){
+	if(mpStream != NULL){
+		LZ4_freeStream(mpStream);
+		mpStream = NULL;
+	}
+}
+
+bool CLz4Compress::Compress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length){
+	if(NULL == mpStream){
+		return false;
+	}
+	int liRet = 0;
+	if(mstrDict.empty()){
+		liRet = LZ4_compress_fast_extState(mpStream, in_buffer, out_buffer,
+			in_length, out_length, miAcceleration);
+	}else{
+		//ÿͬһֵ俪ʼ
+		LZ4_loadDict(mpStream, mstrDict.data(), mstrDict.size());
+		liRet = LZ4_compress_fast_continue(mpStream, in_buffer, out_buffer,
+			in_length, out_length, miAcceleration);
+	}
+	if(liRet <= 0){
+		return false;
+	}
+	out_length = liRet;
+	return true;
+}
+
+bool CLz4Compress::Decompress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length){
+	int liRet = 0;
+	if(mstrDict.empty()){
+		liRet = LZ4_decompress_safe(in_buffer, out_buffer, in_length, out_length);
+	}else{
+		liRet = LZ4_decompress_safe_usingDict(in_buffer, out_buffer, in_length, out_length,
+			mstrDict.data(), mstrDict.size());
+	}
+	if(liRet < 0){
+		return false;
+	}
+	out_length = liRet;
+	return true;
+}
+
+bool CLz4Compress::SetDictionary(const char* dict, uint32 dict_length){
+	if(dict_length > DEF_LZ4_DICT_SIZE){
+		dict += dict_length - DEF_LZ4_DICT_SIZE;
+		dict_length = DEF_LZ4_DICT_SIZE;
+	}
+	mstrDict.assign(dict, dict_length);
+	return true;
+}
+#endif //NET_COMPRESS_LZ4
+
+#ifdef NET_COMPRESS_ZSTD
+/************************************************************************/
+/*
+CZstdCompress
+*/
+/************************************************************************/
+CZstdCompress::CZstdCompress(int aiLevel /* = 1 */){
+	mpCCtx = ZSTD_createCCtx();
+	mpDCtx = ZSTD_createDCtx();
+	mpCDict = NULL;
+	mpDDict = NULL;
+	miLevel = aiLevel;
+	if(NULL == mpCCtx || NULL == mpDCtx){
+		TRACE(1, "CZstdCompress::CZstdCompress ʼʧܡ");
+	}
+}
+
+CZstdCompress::~CZstdCompress(){
+	FreeDict();
+	if(mpCCtx != NULL){
+		ZSTD_freeCCtx(mpCCtx);
+		mpCCtx = NULL;
+	}
+	if(mpDCtx != NULL){
+		ZSTD_freeDCtx(mpDCtx);
+		mpDCtx = NULL;
+	}
+}
+
+void CZstdCompress::FreeDict(){
+	if(mpCDict != NULL){
+		ZSTD_freeCDict(mpCDict);
+		mpCDict = NULL;
+	}
+	if(mpDDict != NULL){
+		ZSTD_freeDDict(mpDDict);
+		mpDDict = NULL;
+	}
+}
+
+bool CZstdCompress::Compress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length){
+	if(NULL == mpCCtx){
+		return false;
+	}
+	size_t liRet = 0;
+	if(mpCDict != NULL){
+		liRet = ZSTD_compress_usingCDict(mpCCtx, out_buffer, out_length, in_buffer, in_length, mpCDict);
+	}else{
+		liRet = ZSTD_compressCCtx(mpCCtx, out_buffer, out_length, in_buffer, in_length, miLevel);
+	}
+	if(ZSTD_isError(liRet)){
+		return false;
+	}
+	out_length = liRet;
+	return true;
+}
+
+bool CZstdCompress::Decompress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length){
+	if(NULL == mpDCtx){
+		return false;
+	}
+	size_t liRet = 0;
+	if(mpDDict != NULL){
+		liRet = ZSTD_decompress_usingDDict(mpDCtx, out_buffer, out_length, in_buffer, in_length, mpDDict);
+	}else{
+		liRet = ZSTD_decompressDCtx(mpDCtx, out_buffer, out_length, in_buffer, in_length);
+	}
+	if(ZSTD_isError(liRet)){
+		return false;
+	}
+	out_length = liRet;
+	return true;
+}
+
+bool CZstdCompress::SetDictionary(const char* dict, uint32 dict_length){
+	FreeDict();
+	if(0 == dict_length){
+		return true;
+	}
+	mpCDict = ZSTD_createCDict(dict, dict_length, miLevel);
+	mpDDict = ZSTD_createDDict(dict, dict_length);
+	if(NULL == mpCDict || NULL == mpDDict){
+		FreeDict();
+		return false;
+	}
+	return true;
+}
+#endif //NET_COMPRESS_ZSTD
+
+/************************************************************************/
+/*
+CNetCompress
+*/
+/************************************************************************/
+//ÿ̵߳ѹ㷨±ţõʱŴ
+struct STRU_COMPRESS_CACHE{
+	STRU_COMPRESS_CACHE(){
+		memset(mpCompress, 0, sizeof(mpCompress));
+	}
+	~STRU_COMPRESS_CACHE(){
+		for(int i = 0; i < COMPRESS_TYPE_MAX; ++i){
+			if(mpCompress[i] != NULL){
+				delete mpCompress[i];
+				mpCompress[i] = NULL;
+			}
+		}
+	}
+	CBaseCompress *mpCompress[COMPRESS_TYPE_MAX];
+};
+
+static string gstrCompressDict[COMPRESS_TYPE_MAX];
+static __thread STRU_COMPRESS_CACHE *gpCompressCache = NULL;
+static pthread_key_t goCompressCacheKey;
+static pthread_once_t goCompressCacheOnce = PTHREAD_ONCE_INIT;
+
+static void FreeCompressCache(void *apCache){
+	delete (STRU_COMPRESS_CACHE*)apCache;
+}
+
+static void CreateCompressCacheKey(){
+	pthread_key_create(&goCompressCacheKey, FreeCompressCache);
+}
+
+bool CNetCompress::IsSupport(int aiType){
+	switch(aiType){
+	case COMPRESS_ZLIB:
+		return true;
+#ifdef NET_COMPRESS_LZ4
+	case COMPRESS_LZ4:
+		return true;
+#endif
+#ifdef NET_COMPRESS_ZSTD
+	case COMPRESS_ZSTD:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+int CNetCompress::GetAcceptMask(){
+	int liMask = 0;
+	for(int liType = COMPRESS_NONE + 1; liType < COMPRESS_TYPE_MAX; ++liType){
+		if(IsSupport(liType)){
+			liMask |= COMPRESS_ACCEPT_BIT(liType);
+		}
+	}
+	return liMask;
+}
+
+bool CNetCompress::SetDictionary(int aiType, const char* dict, uint32 dict_length){
+	if(!IsSupport(aiType)){
+		TRACE(1, "CNetCompress::SetDictionary ֵ֧ѹ㷨type = "<<aiType);
+		return false;
+	}
+	gstrCompressDict[aiType].assign(dict, dict_length);
+	return true;
+}
+
+CBaseCompress* CNetCompress::CreateCompress(int aiType){
+	switch(aiType){
+	case COMPRESS_ZLIB:
+		return new CZlibCompress;
+#ifdef NET_COMPRESS_LZ4
+	case COMPRESS_LZ4:
+		return new CLz4Compress;
+#endif
+#ifdef NET_COMPRESS_ZSTD
+	case COMPRESS_ZSTD:
+		return new CZstdCompress;
+#endif
+	default:
+		return NULL;
+	}
+}
+
+CBaseCompress* CNetCompress::GetCompress(int aiType){
+	if(aiType <= COMPRESS_NONE || aiType >= COMPRESS_TYPE_MAX){
+		return NULL;
+	}
+	if(NULL == gpCompressCache){
+		pthread_once(&goCompressCacheOnce, CreateCompressCacheKey);
+		gpCompressCache = new STRU_COMPRESS_CACHE;
+		pthread_setspecific(goCompressCacheKey, gpCompressCache);
+	}
+	CBaseCompress *&lpCompress = gpCompressCache->mpCompress[aiType];
+	if(NULL == lpCompress){
+		lpCompress = CreateCompress(aiType);
+		if(NULL == lpCompress){
+			return NULL;
+		}
+		const string &lstrDict = gstrCompressDict[aiType];
+		if(!lpCompress->SetDictionary(lstrDict.data(), lstrDict.size())){
+			TRACE(1, "CNetCompress::GetCompress ֵʧܡtype = "<<aiType);
+			delete lpCompress;
+			lpCompress = NULL;
+			return NULL;
+		}
+	}
+	return lpCompress;
+}
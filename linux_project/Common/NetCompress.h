@@ -0,0 +1,109 @@
+/********************************************************************
+	file base:	NetCompress
+	file ext:	h
+
+	purpose:	ѹ
+				CZlibCompress ǿ(raw deflatezlibͷУ)
+				CLz4Compress  NET_COMPRESS_LZ4ʱ
+				CZstdCompress NET_COMPRESS_ZSTDʱ
+				ѹ״̬Ҳ룬CNetCompress̻߳棬̻߳š
+				Ԥѵֵ䰴㷨ȫã֮߳ǰã˱һ¡
+*********************************************************************/
+#ifndef _NET_COMPRESS_H_
+#define _NET_COMPRESS_H_
+
+#include <zlib.h>
+#include "include.h"
+#include "BaseCompress.h"
+
+#ifdef NET_COMPRESS_LZ4
+#include <lz4.h>
+#endif
+#ifdef NET_COMPRESS_ZSTD
+#include <zstd.h>
+#endif
+
+//Сȵİѹ̫Сֱӷԭ
+#define DEF_COMPRESS_THRESHOLD 256
+
+class CZlibCompress : public CBaseCompress{
+public:
+	CZlibCompress(int aiLevel = Z_BEST_SPEED);
+	virtual ~CZlibCompress();
+
+	bool Compress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length);
+	bool Decompress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length);
+	bool SetDictionary(const char* dict, uint32 dict_length);
+
+private:
+	CZlibCompress(const CZlibCompress&);
+	CZlibCompress& operator=(const CZlibCompress&);
+
+	z_stream moDeflate;
+	z_stream moInflate;
+	bool mbDeflateInit;
+	bool mbInflateInit;
+	string mstrDict;
+};
+
+#ifdef NET_COMPRESS_LZ4
+class CLz4Compress : public CBaseCompress{
+public:
+	CLz4Compress(int aiAcceleration = 1);
+	virtual ~CLz4Compress();
+
+	bool Compress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length);
+	bool Decompress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length);
+	bool SetDictionary(const char* dict, uint32 dict_length);
+
+private:
+	CLz4Compress(const CLz4Compress&);
+	CLz4Compress& operator=(const CLz4Compress&);
+
+	LZ4_stream_t *mpStream;
+	int miAcceleration;
+	//LZ4ֵ64K
+	string mstrDict;
+};
+#endif
+
+#ifdef NET_COMPRESS_ZSTD
+class CZstdCompress : public CBaseCompress{
+public:
+	CZstdCompress(int aiLevel = 1);
+	virtual ~CZstdCompress();
+
+	bool Compress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length);
+	bool Decompress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length);
+	bool SetDictionary(const char* dict, uint32 dict_length);
+
+private:
+	CZstdCompress(const CZstdCompress&);
+	CZstdCompress& operator=(const CZstdCompress&);
+	void FreeDict();
+
+	ZSTD_CCtx *mpCCtx;
+	ZSTD_DCtx *mpDCtx;
+	//ֵֻSetDictionaryʱһ
+	ZSTD_CDict *mpCDict;
+	ZSTD_DDict *mpDDict;
+	int miLevel;
+};
+#endif
+
+class CNetCompress{
+public:
+	//ʱǷ˸㷨
+	static bool IsSupport(int aiType);
+	//ȫ㷨(COMPRESS_ACCEPT_BIT)
+	static int GetAcceptMask();
+	//㷨Ԥѵֵ䣬֮߳½ѹʹøֵ
+	static bool SetDictionary(int aiType, const char* dict, uint32 dict_length);
+	//ǰ̸߳㷨ѹ֧ʱNULL
+	static CBaseCompress* GetCompress(int aiType);
+
+private:
+	static CBaseCompress* CreateCompress(int aiType);
+};
+
+#endif //_NET_COMPRESS_H_
@@ -1,14 +1,33 @@
 #include "NetEpoll.h"
+#include <sys/eventfd.h>
 
 CNetEpoll::CNetEpoll(){
+	Reset();
+	moTimingWheel.OnTimeOut.connect(this, &CNetEpoll::OnTimerExpire);
+}
+
+CNetEpoll::~CNetEpoll(){
+	if(mpSocketSlot != NULL){
+		delete [] mpSocketSlot;
+		mpSocketSlot = NULL;
+	}
+}
+
+void CNetEpoll::Reset(){
 	miEpfd = -1;
+	miWakeupFd = -1;
+	miWakeupPending = 0;
 	mbHasListenFd = false;
 	mbKeepAlive = true;
+	mbZeroCopyRecv = false;
+	mpRecvViewSocket = NULL;
+	mbRecvViewClosed = false;
 	miMaxFdNumber = 10240;
 	mstruEvent = NULL;
-}
-
-CNetEpoll::~CNetEpoll(){
+	mpSocketSlot = NULL;
+	miSlotSize = 0;
+	miMaxUsedfd = -1;
+	miConnectedSize = 0;
 }
 
 bool CNetEpoll::Init(unsigned int aiMaxSocketSize /* = DEF_EPOLL_SIZE */){
@@ -16,7 +35,7 @@ bool CNetEpoll::Init(unsigned int aiMaxSocketSize /* = DEF_EPOLL_SIZE */){
 		delete [] mstruEvent;
 		mstruEvent = NULL;
 	}
-	mstruEvent = new epoll_event[aiMaxSocketSize]; 
+	mstruEvent = new epoll_event[aiMaxSocketSize];
 	if(mstruEvent == NULL){
 		TRACE(1, "CNetEpoll::Init Epoll¼ʧܡ ");
 		return false;
@@ -28,6 +47,14 @@ bool CNetEpoll::Init(unsigned int aiMaxSocketSize /* = DEF_EPOLL_SIZE */){
 		return false;
 	}
 	miMaxFdNumber = aiMaxSocketSize;
+
+	//fdһС䣬Ԥsocketռõfd
+	CAutoLock lock(moFdSection);
+	moTimingWheel.Init(CTimingWheel::GetMonotonicTime());
+	if(!ReserveSlot(aiMaxSocketSize + 64)){
+		TRACE(1, "CNetEpoll::Init Ӳʧܡ ");
+		return false;
+	}
 	return true;
 }
 
@@ -37,37 +64,116 @@ bool CNetEpoll::Destroy(){
 		mstruEvent = NULL;
 	}
 	CAutoLock lock(moFdSection);
-	while(moNetSocketList.size() != 0){
-		NET_SOCKET_LIST_ITER iter = moNetSocketList.begin();
-		int fd = iter->first;
-		Delfd(fd);
+	for(int fd = miMaxUsedfd; fd >= 0; --fd){
+		if(mpSocketSlot[fd].mpNetSocket != NULL){
+			Delfd(fd);
+		}
+	}
+	if(mpSocketSlot != NULL){
+		delete [] mpSocketSlot;
+		mpSocketSlot = NULL;
 	}
+	miSlotSize = 0;
+	miMaxUsedfd = -1;
+	miConnectedSize = 0;
 	if(miEpfd != -1){
 		close(miEpfd);
 	}
+	if(miWakeupFd != -1){
+		close(miWakeupFd);
+		miWakeupFd = -1;
+	}
+	return true;
+}
+
+bool CNetEpoll::EnableWakeup(){
+	if(miWakeupFd != -1){
+		return true;
+	}
+	miWakeupFd = eventfd(0, EFD_NONBLOCK);
+	if(-1 == miWakeupFd){
+		TRACE(1, "CNetEpoll::EnableWakeup eventfd ʧܡerrno = "<<errno);
+		return false;
+	}
+	//ռӲۣ¼fdDealEpollEventڲж
+	struct epoll_event ev;
+	ev.data.u64 = (uint32)miWakeupFd;
+	ev.events = EPOLLIN;
+	if(epoll_ctl(miEpfd, EPOLL_CTL_ADD, miWakeupFd, &ev) < 0){
+		TRACE(1, "CNetEpoll::EnableWakeup EPOLLʧܡerrno = "<<errno);
+		close(miWakeupFd);
+		miWakeupFd = -1;
+		return false;
+	}
+	return true;
+}
+
+void CNetEpoll::Wakeup(){
+	//EPOLL߳־ٴOnWakeup￴λ˵ѻûд
+	if(-1 == miWakeupFd || __sync_lock_test_and_set(&miWakeupPending, 1) != 0){
+		return;
+	}
+	uint64 liValue = 1;
+	if(write(miWakeupFd, &liValue, sizeof(liValue)) < 0 && errno != EAGAIN){
+		TRACE(1, "CNetEpoll::Wakeup write ʧܡerrno = "<<errno);
+	}
+}
+
+bool CNetEpoll::ReserveSlot(int fd){
+	if(fd < 0){
+		return false;
+	}
+	if((unsigned int)fd < miSlotSize){
+		return true;
+	}
+	unsigned int liNewSize = miSlotSize > 0 ? miSlotSize : DEF_EPOLL_SIZE;
+	while(liNewSize <= (unsigned int)fd){
+		liNewSize *= 2;
+	}
+	STRU_NET_SOCKET_SLOT *lpSlot = new STRU_NET_SOCKET_SLOT[liNewSize];
+	if(NULL == lpSlot){
+		return false;
+	}
+	memset(lpSlot, 0, sizeof(STRU_NET_SOCKET_SLOT) * liNewSize);
+	if(mpSocketSlot != NULL){
+		memcpy(lpSlot, mpSocketSlot, sizeof(STRU_NET_SOCKET_SLOT) * miSlotSize);
+		delete [] mpSocketSlot;
+	}
+	mpSocketSlot = lpSlot;
+	miSlotSize = liNewSize;
 	return true;
 }
 
 bool CNetEpoll::Addfd(CNetSocket* apNetSocket){
 	ASSERT(apNetSocket != NULL);
-	ASSERT(moNetSocketList.end() == moNetSocketList.find(apNetSocket->miSocket));
 	CAutoLock lock(moFdSection);
-	moNetSocketList[apNetSocket->miSocket] = apNetSocket;
+	int fd = apNetSocket->miSocket;
+	if(!ReserveSlot(fd)){
+		TRACE(1, "CNetEpoll::Addfd * fdʧܡ fd = "<<fd);
+		return false;
+	}
+	ASSERT(NULL == mpSocketSlot[fd].mpNetSocket);
+	mpSocketSlot[fd].mpNetSocket = apNetSocket;
 	if(AddEpollEvent(apNetSocket, EPOLLIN | EPOLLET) < 0){
-		NET_SOCKET_LIST_ITER iter = moNetSocketList.find(apNetSocket->miSocket);
-		if(iter != moNetSocketList.end()){
-			moNetSocketList.erase(iter);
-		}
+		mpSocketSlot[fd].mpNetSocket = NULL;
 		TRACE(1, "CNetEpoll::Addfd * ʧܡ errno = "<<errno);
 		return false;
 	}
+	++miConnectedSize;
+	if(fd > miMaxUsedfd){
+		miMaxUsedfd = fd;
+	}
 	TRACE(5, "CNetEpoll::Addfd fd = "<<apNetSocket->miSocket);
 	return true;
 }
 
 bool CNetEpoll::Addfd(int fd){
-	ASSERT(moNetSocketList.end() == moNetSocketList.find(fd));
 	CAutoLock lock(moFdSection);
+	if(!ReserveSlot(fd)){
+		TRACE(1, "CNetEpoll::Addfd fdʧܡ fd = "<<fd);
+		return false;
+	}
+	ASSERT(NULL == mpSocketSlot[fd].mpNetSocket);
 	CNetSocket *lpNetSocket = new CNetSocket;
 	lpNetSocket->miSocket = fd;
 	lpNetSocket->moNetStat = COMMON_TCP_ESTABLISHED;
@@ -79,90 +185,94 @@ bool CNetEpoll::Addfd(int fd){
 		return false;
 	}
 	lpNetSocket->SetNetPack(m_pNetPack);
-	moNetSocketList[fd] = lpNetSocket;
+	lpNetSocket->SetSendQueueLimit(moSendQueueLimit);
+	mpSocketSlot[fd].mpNetSocket = lpNetSocket;
 	if(AddEpollEvent(lpNetSocket, EPOLLIN | EPOLLET) < 0){
-		NET_SOCKET_LIST_ITER iter = moNetSocketList.find(fd);
-		if(iter != moNetSocketList.end()){
-			moNetSocketList.erase(iter);
-		}
+		mpSocketSlot[fd].mpNetSocket = NULL;
 		TRACE(1, "CNetEpoll::Addfd ʧܡ errno = "<<errno);
 		return false;
 	}
+	++miConnectedSize;
+	if(fd > miMaxUsedfd){
+		miMaxUsedfd = fd;
+	}
+	TouchRecvTimer(lpNetSocket);
 	return true;
 }
 
 bool CNetEpoll::Delfd(int fd){
 	CAutoLock lock(moFdSection);
-	CNetSocket *lpNetSocket = NULL;
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.find(fd);
-	if(iter != moNetSocketList.end()){
-		lpNetSocket = iter->second;
-	}
+	CNetSocket *lpNetSocket = GetNetSocket(fd);
 	if(NULL == lpNetSocket){
 		return true;
 	}
 	if(DelEpollEvent(lpNetSocket) < 0){
 		TRACE(1, "CNetEpoll::Delfd ʧܡ errno = "<<errno);
 	}
+	CancelTimer(lpNetSocket);
 	if(!lpNetSocket->mbListenSocket && !lpNetSocket->mbClientSocket){
-		delete lpNetSocket;
+		DeleteSocket(lpNetSocket);
 		lpNetSocket = NULL;
 	}
-	moNetSocketList.erase(iter);
+	mpSocketSlot[fd].mpNetSocket = NULL;
+	++mpSocketSlot[fd].miGeneration;
+	--miConnectedSize;
 	return true;
 }
 
 bool CNetEpoll::Delfd(CNetSocket* apNetSocket){
 	ASSERT(apNetSocket != NULL);
 	CAutoLock lock(moFdSection);
+	int fd = apNetSocket->miSocket;
 	if(DelEpollEvent(apNetSocket) < 0){
 		TRACE(1, "CNetEpoll::Delfd ʧܡ errno = "<<errno);
 	}
-	moNetSocketList.erase(apNetSocket->miSocket);
+	CancelTimer(apNetSocket);
+	if(GetNetSocket(fd) == apNetSocket){
+		mpSocketSlot[fd].mpNetSocket = NULL;
+		++mpSocketSlot[fd].miGeneration;
+		--miConnectedSize;
+	}
 	if(!apNetSocket->mbListenSocket && !apNetSocket->mbClientSocket){
-		delete apNetSocket;
+		DeleteSocket(apNetSocket);
 		apNetSocket = NULL;
 	}
 	return true;
 }
 
-bool CNetEpoll::Delfd(NET_SOCKET_LIST_ITER iter){
-	CAutoLock lock(moFdSection);
-	CNetSocket *lpNetSocket = NULL;
-	lpNetSocket = iter->second;
-	if(NULL == lpNetSocket){
-		return true;
+void CNetEpoll::DeleteSocket(CNetSocket *apNetSocket){
+	//Ѵfdժ߳̿Ǻֹͣͷ
+	if(apNetSocket == mpRecvViewSocket){
+		mbRecvViewClosed = true;
+		return;
 	}
-	if(DelEpollEvent(lpNetSocket) < 0){
-		TRACE(1, "CNetEpoll::Delfd NET_SOCKET_LIST_ITER ʧܡ errno = "<<errno);
-	}
-	if(!lpNetSocket->mbListenSocket && !lpNetSocket->mbClientSocket){
-		delete lpNetSocket;
-		lpNetSocket = NULL;
-	}
-	moNetSocketList.erase(iter);
-	return true;
+	delete apNetSocket;
 }
 
 bool CNetEpoll::Findfd(int fd){
 	CAutoLock lock(moFdSection);
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.find(fd);
-	if(iter != moNetSocketList.end()){
-		return true;
+	return GetNetSocket(fd) != NULL;
+}
+
+int CNetEpoll::GetSendQueueBytes(int fd){
+	CAutoLock lock(moFdSection);
+	CNetSocket *lpNetSocket = GetNetSocket(fd);
+	if(NULL == lpNetSocket){
+		return -1;
 	}
-	return false;
+	return lpNetSocket->GetSendQueueBytes();
 }
 
-int CNetEpoll::AddEpollEvent(CNetSocket* pNetSocket, unsigned int ulEvent){    
+int CNetEpoll::AddEpollEvent(CNetSocket* pNetSocket, unsigned int ulEvent){
 	struct epoll_event ev;
-	ev.data.ptr = pNetSocket;
+	ev.data.u64 = MakeEventData(pNetSocket->miSocket);
 	ev.events = ulEvent;
 	return epoll_ctl(miEpfd, EPOLL_CTL_ADD, pNetSocket->miSocket, &ev);
 }
 
 int CNetEpoll::ModifyEpollEvent(CNetSocket* pNetSocket, unsigned int ulEvent){
 	struct epoll_event ev;
-	ev.data.ptr = pNetSocket;
+	ev.data.u64 = MakeEventData(pNetSocket->miSocket);
 	ev.events = ulEvent;
 	if (epoll_ctl(miEpfd, EPOLL_CTL_MOD, pNetSocket->miSocket, &ev) < 0){
 		int err = errno;
@@ -177,7 +287,7 @@ int CNetEpoll::ModifyEpollEvent(CNetSocket* pNetSocket, unsigned int ulEvent){
 
 int CNetEpoll::DelEpollEvent(CNetSocket* pNetSocket){
 	struct epoll_event ev;
-	ev.data.ptr = pNetSocket;
+	ev.data.u64 = 0;
 	ev.events = 0;
 	return epoll_ctl(miEpfd, EPOLL_CTL_DEL, pNetSocket->miSocket, &ev);
 }
@@ -186,6 +296,10 @@ int CNetEpoll::CheckEpollEvent(int time_out/* =0 */){
 	ASSERT( mstruEvent != NULL);
 	int nRet = 0;
 	int err = 0;
+	if(moTimingWheel.GetTimerCount() > 0
+		&& (time_out < 0 || (unsigned int)time_out > moTimingWheel.GetTickMs())){
+		time_out = (int)moTimingWheel.GetTickMs();
+	}
 	nRet = epoll_wait(miEpfd, mstruEvent,miMaxFdNumber, time_out);
 	err = errno;
 	if(nRet == -1){
@@ -197,14 +311,26 @@ int CNetEpoll::CheckEpollEvent(int time_out/* =0 */){
 	return nRet;
 }
 
-int CNetEpoll::DealEpollEvent(int i){
+int CNetEpoll::DealEpollEvent(int i, bool &abRecvView){
 	int error_fd = -1;
 	bool lbRecvFlag = false;
+	int liEventfd = (int)(uint32)mstruEvent[i].data.u64;
+	if(liEventfd == miWakeupFd && miWakeupFd != -1){
+		uint64 liValue = 0;
+		read(miWakeupFd, &liValue, sizeof(liValue));
+		__sync_lock_test_and_set(&miWakeupPending, 0);
+		OnWakeup();
+		return error_fd;
+	}
 	CAutoLock lock(moFdSection);
-	CNetSocket *lpNetFd  = NULL;
-	lpNetFd = (CNetSocket *)mstruEvent[i].data.ptr;
-	if(moNetSocketList.find(lpNetFd->miSocket) == moNetSocketList.end()){
-		TRACE(1, "CNetEpoll::DealEpollEvent δ鵽FD: "<<lpNetFd->miSocket);
+	uint32 liGeneration = (uint32)(mstruEvent[i].data.u64 >> 32);
+	CNetSocket *lpNetFd = GetNetSocket(liEventfd);
+	if(NULL == lpNetFd){
+		TRACE(1, "CNetEpoll::DealEpollEvent δ鵽FD: "<<liEventfd);
+		return error_fd;
+	}
+	if(mpSocketSlot[liEventfd].miGeneration != liGeneration){
+		TRACE(3, "CNetEpoll::DealEpollEvent fdѱã¼fd = "<<liEventfd);
 		return error_fd;
 	}
 
@@ -222,7 +348,9 @@ int CNetEpoll::DealEpollEvent(int i){
 				if(0 == _fd){
 					break;
 				} else {
-					Addfd(_fd);
+					if(Addfd(_fd)){
+						OnAccept(_fd);
+					}
 					unsigned int liCurrentFdNumber = GetConnectedSize();
 					if(liCurrentFdNumber > miMaxFdNumber){
 						break;
@@ -240,14 +368,19 @@ int CNetEpoll::DealEpollEvent(int i){
 			error_fd = lfd;
 			return error_fd;
 		}
-		if(mstruEvent[i].events & EPOLLIN){
+		if((mstruEvent[i].events & EPOLLIN) && mbZeroCopyRecv){
+			//صܷͻرձӣŵͷmoFdSection֮
+			abRecvView = true;
+		}else if(mstruEvent[i].events & EPOLLIN){
 			if(!lpNetFd->RecvData()){
 				int lfd = lpNetFd->miSocket;
 				Delfd(lpNetFd->miSocket);
 				error_fd = lfd;
 				//OnErrorNotice(lfd);
+				return error_fd;
 			} else {
 				lbRecvFlag = true;
+				TouchRecvTimer(lpNetFd);
 			}
 
 			while(lbRecvFlag){
@@ -271,8 +404,11 @@ int CNetEpoll::DealEpollEvent(int i){
 				Delfd(lpNetFd->miSocket);
 				//OnErrorNotice(lfd);
 				error_fd = lfd;
-			} else if(1 == nRet) {
-				ModifyEpollEvent(lpNetFd, EPOLLIN |EPOLLOUT | EPOLLET);
+			} else {
+				if(1 == nRet) {
+					ModifyEpollEvent(lpNetFd, EPOLLIN |EPOLLOUT | EPOLLET);
+				}
+				UpdateSendTimer(lpNetFd, nRet, true);
 			}
 		}
 	}
@@ -280,7 +416,11 @@ int CNetEpoll::DealEpollEvent(int i){
 }
 int CNetEpoll::ProcessEpollEvent(int aiEventSize){
 	for(int i = 0; i < aiEventSize; i++){
-		int nRet = DealEpollEvent(i);
+		bool lbRecvView = false;
+		int nRet = DealEpollEvent(i, lbRecvView);
+		if(nRet < 0 && lbRecvView){
+			nRet = RecvView(i);
+		}
 		if(nRet >= 0){
 			OnErrorNotice(nRet);
 		}
@@ -288,23 +428,64 @@ int CNetEpoll::ProcessEpollEvent(int aiEventSize){
 	return 0;
 }
 
-bool CNetEpoll::SendData(int fd, const char* buffer, const int length){
+int CNetEpoll::RecvView(int i){
+	int liFd = (int)(uint32)mstruEvent[i].data.u64;
+	uint32 liGeneration = (uint32)(mstruEvent[i].data.u64 >> 32);
+	int liRet = 1;
+	while(liRet > 0){
+		CNetSocket *lpNetFd = NULL;
+		{
+			CAutoLock lock(moFdSection);
+			lpNetFd = GetNetSocket(liFd);
+			if(NULL == lpNetFd || mpSocketSlot[liFd].miGeneration != liGeneration){
+				return -1;
+			}
+			moRecvView.clear();
+			moRecvCopy.clear();
+			liRet = lpNetFd->RecvDataView(moRecvView, moRecvCopy);
+			if(liRet < 0){
+				Delfd(liFd);
+				return liFd;
+			}
+			TouchRecvTimer(lpNetFd);
+			mpRecvViewSocket = lpNetFd;
+			mbRecvViewClosed = false;
+		}
+
+		//ָӵĽջ棬ڽǰᱻͷ
+		char *lpCache = lpNetFd->GetRecvCache();
+		for(size_t v = 0; v < moRecvView.size() && !mbRecvViewClosed; ++v){
+			STRU_RECV_VIEW &loView = moRecvView[v];
+			char *lpBuffer = loView.mbCopy ? &moRecvCopy[loView.miOffset] : lpCache + loView.miOffset;
+			RecvFrom(liFd, lpBuffer, loView.miLength);
+		}
+
+		CAutoLock lock(moFdSection);
+		mpRecvViewSocket = NULL;
+		if(mbRecvViewClosed){
+			//صѾرգʣµİ
+			mbRecvViewClosed = false;
+			delete lpNetFd;
+			return -1;
+		}
+	}
+	return -1;
+}
+
+bool CNetEpoll::SendData(int fd, const char* buffer, const int length, int aiType){
 	if(fd <= 0){
 		return false;
 	}
 	CAutoLock lock(moFdSection);
-	CNetSocket *lpNetSocket = NULL;
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.find(fd);
-	if(iter != moNetSocketList.end()){
-		lpNetSocket = iter->second;
-	}
-
+	CNetSocket *lpNetSocket = GetNetSocket(fd);
 	if(NULL == lpNetSocket){
 		TRACE(1, "CNetEpoll::SendData δ鵽û fd = "<<fd);
 		return false;
 	}
-	lpNetSocket->SendData(buffer, length);
-	int nRet = lpNetSocket->SendData();
+	int nRet = lpNetSocket->SendData(buffer, length, aiType);
+	if(nRet >= 0){
+		nRet = lpNetSocket->SendData();
+	}
 	if(-1 == nRet){
 		int lfd = lpNetSocket->miSocket;
 		Delfd(lpNetSocket->miSocket);
@@ -313,68 +494,199 @@ bool CNetEpoll::SendData(int fd, const char* buffer, const int length){
 	}else if(1 == nRet){
 		ModifyEpollEvent(lpNetSocket, EPOLLIN |EPOLLOUT | EPOLLET);
 	}
+	UpdateSendTimer(lpNetSocket, nRet, false);
 	return true;
 }
 
-bool CNetEpoll::SendAllData(const char* buffer, const int length){
+bool CNetEpoll::SendAllData(const char* buffer, const int length, int aiType){
+	//ֻһΰдͷԱSendDataһmoFdSectionڽ
+	//ѹʱٴһѹ˸㷨
+	CNetChunk *lpChunk = NULL;
+	CNetChunk *lpCompressChunk = NULL;
+	int liCompressType = COMPRESS_NONE;
+	{
+		CAutoLock lock(moFdSection);
+		lpChunk = CNetSocket::PackChunk(m_pNetPack, buffer, length, aiType);
+		liCompressType = m_pNetPack->_compress_type;
+		if(NULL != lpChunk && COMPRESS_NONE != liCompressType){
+			lpCompressChunk = CNetSocket::PackChunk(m_pNetPack, buffer, length, aiType, COMPRESS_ACCEPT_BIT(liCompressType));
+		}
+	}
+	if(NULL == lpChunk){
+		TRACE(1, "CNetEpoll::SendAllData ʧܡlength = "<<length);
+		return false;
+	}
+	bool lbRet = SendAllData(lpChunk, lpCompressChunk, liCompressType);
+	lpChunk->Release();
+	if(NULL != lpCompressChunk){
+		lpCompressChunk->Release();
+	}
+	return lbRet;
+}
+
+bool CNetEpoll::SendAllData(CNetChunk *apChunk, CNetChunk *apCompressChunk, int aiCompressType){
+	ASSERT(apChunk != NULL);
 	CAutoLock lock(moFdSection);
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.begin();
-	for(;iter != moNetSocketList.end();){
-		CNetSocket *lpNetSocket = NULL;
-		lpNetSocket = iter->second;
+	for(int fd = 0; fd <= miMaxUsedfd; ++fd){
+		CNetSocket *lpNetSocket = mpSocketSlot[fd].mpNetSocket;
 		if(NULL == lpNetSocket){
-			iter++;
 			continue;
 		}
 		if(!lpNetSocket->mbListenSocket && !lpNetSocket->mbClientSocket){
-			lpNetSocket->SendData(buffer, length);
-			int nRet = lpNetSocket->SendData();
+			int nRet = lpNetSocket->SendChunk((NULL != apCompressChunk && lpNetSocket->CanCompress(aiCompressType)) ? apCompressChunk : apChunk);
+			if(nRet >= 0){
+				nRet = lpNetSocket->SendData();
+			}
 			if(-1 == nRet){
-				int lfd = lpNetSocket->miSocket;
-				Delfd(iter++);
-				OnErrorNotice(lfd);
+				Delfd(fd);
+				OnErrorNotice(fd);
 				continue;
 			}else if(1 == nRet){
 				ModifyEpollEvent(lpNetSocket, EPOLLIN |EPOLLOUT | EPOLLET);
 			}
+			UpdateSendTimer(lpNetSocket, nRet, false);
 		}
-		iter++;
 	}
 	return true;
 }
 
 unsigned int CNetEpoll::GetConnectedSize(){
 	CAutoLock lock(moFdSection);
-	unsigned int luiSize = moNetSocketList.size();
+	unsigned int luiSize = miConnectedSize;
 	return luiSize;
 }
 
 void CNetEpoll::Dump(){
 	CAutoLock lock(moFdSection);
-	TRACE(2, "CNetEpoll::Dump socket : "<<moNetSocketList.size());
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.begin();
-	for(;iter != moNetSocketList.end();iter++){
-		CNetSocket *lpNetSocket = NULL;
-		lpNetSocket = iter->second;
+	TRACE(2, "CNetEpoll::Dump socket : "<<miConnectedSize<<" : "<<miSlotSize);
+	for(int fd = 0; fd <= miMaxUsedfd; ++fd){
+		CNetSocket *lpNetSocket = mpSocketSlot[fd].mpNetSocket;
 		if(NULL == lpNetSocket){
-			TRACE(2, "CNetEpoll::Dump fd : "<<iter->first<<" socketϢΪա");
-		}else{
-			TRACE(2, "CNetEpoll::Dump fd : "<<iter->first<<" ״̬"<<lpNetSocket->moNetStat);
+			continue;
 		}
+		TRACE(2, "CNetEpoll::Dump fd : "<<fd<<" ״̬"<<lpNetSocket->moNetStat
+			<<" Ͷֽ"<<lpNetSocket->GetSendQueueBytes()
+			<<" Ͷа"<<lpNetSocket->GetSendQueueCount()
+			<<" "<<lpNetSocket->GetSendDropCount());
 	}
 }
 
+void CNetEpoll::SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit){
+	CAutoLock lock(moFdSection);
+	moSendQueueLimit = aoLimit;
+	for(int fd = 0; fd <= miMaxUsedfd; ++fd){
+		CNetSocket *lpNetSocket = mpSocketSlot[fd].mpNetSocket;
+		if(lpNetSocket != NULL && !lpNetSocket->mbListenSocket && !lpNetSocket->mbClientSocket){
+			lpNetSocket->SetSendQueueLimit(aoLimit);
+		}
+	}
+}
 
+void CNetEpoll::GetSendQueueStat(STRU_SEND_QUEUE_STAT &aoStat){
+	CAutoLock lock(moFdSection);
+	for(int fd = 0; fd <= miMaxUsedfd; ++fd){
+		CNetSocket *lpNetSocket = mpSocketSlot[fd].mpNetSocket;
+		if(NULL == lpNetSocket){
+			continue;
+		}
+		int liBytes = lpNetSocket->GetSendQueueBytes();
+		int liCount = lpNetSocket->GetSendQueueCount();
+		aoStat.mui64TotalBytes += liBytes;
+		if(liBytes > aoStat.miMaxBytes){
+			aoStat.miMaxBytes = liBytes;
+		}
+		if(liCount > aoStat.miMaxCount){
+			aoStat.miMaxCount = liCount;
+		}
+		aoStat.mui64DropCount += lpNetSocket->GetSendDropCount();
+	}
+}
 
+void CNetEpoll::SetTimeOut(const STRU_NET_TIMEOUT &aoTimeOut){
+	CAutoLock lock(moFdSection);
+	moTimeOut = aoTimeOut;
+}
 
+int CNetEpoll::ProcessTimer(){
+	CAutoLock lock(moFdSection);
+	return moTimingWheel.Advance(CTimingWheel::GetMonotonicTime());
+}
 
+void CNetEpoll::ArmTimer(CNetSocket *apNetSocket, NET_TIMER_TYPE aoType){
+	//ֻܽ
+	if(apNetSocket->mbListenSocket || apNetSocket->mbClientSocket){
+		return;
+	}
+	unsigned int liTimeOut = 0;
+	switch(aoType){
+	case NET_TIMER_IDLE:
+		liTimeOut = moTimeOut.miIdleTimeOut;
+		break;
+	case NET_TIMER_KEEPALIVE:
+		liTimeOut = moTimeOut.miKeepAliveTime;
+		break;
+	case NET_TIMER_SEND_STALL:
+		liTimeOut = moTimeOut.miSendStallTimeOut;
+		break;
+	default:
+		break;
+	}
+	if(0 == liTimeOut){
+		return;
+	}
+	STRU_TIMER_NODE *lpNode = &apNetSocket->moTimer[aoType];
+	lpNode->miType = aoType;
+	lpNode->mui64Data = MakeEventData(apNetSocket->miSocket);
+	moTimingWheel.Arm(lpNode, liTimeOut);
+}
 
+void CNetEpoll::CancelTimer(CNetSocket *apNetSocket){
+	for(int i = 0; i < NET_TIMER_COUNT; ++i){
+		moTimingWheel.Cancel(&apNetSocket->moTimer[i]);
+	}
+}
 
+void CNetEpoll::TouchRecvTimer(CNetSocket *apNetSocket){
+	ArmTimer(apNetSocket, NET_TIMER_IDLE);
+	ArmTimer(apNetSocket, NET_TIMER_KEEPALIVE);
+}
 
+void CNetEpoll::UpdateSendTimer(CNetSocket *apNetSocket, int aiSendRet, bool abProgress){
+	STRU_TIMER_NODE *lpNode = &apNetSocket->moTimer[NET_TIMER_SEND_STALL];
+	if(1 == aiSendRet){
+		//û꣬нչʱ¼ʱ
+		if(abProgress || !lpNode->IsArmed()){
+			ArmTimer(apNetSocket, NET_TIMER_SEND_STALL);
+		}
+	} else {
+		moTimingWheel.Cancel(lpNode);
+	}
+}
 
-
-
-
-
-
-
+void CNetEpoll::OnTimerExpire(STRU_TIMER_NODE *apNode){
+	int fd = (int)(uint32)apNode->mui64Data;
+	uint32 liGeneration = (uint32)(apNode->mui64Data >> 32);
+	CNetSocket *lpNetSocket = GetNetSocket(fd);
+	if(NULL == lpNetSocket || mpSocketSlot[fd].miGeneration != liGeneration){
+		return;
+	}
+	switch(apNode->miType){
+	case NET_TIMER_IDLE:
+		TRACE(3, "CNetEpoll::OnTimerExpire ӿгʱϿfd = "<<fd);
+		Delfd(fd);
+		OnErrorNotice(fd);
+		break;
+	case NET_TIMER_KEEPALIVE:
+		ArmTimer(lpNetSocket, NET_TIMER_KEEPALIVE);
+		OnKeepAlive(fd);
+		break;
+	case NET_TIMER_SEND_STALL:
+		TRACE(1, "CNetEpoll::OnTimerExpire ͣͳʱϿfd = "<<fd
+			<<" Ͷֽ"<<lpNetSocket->GetSendQueueBytes());
+		Delfd(fd);
+		OnErrorNotice(fd);
+		break;
+	default:
+		break;
+	}
+}
@@ -8,18 +8,57 @@
 #include "NetSocket.h"
 #include "sigslot.h"
 
-typedef std::map<int, CNetSocket*> NET_SOCKET_LIST;
-typedef std::map<int, CNetSocket*>::iterator NET_SOCKET_LIST_ITER;
-
 #define DEF_EPOLL_SIZE 10240
 #define DEF_EPOLL_TIMEOUT 0
 
-class CNetEpoll{
+//ӵĳʱã룬0ʾ
+struct STRU_NET_TIMEOUT{
+	STRU_NET_TIMEOUT(){
+		miIdleTimeOut = 0;
+		miKeepAliveTime = 0;
+		miSendStallTimeOut = 0;
+	}
+	//ûյݾͶϿ
+	unsigned int miIdleTimeOut;
+	//ûյݾʹһOnKeepAlive
+	unsigned int miKeepAliveTime;
+	//ͶжûнչͶϿ
+	unsigned int miSendStallTimeOut;
+};
+
+//Ͷͳ
+struct STRU_SEND_QUEUE_STAT{
+	STRU_SEND_QUEUE_STAT(){
+		mui64TotalBytes = 0;
+		miMaxBytes = 0;
+		miMaxCount = 0;
+		mui64DropCount = 0;
+	}
+	//ӻѹֽ
+	uint64 mui64TotalBytes;
+	//ѹֽ
+	int miMaxBytes;
+	int miMaxCount;
+	//İ
+	uint64 mui64DropCount;
+};
+
+//ӲۣfdΪ±ֱӴȡ
+//fdرʱmiGeneration1epoll_event.dataͬʱfdʹ
+//¼ʱһ˵fdѹر(Ӹ)¼
+struct STRU_NET_SOCKET_SLOT{
+	CNetSocket *mpNetSocket;
+	uint32 miGeneration;
+};
+
+class CNetEpoll : public sigslot::has_slots<>{
 public:
 	CNetEpoll();
 	CNetEpoll(CNetPack *pack){
 		ASSERT(pack != NULL);
+		Reset();
 		m_pNetPack = pack;
+		moTimingWheel.OnTimeOut.connect(this, &CNetEpoll::OnTimerExpire);
 	}
 	~CNetEpoll();
 
@@ -31,39 +70,114 @@ public:
 	bool Init(unsigned int aiMaxSocketSize = DEF_EPOLL_SIZE);
 	bool Destroy();
 
+	//жʱʱȴʱ䲻ʱֵһ̶
 	int CheckEpollEvent(int time_out=0);
 	int ProcessEpollEvent(int aiEventSize);
+	//ƽʱ֣ڵӶʱCheckEpollEvent֮
+	int ProcessTimer();
 
-	bool SendData(int fd, const char* buffer, const int length);
-	bool SendAllData(const char* buffer, const int length);
+	//aiTypeCNetSocket::SendDataSEND_POLICY_COALESCE
+	bool SendData(int fd, const char* buffer, const int length, int aiType = 0);
+	bool SendAllData(const char* buffer, const int length, int aiType = 0);
+	//㲥Ѵðݿ飬ӹͬһݿ
+	//apCompressChunkΪaiCompressTypeѹͬһݣ˸㷨
+	bool SendAllData(CNetChunk *apChunk, CNetChunk *apCompressChunk = NULL, int aiCompressType = COMPRESS_NONE);
 
 	bool Addfd(CNetSocket* apNetSocket);
 	bool Delfd(CNetSocket* apNetSocket);
 	bool Addfd(int fd);
 	bool Delfd(int fd);
 	bool Findfd(int fd);
+	//ӷͶﻹûֽӲڷ-1
+	int GetSendQueueBytes(int fd);
 
 	unsigned int GetConnectedSize();
 
+	//ýӵķͶ޶ͬʱЧ
+	void SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit);
+	//ͳۼӵaoStat
+	void GetSendQueueStat(STRU_SEND_QUEUE_STAT &aoStat);
+	//֮Ч
+	void SetTimeOut(const STRU_NET_TIMEOUT &aoTimeOut);
+
+	//̻߳ѣInit֮EnableWakeup̵߳Wakeup
+	//EPOLL߳ProcessEpollEventﴥOnWakeupWakeupֻһ
+	bool EnableWakeup();
+	void Wakeup();
+
 	void Dump();
 
 private:
-	bool Delfd(NET_SOCKET_LIST_ITER iter);
+	void Reset();
+	//֤fdʱ
+	bool ReserveSlot(int fd);
+	//fdȡsocketδע᷵NULLmoFdSection
+	inline CNetSocket* GetNetSocket(int fd){
+		if(fd < 0 || (unsigned int)fd >= miSlotSize){
+			return NULL;
+		}
+		return mpSocketSlot[fd].mpNetSocket;
+	}
+	//epoll_event.data.u64 = <<32 | fd
+	inline uint64 MakeEventData(int fd){
+		return ((uint64)mpSocketSlot[fd].miGeneration << 32) | (uint32)fd;
+	}
 	int AddEpollEvent(CNetSocket* pNetSocket, unsigned int ulEvent);
 	int ModifyEpollEvent(CNetSocket* pNetSocket, unsigned int ulEvent);
 	int DelEpollEvent(CNetSocket* pNetSocket);
-	int DealEpollEvent(int i);
+	//abRecvViewtrueʱ㿽RecvView⴦
+	int DealEpollEvent(int i, bool &abRecvView);
+	//㿽գmoFdSectionݡͷRecvFrom
+	//سҪ֪ͨfd򷵻-1
+	int RecvView(int i);
+	//صɾڽʱƳٵͷ
+	void DeleteSocket(CNetSocket *apNetSocket);
+	void ArmTimer(CNetSocket *apNetSocket, NET_TIMER_TYPE aoType);
+	void CancelTimer(CNetSocket *apNetSocket);
+	//յݺÿкͱʱ
+	void TouchRecvTimer(CNetSocket *apNetSocket);
+	//SendDataķֵժͣͶʱabProgressΪtrueʱʾнչ
+	void UpdateSendTimer(CNetSocket *apNetSocket, int aiSendRet, bool abProgress);
+	void OnTimerExpire(STRU_TIMER_NODE *apNode);
 
 public:
-		sigslot::signal3<int, char*, int> RecvFrom;
-		sigslot::signal1<int> OnErrorNotice;
+		//հͳÿҪߵ·ֻһۣemitҲ
+		sigslot::single_signal3<int, char*, int> RecvFrom;
+		sigslot::single_signal1<int> OnErrorNotice;
+		//socket½ʱ֪ͨΪӵfd
+		sigslot::signal1<int> OnAccept;
+		//ڱʱûյݣӦÿԷ
+		sigslot::signal1<int> OnKeepAlive;
+		//̵߳Wakeup
+		sigslot::signal0<> OnWakeup;
 		bool mbHasListenFd;
 		bool mbKeepAlive;
+		//㿽գRecvFromյӽջڵָ룬ֻڻصڼЧ
+		//صʱӵصԷ͡رձ
+		bool mbZeroCopyRecv;
 private:
-	NET_SOCKET_LIST moNetSocketList;
+	STRU_NET_SOCKET_SLOT *mpSocketSlot;
+	unsigned int miSlotSize;
+	//עfdʱֻɨ赽
+	int miMaxUsedfd;
+	unsigned int miConnectedSize;
+	STRU_SEND_QUEUE_LIMIT moSendQueueLimit;
+	STRU_NET_TIMEOUT moTimeOut;
+	//moFdSection
+	CTimingWheel moTimingWheel;
 	CCriticalSection moFdSection;
 	int miEpfd;
+	//Wakeupõeventfd-1ʾδ
+	int miWakeupFd;
+	//дeventfdEPOLL̻߳û
+	volatile int miWakeupPending;
 	struct epoll_event* mstruEvent;
+	//㿽һֽİ
+	std::vector<STRU_RECV_VIEW> moRecvView;
+	std::vector<char> moRecvCopy;
+	//⽻ӣصбرʱֻ
+	CNetSocket *mpRecvViewSocket;
+	volatile bool mbRecvViewClosed;
 	unsigned int miMaxFdNumber;
 	CNetPack *m_pNetPack;
 };
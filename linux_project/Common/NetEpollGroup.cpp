@@ -0,0 +1,316 @@
+#include "NetEpollGroup.h"
+#include <sys/resource.h>
+
+/************************************************************************/
+/*
+CNetReactor
+*/
+/************************************************************************/
+CNetReactor::CNetReactor(CNetEpollGroup *apGroup, int aiIndex){
+	ASSERT(apGroup != NULL);
+	m_pGroup = apGroup;
+	miIndex = aiIndex;
+	mpNetPack = NULL;
+	mui64AcceptCount = 0;
+	mui64RecvCount = 0;
+	moNetEpoll.OnAccept.connect(this, &CNetReactor::OnAccept);
+	moNetEpoll.RecvFrom.connect(this, &CNetReactor::OnRecvFrom);
+	moNetEpoll.OnErrorNotice.connect(this, &CNetReactor::OnErrorNotice);
+	moNetEpoll.OnKeepAlive.connect(this, &CNetReactor::OnKeepAlive);
+}
+
+CNetReactor::~CNetReactor(){
+	moNetEpoll.OnAccept.disconnect(this);
+	moNetEpoll.RecvFrom.disconnect(this);
+	moNetEpoll.OnErrorNotice.disconnect(this);
+	moNetEpoll.OnKeepAlive.disconnect(this);
+	if(mpNetPack != NULL){
+		delete mpNetPack;
+		mpNetPack = NULL;
+	}
+}
+
+void CNetReactor::OnAccept(int fd){
+	++mui64AcceptCount;
+	m_pGroup->SetOwner(fd, miIndex);
+}
+
+void CNetReactor::OnRecvFrom(int fd, char *buffer, int length){
+	++mui64RecvCount;
+	m_pGroup->RecvFrom(fd, buffer, length);
+}
+
+void CNetReactor::OnErrorNotice(int fd){
+	m_pGroup->OnErrorNotice(fd);
+}
+
+void CNetReactor::OnKeepAlive(int fd){
+	m_pGroup->OnKeepAlive(fd);
+}
+
+/************************************************************************/
+/*
+CNetEpollGroup
+*/
+/************************************************************************/
+CNetEpollGroup::CNetEpollGroup(){
+	memset(mpReactor, 0, sizeof(mpReactor));
+	miReactorCount = 0;
+	mpFdOwner = NULL;
+	miFdOwnerSize = 0;
+	miEpollTimeOut = 100;
+	m_pNetPack = NULL;
+}
+
+CNetEpollGroup::~CNetEpollGroup(){
+	Destroy();
+}
+
+bool CNetEpollGroup::Init(CNetPack *apPack, const char *ip, const short port,
+	unsigned int aiReactorCount /* = 1 */, unsigned int aiMaxSocketSize /* = DEF_EPOLL_SIZE */){
+	ASSERT(apPack != NULL);
+	if(0 == aiReactorCount || aiReactorCount > DEF_MAX_REACTOR_COUNT){
+		TRACE(1, "CNetEpollGroup::Init ӦѸcount = "<<aiReactorCount);
+		return false;
+	}
+	m_pNetPack = apPack;
+
+	//fd̿ɴ򿪵ļ
+	struct rlimit loLimit;
+	miFdOwnerSize = aiMaxSocketSize * aiReactorCount + 1024;
+	if(0 == getrlimit(RLIMIT_NOFILE, &loLimit) && loLimit.rlim_cur != RLIM_INFINITY
+		&& loLimit.rlim_cur > miFdOwnerSize){
+		miFdOwnerSize = loLimit.rlim_cur;
+	}
+	mpFdOwner = new int8[miFdOwnerSize];
+	memset(mpFdOwner, -1, miFdOwnerSize);
+
+	//ֻһӦʱҪ˿ڸ
+	bool lbReusePort = (aiReactorCount > 1);
+	for(unsigned int i = 0; i < aiReactorCount; ++i){
+		CNetReactor *lpReactor = new CNetReactor(this, i);
+		mpReactor[i] = lpReactor;
+		miReactorCount = i + 1;
+
+		//дĳԱӦ̲ܹ߳һ
+		lpReactor->mpNetPack = apPack->Clone();
+		if(NULL == lpReactor->mpNetPack){
+			TRACE(1, "CNetEpollGroup::Init ָ֧ơreactor = "<<i);
+			Destroy();
+			return false;
+		}
+		lpReactor->moNetEpoll.SetPack(lpReactor->mpNetPack);
+		if(!lpReactor->moNetEpoll.Init(aiMaxSocketSize)){
+			TRACE(1, "CNetEpollGroup::Init EPOLLʼʧܡreactor = "<<i);
+			Destroy();
+			return false;
+		}
+
+		CNetSocket &loListen = lpReactor->moListenSocket;
+		loListen.SetNetPack(lpReactor->mpNetPack);
+		if(!loListen.CreateSocket(ip, port, lbReusePort)){
+			TRACE(1, "CNetEpollGroup::Init 󶨶˿ʧܡreactor = "<<i<<" port = "<<port);
+			Destroy();
+			return false;
+		}
+		loListen.mbListenSocket = true;
+		if(!loListen.SetNoBlock() || !loListen.Listen()){
+			TRACE(1, "CNetEpollGroup::Init ˿ʧܡreactor = "<<i<<" port = "<<port);
+			Destroy();
+			return false;
+		}
+		if(!lpReactor->moNetEpoll.Addfd(&loListen)){
+			TRACE(1, "CNetEpollGroup::Init Ӽ˿ڵEPOLLʧܡreactor = "<<i);
+			Destroy();
+			return false;
+		}
+		lpReactor->moNetEpoll.mbHasListenFd = true;
+	}
+	TRACE(1, "CNetEpollGroup::Init ӦѸ: "<<miReactorCount<<" port = "<<port);
+	return true;
+}
+
+bool CNetEpollGroup::Start(int aiEpollTimeOut /* = 100 */){
+	ASSERT(miReactorCount > 0);
+	miEpollTimeOut = aiEpollTimeOut;
+	unsigned int liCount = moThreadManager.Start(ReactorThread, this, miReactorCount, "net_reactor");
+	if(liCount != miReactorCount){
+		TRACE(1, "CNetEpollGroup::Start Ӧ߳ʧܡ: "<<liCount
+			<<" Ҫ: "<<miReactorCount);
+		return false;
+	}
+	return true;
+}
+
+bool CNetEpollGroup::Destroy(){
+	if(!moThreadManager.IsStop()){
+		moThreadManager.StopAll();
+	}
+	for(unsigned int i = 0; i < miReactorCount; ++i){
+		CNetReactor *lpReactor = mpReactor[i];
+		if(NULL == lpReactor){
+			continue;
+		}
+		lpReactor->moNetEpoll.Destroy();
+		lpReactor->moListenSocket.Close();
+		delete lpReactor;
+		mpReactor[i] = NULL;
+	}
+	miReactorCount = 0;
+	if(mpFdOwner != NULL){
+		delete [] mpFdOwner;
+		mpFdOwner = NULL;
+	}
+	miFdOwnerSize = 0;
+	return true;
+}
+
+unsigned int CNetEpollGroup::ReactorThread(STRU_THREAD_CONTEXT& apContext){
+	try{
+		CNetEpollGroup *p = reinterpret_cast<CNetEpollGroup*>(apContext.mpWorkContext);
+		ASSERT(p != NULL);
+		int liIndex = apContext.moThreadStat.GetThreadIndex();
+		CNetReactor *lpReactor = p->mpReactor[liIndex];
+		ASSERT(lpReactor != NULL);
+		CNetEpoll &loNetEpoll = lpReactor->moNetEpoll;
+		TRACE(1, "CNetEpollGroup::ReactorThread Ӧ߳reactor = "<<liIndex);
+		while(!p->moThreadManager.IsStop()){
+			int nRet = loNetEpoll.CheckEpollEvent(p->miEpollTimeOut);
+			if(nRet > 0){
+				loNetEpoll.ProcessEpollEvent(nRet);
+			}
+			loNetEpoll.ProcessTimer();
+		}
+	}
+	catch (...){
+		TRACE(1, "CNetEpollGroup::ReactorThread 쳣");
+	}
+	return 0;
+}
+
+void CNetEpollGroup::SetOwner(int fd, int aiReactor){
+	if(fd < 0 || (unsigned int)fd >= miFdOwnerSize){
+		TRACE(1, "CNetEpollGroup::SetOwner fdΧfd = "<<fd);
+		return;
+	}
+	mpFdOwner[fd] = (int8)aiReactor;
+}
+
+CNetReactor* CNetEpollGroup::GetReactor(int fd){
+	if(fd < 0 || (unsigned int)fd >= miFdOwnerSize){
+		return NULL;
+	}
+	int liOwner = mpFdOwner[fd];
+	if(liOwner < 0 || (unsigned int)liOwner >= miReactorCount){
+		return NULL;
+	}
+	return mpReactor[liOwner];
+}
+
+bool CNetEpollGroup::Addfd(CNetSocket *apNetSocket, unsigned int aiReactor /* = 0 */){
+	ASSERT(apNetSocket != NULL);
+	if(aiReactor >= miReactorCount){
+		TRACE(1, "CNetEpollGroup::Addfd ӦŴreactor = "<<aiReactor);
+		return false;
+	}
+	if(!mpReactor[aiReactor]->moNetEpoll.Addfd(apNetSocket)){
+		return false;
+	}
+	SetOwner(apNetSocket->miSocket, aiReactor);
+	return true;
+}
+
+bool CNetEpollGroup::Delfd(int fd){
+	CNetReactor *lpReactor = GetReactor(fd);
+	if(NULL == lpReactor){
+		return true;
+	}
+	return lpReactor->moNetEpoll.Delfd(fd);
+}
+
+bool CNetEpollGroup::Findfd(int fd){
+	CNetReactor *lpReactor = GetReactor(fd);
+	if(NULL == lpReactor){
+		return false;
+	}
+	return lpReactor->moNetEpoll.Findfd(fd);
+}
+
+bool CNetEpollGroup::SendData(int fd, const char* buffer, const int length, int aiType){
+	CNetReactor *lpReactor = GetReactor(fd);
+	if(NULL == lpReactor){
+		TRACE(1, "CNetEpollGroup::SendData δ鵽û fd = "<<fd);
+		return false;
+	}
+	return lpReactor->moNetEpoll.SendData(fd, buffer, length, aiType);
+}
+
+bool CNetEpollGroup::SendAllData(const char* buffer, const int length, int aiType){
+	//зӦѹͬһðݿ飬ѹͬCNetEpoll::SendAllData
+	CNetChunk *lpChunk = NULL;
+	CNetChunk *lpCompressChunk = NULL;
+	int liCompressType = COMPRESS_NONE;
+	{
+		CAutoLock lock(moPackSection);
+		lpChunk = CNetSocket::PackChunk(m_pNetPack, buffer, length, aiType);
+		liCompressType = m_pNetPack->_compress_type;
+		if(NULL != lpChunk && COMPRESS_NONE != liCompressType){
+			lpCompressChunk = CNetSocket::PackChunk(m_pNetPack, buffer, length, aiType, COMPRESS_ACCEPT_BIT(liCompressType));
+		}
+	}
+	if(NULL == lpChunk){
+		TRACE(1, "CNetEpollGroup::SendAllData ʧܡlength = "<<length);
+		return false;
+	}
+	for(unsigned int i = 0; i < miReactorCount; ++i){
+		mpReactor[i]->moNetEpoll.SendAllData(lpChunk, lpCompressChunk, liCompressType);
+	}
+	lpChunk->Release();
+	if(NULL != lpCompressChunk){
+		lpCompressChunk->Release();
+	}
+	return true;
+}
+
+unsigned int CNetEpollGroup::GetConnectedSize(){
+	unsigned int luiSize = 0;
+	for(unsigned int i = 0; i < miReactorCount; ++i){
+		luiSize += mpReactor[i]->moNetEpoll.GetConnectedSize();
+	}
+	return luiSize;
+}
+
+void CNetEpollGroup::SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit){
+	for(unsigned int i = 0; i < miReactorCount; ++i){
+		mpReactor[i]->moNetEpoll.SetSendQueueLimit(aoLimit);
+	}
+}
+
+void CNetEpollGroup::GetSendQueueStat(STRU_SEND_QUEUE_STAT &aoStat){
+	for(unsigned int i = 0; i < miReactorCount; ++i){
+		mpReactor[i]->moNetEpoll.GetSendQueueStat(aoStat);
+	}
+}
+
+void CNetEpollGroup::SetTimeOut(const STRU_NET_TIMEOUT &aoTimeOut){
+	for(unsigned int i = 0; i < miReactorCount; ++i){
+		mpReactor[i]->moNetEpoll.SetTimeOut(aoTimeOut);
+	}
+}
+
+void CNetEpollGroup::Dump(){
+	TRACE(2, "CNetEpollGroup::Dump ӦѸ: "<<miReactorCount);
+	for(unsigned int i = 0; i < miReactorCount; ++i){
+		CNetReactor *lpReactor = mpReactor[i];
+		STRU_SEND_QUEUE_STAT loStat;
+		lpReactor->moNetEpoll.GetSendQueueStat(loStat);
+		TRACE(2, "CNetEpollGroup::Dump reactor = "<<i
+			<<" : "<<lpReactor->moNetEpoll.GetConnectedSize()
+			<<" : "<<lpReactor->mui64AcceptCount
+			<<" հ: "<<lpReactor->mui64RecvCount
+			<<" ͻѹֽ: "<<loStat.mui64TotalBytes
+			<<" ѹֽ: "<<loStat.miMaxBytes
+			<<" ѹ: "<<loStat.miMaxCount
+			<<" : "<<loStat.mui64DropCount);
+	}
+}
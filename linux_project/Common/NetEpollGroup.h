@@ -0,0 +1,107 @@
+/********************************************************************
+	file base:	NetEpollGroup
+	file ext:	h
+
+	purpose:	෴ӦEPOLL
+				ÿӦӵжepollfdͼsocket(SO_REUSEPORT)
+				ںڸsocketַ֮ӡһĳӦѽգ
+				ֻɸ÷Ӧѵ̴߳¼
+*********************************************************************/
+#ifndef _NET_EPOLL_GROUP_H_
+#define _NET_EPOLL_GROUP_H_
+
+#include "include.h"
+#include "NetEpoll.h"
+#include "ThreadGroup.h"
+#include "sigslot.h"
+
+#define DEF_MAX_REACTOR_COUNT 64
+
+class CNetEpollGroup;
+
+//Ӧѣһepoll + һsocketԼ߳
+class CNetReactor : public sigslot::has_slots<>
+{
+public:
+	CNetReactor(CNetEpollGroup *apGroup, int aiIndex);
+	~CNetReactor();
+
+	void OnAccept(int fd);
+	void OnRecvFrom(int fd, char *buffer, int length);
+	void OnErrorNotice(int fd);
+	void OnKeepAlive(int fd);
+
+public:
+	int miIndex;
+	CNetEpollGroup *m_pGroup;
+	CNetEpoll moNetEpoll;
+	CNetSocket moListenSocket;
+	//ӦѶõİInitӵߵİƣ״̬̼߳乲
+	CNetPack *mpNetPack;
+	//ͳ
+	uint64 mui64AcceptCount;
+	uint64 mui64RecvCount;
+};
+
+class CNetEpollGroup : public sigslot::has_slots<>
+{
+	friend class CNetReactor;
+public:
+	CNetEpollGroup();
+	~CNetEpollGroup();
+
+	//aiReactorCount Ӧ(߳)Ϊ1ʱͬڵCNetEpoll
+	//ip port ΪֽaiMaxSocketSize ΪÿӦѵ
+	//ÿӦapPack->Clone()õԼİapPack֧Clone
+	bool Init(CNetPack *apPack, const char *ip, const short port,
+		unsigned int aiReactorCount = 1, unsigned int aiMaxSocketSize = DEF_EPOLL_SIZE);
+	//Ӧ̣߳ÿӦһ߳
+	bool Start(int aiEpollTimeOut = 100);
+	bool Destroy();
+
+	//ӵsocketָķӦ
+	bool Addfd(CNetSocket *apNetSocket, unsigned int aiReactor = 0);
+	bool Delfd(int fd);
+	bool Findfd(int fd);
+
+	//aiTypeCNetSocket::SendDataSEND_POLICY_COALESCE
+	bool SendData(int fd, const char* buffer, const int length, int aiType = 0);
+	bool SendAllData(const char* buffer, const int length, int aiType = 0);
+
+	void SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit);
+	//ӦѵͳۼӵaoStat
+	void GetSendQueueStat(STRU_SEND_QUEUE_STAT &aoStat);
+	//СͣͳʱɸӦ̵߳ʱ
+	void SetTimeOut(const STRU_NET_TIMEOUT &aoTimeOut);
+
+	unsigned int GetReactorCount(){ return miReactorCount; }
+	unsigned int GetConnectedSize();
+	void Dump();
+
+	static unsigned int ReactorThread(STRU_THREAD_CONTEXT& apContext);
+
+private:
+	//fdȡķӦ
+	CNetReactor* GetReactor(int fd);
+	void SetOwner(int fd, int aiReactor);
+
+public:
+	//հͳÿҪߵ·ֻһۣemitҲ
+	sigslot::single_signal3<int, char*, int> RecvFrom;
+	sigslot::single_signal1<int> OnErrorNotice;
+	sigslot::signal1<int> OnKeepAlive;
+
+private:
+	CNetReactor *mpReactor[DEF_MAX_REACTOR_COUNT];
+	unsigned int miReactorCount;
+	//fd -> Ӧţfd±ֱӷ
+	int8 *mpFdOwner;
+	unsigned int miFdOwnerSize;
+	int miEpollTimeOut;
+	//ߵİֻڹ㲥ʱһΣдͷԱҪmoPackSection
+	CNetPack *m_pNetPack;
+	CCriticalSection moPackSection;
+	CThreadGroup moThreadManager;
+};
+
+#endif //_NET_EPOLL_GROUP_H_
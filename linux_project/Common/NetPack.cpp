@@ -1,6 +1,40 @@
 #include "NetPack.h"
-#include "BaseEncrypt.h"
 #include "HttpClient.h"
+#include <pthread.h>
+
+//ÿ̵߳ûԿ棬ûIDֱӳ䣬ͻʱǾû
+//չõԿֻڱ߳ʹãü
+#define DEF_AES_CACHE_BITS 10
+#define DEF_AES_CACHE_SIZE (1 << DEF_AES_CACHE_BITS)
+
+struct STRU_AES_CACHE_ITEM{
+	uint64 mui64UserId;
+	bool mbValid;
+	CAESCipher moCipher;
+};
+
+struct STRU_AES_CACHE{
+	STRU_AES_CACHE(){
+		for(int i = 0; i < DEF_AES_CACHE_SIZE; ++i){
+			moItem[i].mui64UserId = 0;
+			moItem[i].mbValid = false;
+		}
+	}
+	STRU_AES_CACHE_ITEM moItem[DEF_AES_CACHE_SIZE];
+};
+
+static __thread STRU_AES_CACHE *gpAESCache = NULL;
+static pthread_key_t goAESCacheKey;
+static pthread_once_t goAESCacheOnce = PTHREAD_ONCE_INIT;
+
+//߳˳ʱͷű̵߳Ļ
+static void FreeAESCache(void *apCache){
+	delete (STRU_AES_CACHE*)apCache;
+}
+
+static void CreateAESCacheKey(){
+	pthread_key_create(&goAESCacheKey, FreeAESCache);
+}
 
 /*
 c_std_net_io: ׼recvsendio
@@ -12,6 +46,7 @@ public:
 	virtual void close(){}
 	virtual int  read(int ai_sock, void *ap_buf, int ai_num){ return recv(ai_sock, ap_buf, ai_num, 0);}	
 	virtual int  write(int ai_sock, const void *ap_buf, int ai_num){ return send(ai_sock, ap_buf, ai_num, 0); }
+	virtual int  writev(int ai_sock, const struct iovec *ap_iov, int ai_count){ return ::writev(ai_sock, ap_iov, ai_count); }
 			
 	virtual void release(){}
 };
@@ -30,6 +65,64 @@ i_net_io* CNetPack::create_clt_io(int ai_sock)
 	return &go_std_net_io;
 }
 
+//Ĭʵ֣ڲΪֱ
+int CNetPack::UnpackView(const char* in_buffer, const int in_length, 
+	const char* &out_buffer, int &out_buffer_length, int &out_data_length){
+	if(_unpack_buffer.size() < (size_t)_max_pack_size){
+		_unpack_buffer.resize(_max_pack_size);
+	}
+	out_buffer_length = _max_pack_size;
+	int ret = Unpack(in_buffer, in_length, &_unpack_buffer[0], out_buffer_length, out_data_length);
+	if(ret > 0){
+		out_buffer = _unpack_buffer.data();
+	}
+	return ret;
+}
+
+bool CNetPack::SetCompress(int aiType, int aiThreshold /* = DEF_COMPRESS_THRESHOLD */){
+	if(aiType != COMPRESS_NONE && !CNetCompress::IsSupport(aiType)){
+		TRACE(1, "CNetPack::SetCompress ֵ֧ѹ㷨type = "<<aiType);
+		return false;
+	}
+	_compress_type = aiType;
+	_compress_threshold = aiThreshold;
+	return true;
+}
+
+int CNetPack::CompressBody(const char* in_buffer, int in_length, char* out_buffer, int out_length){
+	if(COMPRESS_NONE == _compress_type || in_length < _compress_threshold || out_length <= 0 ||
+		0 == (_peer_compress & COMPRESS_ACCEPT_BIT(_compress_type))){
+		return 0;
+	}
+	CBaseCompress *lpCompress = CNetCompress::GetCompress(_compress_type);
+	if(NULL == lpCompress){
+		return 0;
+	}
+	//ȡԭĳȼ1ѹ󲻱ʱѹǰʧܣѹٱȽ
+	uint32 liLength = (uint32)(out_length < in_length ? out_length : in_length - 1);
+	if(!lpCompress->Compress(in_buffer, in_length, out_buffer, liLength)){
+		return 0;
+	}
+	return (int)liLength;
+}
+
+int CNetPack::DecompressBody(int aiType, const char* in_buffer, int in_length, char* out_buffer, int out_length){
+	CBaseCompress *lpCompress = CNetCompress::GetCompress(aiType);
+	if(NULL == lpCompress){
+		TRACE(1, "CNetPack::DecompressBody ֵ֧ѹ㷨type = "<<aiType);
+		return -1;
+	}
+	if(out_length <= 0){
+		return -1;
+	}
+	uint32 liLength = out_length;
+	if(!lpCompress->Decompress(in_buffer, in_length, out_buffer, liLength)){
+		TRACE(1, "CNetPack::DecompressBody ѹʧܡtype = "<<aiType<<" length = "<<in_length);
+		return -1;
+	}
+	return (int)liLength;
+}
+
 
 /************************************************************************/
 /*
@@ -67,15 +160,26 @@ CNetPackVersion1::~CNetPackVersion1(){
 int CNetPackVersion1::Pack(const char* in_buffer, const int in_length,
 	char* out_buffer, int &out_length){
 		try{
-			send_length = in_length;
+			if(_min_pack_size + in_length > out_length){
+				TRACE(1, "CNetPackVersion1::Pack 㡣length = "<<in_length<<" buffer = "<<out_length);
+				return -1;
+			}
+			//ȰѰѹȷȺдͷ
+			int liBodyLen = CompressBody(in_buffer, in_length, out_buffer+_min_pack_size, out_length-_min_pack_size);
+			send_compress = (liBodyLen > 0) ? _compress_type : COMPRESS_NONE;
+			if(0 == liBodyLen){
+				liBodyLen = in_length;
+			}
+			send_length = liBodyLen;
 			CStandardSerialize loSerialize(out_buffer,out_length, CStandardSerialize::STORE);
-			memset(out_buffer, 0, out_length);
+			memset(out_buffer, 0, _min_pack_size);
 			if(Serialize(loSerialize) == -1)
 				return -1;
 			else{
-
-				memcpy(out_buffer+_min_pack_size, in_buffer, in_length);
-				out_length = _min_pack_size + in_length;
+				if(COMPRESS_NONE == send_compress){
+					memcpy(out_buffer+_min_pack_size, in_buffer, in_length);
+				}
+				out_length = _min_pack_size + liBodyLen;
 			}
 			return 1;
 		}
@@ -93,8 +197,18 @@ int CNetPackVersion1::Unpack(const char* in_buffer, const int in_length,
 			}else{
 				if(CheckPack()){
 					if(in_length >= _min_pack_size + recv_length){
-						memcpy(out_buffer, in_buffer+_min_pack_size, recv_length);
-						out_buffer_length = recv_length;
+						if(recv_compress != COMPRESS_NONE){
+							//ѹout_buffer_lengthƽѹ
+							int liLen = DecompressBody(recv_compress, in_buffer+_min_pack_size, recv_length,
+								out_buffer, out_buffer_length);
+							if(liLen < 0){
+								return -1;
+							}
+							out_buffer_length = liLen;
+						}else{
+							memcpy(out_buffer, in_buffer+_min_pack_size, recv_length);
+							out_buffer_length = recv_length;
+						}
 						out_data_length = recv_length+_min_pack_size;
 					}else{
 						return 0;
@@ -110,6 +224,43 @@ int CNetPackVersion1::Unpack(const char* in_buffer, const int in_length,
 		}
 }
 
+int CNetPackVersion1::UnpackView(const char* in_buffer, const int in_length, 
+	const char* &out_buffer, int &out_buffer_length, int &out_data_length){
+		try{
+			CStandardSerialize loSerialize((char*)in_buffer,in_length, CStandardSerialize::LOAD);
+			if(Serialize(loSerialize) == -1){
+				return -1;
+			}
+			if(!CheckPack()){
+				return -1;
+			}
+			if(in_length < _min_pack_size + recv_length){
+				return 0;
+			}
+			//ѹֻܽѹڲ
+			if(recv_compress != COMPRESS_NONE){
+				if(_unpack_buffer.size() < (size_t)_max_pack_size){
+					_unpack_buffer.resize(_max_pack_size);
+				}
+				int liLen = DecompressBody(recv_compress, in_buffer+_min_pack_size, recv_length,
+					&_unpack_buffer[0], _unpack_buffer.size());
+				if(liLen < 0){
+					return -1;
+				}
+				out_buffer = _unpack_buffer.data();
+				out_buffer_length = liLen;
+			}else{
+				out_buffer = in_buffer+_min_pack_size;
+				out_buffer_length = recv_length;
+			}
+			out_data_length = recv_length+_min_pack_size;
+			return 1;
+		}
+		catch(...){
+			return -1;
+		}
+}
+
 int CNetPackVersion1::Serialize(CStandardSerialize &aoStandardSerialize){
 	try{
 		if(aoStandardSerialize.mbyType == CStandardSerialize::STORE){
@@ -118,7 +269,9 @@ int CNetPackVersion1::Serialize(CStandardSerialize &aoStandardSerialize){
 			aoStandardSerialize.Serialize(send_id);
 			aoStandardSerialize.Serialize(send_time);
 			aoStandardSerialize.Serialize(send_encry);
-			aoStandardSerialize.Serialize(send_compress);
+			//send_compressֻ¼㷨дͷʱϱ˵㷨
+			int liCompress = send_compress | (_accept_compress << COMPRESS_FLAG_ACCEPT_SHIFT);
+			aoStandardSerialize.Serialize(liCompress);
 			aoStandardSerialize.Serialize(send_error_code);
 			aoStandardSerialize.Serialize(send_length);
 		}
@@ -129,6 +282,8 @@ int CNetPackVersion1::Serialize(CStandardSerialize &aoStandardSerialize){
 			aoStandardSerialize.Serialize(recv_time);
 			aoStandardSerialize.Serialize(recv_encry);
 			aoStandardSerialize.Serialize(recv_compress);
+			_recv_accept = (recv_compress >> COMPRESS_FLAG_ACCEPT_SHIFT) & COMPRESS_ACCEPT_ALL;
+			recv_compress &= COMPRESS_FLAG_TYPE_MASK;
 			aoStandardSerialize.Serialize(recv_error_code);
 			aoStandardSerialize.Serialize(recv_length);
 		}
@@ -174,36 +329,46 @@ CNetPackVersion2::~CNetPackVersion2(){
 int CNetPackVersion2::Pack(const char* in_buffer, const int in_length, 
 	char* out_buffer, int &out_length){
 		try{
-			string strEncrypt = "";
+			if(send_encry == 2 && send_id == 0){
+				CNetPackVersion1 *p = NULL;
+				p->_max_pack_size = 0;
+				TRACE(1, "CNetPackVersion2::Pack send id = "<<send_id);
+				return -1;
+			}
+			//ֱдѹܰԭز0
+			unsigned char *lpBody = (unsigned char*)out_buffer + _min_pack_size;
+			int liSpare = out_length - _min_pack_size - ((send_encry == 2) ? AES_BLOCK_SIZE : 0);
+			int liDataLen = CompressBody(in_buffer, in_length, (char*)lpBody, liSpare);
+			send_extend1 = (liDataLen > 0) ? _compress_type : COMPRESS_NONE;
+			send_extend2 = liDataLen;
+			if(0 == liDataLen){
+				liDataLen = in_length;
+			}
+			int liBodyLen = liDataLen;
 			if(send_encry == 2){
-				if(send_id == 0){
-					CNetPackVersion1 *p = NULL;
-					p->_max_pack_size = 0;
-					TRACE(1, "CNetPackVersion2::Pack send id = "<<send_id);
-					return -1;
-				}
-				string strBuffer(in_buffer, in_length);
-				string strKey = GetEncryKey(send_id, 2);
-				CAESEncrypt aes_encrypt;
-
-				bool nRet = aes_encrypt.Encrypt(strBuffer, strKey, strEncrypt);
-				if(!nRet){
-					TRACE(1, "CNetPackVersion2::Pack ʧܡ");
-					return -1;
-				}
-			}else{
-				strEncrypt = string(in_buffer, in_length);
-				ASSERT(strEncrypt.size() == in_length);
+				liBodyLen = CAESCipher::AlignLength(liDataLen);
 			}
-			send_length = strEncrypt.size();
+			if(_min_pack_size + liBodyLen > out_length){
+				TRACE(1, "CNetPackVersion2::Pack 㡣length = "<<liBodyLen<<" buffer = "<<out_length);
+				return -1;
+			}
+			send_length = liBodyLen;
 			CStandardSerialize loSerialize(out_buffer,out_length, CStandardSerialize::STORE);
-			memset(out_buffer, 0, out_length);
+			memset(out_buffer, 0, _min_pack_size);
 			if(Serialize(loSerialize) == -1)
 				return -1;
-			else{
-				memcpy(out_buffer+_min_pack_size, strEncrypt.c_str(), strEncrypt.size());
-				out_length = _min_pack_size + strEncrypt.size();
+			if(COMPRESS_NONE == send_extend1){
+				memcpy(lpBody, in_buffer, in_length);
+			}
+			if(send_encry == 2){
+				memset(lpBody + liDataLen, 0, liBodyLen - liDataLen);
+				CAESCipher *lpCipher = GetCipher(send_id);
+				if(NULL == lpCipher || !lpCipher->Encrypt(lpBody, liBodyLen, lpBody)){
+					TRACE(1, "CNetPackVersion2::Pack ʧܡ");
+					return -1;
+				}
 			}
+			out_length = _min_pack_size + liBodyLen;
 			return 1;
 		}
 		catch (...){
@@ -221,22 +386,11 @@ int CNetPackVersion2::Unpack(const char* in_buffer, const int in_length,
 				if(CheckPack()){
 					if(in_length >= _min_pack_size + recv_length)
 					{
-						string strEncrypt = "";
-						//жǷҪ
-						if(recv_encry == 2){
-							string strBuffer(in_buffer+_min_pack_size, recv_length);
-							string strKey = GetEncryKey(recv_id, recv_encry);
-							CAESEncrypt aes_encrypt;
-							bool nRet = aes_encrypt.Decrypt(strBuffer, strKey, strEncrypt);
-							if(!nRet){
-								TRACE(1, "CNetPackVersion2::Unpack ʧܡ");
-								return -1;
-							}
-						}else{
-							strEncrypt = string((in_buffer+_min_pack_size), recv_length);
+						int liLen = DecodeBody(in_buffer + _min_pack_size, out_buffer, out_buffer_length);
+						if(liLen < 0){
+							return -1;
 						}
-						memcpy(out_buffer, strEncrypt.c_str(), strEncrypt.size());
-						out_buffer_length = strEncrypt.size();
+						out_buffer_length = liLen;
 						out_data_length = recv_length+_min_pack_size;
 					}else{
 						return 0;
@@ -253,6 +407,108 @@ int CNetPackVersion2::Unpack(const char* in_buffer, const int in_length,
 			return -1;
 		}
 }
+int CNetPackVersion2::UnpackView(const char* in_buffer, const int in_length, 
+	const char* &out_buffer, int &out_buffer_length, int &out_data_length){
+		try{
+			CStandardSerialize loSerialize((char*)in_buffer,in_length, CStandardSerialize::LOAD);
+			if(Serialize(loSerialize) == -1){
+				return -1;
+			}
+			if(!CheckPack()){
+				return -1;
+			}
+			if(in_length < _min_pack_size + recv_length){
+				return 0;
+			}
+			//ܻѹֻܽ⵽ڲİֱ
+			if(recv_encry == 2 || recv_extend1 != COMPRESS_NONE){
+				if(_unpack_buffer.size() < (size_t)_max_pack_size){
+					_unpack_buffer.resize(_max_pack_size);
+				}
+				int liLen = DecodeBody(in_buffer+_min_pack_size, &_unpack_buffer[0], _unpack_buffer.size());
+				if(liLen < 0){
+					return -1;
+				}
+				out_buffer = _unpack_buffer.data();
+				out_buffer_length = liLen;
+			}else{
+				out_buffer = in_buffer+_min_pack_size;
+				out_buffer_length = recv_length;
+			}
+			out_data_length = recv_length+_min_pack_size;
+			return 1;
+		}
+		catch(...){
+			TRACE(1, "CNetPackVersion2::UnpackView 쳣");
+			return -1;
+		}
+}
+int CNetPackVersion2::DecodeBody(const char* in_buffer, char* out_buffer, int out_length){
+	const char *lpData = in_buffer;
+	if(recv_encry == 2){
+		//ȼѹʱȽܵת
+		char *lpPlain = out_buffer;
+		if(recv_extend1 != COMPRESS_NONE){
+			if(_decrypt_buffer.size() < (size_t)recv_length){
+				_decrypt_buffer.resize(_max_pack_size > recv_length ? _max_pack_size : recv_length);
+			}
+			lpPlain = &_decrypt_buffer[0];
+		}else if(recv_length > out_length){
+			TRACE(1, "CNetPackVersion2::DecodeBody 㡣length = "<<recv_length);
+			return -1;
+		}
+		CAESCipher *lpCipher = GetCipher(recv_id);
+		if(NULL == lpCipher || !lpCipher->Decrypt((const unsigned char*)in_buffer, recv_length, (unsigned char*)lpPlain)){
+			TRACE(1, "CNetPackVersion2::DecodeBody ʧܡ");
+			return -1;
+		}
+		if(COMPRESS_NONE == recv_extend1){
+			return recv_length;
+		}
+		lpData = lpPlain;
+	}
+	if(COMPRESS_NONE == recv_extend1){
+		if(recv_length > out_length){
+			TRACE(1, "CNetPackVersion2::DecodeBody 㡣length = "<<recv_length);
+			return -1;
+		}
+		memcpy(out_buffer, lpData, recv_length);
+		return recv_length;
+	}
+	//extend2ǲ0֮ǰѹݳ
+	if(recv_extend2 <= 0 || recv_extend2 > recv_length){
+		TRACE(1, "CNetPackVersion2::DecodeBody ѹȴlength = "<<recv_extend2<<" body = "<<recv_length);
+		return -1;
+	}
+	return DecompressBody(recv_extend1, lpData, recv_extend2, out_buffer, out_length);
+}
+void CNetPackVersion2::MakeEncryKey(uint64_t user_id, unsigned char *key){
+	char lszUserId[24];
+	int liLen = snprintf(lszUserId, sizeof(lszUserId), "%llu", (unsigned long long)user_id);
+	char lszMd5[33];
+	CCommon::MakeMD5WithBuffer32((uint8_t*)lszUserId, liLen, (uint8_t*)lszMd5);
+	memcpy(key, lszMd5+7, DEF_AES_KEY_LEN);
+}
+CAESCipher* CNetPackVersion2::GetCipher(uint64_t user_id){
+	if(NULL == gpAESCache){
+		pthread_once(&goAESCacheOnce, CreateAESCacheKey);
+		gpAESCache = new STRU_AES_CACHE;
+		pthread_setspecific(goAESCacheKey, gpAESCache);
+	}
+	STRU_AES_CACHE_ITEM &loItem = gpAESCache->moItem[(user_id * 0x9E3779B97F4A7C15ULL) >> (64 - DEF_AES_CACHE_BITS)];
+	if(loItem.mbValid && loItem.mui64UserId == user_id){
+		return &loItem.moCipher;
+	}
+	unsigned char lszKey[DEF_AES_KEY_LEN];
+	MakeEncryKey(user_id, lszKey);
+	loItem.mui64UserId = user_id;
+	loItem.mbValid = loItem.moCipher.SetKey(lszKey);
+	if(!loItem.mbValid){
+		TRACE(1, "CNetPackVersion2::GetCipher Կչʧܡuser id = "<<user_id);
+		return NULL;
+	}
+	return &loItem.moCipher;
+}
 int CNetPackVersion2::Serialize(CStandardSerialize &aoStandardSerialize){
 	try{
 		if(aoStandardSerialize.mbyType ==  CStandardSerialize::STORE){
@@ -260,7 +516,8 @@ int CNetPackVersion2::Serialize(CStandardSerialize &aoStandardSerialize){
 			aoStandardSerialize.Serialize(send_version);
 			aoStandardSerialize.Serialize(send_length);
 			aoStandardSerialize.Serialize(send_encry);
-			aoStandardSerialize.Serialize(send_extend1);
+			int8 liExtend1 = (int8)(send_extend1 | (_accept_compress << COMPRESS_FLAG_ACCEPT_SHIFT));
+			aoStandardSerialize.Serialize(liExtend1);
 			aoStandardSerialize.Serialize(send_extend2);
 			aoStandardSerialize.Serialize(send_check_key);
 			aoStandardSerialize.Serialize(send_id);
@@ -271,6 +528,8 @@ int CNetPackVersion2::Serialize(CStandardSerialize &aoStandardSerialize){
 			aoStandardSerialize.Serialize(recv_length);
 			aoStandardSerialize.Serialize(recv_encry);
 			aoStandardSerialize.Serialize(recv_extend1);
+			_recv_accept = (recv_extend1 >> COMPRESS_FLAG_ACCEPT_SHIFT) & COMPRESS_ACCEPT_ALL;
+			recv_extend1 &= COMPRESS_FLAG_TYPE_MASK;
 			aoStandardSerialize.Serialize(recv_extend2);
 			aoStandardSerialize.Serialize(recv_check_key);
 			aoStandardSerialize.Serialize(recv_id);
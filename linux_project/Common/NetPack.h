@@ -10,8 +10,11 @@ purpose:	TCPЭ
 #ifndef _NET_PACK_H_
 #define _NET_PACK_H_
 
+#include <sys/uio.h>
 #include "include.h"
 #include "StandardSerialize.h"
+#include "BaseEncrypt.h"
+#include "NetCompress.h"
 
 #define DEF_NET_PACK_HEAD_PREFIX 0x99
 #define DEF_BUFFER_LEN (5*1024)
@@ -27,18 +30,41 @@ public:
 	virtual void close()=0;
 	virtual int  read(int ai_sock, void *ap_buf, int ai_num)=0;	
 	virtual int  write(int ai_sock, const void *ap_buf, int ai_num)=0;
+	//ۼдĬֻдһΣҪд
+	virtual int  writev(int ai_sock, const struct iovec *ap_iov, int ai_count){
+		if(ai_count <= 0){
+			return 0;
+		}
+		return write(ai_sock, ap_iov[0].iov_base, ap_iov[0].iov_len);
+	}
 		
 	virtual void release() =0;
 };
 
 class CNetPack{
 public:
-	CNetPack(){}
+	CNetPack(){
+		_compress_type = COMPRESS_NONE;
+		_compress_threshold = DEF_COMPRESS_THRESHOLD;
+		_accept_compress = CNetCompress::GetAcceptMask();
+		_peer_compress = 0;
+		_recv_accept = 0;
+	}
 	virtual ~CNetPack(){}
 	virtual bool CheckPack() = 0;
 	virtual int Pack(const char* in_buffer, const int in_length, char* out_buffer, int &out_length) = 0;
 	//0 Ȳ 1 һ -1 ʧ
 	virtual int Unpack(const char* in_buffer, const int in_length, char* out_buffer, int &out_buffer_length, int &out_data_length) = 0;
+	//壬out_bufferָݣֵͬUnpack
+	//Ҫתİֱָin_bufferڲָڲ´νǰЧ
+	virtual int UnpackView(const char* in_buffer, const int in_length, const char* &out_buffer, int &out_buffer_length, int &out_data_length);
+
+	//ѹ岻СaiThresholdѹȷʵʱѹԭ
+	//ǰͷѹ־ѹ޹أ˿ԸԾǷѹ
+	//ǷѹҪԶڰͷ㷨(_peer_compress)CNetSocket::GetPeerCompress
+	bool SetCompress(int aiType, int aiThreshold = DEF_COMPRESS_THRESHOLD);
+	//һͬİ󣬽״̬ڳԱ̸߳һݣ֧ʱNULL
+	virtual CNetPack* Clone(){ return NULL; }
 	
 public:
 	//IO
@@ -49,6 +75,23 @@ public:
 public:
 	int _min_pack_size;
 	int _max_pack_size;
+	int _compress_type;
+	int _compress_threshold;
+	//ܽѹ㷨룬ÿڰͷ߶ԶˣĬΪȫ㷨
+	int _accept_compress;
+	//PackǰɵдԶ˵㷨룬ûжӦλʱԭģĬ0ѹ
+	int _peer_compress;
+	//һνİͷԶ㷨
+	int _recv_accept;
+
+protected:
+	//ѹ嵽out_bufferѹĳȣҪѹѹ󲻱̷0
+	int CompressBody(const char* in_buffer, int in_length, char* out_buffer, int out_length);
+	//ؽѹĳȣʧܷ-1
+	int DecompressBody(int aiType, const char* in_buffer, int in_length, char* out_buffer, int out_length);
+
+	//UnpackView޷ֱʱʹõĻ
+	string _unpack_buffer;
 };
 
 class CNetPackVersion1 : public CNetPack{
@@ -58,6 +101,8 @@ public:
 
 	int Pack(const char* in_buffer, const int in_length, char* out_buffer, int &out_length);
 	int Unpack(const char* in_buffer, const int in_length, char* out_buffer, int &out_buffer_length, int &out_data_length);
+	int UnpackView(const char* in_buffer, const int in_length, const char* &out_buffer, int &out_buffer_length, int &out_data_length);
+	CNetPack* Clone(){ return new CNetPackVersion1(*this); }
 
 	bool CheckPack(){
 		if((recv_flag == send_flag) && 
@@ -81,6 +126,7 @@ public:
 	int send_id;
 	int send_time;
 	int send_encry;
+	//PackʱʵдѹʱΪ㷨Ϊ0дͷʱλ_accept_compress
 	int send_compress;
 	int send_error_code;
 	int send_length;
@@ -103,6 +149,8 @@ public:
 
 	int Pack(const char* in_buffer, const int in_length, char* out_buffer, int &out_length);
 	int Unpack(const char* in_buffer, const int in_length, char* out_buffer, int &out_buffer_length, int &out_data_length);
+	int UnpackView(const char* in_buffer, const int in_length, const char* &out_buffer, int &out_buffer_length, int &out_data_length);
+	CNetPack* Clone(){ return new CNetPackVersion2(*this); }
 
 	bool CheckPack(){
 		if((recv_flag == send_flag) && 
@@ -119,19 +167,12 @@ public:
 
 private:
 	int Serialize(CStandardSerialize &aoStandardSerialize);
-	string GetEncryKey(uint64_t user_id, uint32_t encry_type){
-		stringstream  strStream;
-		strStream<<user_id;
-		string strUserId = "";
-		strStream>>strUserId;
-		char strMd5[33];
-		memset(strMd5, 0, 33);
-		CCommon::MakeMD5WithBuffer32((uint8_t*)strUserId.c_str(), strUserId.length(), (uint8_t*)strMd5);
-		char strEncryKey[17];
-		memset(strEncryKey, 0, 17);
-		memcpy(strEncryKey, strMd5+7, 16);
-		return strEncryKey;
-	}
+	//ͷܡѹ嵽out_bufferذ峤ȣʧܷ-1
+	int DecodeBody(const char* in_buffer, char* out_buffer, int out_length);
+	//ûԿûIDʮƴMD5(32λСд)7λ16ַ
+	static void MakeEncryKey(uint64_t user_id, unsigned char *key);
+	//ȡǰ̻߳ûԿģδʱɲչԿʧܷNULL
+	static CAESCipher* GetCipher(uint64_t user_id);
 
 public:
 	//ͷ
@@ -139,6 +180,7 @@ public:
 	int16 send_version;
 	int16 send_length;
 	int8 send_encry;
+	//Packʱдextend1Ϊѹ㷨(0δѹдͷʱλ_accept_compress)extend2Ϊѹݳ(ܲ0֮ǰ)
 	int8 send_extend1;
 	int16 send_extend2;
 	int32 send_check_key;
@@ -153,6 +195,10 @@ public:
 	int16 recv_extend2;
 	int32 recv_check_key;
 	int64 recv_id;
+
+private:
+	//ȼѹİȽܵٽѹ
+	string _decrypt_buffer;
 };
 
 #endif //_NET_PACK_H_
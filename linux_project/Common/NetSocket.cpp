@@ -11,16 +11,19 @@ purpose:	TCPЭ
 
 CNetSocket::CNetSocket(){
 	miSocket = -1;
-	memset(mszResendBuffer, 0, SEND_CATCH_LEN);
-	miResendLength = 0;
+	miSendOffset = 0;
+	miSendQueueBytes = 0;
+	mui64SendDropCount = 0;
 	memset(mszRecvCache, 0, RECV_CATCH_LEN);
 	miRecvCacheLength = 0;
+	miRecvReadPos = 0;
 	mbCanSend = true;
 	moNetStat = COMMON_TCP_CLOSED;
 	mbListenSocket = false;
 	mbClientSocket = false;
 	m_pNetPack = NULL;
 	mp_net_io = NULL;
+	miPeerCompress = 0;
 }
 CNetSocket::~CNetSocket(){
 	Close();
@@ -34,7 +37,7 @@ bool CNetSocket::CreateSocket(void){
 	}
 	return true;
 }
-bool CNetSocket::CreateSocket(const char* ip, const short port){
+bool CNetSocket::CreateSocket(const char* ip, const short port, bool abReusePort /* = false */){
 	miSocket = socket(AF_INET, SOCK_STREAM, 0);
 	int err = errno;
 	if (miSocket < 0){
@@ -47,6 +50,24 @@ bool CNetSocket::CreateSocket(const char* ip, const short port){
 	setsockopt(miSocket, SOL_SOCKET, SO_REUSEADDR, (void*)(&(iReuseAddr))
 		, sizeof(iReuseAddr));
 
+	//ö˿ڸ
+	if(abReusePort){
+#ifdef SO_REUSEPORT
+		int iReusePort = 1;
+		if(setsockopt(miSocket, SOL_SOCKET, SO_REUSEPORT, (void*)(&(iReusePort))
+			, sizeof(iReusePort)) < 0){
+			err = errno;
+			TRACE(1, "CNetSocket::CreateSocket SO_REUSEPORT ʧܡerrno = "<<err);
+			close(miSocket);
+			return false;
+		}
+#else
+		TRACE(1, "CNetSocket::CreateSocket ϵͳ֧SO_REUSEPORT");
+		close(miSocket);
+		return false;
+#endif
+	}
+
 	struct sockaddr_in stAddr;
 	stAddr.sin_family = AF_INET;
 
@@ -69,22 +90,22 @@ bool CNetSocket::CreateSocket(const char* ip, const short port){
 	return true;
 }
 bool CNetSocket::Close(int flag /* = 2 */){
-	//ͻ
-	memset(mszResendBuffer, 0, SEND_CATCH_LEN);
-	miResendLength = 0;
 	//Ͷ
 	CAutoLock send_lock(moSendSection);
-	STRU_NET_DATA_INFO loNetDataInfo;
-	while(moSendList.PopFront(loNetDataInfo)){
-		delete loNetDataInfo.buffer;
-		loNetDataInfo.buffer = NULL;
-		loNetDataInfo.length = 0;
+	while(!moSendQueue.empty()){
+		moSendQueue.front()->Release();
+		moSendQueue.pop_front();
 	}
+	miSendOffset = 0;
+	miSendQueueBytes = 0;
 	//ջ
 	memset(mszRecvCache, 0,  RECV_CATCH_LEN);
 	miRecvCacheLength = 0;
+	miRecvReadPos = 0;
+	miPeerCompress = 0;
 	//ն
 	CAutoLock recv_lock(moRecvSection);
+	STRU_NET_DATA_INFO loNetDataInfo;
 	while(moRecvList.PopFront(loNetDataInfo)){
 		delete loNetDataInfo.buffer;
 		loNetDataInfo.buffer = NULL;
@@ -232,67 +253,121 @@ int CNetSocket::SetTcpSockKeepAlive(int nKeepAlive, int nKeepIdle, int nKeepInte
 	}
 	return 0;
 }
-int CNetSocket::SendData(const char* buffer, const int length){
-	ASSERT(NULL != m_pNetPack);
-
-	char lszSendBuffer[m_pNetPack->_max_pack_size];
-	memset(lszSendBuffer, 0, m_pNetPack->_max_pack_size);
-	int liSendLen = m_pNetPack->_max_pack_size;
-	int nRet = m_pNetPack->Pack(buffer, length, lszSendBuffer, liSendLen);
-	if(nRet<0){
-		TRACE(1, "CNetSocket::SendData ʧܡfd = "<<miSocket<<" ret = "<<nRet);
-		return -1;
+CNetChunk* CNetSocket::PackChunk(CNetPack *apPack, const char* buffer, const int length, int aiType, int aiPeerCompress){
+	ASSERT(NULL != apPack);
+	CNetChunk *lpChunk = CNetChunk::Alloc(apPack->_max_pack_size);
+	if(NULL == lpChunk){
+		return NULL;
 	}
-
-	CAutoLock lock(moSendSection);
-	if(((liSendLen + miResendLength) <= DEF_SOCKET_CATCH_LEN) && moSendList.IsEmpty()){
-		memcpy(mszResendBuffer+miResendLength, lszSendBuffer, liSendLen);
-		miResendLength += liSendLen;
-	}else{
-		STRU_NET_DATA_INFO struNetDataInfo;
-		struNetDataInfo.buffer =  new char[liSendLen];
-		memset(struNetDataInfo.buffer, 0, liSendLen);
-		memcpy(struNetDataInfo.buffer, lszSendBuffer, liSendLen);
-		struNetDataInfo.length = liSendLen;
-		moSendList.PushBack(struNetDataInfo);
+	int liSendLen = lpChunk->GetCapacity();
+	apPack->_peer_compress = aiPeerCompress;
+	int nRet = apPack->Pack(buffer, length, lpChunk->GetBuffer(), liSendLen);
+	if(nRet<0){
+		TRACE(1, "CNetSocket::PackChunk ʧܡret = "<<nRet);
+		lpChunk->Release();
+		return NULL;
 	}
-	return 1;
+	lpChunk->miLength = liSendLen;
+	lpChunk->miType = aiType;
+	return lpChunk;
 }
+
 /************************************************************************
 ֵ 
-1   ȴ´¼֪ͨ  Ҫsocket
-0   
--1  ӳ⣬ҪϿ
+1   뷢Ͷ
+0   Ͷг޶ݱ
+-1  Ͷг޶ҪϿ
+-2  ʧ
 ************************************************************************/
-int CNetSocket::SendCacheData(){
-	if(miResendLength != 0){
-		int nRet = 0;
-		nRet = _SendData(mszResendBuffer, miResendLength);
-		if(nRet == 0){
-			mbCanSend = false;
-			return 1;
+int CNetSocket::SendData(const char* buffer, const int length, int aiType){
+	ASSERT(NULL != m_pNetPack);
+
+	CNetChunk *lpChunk = PackChunk(m_pNetPack, buffer, length, aiType, miPeerCompress);
+	if(NULL == lpChunk){
+		TRACE(1, "CNetSocket::SendData ʧܡfd = "<<miSocket);
+		return -2;
+	}
+	int nRet = SendChunk(lpChunk);
+	lpChunk->Release();
+	return nRet;
+}
+
+//ֵͬSendData(buffer, length)
+int CNetSocket::SendChunk(CNetChunk *apChunk){
+	ASSERT(NULL != apChunk);
+	CAutoLock lock(moSendSection);
+	if(IsSendQueueFull(apChunk->miLength)){
+		if(SEND_POLICY_DISCONNECT == moSendQueueLimit.moPolicy){
+			TRACE(1, "CNetSocket::SendChunk ͶϿӡfd = "<<miSocket
+				<<" bytes = "<<miSendQueueBytes<<" count = "<<moSendQueue.size());
+			return -1;
 		}
+		int nRet = MakeSendQueueRoom(apChunk);
 		if(nRet < 0){
-			TRACE(1, "CNetSocket::SendCacheData 쳣1nRet = "<<nRet<<" miResendLength = "<<miResendLength);
-			return -1;
+			++mui64SendDropCount;
+			TRACE(3, "CNetSocket::SendChunk Ͷݡfd = "<<miSocket
+				<<" bytes = "<<miSendQueueBytes<<" count = "<<moSendQueue.size());
+			return 0;
 		}
-		if((nRet < miResendLength) && (nRet > 0)){
-			miResendLength -= nRet;
-			ASSERT(miResendLength > 0);
-			memmove(mszResendBuffer, mszResendBuffer+nRet, miResendLength+1);
-			mbCanSend = false;
+		//ͺϲʱѾ滻
+		if(nRet > 0){
 			return 1;
 		}
+	}
+	apChunk->AddRef();
+	moSendQueue.push_back(apChunk);
+	miSendQueueBytes += apChunk->miLength;
+	return 1;
+}
 
-		if(nRet > miResendLength){
-			mbCanSend = false;
-			TRACE(1, "CNetSocket::SendCacheData 쳣2nRet = "<<nRet<<" miResendLength = "<<miResendLength);
-			return -1;
+void CNetSocket::SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit){
+	CAutoLock lock(moSendSection);
+	moSendQueueLimit = aoLimit;
+}
+
+bool CNetSocket::IsSendQueueFull(int aiLength){
+	if(moSendQueueLimit.miMaxBytes > 0 && miSendQueueBytes + aiLength > moSendQueueLimit.miMaxBytes){
+		return true;
+	}
+	if(moSendQueueLimit.miMaxCount > 0 && (int)moSendQueue.size() >= moSendQueueLimit.miMaxCount){
+		return true;
+	}
+	return false;
+}
+
+int CNetSocket::MakeSendQueueRoom(CNetChunk *apChunk){
+	//ͷѷһʱܶ
+	size_t liFirst = (miSendOffset > 0) ? 1 : 0;
+	if(SEND_POLICY_COALESCE == moSendQueueLimit.moPolicy && apChunk->miType != 0){
+		for(size_t i = liFirst; i < moSendQueue.size(); ++i){
+			CNetChunk *lpOld = moSendQueue[i];
+			if(lpOld->miType != apChunk->miType){
+				continue;
+			}
+			if(miSendQueueBytes - lpOld->miLength + apChunk->miLength > moSendQueueLimit.miMaxBytes
+				&& moSendQueueLimit.miMaxBytes > 0){
+				break;
+			}
+			apChunk->AddRef();
+			moSendQueue[i] = apChunk;
+			miSendQueueBytes += apChunk->miLength - lpOld->miLength;
+			lpOld->Release();
+			++mui64SendDropCount;
+			return 1;
 		}
 	}
-	miResendLength = 0;
-	memset(mszResendBuffer, 0, SEND_CATCH_LEN);
-	return 0;
+	if(SEND_POLICY_DROP_OLDEST != moSendQueueLimit.moPolicy
+		&& SEND_POLICY_COALESCE != moSendQueueLimit.moPolicy){
+		return -1;
+	}
+	while(IsSendQueueFull(apChunk->miLength) && moSendQueue.size() > liFirst){
+		std::deque<CNetChunk*>::iterator iter = moSendQueue.begin() + liFirst;
+		miSendQueueBytes -= (*iter)->miLength;
+		(*iter)->Release();
+		moSendQueue.erase(iter);
+		++mui64SendDropCount;
+	}
+	return IsSendQueueFull(apChunk->miLength) ? -1 : 0;
 }
 
 /************************************************************************
@@ -309,42 +384,47 @@ int CNetSocket::SendData(){
 	}
 
 	CAutoLock lock(moSendSection);
-	if(0 == miResendLength && moSendList.IsEmpty()){
+	if(moSendQueue.empty()){
 		return 2;
 	}
-	int nSendCacheRtn = SendCacheData();
-	if(0 != nSendCacheRtn){
-		return nSendCacheRtn;
-	}
-	STRU_NET_DATA_INFO loNetDataInfo;
-	//ݷϾwhile
-	while(moSendList.TryPop(loNetDataInfo)){
-		if(miResendLength + loNetDataInfo.length <= DEF_SOCKET_CATCH_LEN){
-			STRU_NET_DATA_INFO info;
-			moSendList.PopFront(info);
-
-			ASSERT(info.length == loNetDataInfo.length);
-			ASSERT(info.buffer == loNetDataInfo.buffer);
+	struct iovec loIov[DEF_SEND_IOV_COUNT];
+	while(!moSendQueue.empty()){
+		//еݿһwritevύ
+		int liCount = 0;
+		int liTotal = 0;
+		std::deque<CNetChunk*>::iterator iter = moSendQueue.begin();
+		for(; iter != moSendQueue.end() && liCount < DEF_SEND_IOV_COUNT; ++iter, ++liCount){
+			CNetChunk *lpChunk = *iter;
+			int liOffset = (0 == liCount) ? miSendOffset : 0;
+			loIov[liCount].iov_base = lpChunk->GetBuffer() + liOffset;
+			loIov[liCount].iov_len = lpChunk->miLength - liOffset;
+			liTotal += lpChunk->miLength - liOffset;
+		}
 
-			memcpy(mszResendBuffer+miResendLength, loNetDataInfo.buffer, loNetDataInfo.length);
-			miResendLength += loNetDataInfo.length;
+		int nRet = _SendData(loIov, liCount);
+		if(nRet < 0){
+			TRACE(1,"CNetSocket::SendData socket ݡfd : "<<miSocket);
+			return -1;
+		}
+		if(nRet == 0){
+			mbCanSend = false;
+			return 1;
+		}
 
-			delete [] loNetDataInfo.buffer;
-			loNetDataInfo.buffer = NULL;
-			loNetDataInfo.length = 0;
-		}else{
-			int liReSendCache = SendCacheData();
-			if(0 != liReSendCache){
-				TRACE(1,"CNetSocket::SendData socket 1fd : "<<miSocket);
-				return liReSendCache;
-			}
+		//ͷѷݿ
+		int liSent = nRet + miSendOffset;
+		while(!moSendQueue.empty() && liSent >= moSendQueue.front()->miLength){
+			liSent -= moSendQueue.front()->miLength;
+			miSendQueueBytes -= moSendQueue.front()->miLength;
+			moSendQueue.front()->Release();
+			moSendQueue.pop_front();
 		}
-	}
+		miSendOffset = liSent;
 
-	int iRtn = SendCacheData();
-	if(0 != iRtn){
-		TRACE(1,"CNetSocket::SendData socket 2fd : "<<miSocket);
-		return iRtn;
+		if(nRet < liTotal){
+			mbCanSend = false;
+			return 1;
+		}
 	}
 	return 0;
 }
@@ -355,9 +435,9 @@ int CNetSocket::SendData(){
 0    Ҫȴ´֪ͨ
 -1  ӳ쳣
 ************************************************************************/
-int CNetSocket::_SendData(const char* buffer, const int length)
+int CNetSocket::_SendData(const struct iovec *apIov, const int aiCount)
 {	
-	int nRet =mp_net_io->write(miSocket, buffer, length);	
+	int nRet =mp_net_io->writev(miSocket, apIov, aiCount);	
 	int err = errno;
 	if(nRet > 0){
 		return nRet;
@@ -411,6 +491,7 @@ bool CNetSocket::RecvData(){
 
 				int ret = m_pNetPack->Unpack((const char*)mszRecvCache, (const int)miRecvCacheLength, lszRecvBuffer, liRecvBufferLen, liRecvDataLen);
 				if(ret > 0){
+					miPeerCompress = m_pNetPack->_recv_accept;
 					STRU_NET_DATA_INFO loNetDataInfo;
 					char *lpBuffer = new char[liRecvBufferLen+1];
 					memset(lpBuffer, 0, liRecvBufferLen+1);
@@ -448,6 +529,75 @@ bool CNetSocket::RecvData(){
 	TRACE(1,"CNetSocket::RecvData return recv errno : "<<err<<" fd = "<<miSocket);
 	return false;
 }
+int CNetSocket::RecvDataView(std::vector<STRU_RECV_VIEW> &aoView, std::vector<char> &aoCopy){
+	int err = 0;
+
+	CAutoLock lock(moRecvSection);
+	//ϴνİѾ꣬ʱܻջ
+	if(miRecvReadPos == miRecvCacheLength){
+		miRecvReadPos = 0;
+		miRecvCacheLength = 0;
+	}else if(miRecvReadPos > 0 && (RECV_CATCH_LEN-1-miRecvCacheLength) < DEF_SOCKET_CATCH_LEN){
+		miRecvCacheLength -= miRecvReadPos;
+		memmove(mszRecvCache, mszRecvCache+miRecvReadPos, miRecvCacheLength);
+		miRecvReadPos = 0;
+	}
+	while(moNetStat == COMMON_TCP_ESTABLISHED || moNetStat == COMMON_TCP_CONNECTED){
+		int liSpace = RECV_CATCH_LEN-1-miRecvCacheLength;
+		//βռ䲻һζȡνİ廹Ż棬Ƚ
+		if(miRecvReadPos > 0 && liSpace < DEF_SOCKET_CATCH_LEN){
+			return 1;
+		}
+		int nRet = mp_net_io->read(miSocket, mszRecvCache+miRecvCacheLength, liSpace);
+		err = errno;
+		if(nRet > 0){
+			miRecvCacheLength += nRet;
+
+			while ((miRecvCacheLength-miRecvReadPos) > m_pNetPack->_min_pack_size){
+				const char *lpRecvBuffer = NULL;
+				int liRecvBufferLen = 0;
+				int liRecvDataLen = 0;
+
+				int ret = m_pNetPack->UnpackView(mszRecvCache+miRecvReadPos, miRecvCacheLength-miRecvReadPos,
+					lpRecvBuffer, liRecvBufferLen, liRecvDataLen);
+				if(ret > 0){
+					miPeerCompress = m_pNetPack->_recv_accept;
+					STRU_RECV_VIEW loView;
+					loView.miLength = liRecvBufferLen;
+					if(lpRecvBuffer >= mszRecvCache && lpRecvBuffer < mszRecvCache+RECV_CATCH_LEN){
+						loView.mbCopy = false;
+						loView.miOffset = (int)(lpRecvBuffer - mszRecvCache);
+					}else{
+						//ڲĻ´νͱǣƳ
+						loView.mbCopy = true;
+						loView.miOffset = (int)aoCopy.size();
+						aoCopy.insert(aoCopy.end(), lpRecvBuffer, lpRecvBuffer+liRecvBufferLen);
+					}
+					aoView.push_back(loView);
+					miRecvReadPos += liRecvDataLen;
+				}else if(ret == 0){
+					break;
+				} else {
+					TRACE(1, "CNetSocket::RecvDataView ʧܡret = "<<ret);
+					return -1;
+				}
+			}
+
+			if(nRet >= liSpace){
+				continue;
+			}else{
+				return 0;
+			}
+		}else if (nRet == 0 ){
+			TRACE(1,"CNetSocket::RecvDataView recv errno : "<<err<<" fd = "<<miSocket);
+			return -1;
+		}else if((nRet < 0) && (errno != ECONNRESET)){
+			return 0;
+		}
+	}
+	TRACE(1,"CNetSocket::RecvDataView return recv errno : "<<err<<" fd = "<<miSocket);
+	return -1;
+}
 
 
 
@@ -13,12 +13,20 @@
 #include "include.h"
 #include "CriticalSection.h"
 #include "NetPack.h"
+#include "NetChunk.h"
+#include "TimingWheel.h"
 #include "list.h"
+#include "sigslot.h"
+#include <deque>
 
 #define DEF_LOCAL_ADDR "127.0.0.1"
 #define DEF_SOCKET_CATCH_LEN (10*1024)
 #define RECV_CATCH_LEN (DEF_SOCKET_CATCH_LEN+DEF_BUFFER_LEN+1)
-#define SEND_CATCH_LEN (DEF_SOCKET_CATCH_LEN+1)
+//һwritevύݿ
+#define DEF_SEND_IOV_COUNT 64
+//ÿӷͶеĬ޶
+#define DEF_SEND_QUEUE_MAX_BYTES (4*1024*1024)
+#define DEF_SEND_QUEUE_MAX_COUNT 8192
 
 class STRU_NET_DATA_INFO{
 public:
@@ -61,6 +69,49 @@ enum NET_STAT{
 	COMMON_TCP_CLOSED
 };
 
+//Ͷг޶ʱĴ
+enum SEND_QUEUE_POLICY{
+	//
+	SEND_POLICY_DROP_NEWEST = 0,
+	//(ѷһֵĳ)
+	SEND_POLICY_DROP_OLDEST,
+	//Ͽ
+	SEND_POLICY_DISCONNECT,
+	//滻ͬ(SendDataaiType)ݣûͬʱ
+	SEND_POLICY_COALESCE
+};
+
+//㿽սһ壬ʱŻָ
+struct STRU_RECV_VIEW{
+	//true 徭ܻѹڵ߸ĸfalse ӵĽջ
+	bool mbCopy;
+	int miOffset;
+	int miLength;
+};
+
+//ϵĶʱCNetEpollʱ
+enum NET_TIMER_TYPE{
+	//ʱûյݣϿ
+	NET_TIMER_IDLE = 0,
+	//ʱûյݣ֪ͨӦ÷
+	NET_TIMER_KEEPALIVE,
+	//ͶгʱûнչϿ
+	NET_TIMER_SEND_STALL,
+	NET_TIMER_COUNT
+};
+
+//Ͷ޶0ʾ
+struct STRU_SEND_QUEUE_LIMIT{
+	STRU_SEND_QUEUE_LIMIT(){
+		miMaxBytes = DEF_SEND_QUEUE_MAX_BYTES;
+		miMaxCount = DEF_SEND_QUEUE_MAX_COUNT;
+		moPolicy = SEND_POLICY_DROP_NEWEST;
+	}
+	int miMaxBytes;
+	int miMaxCount;
+	SEND_QUEUE_POLICY moPolicy;
+};
+
 class CNetSocket
 {
 public:
@@ -68,6 +119,7 @@ public:
 	CNetSocket(CNetPack *pack){
 		ASSERT(pack != NULL);
 		m_pNetPack = pack;
+		miPeerCompress = 0;
 	}
 	~CNetSocket();
 
@@ -85,7 +137,8 @@ public:
 
 	//socket󶨵ָ˿
 	//Ϊֽ
-	bool CreateSocket(const char* ip, const short port);
+	//abReusePortΪtrueʱSO_REUSEPORTsocket԰ͬһ˿ڣں˷ַ
+	bool CreateSocket(const char* ip, const short port, bool abReusePort = false);
 	//socketҪ
 	bool CreateSocket(void);
 	//ر׽֣Դ
@@ -99,15 +152,39 @@ public:
 	//ACCEPT ip  portΪֽ
 	int Accept(unsigned int &ip, unsigned short &port);
 	bool SetNoBlock();
-	int SendData(const char* buffer, const int length);
+	//aiTypeΪϢͣSEND_POLICY_COALESCEʱ滻ͬ͵ľݣ0ʾϲ
+	//ֻöԶ㷨ѹGetPeerCompress
+	int SendData(const char* buffer, const int length, int aiType = 0);
+	//ѴðݿҵͶУһãɶӹ
+	int SendChunk(CNetChunk *apChunk);
+	void SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit);
+	//Ͷ
+	int GetSendQueueBytes(){ return miSendQueueBytes; }
+	int GetSendQueueCount(){ return (int)moSendQueue.size(); }
+	uint64 GetSendDropCount(){ return mui64SendDropCount; }
+	//Զڰͷܽѹ㷨룬յԶ˵İ֮ǰΪ0İѹ
+	int GetPeerCompress(){ return miPeerCompress; }
+	bool CanCompress(int aiType){ return aiType != COMPRESS_NONE && 0 != (miPeerCompress & COMPRESS_ACCEPT_BIT(aiType)); }
 	int SendData();
+	//ݴ·ݿ飬ͷֱдݿ飬ʧܷNULL
+	//aiPeerCompressΪշ㷨룬Ƿѹ
+	static CNetChunk* PackChunk(CNetPack *apPack, const char* buffer, const int length, int aiType = 0, int aiPeerCompress = 0);
 	bool RecvData(char* buffer, int &length);
 	bool RecvData();
+	//㿽գֱӶջ棬İǵaoViewص
+	//ڽջİ(ܻѹ)׷ӵaoCopy
+	//´εǰ治aoViewһֱЧ߿ͷٽ
+	// 0 Ѷ 1 ҪӦٵ -1 ӳ
+	int RecvDataView(std::vector<STRU_RECV_VIEW> &aoView, std::vector<char> &aoCopy);
+	char* GetRecvCache(){ return mszRecvCache; }
 	const int GetSocket(){ return miSocket; }
 
 private:
-	int _SendData(const char* buffer, const int length);
-	int SendCacheData(void);
+	int _SendData(const struct iovec *apIov, const int aiCount);
+	bool IsSendQueueFull(int aiLength);
+	//ڳͶпռ
+	// 1 滻ͬ 0 ڳռ -1 ڲռ
+	int MakeSendQueueRoom(CNetChunk *apChunk);
 	//nKeepAlive-Ƿ
 	//nKeepIdle-೤ʱշ, ̽
 	//nKeepInterval-̽ⷢʱ
@@ -124,16 +201,28 @@ public:
 	CNetPack *m_pNetPack;	
 	//ioӿ
 	i_net_io *mp_net_io;
+	//NET_TIMER_TYPE
+	STRU_TIMER_NODE moTimer[NET_TIMER_COUNT];
 
 private:
-	char mszResendBuffer[SEND_CATCH_LEN];
 	CCriticalSection moSendSection;
 	CCriticalSection moRecvSection;
-	int miResendLength;
-	_List<STRU_NET_DATA_INFO> moSendList;
+	//ͶУͷݿѷmiSendOffsetֽ
+	std::deque<CNetChunk*> moSendQueue;
+	int miSendOffset;
+	//ݿֽ
+	int miSendQueueBytes;
+	STRU_SEND_QUEUE_LIMIT moSendQueueLimit;
+	uint64 mui64SendDropCount;
 	_List<STRU_NET_DATA_INFO> moRecvList;
+	//ջ棬[miRecvReadPos, miRecvCacheLength)Ϊδ
+	//βռ䲻һζȡʱŰδݰᵽͷ
+	//Իǻλ棺ڻģԭؽô
 	char mszRecvCache[RECV_CATCH_LEN];
 	int miRecvCacheLength;
+	int miRecvReadPos;
+	//ÿһһΣ߳д̶߳
+	volatile int miPeerCompress;
 };
 #endif //_NET_SOCKET_H_
 
@@ -2,11 +2,65 @@
 #define _DEF_SINA_POOL_H_
 
 #include "include.h"
-#include "SafeList.h"
+#include <sys/syscall.h>
 
+//ÿϻĶ
+#define DEF_POOL_MAGAZINE_SIZE 32
+//NUMAزֿ༸ڵųʱȡģ
+#define DEF_POOL_MAX_NODE 4
+
+//ȡǰ߳ڵNUMAڵ㣬ȡ0
+inline int GetCurrentNumaNode()
+{
+#ifdef SYS_getcpu
+	unsigned int liCpu = 0;
+	unsigned int liNode = 0;
+	if(0 == syscall(SYS_getcpu, &liCpu, &liNode, NULL))
+	{
+		return (int)liNode;
+	}
+#endif
+	return 0;
+}
+
+//
+//ÿ̳߳ϻ(ǰ)ͷֻڱ̵߳ĵϻϽУ
+//ϻ()ʱϻغͲֿ⽻ֿ̯ÿֻ1/DEF_POOL_MAGAZINE_SIZEΡ
+//NUMAز̶ֿ̹߳ʹһηʱڽڵĲֿ⡣
 template< class PooledType >
 class CPool
 {
+	//ϻ
+	struct STRU_POOL_MAGAZINE
+	{
+		int miCount;
+		STRU_POOL_MAGAZINE *mpNext;
+		PooledType *mpObject[DEF_POOL_MAGAZINE_SIZE];
+	};
+
+	//ֿ⣬ϻͿյϻ
+	struct STRU_POOL_DEPOT
+	{
+		CCriticalSection moSection;
+		STRU_POOL_MAGAZINE *mpFull;
+		STRU_POOL_MAGAZINE *mpEmpty;
+		//ϻĶ
+		int miObjectCount;
+	};
+
+	//̻߳棬pthread_key߳
+	struct STRU_POOL_CACHE
+	{
+		CPool *mpPool;
+		STRU_POOL_MAGAZINE *mpLoaded;
+		STRU_POOL_MAGAZINE *mpPrevious;
+		STRU_POOL_DEPOT *mpDepot;
+		//ֻɱ߳޸ģDumpʱǽֵ
+		uint64 mui64Hit;
+		uint64 mui64Miss;
+		STRU_POOL_CACHE *mpNext;
+	};
+
 public:
 	//ӻз
 	PooledType* Malloc();
@@ -15,7 +69,8 @@ public:
 	void Free(PooledType * apObjet);
 
 	//
-	CPool(int alMaxPooled = 2000);
+	//abNumaLocalΪtrueʱÿNUMAڵһֿ
+	CPool(int alMaxPooled = 2000, bool abNumaLocal = false);
 
 	//
 	~CPool();
@@ -24,11 +79,34 @@ public:
 	void Dump();
 
 private:
-	CSafeList<PooledType> moPool;		//
-    CCriticalSection moAccessCS;
+	STRU_POOL_CACHE* GetCache();
+	STRU_POOL_CACHE* CreateCache();
+	//߳˳ʱѵϻֿ
+	static void OnThreadExit(void *apCache);
+	void ReleaseCache(STRU_POOL_CACHE *apCache);
+	//ÿյϻһϻֿûϻʱNULL
+	STRU_POOL_MAGAZINE* ExchangeEmpty(STRU_POOL_DEPOT *apDepot, STRU_POOL_MAGAZINE *apEmpty);
+	//ϻһյϻֿʱֱɾ
+	STRU_POOL_MAGAZINE* ExchangeFull(STRU_POOL_DEPOT *apDepot, STRU_POOL_MAGAZINE *apFull);
+	void DeleteMagazine(STRU_POOL_MAGAZINE *apMagazine);
+	PooledType* Create(STRU_POOL_CACHE *apCache);
+
+private:
+	STRU_POOL_DEPOT moDepot[DEF_POOL_MAX_NODE];
+	int miDepotCount;
+	pthread_key_t moCacheKey;
+	bool mbKeyValid;
+	//̻߳棬Dumpʱʹ
+	STRU_POOL_CACHE *mpCacheList;
+	CCriticalSection moCacheSection;
 
 	//Ķ
-	int		mlCreateCount;
+	volatile int	mlCreateCount;
+	//ˮλ
+	volatile int	mlHighWater;
+	//˳̵߳Сδд
+	uint64	mui64Hit;
+	uint64	mui64Miss;
 
 	//ߴ
 	int		mlMaxPoolSize;
@@ -38,28 +116,35 @@ private:
 template< class PooledType >
 PooledType* CPool<PooledType>::Malloc()
 {
-	PooledType* lpRetObj = NULL;
-	//ӻȡ
-	if (moPool.GetCount())
+	STRU_POOL_CACHE *lpCache = GetCache();
+	if(NULL == lpCache)
 	{
-		lpRetObj = moPool.DelHead();
+		return Create(NULL);
 	}
 
-	if (lpRetObj)
-	{
-		return lpRetObj;
-	}
-	else
+	STRU_POOL_MAGAZINE *lpLoaded = lpCache->mpLoaded;
+	if(lpLoaded->miCount == 0)
 	{
-		//òȥ
-		lpRetObj = new(std::nothrow) PooledType;
-		if (lpRetObj)
+		if(lpCache->mpPrevious->miCount > 0)
+		{
+			lpCache->mpLoaded = lpCache->mpPrevious;
+			lpCache->mpPrevious = lpLoaded;
+		}
+		else
 		{
-			CAutoLock loLock(moAccessCS);
-			mlCreateCount++;
+			//գյıõϻһĻ
+			STRU_POOL_MAGAZINE *lpFull = ExchangeEmpty(lpCache->mpDepot, lpCache->mpPrevious);
+			if(NULL == lpFull)
+			{
+				return Create(lpCache);
+			}
+			lpCache->mpPrevious = lpLoaded;
+			lpCache->mpLoaded = lpFull;
 		}
-		return lpRetObj;
+		lpLoaded = lpCache->mpLoaded;
 	}
+	++lpCache->mui64Hit;
+	return lpLoaded->mpObject[--lpLoaded->miCount];
 }
 
 //ӻз
@@ -67,52 +152,308 @@ template< class PooledType >
 void CPool<PooledType>::Free(PooledType * apObjet)
 {
 	ASSERT(apObjet);
-	if(apObjet)
+	if(NULL == apObjet)
+	{
+		return;
+	}
+	STRU_POOL_CACHE *lpCache = GetCache();
+	if(NULL == lpCache)
 	{
-		if(moPool.GetCount() < mlMaxPoolSize)
+		delete apObjet;
+		__sync_sub_and_fetch(&mlCreateCount, 1);
+		return;
+	}
+
+	STRU_POOL_MAGAZINE *lpLoaded = lpCache->mpLoaded;
+	if(lpLoaded->miCount == DEF_POOL_MAGAZINE_SIZE)
+	{
+		if(lpCache->mpPrevious->miCount == 0)
 		{
-			//黹
-			moPool.AddTail(apObjet);
+			lpCache->mpLoaded = lpCache->mpPrevious;
+			lpCache->mpPrevious = lpLoaded;
 		}
 		else
 		{
-			//ֱɾ
-			delete apObjet;
-			CAutoLock loLock(moAccessCS);
-			mlCreateCount--;
+			//ıõϻһյĻ
+			STRU_POOL_MAGAZINE *lpEmpty = ExchangeFull(lpCache->mpDepot, lpCache->mpPrevious);
+			lpCache->mpPrevious = lpLoaded;
+			lpCache->mpLoaded = lpEmpty;
 		}
+		lpLoaded = lpCache->mpLoaded;
 	}
+	lpLoaded->mpObject[lpLoaded->miCount++] = apObjet;
 }
 
 //ӻз
 template< class PooledType >
-CPool<PooledType>::CPool(int alMaxPoolSize)
+CPool<PooledType>::CPool(int alMaxPoolSize, bool abNumaLocal)
 {
 	ASSERT(alMaxPoolSize > 0);
 	mlCreateCount = 0;
+	mlHighWater = 0;
+	mui64Hit = 0;
+	mui64Miss = 0;
 	mlMaxPoolSize = alMaxPoolSize;
+	mpCacheList = NULL;
+	miDepotCount = abNumaLocal ? DEF_POOL_MAX_NODE : 1;
+	for(int i = 0; i < DEF_POOL_MAX_NODE; ++i)
+	{
+		moDepot[i].mpFull = NULL;
+		moDepot[i].mpEmpty = NULL;
+		moDepot[i].miObjectCount = 0;
+	}
+	//keyʱ˻Ϊÿֱnew/delete
+	mbKeyValid = (0 == pthread_key_create(&moCacheKey, OnThreadExit));
+	if(!mbKeyValid)
+	{
+		TRACE(1, "CPool::CPool pthread_key_create ʧܣʹ̻߳档");
+	}
 }
 
 //
 template< class PooledType >
 CPool<PooledType>::~CPool()
 {
-	moPool.ClearAll();
-//	PooledType* lpRetObj = NULL;
-
-	//while(moPool.GetCount())
-	//{
-	//	lpRetObj = moPool.DelHead();
-	//	delete lpRetObj;
-	//	lpRetObj = NULL;
-	//}
+	if(mbKeyValid)
+	{
+		pthread_key_delete(moCacheKey);
+		mbKeyValid = false;
+	}
+	CAutoLock loLock(moCacheSection);
+	while(mpCacheList != NULL)
+	{
+		STRU_POOL_CACHE *lpCache = mpCacheList;
+		mpCacheList = lpCache->mpNext;
+		DeleteMagazine(lpCache->mpLoaded);
+		DeleteMagazine(lpCache->mpPrevious);
+		delete lpCache;
+	}
+	for(int i = 0; i < DEF_POOL_MAX_NODE; ++i)
+	{
+		STRU_POOL_DEPOT &loDepot = moDepot[i];
+		while(loDepot.mpFull != NULL)
+		{
+			STRU_POOL_MAGAZINE *lpMagazine = loDepot.mpFull;
+			loDepot.mpFull = lpMagazine->mpNext;
+			DeleteMagazine(lpMagazine);
+		}
+		while(loDepot.mpEmpty != NULL)
+		{
+			STRU_POOL_MAGAZINE *lpMagazine = loDepot.mpEmpty;
+			loDepot.mpEmpty = lpMagazine->mpNext;
+			delete lpMagazine;
+		}
+		loDepot.miObjectCount = 0;
+	}
+}
+
+template< class PooledType >
+typename CPool<PooledType>::STRU_POOL_CACHE* CPool<PooledType>::GetCache()
+{
+	if(!mbKeyValid)
+	{
+		return NULL;
+	}
+	STRU_POOL_CACHE *lpCache = (STRU_POOL_CACHE*)pthread_getspecific(moCacheKey);
+	if(lpCache != NULL)
+	{
+		return lpCache;
+	}
+	return CreateCache();
+}
+
+template< class PooledType >
+typename CPool<PooledType>::STRU_POOL_CACHE* CPool<PooledType>::CreateCache()
+{
+	STRU_POOL_CACHE *lpCache = new(std::nothrow) STRU_POOL_CACHE;
+	if(NULL == lpCache)
+	{
+		return NULL;
+	}
+	lpCache->mpPool = this;
+	lpCache->mpLoaded = new(std::nothrow) STRU_POOL_MAGAZINE;
+	lpCache->mpPrevious = new(std::nothrow) STRU_POOL_MAGAZINE;
+	if(NULL == lpCache->mpLoaded || NULL == lpCache->mpPrevious)
+	{
+		delete lpCache->mpLoaded;
+		delete lpCache->mpPrevious;
+		delete lpCache;
+		return NULL;
+	}
+	lpCache->mpLoaded->miCount = 0;
+	lpCache->mpPrevious->miCount = 0;
+	lpCache->mpDepot = &moDepot[GetCurrentNumaNode() % miDepotCount];
+	lpCache->mui64Hit = 0;
+	lpCache->mui64Miss = 0;
+	if(0 != pthread_setspecific(moCacheKey, lpCache))
+	{
+		delete lpCache->mpLoaded;
+		delete lpCache->mpPrevious;
+		delete lpCache;
+		return NULL;
+	}
+	CAutoLock loLock(moCacheSection);
+	lpCache->mpNext = mpCacheList;
+	mpCacheList = lpCache;
+	return lpCache;
+}
+
+template< class PooledType >
+void CPool<PooledType>::OnThreadExit(void *apCache)
+{
+	STRU_POOL_CACHE *lpCache = (STRU_POOL_CACHE*)apCache;
+	if(lpCache != NULL)
+	{
+		lpCache->mpPool->ReleaseCache(lpCache);
+	}
+}
+
+template< class PooledType >
+void CPool<PooledType>::ReleaseCache(STRU_POOL_CACHE *apCache)
+{
+	{
+		CAutoLock loLock(moCacheSection);
+		STRU_POOL_CACHE **lppCache = &mpCacheList;
+		while(*lppCache != NULL && *lppCache != apCache)
+		{
+			lppCache = &(*lppCache)->mpNext;
+		}
+		if(*lppCache != NULL)
+		{
+			*lppCache = apCache->mpNext;
+		}
+		mui64Hit += apCache->mui64Hit;
+		mui64Miss += apCache->mui64Miss;
+	}
+	//ûĵϻҲϻأʱmiCountȡ
+	STRU_POOL_MAGAZINE *lpMagazine[2] = {apCache->mpLoaded, apCache->mpPrevious};
+	for(int i = 0; i < 2; ++i)
+	{
+		if(lpMagazine[i]->miCount > 0)
+		{
+			lpMagazine[i] = ExchangeFull(apCache->mpDepot, lpMagazine[i]);
+		}
+		CAutoLock loLock(apCache->mpDepot->moSection);
+		lpMagazine[i]->mpNext = apCache->mpDepot->mpEmpty;
+		apCache->mpDepot->mpEmpty = lpMagazine[i];
+	}
+	delete apCache;
+}
+
+template< class PooledType >
+typename CPool<PooledType>::STRU_POOL_MAGAZINE* CPool<PooledType>::ExchangeEmpty(
+	STRU_POOL_DEPOT *apDepot, STRU_POOL_MAGAZINE *apEmpty)
+{
+	CAutoLock loLock(apDepot->moSection);
+	STRU_POOL_MAGAZINE *lpFull = apDepot->mpFull;
+	if(NULL == lpFull)
+	{
+		return NULL;
+	}
+	apDepot->mpFull = lpFull->mpNext;
+	apDepot->miObjectCount -= lpFull->miCount;
+	apEmpty->mpNext = apDepot->mpEmpty;
+	apDepot->mpEmpty = apEmpty;
+	return lpFull;
+}
+
+template< class PooledType >
+typename CPool<PooledType>::STRU_POOL_MAGAZINE* CPool<PooledType>::ExchangeFull(
+	STRU_POOL_DEPOT *apDepot, STRU_POOL_MAGAZINE *apFull)
+{
+	{
+		CAutoLock loLock(apDepot->moSection);
+		if((apDepot->miObjectCount + apFull->miCount) * miDepotCount <= mlMaxPoolSize)
+		{
+			apDepot->miObjectCount += apFull->miCount;
+			apFull->mpNext = apDepot->mpFull;
+			apDepot->mpFull = apFull;
+			STRU_POOL_MAGAZINE *lpEmpty = apDepot->mpEmpty;
+			if(lpEmpty != NULL)
+			{
+				apDepot->mpEmpty = lpEmpty->mpNext;
+				return lpEmpty;
+			}
+			apFull = NULL;
+		}
+	}
+	if(NULL == apFull)
+	{
+		//ֿûпյϻֻԤȽ׶γ
+		apFull = new STRU_POOL_MAGAZINE;
+	}
+	else
+	{
+		//ֿĶֱɾ
+		for(int i = 0; i < apFull->miCount; ++i)
+		{
+			delete apFull->mpObject[i];
+		}
+		__sync_sub_and_fetch(&mlCreateCount, apFull->miCount);
+	}
+	apFull->miCount = 0;
+	return apFull;
+}
+
+template< class PooledType >
+void CPool<PooledType>::DeleteMagazine(STRU_POOL_MAGAZINE *apMagazine)
+{
+	for(int i = 0; i < apMagazine->miCount; ++i)
+	{
+		delete apMagazine->mpObject[i];
+	}
+	__sync_sub_and_fetch(&mlCreateCount, apMagazine->miCount);
+	delete apMagazine;
+}
+
+template< class PooledType >
+PooledType* CPool<PooledType>::Create(STRU_POOL_CACHE *apCache)
+{
+	PooledType* lpRetObj = new(std::nothrow) PooledType;
+	if(NULL == lpRetObj)
+	{
+		return NULL;
+	}
+	if(apCache != NULL)
+	{
+		++apCache->mui64Miss;
+	}
+	int liCount = __sync_add_and_fetch(&mlCreateCount, 1);
+	int liHighWater = mlHighWater;
+	while(liCount > liHighWater
+		&& !__sync_bool_compare_and_swap(&mlHighWater, liHighWater, liCount))
+	{
+		liHighWater = mlHighWater;
+	}
+	return lpRetObj;
 }
 
 //Ϣ
 template< class PooledType >
 void CPool<PooledType>::Dump()
 {
-	TRACE(1,"CPool::Dump :" << mlCreateCount << ", 󻺳:" << mlMaxPoolSize
-		<< ",ǰеԪ:" << moPool.GetCount());
+	uint64 lui64Hit = 0;
+	uint64 lui64Miss = 0;
+	int liCacheCount = 0;
+	{
+		CAutoLock loLock(moCacheSection);
+		lui64Hit = mui64Hit;
+		lui64Miss = mui64Miss;
+		for(STRU_POOL_CACHE *lpCache = mpCacheList; lpCache != NULL; lpCache = lpCache->mpNext)
+		{
+			lui64Hit += lpCache->mui64Hit;
+			lui64Miss += lpCache->mui64Miss;
+			++liCacheCount;
+		}
+	}
+	int liFreeCount = 0;
+	for(int i = 0; i < miDepotCount; ++i)
+	{
+		CAutoLock loLock(moDepot[i].moSection);
+		liFreeCount += moDepot[i].miObjectCount;
+	}
+	TRACE(1,"CPool::Dump :" << mlCreateCount << ", ˮλ:" << mlHighWater
+		<< ", 󻺳:" << mlMaxPoolSize << ",ֿеԪ:" << liFreeCount
+		<< ", ̻߳:" << liCacheCount << ", :" << lui64Hit << ", δ:" << lui64Miss);
 }
 #endif //_DEF_SINA_POOL_H_
@@ -0,0 +1,92 @@
+/********************************************************************
+	file base:	TimingWheel
+	file ext:	h
+
+	purpose:	ֲʱ
+				0256ۣÿһ̶ȣ1~464ۣÿ۸һһȦ
+				ʱڵʹ߳(һǶӶ)롢عҡժO(1)
+				ƽʱֻڵĲۣ붨ʱ޹ء
+*********************************************************************/
+#ifndef _TIMING_WHEEL_H_
+#define _TIMING_WHEEL_H_
+
+#include "include.h"
+#include "sigslot.h"
+
+#define DEF_TW_ROOT_BITS 8
+#define DEF_TW_LEVEL_BITS 6
+#define DEF_TW_ROOT_SIZE (1 << DEF_TW_ROOT_BITS)
+#define DEF_TW_LEVEL_SIZE (1 << DEF_TW_LEVEL_BITS)
+#define DEF_TW_ROOT_MASK (DEF_TW_ROOT_SIZE - 1)
+#define DEF_TW_LEVEL_MASK (DEF_TW_LEVEL_SIZE - 1)
+#define DEF_TW_LEVEL_COUNT 4
+//ĬϿ̶ȣ
+#define DEF_TW_TICK_MS 100
+
+//ʱڵ㣬ڲ۵˫
+struct STRU_TIMER_NODE{
+	STRU_TIMER_NODE(){
+		mpPrev = NULL;
+		mpNext = NULL;
+		mui64Expire = 0;
+		miType = 0;
+		mui64Data = 0;
+	}
+	inline bool IsArmed() const{
+		return mpNext != NULL;
+	}
+
+	STRU_TIMER_NODE *mpPrev;
+	STRU_TIMER_NODE *mpNext;
+	//ڵĿ̶
+	uint64 mui64Expire;
+	//ʹԶ壬ʱԭ
+	int miType;
+	uint64 mui64Data;
+};
+
+//ֻƽ߳(һepoll߳)ʹãɵ÷
+class CTimingWheel{
+public:
+	CTimingWheel();
+	~CTimingWheel();
+
+	//aui64Now ǰʱ䣬(GetMonotonicTime)
+	void Init(uint64 aui64Now, unsigned int aiTickMs = DEF_TW_TICK_MS);
+	//عңaiTimeOut
+	void Arm(STRU_TIMER_NODE *apNode, unsigned int aiTimeOut);
+	void Cancel(STRU_TIMER_NODE *apNode);
+	//ƽaui64NowڽڵժͨOnTimeOut֪ͨصعһժڵ
+	//صڵĽڵ
+	int Advance(uint64 aui64Now);
+
+	inline unsigned int GetTimerCount(){ return miTimerCount; }
+	inline unsigned int GetTickMs(){ return miTickMs; }
+
+	//ʱ䣬
+	static uint64 GetMonotonicTime();
+
+public:
+	sigslot::signal1<STRU_TIMER_NODE*> OnTimeOut;
+
+private:
+	void AddNode(STRU_TIMER_NODE *apNode);
+	//ѵaiLevel㵱ǰ۵Ľڵ·ɢ²㣬ز
+	int Cascade(int aiLevel);
+	static void InitHead(STRU_TIMER_NODE *apHead);
+	static void LinkTail(STRU_TIMER_NODE *apHead, STRU_TIMER_NODE *apNode);
+	static void Unlink(STRU_TIMER_NODE *apNode);
+	//apFromϵĽڵƵapToapToΪ
+	static void Splice(STRU_TIMER_NODE *apFrom, STRU_TIMER_NODE *apTo);
+
+private:
+	STRU_TIMER_NODE moRoot[DEF_TW_ROOT_SIZE];
+	STRU_TIMER_NODE moLevel[DEF_TW_LEVEL_COUNT][DEF_TW_LEVEL_SIZE];
+	//һҪĿ̶
+	uint64 mui64CurrentTick;
+	uint64 mui64StartTime;
+	unsigned int miTickMs;
+	unsigned int miTimerCount;
+};
+
+#endif //_TIMING_WHEEL_H_
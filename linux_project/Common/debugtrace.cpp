@@ -10,14 +10,388 @@
 ĿӦƽ̨Ӧ
 ***********************************************************/
 #include <stdio.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/stat.h>
 #include "include.h"
 #include "debugtrace.h"
 #include "FileStream.h"
+#include "RingQueue.h"
+#include "Pool.h"
+
+//첽дļĻ
+#define DEF_ASYNC_LOG_BUFFER_LEN (256*1024)
+//д߳һδӶȡ
+#define DEF_ASYNC_LOG_BATCH 256
+//д߳̿ʱĵȴʱ䣬룬Ҳ־ӳ
+#define DEF_ASYNC_LOG_WAIT 50
+//ʱȴд߳деʱ䣬
+#define DEF_ASYNC_LOG_CRASH_WAIT 2000
 
 char goLogMark[] = "SERVER_LOG_BEGIN";
 
 int64		gi64TraceUserId;	//׷ٵûID
 
+__thread STRU_TRACE_LINE *gpTraceLine = NULL;
+//ǰд̣߳BeginTraceʱȡ;лģʽ
+static __thread CAsyncLogWriter *gpTraceWriter = NULL;
+//лʧʱʽEndTraceʱ
+static __thread STRU_TRACE_LINE goDropLine;
+
+/************************************************************************/
+/*
+CAsyncLogWriter
+̰߳Ѹʽõз߶У߳ȡдļ
+߲д߳(ʡһڴ)д߳ÿDEF_ASYNC_LOG_WAITһΣ
+йҪʱŻѡ
+*/
+/************************************************************************/
+class CAsyncLogWriter
+{
+public:
+	CAsyncLogWriter(CDebugTrace *apTrace, unsigned int aiQueueSize);
+	~CAsyncLogWriter();
+
+	bool Start();
+	//дк˳д߳
+	void Stop();
+
+	STRU_TRACE_LINE* AllocLine()
+	{
+		return moLinePool.Malloc();
+	}
+	//ʱ
+	void Push(STRU_TRACE_LINE *apLine);
+	void AddDropCount()
+	{
+		__sync_add_and_fetch(&miDropCount, 1);
+	}
+	//д̰߳Ѷд겢̣aiTimeOut룬źŴ
+	void FlushWait(int aiTimeOut);
+	//־ļ
+	void Reopen()
+	{
+		miReopen = 1;
+	}
+
+private:
+	static void* WriteThread(void *apParam);
+	void Run();
+	//ȡնвдļ
+	void Drain();
+	void Append(const char *apData, int aiLength);
+	void WriteBuffer();
+	void CheckRotate();
+	void CloseFile();
+
+private:
+	CDebugTrace *mpTrace;
+	CMpscRingQueue<STRU_TRACE_LINE*> moQueue;
+	CQueueNotify moNotify;
+	CPool<STRU_TRACE_LINE> moLinePool;
+	unsigned int miQueueSize;
+	pthread_t moThread;
+	bool mbStarted;
+	volatile int miStop;
+	volatile int miFlushRequest;
+	volatile int miFlushDone;
+	volatile int miReopen;
+	volatile int miDropCount;
+
+	int miFd;
+	char mszOpenFileName[512];
+	uint64 mui64FileSize;
+	time_t mtOpenTime;
+	char *mpWriteBuffer;
+	int miWriteLength;
+};
+
+CAsyncLogWriter::CAsyncLogWriter(CDebugTrace *apTrace, unsigned int aiQueueSize)
+	:moLinePool(aiQueueSize)
+{
+	ASSERT(apTrace != NULL);
+	mpTrace = apTrace;
+	miQueueSize = aiQueueSize;
+	mbStarted = false;
+	miStop = 0;
+	miFlushRequest = 0;
+	miFlushDone = 0;
+	miReopen = 0;
+	miDropCount = 0;
+	miFd = -1;
+	memset(mszOpenFileName, 0, sizeof(mszOpenFileName));
+	mui64FileSize = 0;
+	mtOpenTime = 0;
+	mpWriteBuffer = NULL;
+	miWriteLength = 0;
+}
+
+CAsyncLogWriter::~CAsyncLogWriter()
+{
+	Stop();
+	STRU_TRACE_LINE *lpLine = NULL;
+	while(moQueue.Pop(lpLine))
+	{
+		moLinePool.Free(lpLine);
+	}
+	if(mpWriteBuffer != NULL)
+	{
+		delete [] mpWriteBuffer;
+		mpWriteBuffer = NULL;
+	}
+}
+
+bool CAsyncLogWriter::Start()
+{
+	mpWriteBuffer = new(std::nothrow) char[DEF_ASYNC_LOG_BUFFER_LEN];
+	if(NULL == mpWriteBuffer || !moQueue.Init(miQueueSize) || !moNotify.Create())
+	{
+		return false;
+	}
+	if(0 != pthread_create(&moThread, NULL, WriteThread, this))
+	{
+		return false;
+	}
+	mbStarted = true;
+	return true;
+}
+
+void CAsyncLogWriter::Stop()
+{
+	if(!mbStarted)
+	{
+		return;
+	}
+	miStop = 1;
+	moNotify.Notify();
+	pthread_join(moThread, NULL);
+	mbStarted = false;
+}
+
+void CAsyncLogWriter::Push(STRU_TRACE_LINE *apLine)
+{
+	if(!moQueue.Push(apLine))
+	{
+		moLinePool.Free(apLine);
+		AddDropCount();
+		return;
+	}
+	if(moQueue.GetCount() > (miQueueSize >> 1))
+	{
+		moNotify.Notify();
+	}
+}
+
+void CAsyncLogWriter::FlushWait(int aiTimeOut)
+{
+	if(!mbStarted)
+	{
+		return;
+	}
+	if(pthread_equal(pthread_self(), moThread))
+	{
+		//д߳Լˣֻܾ͵д
+		Drain();
+		return;
+	}
+	int liRequest = __sync_add_and_fetch(&miFlushRequest, 1);
+	moNotify.Notify();
+	struct timespec loSleep;
+	loSleep.tv_sec = 0;
+	loSleep.tv_nsec = 5 * 1000000;
+	for(int i = 0; i < aiTimeOut && (miFlushDone - liRequest) < 0; i += 5)
+	{
+		nanosleep(&loSleep, NULL);
+	}
+}
+
+void* CAsyncLogWriter::WriteThread(void *apParam)
+{
+	CAsyncLogWriter *lpWriter = (CAsyncLogWriter*)apParam;
+	lpWriter->Run();
+	return NULL;
+}
+
+void CAsyncLogWriter::Run()
+{
+	while(!miStop)
+	{
+		int liRequest = miFlushRequest;
+		Drain();
+		if(liRequest != miFlushDone)
+		{
+			if(miFd != -1)
+			{
+				fsync(miFd);
+			}
+			miFlushDone = liRequest;
+			continue;
+		}
+		moNotify.BeginWait();
+		if(miStop || miFlushRequest != miFlushDone || moQueue.GetCount() > (miQueueSize >> 1))
+		{
+			moNotify.EndWait();
+			continue;
+		}
+		moNotify.Wait(DEF_ASYNC_LOG_WAIT);
+	}
+	Drain();
+	CloseFile();
+}
+
+void CAsyncLogWriter::Drain()
+{
+	STRU_TRACE_LINE *lpLine[DEF_ASYNC_LOG_BATCH];
+	unsigned int liCount = 0;
+	while((liCount = moQueue.PopBatch(lpLine, DEF_ASYNC_LOG_BATCH)) > 0)
+	{
+		for(unsigned int i = 0; i < liCount; ++i)
+		{
+			Append(lpLine[i]->mszPrintBuff, lpLine[i]->mlDataLen);
+			moLinePool.Free(lpLine[i]);
+		}
+	}
+	int liDropCount = __sync_fetch_and_and(&miDropCount, 0);
+	if(liDropCount > 0)
+	{
+		char lszMessage[128];
+		int liLength = snprintf(lszMessage, sizeof(lszMessage),
+			"***CAsyncLogWriter::Drain ־%d\n", liDropCount);
+		Append(lszMessage, liLength);
+	}
+	WriteBuffer();
+}
+
+void CAsyncLogWriter::Append(const char *apData, int aiLength)
+{
+	if(aiLength <= 0)
+	{
+		return;
+	}
+	if(mpTrace->muTraceOptions & CDebugTrace::PrintToConsole)
+	{
+		fwrite(apData, aiLength, 1, stdout);
+	}
+	if(!(mpTrace->muTraceOptions & CDebugTrace::AppendToFile))
+	{
+		return;
+	}
+	if(miWriteLength + aiLength > DEF_ASYNC_LOG_BUFFER_LEN)
+	{
+		WriteBuffer();
+	}
+	memcpy(mpWriteBuffer + miWriteLength, apData, aiLength);
+	miWriteLength += aiLength;
+}
+
+void CAsyncLogWriter::WriteBuffer()
+{
+	if(0 == miWriteLength)
+	{
+		return;
+	}
+	CheckRotate();
+	if(-1 == miFd)
+	{
+		//ļSET_LOG_FILENAME޸ģһ
+		mpTrace->GetLogFileName(mszOpenFileName, sizeof(mszOpenFileName));
+	}
+	if(-1 == miFd && strlen(mszOpenFileName) > 1)
+	{
+		miFd = open(mszOpenFileName, O_WRONLY | O_CREAT | O_APPEND, 0644);
+		if(miFd != -1)
+		{
+			struct stat loStat;
+			mui64FileSize = (0 == fstat(miFd, &loStat)) ? loStat.st_size : 0;
+			mtOpenTime = time(NULL);
+		}
+	}
+	if(miFd != -1)
+	{
+		int liOffset = 0;
+		while(liOffset < miWriteLength)
+		{
+			int liRet = write(miFd, mpWriteBuffer + liOffset, miWriteLength - liOffset);
+			if(liRet <= 0)
+			{
+				if(liRet < 0 && EINTR == errno)
+				{
+					continue;
+				}
+				break;
+			}
+			liOffset += liRet;
+		}
+		mui64FileSize += liOffset;
+	}
+	//дȥҲöжѻ
+	miWriteLength = 0;
+}
+
+void CAsyncLogWriter::CheckRotate()
+{
+	//־ٹļڼٴθһ´
+	if(__sync_fetch_and_and(&miReopen, 0))
+	{
+		CloseFile();
+	}
+	if(-1 == miFd)
+	{
+		return;
+	}
+	bool lbRotate = (mui64FileSize > mpTrace->muiLogFileSize);
+	if(mpTrace->muiLogRotateTime > 0 && time(NULL) - mtOpenTime >= (time_t)mpTrace->muiLogRotateTime)
+	{
+		lbRotate = true;
+	}
+	if(!lbRotate)
+	{
+		return;
+	}
+	//ǰʱļͬһֲʱдԭļ
+	char lszFileName[sizeof(mszOpenFileName)];
+	mpTrace->RenewLogFileName(lszFileName, sizeof(lszFileName));
+	if(0 == strcmp(mszOpenFileName, lszFileName))
+	{
+		mui64FileSize = 0;
+		mtOpenTime = time(NULL);
+		return;
+	}
+	CloseFile();
+}
+
+void CAsyncLogWriter::CloseFile()
+{
+	if(miFd != -1)
+	{
+		close(miFd);
+		miFd = -1;
+	}
+}
+
+//StartAsync֮ǰװźŴźֵ
+static struct sigaction goOldSignalAction[NSIG];
+
+//ʱȰ־д꣬ٻָԭĴʽ·ź
+//źڴغŵͣԭĬϴʱճcore
+static void OnFatalSignal(int aiSignal)
+{
+	if(goDebugTrace != NULL)
+	{
+		goDebugTrace->FlushAsync(DEF_ASYNC_LOG_CRASH_WAIT);
+	}
+	sigaction(aiSignal, &goOldSignalAction[aiSignal], NULL);
+	raise(aiSignal);
+}
+
+static void OnProcessExit()
+{
+	if(goDebugTrace != NULL)
+	{
+		goDebugTrace->StopAsync();
+	}
+}
+
 //*****************************************************************************
 //  ԭͣ  CDebugTrace(unsigned asTraceOptions)
 //        unsigned asTraceOptions (־ӡѡ,Ĭϴӡʱд뵽ļ)
@@ -27,18 +401,20 @@ int64		gi64TraceUserId;	//׷
 // $_CODE_CHANGE 2005-09-09 fyf޸ģʼ
 CDebugTrace::CDebugTrace(unsigned asTraceOptions)
 {
-	mlDataLen = 0;  
+	moSyncLine.mlDataLen = 0;  
 	mnLogLevel = 4;
+	mpAsyncWriter = NULL;
 
 	memset(mszLogFileName,0,512);
 	memset(mszLogFileNamePre, 0, 450);
 
 	//ʱ
-	memset(mszPrintBuff, 0, sizeof(mszPrintBuff));
+	memset(moSyncLine.mszPrintBuff, 0, sizeof(moSyncLine.mszPrintBuff));
 
     muTraceOptions = asTraceOptions;
 	//Ĭ־ļСΪ1G
 	muiLogFileSize = 1024*1024*1024;
+	muiLogRotateTime = 0;
 
 #ifndef LOG_OUTPUT_TO_FILE_DIRECT
 	//֤ĳߴ
@@ -61,6 +437,7 @@ CDebugTrace::CDebugTrace(unsigned asTraceOptions)
 // $_CODE_CHANGE 2005-09-09 fyf޸ģʱеĻ
 CDebugTrace::~CDebugTrace()
 {
+	StopAsync();
 #ifndef LOG_OUTPUT_TO_FILE_DIRECT
 	Flush();
 #endif //LOG_OUTPUT_TO_FILE_DIRECT
@@ -69,10 +446,11 @@ CDebugTrace::~CDebugTrace()
 //ӡַ
 CDebugTrace& CDebugTrace::operator << (unsigned char acCharVal)
 {
-	if (mlDataLen < DEF_MAX_BUFF_LEN - 2)
+	STRU_TRACE_LINE &loLine = CurrentLine();
+	if (loLine.mlDataLen < DEF_MAX_BUFF_LEN - 2)
 	{
-		char * lpWritePtr = mszPrintBuff + mlDataLen;		
-		mlDataLen += sprintf(lpWritePtr,"%d",acCharVal);
+		char * lpWritePtr = loLine.mszPrintBuff + loLine.mlDataLen;		
+		loLine.mlDataLen += sprintf(lpWritePtr,"%d",acCharVal);
 	}
 	return *this;
 }
@@ -80,16 +458,17 @@ CDebugTrace& CDebugTrace::operator << (unsigned char acCharVal)
 //ӡboolֵ
 CDebugTrace& CDebugTrace::operator << (bool abBoolVal)
 {
-	if (mlDataLen < DEF_MAX_BUFF_LEN - 6)
+	STRU_TRACE_LINE &loLine = CurrentLine();
+	if (loLine.mlDataLen < DEF_MAX_BUFF_LEN - 6)
 	{
-		char * lpWritePtr = mszPrintBuff + mlDataLen;
+		char * lpWritePtr = loLine.mszPrintBuff + loLine.mlDataLen;
 		if (abBoolVal)
 		{   
-			mlDataLen += sprintf(lpWritePtr,"%s","true");
+			loLine.mlDataLen += sprintf(lpWritePtr,"%s","true");
 		}
 		else
 		{
-			mlDataLen += sprintf(lpWritePtr,"%s","false");
+			loLine.mlDataLen += sprintf(lpWritePtr,"%s","false");
 		}
 	}
 	return *this;
@@ -99,13 +478,14 @@ CDebugTrace& CDebugTrace::operator << (bool abBoolVal)
 //ӡ64λ(int64)
 CDebugTrace& CDebugTrace::operator << (int64 aiint64Val)
 {
-	if (mlDataLen < DEF_MAX_BUFF_LEN - 20) //max:18446744073709551615
+	STRU_TRACE_LINE &loLine = CurrentLine();
+	if (loLine.mlDataLen < DEF_MAX_BUFF_LEN - 20) //max:18446744073709551615
 	{
-		char *lpWritePtr = mszPrintBuff + mlDataLen;
+		char *lpWritePtr = loLine.mszPrintBuff + loLine.mlDataLen;
 #ifdef WIN32
-		mlDataLen += sprintf(lpWritePtr,"%I64d",aiint64Val);
+		loLine.mlDataLen += sprintf(lpWritePtr,"%I64d",aiint64Val);
 #else
-		mlDataLen += sprintf(lpWritePtr,"%lld",aiint64Val);
+		loLine.mlDataLen += sprintf(lpWritePtr,"%lld",aiint64Val);
 #endif
 	}
 	return *this;
@@ -115,16 +495,17 @@ CDebugTrace& CDebugTrace::operator << (int64 aiint64Val)
 //ӡֵַ
 CDebugTrace& CDebugTrace::operator << (const char *apStrVal)
 {	
-	char * lpWritePtr = mszPrintBuff + mlDataLen;
+	STRU_TRACE_LINE &loLine = CurrentLine();
+	char * lpWritePtr = loLine.mszPrintBuff + loLine.mlDataLen;
 	if (apStrVal == 0)
 	{       
-		if (mlDataLen < (int)(DEF_MAX_BUFF_LEN - strlen("NULL")))
-			mlDataLen += sprintf(lpWritePtr,"%s","NULL");
+		if (loLine.mlDataLen < (int)(DEF_MAX_BUFF_LEN - strlen("NULL")))
+			loLine.mlDataLen += sprintf(lpWritePtr,"%s","NULL");
 	}
 	else
 	{
-		if (mlDataLen < (int)(DEF_MAX_BUFF_LEN - strlen(apStrVal)))
-			mlDataLen += sprintf(lpWritePtr,"%s",apStrVal);
+		if (loLine.mlDataLen < (int)(DEF_MAX_BUFF_LEN - strlen(apStrVal)))
+			loLine.mlDataLen += sprintf(lpWritePtr,"%s",apStrVal);
 	}   	
 	return *this;
 }
@@ -132,14 +513,15 @@ CDebugTrace& CDebugTrace::operator << (const char *apStrVal)
 //inline _CRTIMP ostream& __cdecl endl(ostream& _outs) { return _outs << '\n' << flush; }
 CDebugTrace& CDebugTrace::endl(CDebugTrace &aoDebugTrace)
 {
+	STRU_TRACE_LINE &loLine = aoDebugTrace.CurrentLine();
 #ifdef WIN32
 	//Դ
-	OutputDebugString(aoDebugTrace.mszPrintBuff); 
+	OutputDebugString(loLine.mszPrintBuff); 
 #endif
 
 	//Ҫ̨,־Ϣڿ̨Ҳӡһ
 	if (aoDebugTrace.muTraceOptions & CDebugTrace::PrintToConsole) {
-		printf("%s",aoDebugTrace.mszPrintBuff);
+		printf("%s",loLine.mszPrintBuff);
 	}
 
 	//Ҫдļ־ļ,־Ϣдļ
@@ -149,11 +531,11 @@ CDebugTrace& CDebugTrace::endl(CDebugTrace &aoDebugTrace)
 		lfpTraceFile = fopen(aoDebugTrace.mszLogFileName,"a");  
 		if (lfpTraceFile != NULL)
 		{
-			fprintf(lfpTraceFile,"%s",aoDebugTrace.mszPrintBuff);
+			fprintf(lfpTraceFile,"%s",loLine.mszPrintBuff);
 			fclose(lfpTraceFile);
 		}
 	}
-	aoDebugTrace.mlDataLen = 0;
+	loLine.mlDataLen = 0;
 	moCriticalSection.Leave(); //˳ٽ
 	return aoDebugTrace;	
 }
@@ -166,16 +548,17 @@ CDebugTrace& CDebugTrace::endl(CDebugTrace &aoDebugTrace)
 //*****************************************************************************
 void CDebugTrace::TraceFormat(const char * pFmt,...)
 {
+	STRU_TRACE_LINE &loLine = CurrentLine();
 	va_list argptr;
 	va_start(argptr, pFmt);
 
 #ifdef WIN32
-	mlDataLen += _vsnprintf(mszPrintBuff + mlDataLen, 
-		DEF_MAX_BUFF_LEN - mlDataLen,
+	loLine.mlDataLen += _vsnprintf(loLine.mszPrintBuff + loLine.mlDataLen, 
+		DEF_MAX_BUFF_LEN - loLine.mlDataLen,
 		pFmt , argptr);
 #else
-	mlDataLen += vsnprintf(mszPrintBuff + mlDataLen, 
-		DEF_MAX_BUFF_LEN - mlDataLen,
+	loLine.mlDataLen += vsnprintf(loLine.mszPrintBuff + loLine.mlDataLen, 
+		DEF_MAX_BUFF_LEN - loLine.mlDataLen,
 		pFmt , argptr);
 #endif
 
@@ -199,6 +582,71 @@ void CDebugTrace::SetLogFileSize(unsigned int aiSize)
 	muiLogFileSize = aiSize;
 }
 
+void CDebugTrace::SetLogRotateTime(unsigned int aiSeconds)
+{
+	muiLogRotateTime = aiSeconds;
+}
+
+bool CDebugTrace::StartAsync(unsigned int aiQueueSize /* = 8192 */)
+{
+	if (mpAsyncWriter != NULL)
+	{
+		return true;
+	}
+	CAsyncLogWriter *lpWriter = new(std::nothrow) CAsyncLogWriter(this, aiQueueSize);
+	if (NULL == lpWriter || !lpWriter->Start())
+	{
+		delete lpWriter;
+		return false;
+	}
+#ifndef LOG_OUTPUT_TO_FILE_DIRECT
+	//ͬģʽ»־дȥ֤˳
+	Flush();
+#endif //LOG_OUTPUT_TO_FILE_DIRECT
+	__sync_synchronize();
+	mpAsyncWriter = lpWriter;
+
+	static bool sbInstalled = false;
+	if (!sbInstalled)
+	{
+		sbInstalled = true;
+		struct sigaction loAction;
+		memset(&loAction, 0, sizeof(loAction));
+		loAction.sa_handler = OnFatalSignal;
+		loAction.sa_flags = SA_RESETHAND;
+		sigemptyset(&loAction.sa_mask);
+		int liSignal[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+		for (unsigned int i = 0; i < sizeof(liSignal)/sizeof(liSignal[0]); ++i)
+		{
+			sigaction(liSignal[i], &loAction, &goOldSignalAction[liSignal[i]]);
+		}
+		atexit(OnProcessExit);
+	}
+	return true;
+}
+
+void CDebugTrace::StopAsync()
+{
+	CAsyncLogWriter *lpWriter = mpAsyncWriter;
+	if (NULL == lpWriter)
+	{
+		return;
+	}
+	mpAsyncWriter = NULL;
+	__sync_synchronize();
+	//߳̿Ÿöʽֻ̲ͣ߳ͷ
+	lpWriter->Stop();
+}
+
+void CDebugTrace::FlushAsync(int aiTimeOut)
+{
+	CAsyncLogWriter *lpWriter = mpAsyncWriter;
+	if (lpWriter != NULL)
+	{
+		lpWriter->FlushWait(aiTimeOut);
+	}
+}
+
 
 //־ļ
 // $_CODE_CHANGE 2005-09-09 fyf޸ģûļʱһ
@@ -207,27 +655,59 @@ void CDebugTrace::SetLogFileName(char *aszLogFile)
 #ifndef LOG_OUTPUT_TO_FILE_DIRECT
 	Flush();
 #endif //LOG_OUTPUT_TO_FILE_DIRECT
-	if (aszLogFile != NULL)
 	{
-		ASSERT(strlen(aszLogFile) <= 512);
-		strcpy(mszLogFileNamePre,aszLogFile);
+		//첽д̺߳ͬд־ļ
+		CAutoLock loLock(moCriticalSection);
+		if (aszLogFile != NULL)
+		{
+			ASSERT(strlen(aszLogFile) < sizeof(mszLogFileNamePre));
+			//߿ܴmszLogFileNamePre
+			if (aszLogFile != mszLogFileNamePre)
+			{
+				snprintf(mszLogFileNamePre, sizeof(mszLogFileNamePre), "%s", aszLogFile);
+			}
+		}
+		else
+		{
+			strcpy(mszLogFileNamePre,"");
+		}
+		MakeLogFileName();
 	}
-	else
+
+	if (mpAsyncWriter != NULL)
 	{
-		strcpy(mszLogFileNamePre,"");
+		mpAsyncWriter->Reopen();
 	}
+}
+
+void CDebugTrace::GetLogFileName(char *aszLogFile, unsigned int aiSize)
+{
+	ASSERT(aszLogFile != NULL && aiSize > 0);
+	CAutoLock loLock(moCriticalSection);
+	snprintf(aszLogFile, aiSize, "%s", mszLogFileName);
+}
 
+void CDebugTrace::RenewLogFileName(char *aszLogFile, unsigned int aiSize)
+{
+	ASSERT(aszLogFile != NULL && aiSize > 0);
+	CAutoLock loLock(moCriticalSection);
+	MakeLogFileName();
+	snprintf(aszLogFile, aiSize, "%s", mszLogFileName);
+}
+
+void CDebugTrace::MakeLogFileName()
+{
 	char lszFileDate[50];
 	memset(lszFileDate, 0, 50);
 	time_t loSystemTime;
 	time(&loSystemTime);
-	struct tm* lptm = localtime(&loSystemTime);
+	struct tm loTime;
+	localtime_r(&loSystemTime, &loTime);
 	sprintf(lszFileDate, "-%4d%02d%02d%02d%02d.log", 
-		1900+lptm->tm_year,1+lptm->tm_mon,lptm->tm_mday, 
-		lptm->tm_hour, lptm->tm_min);
+		1900+loTime.tm_year,1+loTime.tm_mon,loTime.tm_mday, 
+		loTime.tm_hour, loTime.tm_min);
 
-	memcpy(mszLogFileName, mszLogFileNamePre, strlen(mszLogFileNamePre));
-	memcpy(mszLogFileName+strlen(mszLogFileNamePre), lszFileDate, strlen(lszFileDate));
+	snprintf(mszLogFileName, sizeof(mszLogFileName), "%s%s", mszLogFileNamePre, lszFileDate);
 }
 
 
@@ -259,20 +739,39 @@ bool CDebugTrace::CanTrace(int aiLogLevel)
 //*****************************************************************************
 CDebugTrace& CDebugTrace::BeginTrace(int aiLogLevel,char *apSrcFile,int aiSrcLine)
 {      
-	mlDataLen = 0;  //Ѵӡݳ0
-	memset(mszPrintBuff, 0, (DEF_MAX_BUFF_LEN+1));
-	miLogLevel = aiLogLevel;
+	//첽ģʽ¸ʽӳȡУEndTraceʱз
+	STRU_TRACE_LINE *lpLine = &moSyncLine;
+	gpTraceWriter = mpAsyncWriter;
+	if (gpTraceWriter != NULL)
+	{
+		lpLine = gpTraceWriter->AllocLine();
+		if (NULL == lpLine)
+		{
+			lpLine = &goDropLine;
+		}
+	}
+	gpTraceLine = lpLine;
+	lpLine->mlDataLen = 0;  //Ѵӡݳ0
+	lpLine->mszPrintBuff[0] = '\0';
 		
-	ftime(&moSystemTime);
+	//첽ģʽ²ʱջ
+	struct timeb loSystemTime;
+	ftime(&loSystemTime);
+	if (NULL == gpTraceWriter)
+	{
+		miLogLevel = aiLogLevel;
+		moSystemTime = loSystemTime;
+	}
 
-	struct tm* lptm = localtime(&moSystemTime.time);
+	struct tm loTm;
+	struct tm* lptm = localtime_r(&loSystemTime.time, &loTm);
 
 	//Ҫʱ,־־ʱ(::)
 	if (muTraceOptions & Timestamp) 
 	{
 		char lszTraceDataBuff[20];
 		sprintf(lszTraceDataBuff,"%02d:%02d:%02d:%03d",\
-			lptm->tm_hour, lptm->tm_min, lptm->tm_sec, moSystemTime.millitm);
+			lptm->tm_hour, lptm->tm_min, lptm->tm_sec, loSystemTime.millitm);
 
 		*this << lszTraceDataBuff<<' ';
 	}
@@ -301,17 +800,37 @@ CDebugTrace& CDebugTrace::BeginTrace(int aiLogLevel,char *apSrcFile,int aiSrcLin
 // $_CODE_CHANGE 2005-09-09 fyf޸ģ
 void CDebugTrace::EndTrace()       //ӡ
 {
+	if (gpTraceWriter != NULL)
+	{
+		//̨Ҳд߳
+		STRU_TRACE_LINE *lpLine = gpTraceLine;
+		CAsyncLogWriter *lpWriter = gpTraceWriter;
+		gpTraceLine = NULL;
+		gpTraceWriter = NULL;
+		if (lpLine == &goDropLine)
+		{
+			lpWriter->AddDropCount();
+		}
+		else if (lpLine != NULL)
+		{
+			lpWriter->Push(lpLine);
+		}
+		return;
+	}
+	gpTraceLine = NULL;
+	moSyncLine.mszPrintBuff[moSyncLine.mlDataLen] = '\0';
+
 	try
 	{
 #ifdef WIN32
 		//Դ
-		OutputDebugString( mszPrintBuff ); 
+		OutputDebugString( moSyncLine.mszPrintBuff ); 
 #endif
 
 		//Ҫ̨,־Ϣڿ̨Ҳӡһ
 		if (muTraceOptions & PrintToConsole) 
 		{
-			printf( "%s" , mszPrintBuff );
+			printf( "%s" , moSyncLine.mszPrintBuff );
 		}
 
 		//Ҫдļ־ļ,־Ϣдļ
@@ -336,7 +855,7 @@ void CDebugTrace::EndTrace()       //
 
 			if (lfpTraceFile != NULL)
 			{
-				fprintf(lfpTraceFile,"%s",mszPrintBuff);
+				fprintf(lfpTraceFile,"%s",moSyncLine.mszPrintBuff);
 				fclose(lfpTraceFile);
 			}
 #else  //LOG_OUTPUT_TO_FILE_DIRECT
@@ -436,7 +955,7 @@ bool CDebugTrace::AddToLogBuffer()
 {
 	int liFlushRet = 0;
 
-	if ( mlDataLen > LOG_BUFFER_LEN - mlBufDataLen )
+	if ( moSyncLine.mlDataLen > LOG_BUFFER_LEN - mlBufDataLen )
 	{
 		if (NULL != (liFlushRet = Flush()))
 		{
@@ -456,8 +975,8 @@ bool CDebugTrace::AddToLogBuffer()
 
 	//ǰѾȷϹĳ
 	//㹻
-	memcpy(mszLogBuffer + mlBufDataLen, mszPrintBuff, mlDataLen);
-	mlBufDataLen += mlDataLen;
+	memcpy(mszLogBuffer + mlBufDataLen, moSyncLine.mszPrintBuff, moSyncLine.mlDataLen);
+	mlBufDataLen += moSyncLine.mlDataLen;
 	return true;
 }
 #endif // LOG_OUTPUT_TO_FILE_DIRECT
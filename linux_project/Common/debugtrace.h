@@ -56,6 +56,7 @@ extern CDebugTrace	*goDebugTrace;       //
 //йTRACEĶ
 #define SET_TRACE_LEVEL		goDebugTrace->SetTraceLevel
 #define SET_LOG_FILENAME	goDebugTrace->SetLogFileName
+#define SET_TRACE_ASYNC		goDebugTrace->StartAsync
  #define SET_TRACE_OPTIONS	goDebugTrace->SetTraceOptions
 #define GET_TRACE_OPTIONS	goDebugTrace->GetTraceOptions
 
@@ -65,10 +66,11 @@ extern CDebugTrace	*goDebugTrace;       //
 //¶TRACE
 //¼־:㹻߲Ŵӡ־,򲻴
 #ifdef SINA_UC_INFORMATION_OUTPUT			
+//첽ģʽLockÿ̸߳ʽԼл
 #define TRACE(level, args) \
 	if (!goDebugTrace->CanTrace(level)) 	;  else\
 	{\
-		goDebugTrace->Lock();\
+		bool lbTraceLock = goDebugTrace->Lock();\
 		try\
 		{\
 			(goDebugTrace->BeginTrace(level,__FILE__,__LINE__) << args << '\n').EndTrace();\
@@ -76,7 +78,7 @@ extern CDebugTrace	*goDebugTrace;       //
 		catch (...)\
 		{\
 		}\
-		goDebugTrace->UnLock();\
+		goDebugTrace->UnLock(lbTraceLock);\
 	}
 
 
@@ -92,7 +94,7 @@ extern int64	gi64TraceUserId;	//׷
 
 #define SET_TRACE_USER_ID(userid)  (gi64TraceUserId=(userid));\
 {\
-	goDebugTrace->Lock();\
+	bool lbTraceLock = goDebugTrace->Lock();\
 	try\
 	{\
 		(goDebugTrace->BeginTrace(0,__FILE__,__LINE__) << "׷ٵûID:" << userid << '\n').EndTrace();\
@@ -100,12 +102,12 @@ extern int64	gi64TraceUserId;	//׷
 	catch (...)\
 	{\
 	}\
-	goDebugTrace->UnLock();\
+	goDebugTrace->UnLock(lbTraceLock);\
 }
 
 #define TraceUserEvent(userid, args) \
 {\
-	goDebugTrace->Lock();\
+	bool lbTraceLock = goDebugTrace->Lock();\
 	try\
 	{\
 		if ((userid) == gi64TraceUserId)\
@@ -114,7 +116,7 @@ extern int64	gi64TraceUserId;	//׷
 	catch (...)\
 	{\
 	}\
-	goDebugTrace->UnLock();\
+	goDebugTrace->UnLock(lbTraceLock);\
 }
 
 
@@ -123,11 +125,23 @@ extern int64	gi64TraceUserId;	//׷
 //־ʵ
 typedef CDebugTrace& (* DebugTraceFunc)(CDebugTrace &aoDebugTrace);
 
-class CDebugTrace
+//һ־
+struct STRU_TRACE_LINE
 {
-public:
 	char		mszPrintBuff[DEF_MAX_BUFF_LEN+1];	 //ӡݻ
 	int		mlDataLen;			 //ݳ
+};
+
+//ǰ߳ڸʽУBeginTraceʱ
+extern __thread STRU_TRACE_LINE *gpTraceLine;
+
+//첽д־̣߳debugtrace.cpp
+class CAsyncLogWriter;
+
+class CDebugTrace
+{
+public:
+	STRU_TRACE_LINE	moSyncLine;		 //ͬģʽʹõл棬moCriticalSection
 	int			mnLogLevel;			 //־ȼ
 	char		mszLogFileName[512]; //־ļ
 	//־ļǰ׺
@@ -139,6 +153,8 @@ public:
 	int	 miLogLevel;						//ĳλỰ־ȼ
 	//־ļֽ
 	unsigned int muiLogFileSize;
+	//첽ģʽ°ʱл־ļļ룬0ʾֻСл
+	unsigned int muiLogRotateTime;
 
 public:
 	//ӡѡ
@@ -168,9 +184,32 @@ public:
 	//־ļֽ
 	void SetLogFileSize(unsigned int aiSize);
 
+	//ðʱл־ļļ()ֻ첽ģʽЧ
+	void SetLogRotateTime(unsigned int aiSeconds);
+
+	//л첽ģʽTRACEֻʽУɺ̨߳дļ
+	//ʱͬʱӹSIGSEGVźţǰѶд
+	bool StartAsync(unsigned int aiQueueSize = 8192);
+
+	//де־صͬģʽ˳ʱԶ
+	void StopAsync();
+
+	//ȴд̰߳Ѷд겢̣aiTimeOut룬ʱ
+	void FlushAsync(int aiTimeOut);
+
+	inline bool IsAsync()
+	{
+		return mpAsyncWriter != NULL;
+	}
+
 	//־ļ
 	void SetLogFileName(char *aszLogFile);
 
+	//moCriticalSectionƵǰ־ļ̶߳ļʱ
+	void GetLogFileName(char *aszLogFile, unsigned int aiSize);
+	//ǰʱļƳ֪ͨд߳´򿪣첽д߳лļʱ
+	void RenewLogFileName(char *aszLogFile, unsigned int aiSize);
+
 	// TRACEѡ .ע⺯ OR ѡ
 	void SetTraceOptions(unsigned options /** New level for trace */ );
 
@@ -201,14 +240,15 @@ public:
 	template <class T>
 	inline CDebugTrace& operator<<(T value)
 	{
+		STRU_TRACE_LINE &loLine = CurrentLine();
 		stringstream str;
 		str<<value;
 		string ss = "";
 		ss = str.str();
-		if (mlDataLen < DEF_MAX_BUFF_LEN - (int)ss.length())
+		if (loLine.mlDataLen < DEF_MAX_BUFF_LEN - (int)ss.length())
 		{
-			memcpy((void*)(mszPrintBuff + mlDataLen), ss.c_str(), ss.length());
-			mlDataLen += ss.length();
+			memcpy((void*)(loLine.mszPrintBuff + loLine.mlDataLen), ss.c_str(), ss.length());
+			loLine.mlDataLen += ss.length();
 		}
 		return *this;
 	}
@@ -225,16 +265,36 @@ public:
 
 	//ʱ
 	int Flush();
-	void Lock()
+	//Ƿļ첽ģʽ²
+	bool Lock()
 	{
-		 moCriticalSection.Enter();
+		if (IsAsync())
+		{
+			return false;
+		}
+		moCriticalSection.Enter();
+		return true;
 	}
-	void UnLock()
+	void UnLock(bool abLocked = true)
 	{
-		moCriticalSection.Leave();
+		if (abLocked)
+		{
+			moCriticalSection.Leave();
+		}
+	}
+
+	inline STRU_TRACE_LINE& CurrentLine()
+	{
+		return (gpTraceLine != NULL) ? *gpTraceLine : moSyncLine;
 	}
 
 private:
+	CAsyncLogWriter *mpAsyncWriter;
+
+private:
+	//mszLogFileNamePreϵǰʱmszLogFileName߳moCriticalSection
+	void MakeLogFileName();
+
 	unsigned int GetFileSize( FILE *fp )
 	{
 		ASSERT(fp != NULL);
@@ -80,6 +80,8 @@
 
 #include <set>
 #include <list>
+#include <vector>
+#include <algorithm>
 
 // On our copy of sigslot.h, we force single threading
 #define SIGSLOT_PURE_ISO
@@ -304,6 +306,7 @@ namespace sigslot {
 	class _connection_base0
 	{
 	public:
+		virtual ~_connection_base0(){}
 		virtual has_slots<mt_policy>* getdest() const = 0;
 		virtual void emit() = 0;
 		virtual _connection_base0* clone() = 0;
@@ -325,6 +328,7 @@ namespace sigslot {
 	class _connection_base2
 	{
 	public:
+		virtual ~_connection_base2(){}
 		virtual has_slots<mt_policy>* getdest() const = 0;
 		virtual void emit(arg1_type, arg2_type) = 0;
 		virtual _connection_base2<arg1_type, arg2_type, mt_policy>* clone() = 0;
@@ -335,6 +339,7 @@ namespace sigslot {
 	class _connection_base3
 	{
 	public:
+		virtual ~_connection_base3(){}
 		virtual has_slots<mt_policy>* getdest() const = 0;
 		virtual void emit(arg1_type, arg2_type, arg3_type) = 0;
 		virtual _connection_base3<arg1_type, arg2_type, arg3_type, mt_policy>* clone() = 0;
@@ -345,6 +350,7 @@ namespace sigslot {
 	class _connection_base4
 	{
 	public:
+		virtual ~_connection_base4(){}
 		virtual has_slots<mt_policy>* getdest() const = 0;
 		virtual void emit(arg1_type, arg2_type, arg3_type, arg4_type) = 0;
 		virtual _connection_base4<arg1_type, arg2_type, arg3_type, arg4_type, mt_policy>* clone() = 0;
@@ -356,6 +362,7 @@ namespace sigslot {
 	class _connection_base5
 	{
 	public:
+		virtual ~_connection_base5(){}
 		virtual has_slots<mt_policy>* getdest() const = 0;
 		virtual void emit(arg1_type, arg2_type, arg3_type, arg4_type, 
 			arg5_type) = 0;
@@ -370,6 +377,7 @@ namespace sigslot {
 	class _connection_base6
 	{
 	public:
+		virtual ~_connection_base6(){}
 		virtual has_slots<mt_policy>* getdest() const = 0;
 		virtual void emit(arg1_type, arg2_type, arg3_type, arg4_type, arg5_type,
 			arg6_type) = 0;
@@ -384,6 +392,7 @@ namespace sigslot {
 	class _connection_base7
 	{
 	public:
+		virtual ~_connection_base7(){}
 		virtual has_slots<mt_policy>* getdest() const = 0;
 		virtual void emit(arg1_type, arg2_type, arg3_type, arg4_type, arg5_type,
 			arg6_type, arg7_type) = 0;
@@ -398,6 +407,7 @@ namespace sigslot {
 	class _connection_base8
 	{
 	public:
+		virtual ~_connection_base8(){}
 		virtual has_slots<mt_policy>* getdest() const = 0;
 		virtual void emit(arg1_type, arg2_type, arg3_type, arg4_type, arg5_type,
 			arg6_type, arg7_type, arg8_type) = 0;
@@ -2695,6 +2705,369 @@ namespace sigslot {
 		}
 	};
 
+	// Hot-path signals.
+	//
+	// cow_signalN keeps its connections in a copy-on-write table. emit() reads the
+	// current table through one pointer load and takes no lock; a published table
+	// is never modified. connect()/disconnect() (serialized by mt_policy) build a
+	// new table and publish it with a single pointer store.
+	//
+	// single_signalN holds at most one connection, so emit() is a pointer load and
+	// one call. Connecting a second slot replaces the first.
+	//
+	// An emitter on another thread may still be walking a replaced table or calling
+	// a disconnected connection, so both are kept until the signal is destroyed.
+	// Connections are meant to change only at startup and shutdown, which bounds
+	// that memory. Disconnecting does not wait for emits already in progress: a
+	// slot object must not be destroyed while the signal can still fire on another
+	// thread.
+
+#if defined(__GNUC__)
+#	define _SIGSLOT_PUBLISH_BARRIER() __sync_synchronize()
+#else
+#	define _SIGSLOT_PUBLISH_BARRIER()
+#endif
+
+	template<class connection_base, class mt_policy>
+	class _cow_signal_base : public _signal_base<mt_policy>
+	{
+	public:
+		typedef std::vector<connection_base *> slot_list;
+
+		_cow_signal_base()
+		{
+			m_table = NULL;
+		}
+
+		~_cow_signal_base()
+		{
+			disconnect_all();
+			typename std::list<connection_base **>::iterator it = m_retired_tables.begin();
+			for(; it != m_retired_tables.end(); ++it)
+			{
+				delete [] *it;
+			}
+			typename std::list<connection_base *>::iterator itSlot = m_retired_slots.begin();
+			for(; itSlot != m_retired_slots.end(); ++itSlot)
+			{
+				delete *itSlot;
+			}
+		}
+
+		void disconnect_all()
+		{
+			lock_block<mt_policy> lock(this);
+			slot_list slots;
+			current(slots);
+			for(size_t i = 0; i < slots.size(); ++i)
+			{
+				slots[i]->getdest()->signal_disconnect(this);
+				m_retired_slots.push_back(slots[i]);
+			}
+			publish(slot_list());
+		}
+
+		void disconnect(has_slots<mt_policy>* pclass)
+		{
+			lock_block<mt_policy> lock(this);
+			slot_list slots;
+			current(slots);
+			for(size_t i = 0; i < slots.size(); ++i)
+			{
+				if(slots[i]->getdest() == pclass)
+				{
+					m_retired_slots.push_back(slots[i]);
+					slots.erase(slots.begin() + i);
+					publish(slots);
+					pclass->signal_disconnect(this);
+					return;
+				}
+			}
+		}
+
+		void slot_disconnect(has_slots<mt_policy>* pslot)
+		{
+			lock_block<mt_policy> lock(this);
+			slot_list slots, kept;
+			current(slots);
+			for(size_t i = 0; i < slots.size(); ++i)
+			{
+				if(slots[i]->getdest() == pslot)
+				{
+					m_retired_slots.push_back(slots[i]);
+				}
+				else
+				{
+					kept.push_back(slots[i]);
+				}
+			}
+			publish(kept);
+		}
+
+		void slot_duplicate(const has_slots<mt_policy>* oldtarget, has_slots<mt_policy>* newtarget)
+		{
+			lock_block<mt_policy> lock(this);
+			slot_list slots;
+			current(slots);
+			size_t count = slots.size();
+			for(size_t i = 0; i < count; ++i)
+			{
+				if(slots[i]->getdest() == oldtarget)
+				{
+					slots.push_back(slots[i]->duplicate(newtarget));
+				}
+			}
+			publish(slots);
+		}
+
+	protected:
+		void add_slot(connection_base *conn)
+		{
+			lock_block<mt_policy> lock(this);
+			slot_list slots;
+			current(slots);
+			slots.push_back(conn);
+			publish(slots);
+			conn->getdest()->signal_connect(this);
+		}
+
+		// Called with the lock held.
+		void current(slot_list &slots)
+		{
+			connection_base **table = m_table;
+			for(; table != NULL && *table != NULL; ++table)
+			{
+				slots.push_back(*table);
+			}
+		}
+
+		// Called with the lock held. The published table is a NULL-terminated
+		// array so emit() reaches the first connection with two loads; an empty
+		// table is published as NULL.
+		void publish(const slot_list &slots)
+		{
+			connection_base **newtable = NULL;
+			if(!slots.empty())
+			{
+				newtable = new connection_base *[slots.size() + 1];
+				std::copy(slots.begin(), slots.end(), newtable);
+				newtable[slots.size()] = NULL;
+			}
+			if(m_table != NULL)
+			{
+				m_retired_tables.push_back((connection_base **)m_table);
+			}
+			_SIGSLOT_PUBLISH_BARRIER();
+			m_table = newtable;
+		}
+
+	protected:
+		connection_base ** volatile m_table;
+
+	private:
+		_cow_signal_base(const _cow_signal_base&);
+		_cow_signal_base& operator=(const _cow_signal_base&);
+
+		std::list<connection_base **> m_retired_tables;
+		std::list<connection_base *> m_retired_slots;
+	};
+
+	template<class connection_base, class mt_policy>
+	class _single_signal_base : public _signal_base<mt_policy>
+	{
+	public:
+		_single_signal_base()
+		{
+			m_slot = NULL;
+		}
+
+		~_single_signal_base()
+		{
+			disconnect_all();
+			typename std::list<connection_base *>::iterator it = m_retired_slots.begin();
+			for(; it != m_retired_slots.end(); ++it)
+			{
+				delete *it;
+			}
+		}
+
+		void disconnect_all()
+		{
+			lock_block<mt_policy> lock(this);
+			if(m_slot != NULL)
+			{
+				m_slot->getdest()->signal_disconnect(this);
+				retire();
+			}
+		}
+
+		void disconnect(has_slots<mt_policy>* pclass)
+		{
+			lock_block<mt_policy> lock(this);
+			if(m_slot != NULL && m_slot->getdest() == pclass)
+			{
+				retire();
+				pclass->signal_disconnect(this);
+			}
+		}
+
+		void slot_disconnect(has_slots<mt_policy>* pslot)
+		{
+			lock_block<mt_policy> lock(this);
+			if(m_slot != NULL && m_slot->getdest() == pslot)
+			{
+				retire();
+			}
+		}
+
+		void slot_duplicate(const has_slots<mt_policy>*, has_slots<mt_policy>*)
+		{
+			// Only one slot: a copied slot object is not connected.
+		}
+
+	protected:
+		void set_slot(connection_base *conn)
+		{
+			lock_block<mt_policy> lock(this);
+			if(m_slot != NULL)
+			{
+				has_slots<mt_policy> *olddest = m_slot->getdest();
+				retire();
+				if(olddest != conn->getdest())
+				{
+					olddest->signal_disconnect(this);
+				}
+			}
+			_SIGSLOT_PUBLISH_BARRIER();
+			m_slot = conn;
+			conn->getdest()->signal_connect(this);
+		}
+
+	protected:
+		connection_base * volatile m_slot;
+
+	private:
+		_single_signal_base(const _single_signal_base&);
+		_single_signal_base& operator=(const _single_signal_base&);
+
+		// Called with the lock held.
+		void retire()
+		{
+			m_retired_slots.push_back((connection_base *)m_slot);
+			m_slot = NULL;
+		}
+
+		std::list<connection_base *> m_retired_slots;
+	};
+
+	template<class arg1_type, class mt_policy = SIGSLOT_DEFAULT_MT_POLICY>
+	class cow_signal1 : public _cow_signal_base<_connection_base1<arg1_type, mt_policy>, mt_policy>
+	{
+	public:
+		template<class desttype>
+			void connect(desttype* pclass, void (desttype::*pmemfun)(arg1_type))
+		{
+			this->add_slot(new _connection1<desttype, arg1_type, mt_policy>(pclass, pmemfun));
+		}
+
+		void emit(arg1_type a1)
+		{
+			_connection_base1<arg1_type, mt_policy> **table = this->m_table;
+			if(table != NULL)
+			{
+				for(; *table != NULL; ++table)
+				{
+					(*table)->emit(a1);
+				}
+			}
+		}
+
+		void operator()(arg1_type a1)
+		{
+			emit(a1);
+		}
+	};
+
+	template<class arg1_type, class arg2_type, class arg3_type, class mt_policy = SIGSLOT_DEFAULT_MT_POLICY>
+	class cow_signal3 : public _cow_signal_base<_connection_base3<arg1_type, arg2_type, arg3_type, mt_policy>, mt_policy>
+	{
+	public:
+		template<class desttype>
+			void connect(desttype* pclass, void (desttype::*pmemfun)(arg1_type,
+			arg2_type, arg3_type))
+		{
+			this->add_slot(new _connection3<desttype, arg1_type, arg2_type, arg3_type, mt_policy>(pclass, pmemfun));
+		}
+
+		void emit(arg1_type a1, arg2_type a2, arg3_type a3)
+		{
+			_connection_base3<arg1_type, arg2_type, arg3_type, mt_policy> **table = this->m_table;
+			if(table != NULL)
+			{
+				for(; *table != NULL; ++table)
+				{
+					(*table)->emit(a1, a2, a3);
+				}
+			}
+		}
+
+		void operator()(arg1_type a1, arg2_type a2, arg3_type a3)
+		{
+			emit(a1, a2, a3);
+		}
+	};
+
+	template<class arg1_type, class mt_policy = SIGSLOT_DEFAULT_MT_POLICY>
+	class single_signal1 : public _single_signal_base<_connection_base1<arg1_type, mt_policy>, mt_policy>
+	{
+	public:
+		template<class desttype>
+			void connect(desttype* pclass, void (desttype::*pmemfun)(arg1_type))
+		{
+			this->set_slot(new _connection1<desttype, arg1_type, mt_policy>(pclass, pmemfun));
+		}
+
+		void emit(arg1_type a1)
+		{
+			_connection_base1<arg1_type, mt_policy> *conn = this->m_slot;
+			if(conn != NULL)
+			{
+				conn->emit(a1);
+			}
+		}
+
+		void operator()(arg1_type a1)
+		{
+			emit(a1);
+		}
+	};
+
+	template<class arg1_type, class arg2_type, class arg3_type, class mt_policy = SIGSLOT_DEFAULT_MT_POLICY>
+	class single_signal3 : public _single_signal_base<_connection_base3<arg1_type, arg2_type, arg3_type, mt_policy>, mt_policy>
+	{
+	public:
+		template<class desttype>
+			void connect(desttype* pclass, void (desttype::*pmemfun)(arg1_type,
+			arg2_type, arg3_type))
+		{
+			this->set_slot(new _connection3<desttype, arg1_type, arg2_type, arg3_type, mt_policy>(pclass, pmemfun));
+		}
+
+		void emit(arg1_type a1, arg2_type a2, arg3_type a3)
+		{
+			_connection_base3<arg1_type, arg2_type, arg3_type, mt_policy> *conn = this->m_slot;
+			if(conn != NULL)
+			{
+				conn->emit(a1, a2, a3);
+			}
+		}
+
+		void operator()(arg1_type a1, arg2_type a2, arg3_type a3)
+		{
+			emit(a1, a2, a3);
+		}
+	};
+
 }; // namespace sigslot
 
 #endif // TALK_BASE_SIGSLOT_H__
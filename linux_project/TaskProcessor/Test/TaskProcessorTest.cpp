@@ -18,11 +18,55 @@ using namespace std;
 #include "FileStream.h"
 #include "debugtrace.h"
 #include "../src/TaskProcessorConfig.h"
+#include "../src/TaskProcessor.h"
 
 const string gstrTaskProcessorVersion = "1.0.0.1";
 
+CDebugTrace *goDebugTrace = NULL;
+
+//ȴӦʱ䣬
+#define DEF_TEST_WAIT_TIMEOUT 30000
+//ÿͬʱôûյӦ𣬱˷Ͷ
+#define DEF_TEST_WINDOW 64
+
+struct STRU_TEST_CONNECT
+{
+	CNetSocket *mpSocket;
+	//ѷ
+	int miSent;
+	//յӦˮģʽһƬ
+	int miReply;
+	//˹ر
+	bool mbClosed;
+};
+
+//һˮģʽ´ͷ
+void SendRequest(STRU_TEST_CONNECT &aoConn, bool abPipeline)
+{
+	string str = "1000";
+	char lszRequest[DEF_BUFFER_LEN];
+	int liLength = 0;
+	if(abPipeline)
+	{
+		STRU_TASK_HEAD loHead;
+		loHead.miRequestId = htonl((uint32)aoConn.miSent);
+		loHead.miFlag = 0;
+		memcpy(lszRequest, &loHead, sizeof(loHead));
+		liLength = sizeof(loHead);
+	}
+	memcpy(lszRequest + liLength, str.c_str(), str.length());
+	liLength += str.length();
+	aoConn.mpSocket->SendData(lszRequest, liLength);
+	++aoConn.miSent;
+}
+
+//÷: TaskProcessorTest [] [ÿӵ]
+//ҪÿӦ𣬶(keep_alive=0)ҪһӦҷر
+//worker_thread_number=0ʱ߳ﴦΪ1϶ʱ̶߳л
 int main(int argc, char* argv[])
 {
+	goDebugTrace = new CDebugTrace;
+
 	//óʼʱ־ѡ
 	SET_TRACE_LEVEL(5);
 	unsigned liOptions = (CDebugTrace::Timestamp | CDebugTrace::LogLevel\
@@ -38,7 +82,7 @@ int main(int argc, char* argv[])
 	CFileStream::CreatePath(lszLogFileName);
 
 	//TRACEļ
-	char lszFileDate[30] = "";
+	char lszFileDate[64] = "";
 	time_t loSystemTime;
 	time(&loSystemTime);
 	struct tm* lptm = localtime(&loSystemTime);
@@ -55,78 +99,101 @@ int main(int argc, char* argv[])
 	loConfig.set_conf_file_name("TaskProcessor.conf");
 	loConfig.load();
 
-	CNetSocket moHallTrans;
-	bool lbCreate = false;
-	lbCreate = moHallTrans.CreateSocket(NULL, 9000);
-	if(!lbCreate)
+	int liConnectCount = (argc > 1) ? atoi(argv[1]) : 1;
+	int liRequestCount = (argc > 2) ? atoi(argv[2]) : 1;
+	if(liConnectCount <= 0 || liRequestCount <= 0)
 	{
-		cout<<"create socket error"<<endl;
-		return 0;
+		cout<<"usage: TaskProcessorTest [] [ÿӵ]"<<endl;
+		return 1;
 	}
 
-	int liConnectCount = 0;
-
-	while(moHallTrans.moNetStat != TCP_CONNECTED)
+	struct sockaddr_in addr;
+	addr.sin_addr.s_addr = loConfig.tps_ip;
+	string strIp = inet_ntoa(addr.sin_addr);
+	//ӱ˹رպ󻹿ڷ
+	signal(SIGPIPE, SIG_IGN);
+	CNetPackVersion1 loNetPack;
+	vector<STRU_TEST_CONNECT> loConnect(liConnectCount);
+	for(int i = 0; i < liConnectCount; i++)
 	{
-		struct sockaddr_in addr;
-		addr.sin_addr.s_addr = loConfig.tps_ip;
-		bool lbConnet = moHallTrans.ConnectServer(inet_ntoa(addr.sin_addr), loConfig.tps_port);
-		if(lbConnet)
+		STRU_TEST_CONNECT &loConn = loConnect[i];
+		loConn.miSent = 0;
+		loConn.miReply = 0;
+		loConn.mbClosed = false;
+		loConn.mpSocket = new CNetSocket;
+		loConn.mpSocket->SetNetPack(&loNetPack);
+		if(!loConn.mpSocket->CreateSocket() || !loConn.mpSocket->ConnectServer(strIp.c_str(), loConfig.tps_port))
 		{
-			moHallTrans.moNetStat = TCP_CONNECTED;
+			cout<<"ӷʧܡindex = "<<i<<endl;
+			return 1;
 		}
-		else
+		loConn.mpSocket->SetNoBlock();
+	}
+
+	int liDone = 0;
+	int liWaitTime = 0;
+	while(liDone < liConnectCount && liWaitTime < DEF_TEST_WAIT_TIMEOUT)
+	{
+		liDone = 0;
+		for(int i = 0; i < liConnectCount; i++)
 		{
-			if(++liConnectCount >= 100)
+			STRU_TEST_CONNECT &loConn = loConnect[i];
+			if(loConn.mbClosed || (loConfig.keep_alive && loConn.miReply >= liRequestCount))
 			{
-				moHallTrans.Close();
-				cout<<"ӷʧܡ"<<endl;
-				return 0;
+				++liDone;
+				continue;
 			}
-			else
+			while(loConn.miSent < liRequestCount && loConn.miSent - loConn.miReply < DEF_TEST_WINDOW)
 			{
-				usleep(1000*1000*3);
-				continue;
+				SendRequest(loConn, loConfig.pipeline);
+			}
+			loConn.mpSocket->SendData();
+			if(!loConn.mpSocket->RecvData())
+			{
+				loConn.mbClosed = true;
+			}
+			char buffer[DEF_BUFFER_LEN];
+			int length = 0;
+			while(loConn.mpSocket->RecvData(buffer, length))
+			{
+				if(loConfig.pipeline)
+				{
+					STRU_TASK_HEAD loHead;
+					memcpy(&loHead, buffer, sizeof(loHead));
+					if(ntohl(loHead.miFlag) & TASK_FLAG_MORE)
+						continue;
+				}
+				if(0 == i && 0 == loConn.miReply)
+				{
+					cout<<"client length = "<<length<<endl;
+				}
+				++loConn.miReply;
 			}
 		}
+		usleep(1000);
+		++liWaitTime;
 	}
 
-	moHallTrans.SetNoBlock();
-
-	//CNetPackLogin loLogin;
-	//loLogin.miId = 1000;
-	//char *lpSendBuffer = new char[DEF_BUFFER_LEN];
-	//memset(lpSendBuffer, 0, DEF_BUFFER_LEN);
-	//int liSendLen = DEF_BUFFER_LEN;
-	//int nRet = loLogin.Pack(lpSendBuffer, liSendLen);
-	string str = "1000";
-	moHallTrans.SendData(str.c_str(), str.length());
-	//cout<<"SendLogint = "<<1000<<endl;
-	//delete [] lpSendBuffer;
-	//lpSendBuffer = NULL;
-
-	for(;;)
+	//һӦұرգÿӦ
+	int liFailed = 0;
+	int liReplyTotal = 0;
+	for(int i = 0; i < liConnectCount; i++)
 	{
-		moHallTrans.SendData();
-		if(!moHallTrans.RecvData())
-		{
-			cout<<"recv data error"<<endl;
-			break;
-		}
-		char buffer[DEF_BUFFER_LEN];
-		memset(buffer, 0, DEF_BUFFER_LEN);
-		int length = 0;
-		bool bRecvData = moHallTrans.RecvData(buffer, length);
-		bool lbProcessExit = false;
-		if(bRecvData)
+		STRU_TEST_CONNECT &loConn = loConnect[i];
+		liReplyTotal += loConn.miReply;
+		bool lbOk = loConfig.keep_alive ? (loConn.miReply >= liRequestCount && !loConn.mbClosed)
+			: (loConn.miReply >= 1 && loConn.mbClosed);
+		if(!lbOk)
 		{
-			cout<<"client length = "<<length<<" buffer = "<<buffer<<endl;
-			//CNetPackLogout loLogout;
-			//loLogout.Unpack(buffer, length);
-			//cout<<"RecvLogout = "<<loLogout.miId<<endl;
-			break;
+			++liFailed;
+			TRACE(1, "TaskProcessorTest Ӽʧܡindex = "<<i<<" reply = "<<loConn.miReply
+				<<" closed = "<<loConn.mbClosed);
 		}
+		loConn.mpSocket->Close();
+		delete loConn.mpSocket;
 	}
-	moHallTrans.Close();
-	return 0;
-}
\ No newline at end of file
+	cout<<"keep_alive = "<<loConfig.keep_alive<<" pipeline = "<<loConfig.pipeline
+		<<" connect = "<<liConnectCount<<" request = "<<liRequestCount
+		<<" reply = "<<liReplyTotal<<" failed = "<<liFailed<<endl;
+	return liFailed > 0 ? 1 : 0;
+}
@@ -12,11 +12,45 @@
 #ifndef _I_TASK_PROCESS_H_
 #define _I_TASK_PROCESS_H_
 
+#include "include.h"
+#include "NetPack.h"
+
+//һľComplete֮ǰһֱЧ
+class ITaskRequest
+{
+public:
+	virtual ~ITaskRequest(){}
+	//壬ˮģʽȥͷ
+	virtual const char* GetData() = 0;
+	virtual int GetLength() = 0;
+	//ˮģʽΪͻ˴IDΪ0
+	virtual uint32 GetRequestId() = 0;
+	//׷ӦݣԶεãܳޣһʱ˳ֳɶ
+	virtual bool Append(const char *buffer, int length) = 0;
+	//ɣ̵߳һΣ֮ʹ
+	virtual void Complete() = 0;
+};
+
 class ITaskProcess
 {
 public:
 	virtual ~ITaskProcess(){}
+	//ͬӦܳDEF_BUFFER_LEN
 	virtual void TaskProcessFun(const char *buffer, const int length, char *rtn, int &rtn_len) = 0;
+	//첽ĬϵTaskProcessFun
+	//԰apRequesṭ߳Completeͬһӽ
+	virtual void TaskProcessAsync(ITaskRequest *apRequest)
+	{
+		char rtn[DEF_BUFFER_LEN];
+		memset(rtn, 0, DEF_BUFFER_LEN);
+		int rtn_len = 0;
+		TaskProcessFun(apRequest->GetData(), apRequest->GetLength(), rtn, rtn_len);
+		if(rtn_len > 0)
+		{
+			apRequest->Append(rtn, rtn_len);
+		}
+		apRequest->Complete();
+	}
 };
 #endif//_I_TASK_PROCESS_H_
 
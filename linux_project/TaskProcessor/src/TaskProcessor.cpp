@@ -10,16 +10,93 @@ author:		isold
 purpose:	
 *********************************************************************/
 #include "TaskProcessor.h"
+#include <sys/prctl.h>
 
+/************************************************************************/
+/*
+CTaskRequest
+*/
+/************************************************************************/
+CTaskRequest::CTaskRequest(CTaskProcessor *apProcessor, int fd, uint32 aiConnSeq, uint32 aiRequestId,
+	const char *buffer, int length, int aiHeadLen)
+	: mstrData(buffer, length)
+{
+	m_pProcessor = apProcessor;
+	miFd = fd;
+	miConnSeq = aiConnSeq;
+	miRequestId = aiRequestId;
+	miHeadLen = aiHeadLen;
+}
+
+CTaskRequest::~CTaskRequest()
+{
+	for(size_t i = 0; i < moSegment.size(); i++)
+	{
+		moSegment[i]->Release();
+	}
+	moSegment.clear();
+}
+
+bool CTaskRequest::Append(const char *buffer, int length)
+{
+	while(length > 0)
+	{
+		if(moSegment.empty() || moSegment.back()->miLength >= DEF_TASK_SEGMENT_LEN)
+		{
+			CNetChunk *lpChunk = CNetChunk::Alloc(DEF_TASK_SEGMENT_LEN);
+			if(NULL == lpChunk)
+			{
+				return false;
+			}
+			lpChunk->miLength = miHeadLen;
+			moSegment.push_back(lpChunk);
+		}
+		CNetChunk *lpChunk = moSegment.back();
+		int liCopy = DEF_TASK_SEGMENT_LEN - lpChunk->miLength;
+		if(liCopy > length)
+		{
+			liCopy = length;
+		}
+		memcpy(lpChunk->GetBuffer() + lpChunk->miLength, buffer, liCopy);
+		lpChunk->miLength += liCopy;
+		buffer += liCopy;
+		length -= liCopy;
+	}
+	return true;
+}
+
+void CTaskRequest::Complete()
+{
+	m_pProcessor->PostDone(this);
+}
+
+/************************************************************************/
+/*
+CTaskProcessor
+*/
+/************************************************************************/
 CTaskProcessor::CTaskProcessor()
 {
 	m_pConfig = NULL;
 	m_pTaskProcess = NULL;
+	mpWorker = NULL;
+	miWorkerCount = 0;
+	miNextWorker = 0;
+	miBacklogCount = 0;
+	moLoopThread = pthread_self();
+	mbInLoopProcess = false;
 }
 
 CTaskProcessor::~CTaskProcessor()
 {
-	if(m_Listener.moNetStat == TCP_LISTEN)
+	if(!moThreadManager.IsStop())
+		moThreadManager.StopAll();
+	if(mpWorker != NULL)
+	{
+		delete [] mpWorker;
+		mpWorker = NULL;
+	}
+	if(m_Listener.moNetStat == COMMON_TCP_LISTEN)
 		m_Listener.Close();
 }
 
@@ -29,86 +106,123 @@ void CTaskProcessor::SetConfigInfo(CTaskProcessorConfig *apConfig)
 	m_pConfig = apConfig;
 }
 
-int CTaskProcessor::Run()
+bool CTaskProcessor::InitListener(bool abReusePort)
 {
 	struct sockaddr_in addr;
 	addr.sin_addr.s_addr = m_pConfig->tps_ip;
-	bool bRet = m_Listener.CreateSocket(inet_ntoa(addr.sin_addr), m_pConfig->tps_port);
+	m_Listener.SetNetPack(&moNetPack);
+	bool bRet = m_Listener.CreateSocket(inet_ntoa(addr.sin_addr), m_pConfig->tps_port, abReusePort);
 	if(!bRet)
 	{
-		return FAILED;
+		return false;
 	}
 
 	bRet = m_Listener.SetNoBlock();
 	if(!bRet)
 	{
 		m_Listener.Close();
-		return FAILED;
+		return false;
 	}
 	bRet = m_Listener.Listen();
 	if(!bRet)
 	{
 		m_Listener.Close();
-		return FAILED;
+		return false;
 	}
-	m_Listener.moNetStat = TCP_LISTEN;
 	m_Listener.mbListenSocket = true;
+	return true;
+}
+
+int CTaskProcessor::Run()
+{
+	//ö˿ڸʱڸ̼ӽ̹
+	if(!m_pConfig->reuse_port && !InitListener(false))
+	{
+		return FAILED;
+	}
+	//˿ڸʱӽ̸ԼŰһΣ˿ڲþͲӽ
+	//Ϲرգں˻ӷ̵ָsocket
+	if(m_pConfig->reuse_port)
+	{
+		if(!InitListener(true))
+		{
+			TRACE(1, "CTaskProcessor::Run socketʧܡport = "<<m_pConfig->tps_port);
+			return FAILED;
+		}
+		m_Listener.Close();
+	}
 
-	TRACE(5, "CTaskProcessor::Run ӽ̸: "<<m_pConfig->max_processor);
+	TRACE(5, "CTaskProcessor::Run ӽ̸: "<<m_pConfig->max_processor
+		<<" ߳: "<<m_pConfig->worker_threads<<" ˿ڸ: "<<m_pConfig->reuse_port);
 
 	for(uint32 i = 0; i < m_pConfig->max_processor; i++)
 	{
-		pid_t nPid;
-		if ((nPid = fork()) < 0)
+		if(!ForkChild())
 		{
-			TRACE(1, "CTaskProcessor::Run ӽʧܡ ");
 			kill(0, SIGKILL);
 			return FAILED;
 		}
-		else if (nPid == 0)
-		{
-			ChildProcess(this);
-		}
-		else
-		{
-			TRACE(1, "CTaskProcessor::Run Child PID: "<<nPid<<" PID: "<<getpid());
-		}
 	}
 
+	//ȴӽ˳˳һһ
+	//ӽʼʧʱӳȴٲ
+	uint32 liInitFailed = 0;
 	for(;;)
 	{
-		pid_t pt;
 		int status = 0;
-		pt = waitpid(-1, &status, WNOHANG);
+		pid_t pt = waitpid(-1, &status, 0);
 		if(-1 == pt)
 		{
-			if(errno != ECHILD)
+			if(EINTR == errno)
 			{
-				TRACE(1, "CTaskProcessor::Run wait_pid ִerrno = "<<errno);
+				continue;
 			}
+			TRACE(1, "CTaskProcessor::Run wait_pid ִerrno = "<<errno);
+			break;
 		}
-		else if(pt > 0)
+		TRACE(1, "CTaskProcessor::Run ӽ˳PID: "<<pt<<" status = "<<status);
+		if(WIFEXITED(status) && DEF_TASK_INIT_FAILED == WEXITSTATUS(status))
 		{
-			pid_t nPid;
-			if ((nPid = fork()) < 0)
+			if(++liInitFailed > DEF_TASK_MAX_INIT_FAILED)
 			{
-				TRACE(1, "CTaskProcessor::Run ӽʧܡ ");
+				TRACE(1, "CTaskProcessor::Run ӽʼʧܣ˳: "<<liInitFailed);
 				kill(0, SIGKILL);
+				break;
 			}
-			else if (nPid == 0)
-			{
-				ChildProcess(this);
-			}
-			else
-			{
-				TRACE(1, "CTaskProcessor::ChildProcessFun Child PID: "<<nPid<<" PID: "<<getpid());
-			}
-
+			sleep(liInitFailed);
+		}
+		else
+		{
+			liInitFailed = 0;
+		}
+		if(!ForkChild())
+		{
+			kill(0, SIGKILL);
+			break;
 		}
-		usleep(1000*100);
 	}
-	return SUCCEEDED;
+	return FAILED;
+}
+
+bool CTaskProcessor::ForkChild()
+{
+	pid_t nPid;
+	if ((nPid = fork()) < 0)
+	{
+		TRACE(1, "CTaskProcessor::ForkChild ӽʧܡerrno = "<<errno);
+		return false;
+	}
+	else if (nPid == 0)
+	{
+		ChildProcess(this);
+	}
+	else
+	{
+		TRACE(1, "CTaskProcessor::ForkChild Child PID: "<<nPid<<" PID: "<<getpid());
+	}
+	return true;
 }
+
 void CTaskProcessor::ChildProcess(void *parameter)
 {
 	ASSERT(parameter != NULL);
@@ -123,28 +237,59 @@ void CTaskProcessor::ChildProcessFun()
 	try
 	{
 		int liParentId = getppid();
-		if(1 == liParentId)
+		//˳ʱںֱӽӽ̣ѯ
+		prctl(PR_SET_PDEATHSIG, SIGKILL);
+		if(1 == getppid())
 		{
 			TRACE(1, "CTaskProcessor::ChildProcessFun ˳ˡID = "<<liParentId);
 			exit(0);
 		}
 
-		CNetEpoll loNetEpoll;
-		bool bRet = loNetEpoll.Init();
+		//ÿӽԼļsocketں˰ӷַûоȺ
+		if(m_pConfig->reuse_port && !InitListener(true))
+		{
+			TRACE(1, "CTaskProcessor::ChildProcessFun socketʧܡport = "<<m_pConfig->tps_port);
+			exit(DEF_TASK_INIT_FAILED);
+		}
+
+		//ֵ֧㷨SetCompress־԰ѹ
+		moNetPack.SetCompress(m_pConfig->compress_type, m_pConfig->compress_threshold);
+		moNetEpoll.SetPack(&moNetPack);
+		bool bRet = moNetEpoll.Init();
 		if(!bRet)
 		{
 			TRACE(1, "CTaskProcessor::ChildProcessFun EPOLLʼʧܡ");
-			exit(0);
+			exit(DEF_TASK_INIT_FAILED);
 		}
-		bRet = loNetEpoll.Addfd(&m_Listener);
+		STRU_NET_TIMEOUT loTimeOut;
+		loTimeOut.miIdleTimeOut = (unsigned int)m_pConfig->connected_time_out;
+		moNetEpoll.SetTimeOut(loTimeOut);
+		bRet = moNetEpoll.Addfd(&m_Listener);
 		if(!bRet)
 		{
 			TRACE(1, "CTaskProcessor::ChildProcessFun Ӽ˿ڵEPOLLʧܡ");
-			loNetEpoll.Destroy();
-			exit(0);
+			moNetEpoll.Destroy();
+			exit(DEF_TASK_INIT_FAILED);
+		}
+		moNetEpoll.mbHasListenFd = true;
+		moNetEpoll.RecvFrom.connect(this, &CTaskProcessor::DealData);
+		moNetEpoll.OnAccept.connect(this, &CTaskProcessor::OnAccept);
+		//ɵ߳̽߳
+		moLoopThread = pthread_self();
+		if(!moDoneQueue.Init(DEF_TASK_DONE_QUEUE_SIZE) || !moNetEpoll.EnableWakeup())
+		{
+			TRACE(1, "CTaskProcessor::ChildProcessFun ɶгʼʧܡ");
+			moNetEpoll.Destroy();
+			exit(DEF_TASK_INIT_FAILED);
 		}
-		loNetEpoll.mbHasListenFd = true;
-		loNetEpoll.RecvFrom.connect(this, &CTaskProcessor::DealData);
+		moNetEpoll.OnWakeup.connect(this, &CTaskProcessor::OnWakeup);
+		if(m_pConfig->worker_threads > 0 && !StartWorker())
+		{
+			TRACE(1, "CTaskProcessor::ChildProcessFun ߳ʧܡ");
+			moNetEpoll.Destroy();
+			exit(DEF_TASK_INIT_FAILED);
+		}
+
 		for(;;)
 		{
 			int liCurrentParentId = getppid();
@@ -155,33 +300,50 @@ void CTaskProcessor::ChildProcessFun()
 				break;
 			}
 
-			if(loNetEpoll.GetConnectedSize() > m_pConfig->max_connected)
+			if(moNetEpoll.mbHasListenFd && moNetEpoll.GetConnectedSize() > m_pConfig->max_connected)
 			{
 				TRACE(1, "CTaskProcessor::ChildProcessFun ǰ: "<<
-					loNetEpoll.GetConnectedSize()<<" Ӹ: "<<m_pConfig->max_connected);
-				loNetEpoll.Delfd(&m_Listener);
-				loNetEpoll.mbHasListenFd = false;
+					moNetEpoll.GetConnectedSize()<<" Ӹ: "<<m_pConfig->max_connected);
+				moNetEpoll.Delfd(&m_Listener);
+				moNetEpoll.mbHasListenFd = false;
+				//˿ڸʱںӷֵsocketϣֹֻͣacceptһֱŶ
+				//صsocketں˷ָӽ̣ڶûacceptӱ
+				if(m_pConfig->reuse_port)
+				{
+					m_Listener.Close();
+				}
 			}
 
-			if(loNetEpoll.GetConnectedSize() < m_pConfig->max_connected)
+			if(!moNetEpoll.mbHasListenFd && moNetEpoll.GetConnectedSize() < m_pConfig->max_connected)
 			{
-				if(!loNetEpoll.mbHasListenFd)
+				if(m_pConfig->reuse_port && !InitListener(true))
+				{
+					TRACE(1, "CTaskProcessor::ChildProcessFun ¼ʧܡport = "<<m_pConfig->tps_port);
+				}
+				else
 				{
-					loNetEpoll.Addfd(&m_Listener);
-					loNetEpoll.mbHasListenFd = true;
+					moNetEpoll.Addfd(&m_Listener);
+					moNetEpoll.mbHasListenFd = true;
 				}
 			}
 
-			int nRet = loNetEpoll.CheckEpollEvent();
-			loNetEpoll.ProcessEpollEvent(nRet);
-			loNetEpoll.SendData();
-			loNetEpoll.RecvData();
-			if(!m_pConfig->keep_alive)
+			//û¼ʱӶʱʱȵһʱ̶ֿ
+			int nRet = moNetEpoll.CheckEpollEvent(DEF_TASK_LOOP_TIMEOUT);
+			if(nRet > 0)
+			{
+				moNetEpoll.ProcessEpollEvent(nRet);
+			}
+			moNetEpoll.ProcessTimer();
+			if(miBacklogCount > 0)
 			{
-				loNetEpoll.CloseConnect();
+				FlushBacklog();
+			}
+			if(!moClosing.empty())
+			{
+				CloseSentConnect();
 			}
-			usleep(1000*100);
 		}
+		moThreadManager.StopAll();
 	}
 	catch (...)
 	{
@@ -190,16 +352,126 @@ void CTaskProcessor::ChildProcessFun()
 	exit(0);
 }
 
-void CTaskProcessor::DealData(CNetSocket* fd, char *buffer, int length)
+bool CTaskProcessor::StartWorker()
+{
+	miWorkerCount = m_pConfig->worker_threads;
+	if(miWorkerCount > DEF_MAX_TASK_WORKER)
+	{
+		miWorkerCount = DEF_MAX_TASK_WORKER;
+	}
+	uint32 liQueueSize = m_pConfig->worker_queue_size;
+	if(0 == liQueueSize)
+	{
+		liQueueSize = DEF_TASK_QUEUE_SIZE;
+	}
+	mpWorker = new STRU_TASK_WORKER[miWorkerCount];
+	for(uint32 i = 0; i < miWorkerCount; i++)
+	{
+		if(!mpWorker[i].moQueue.Init(liQueueSize) || !mpWorker[i].moNotify.Create())
+		{
+			return false;
+		}
+	}
+	uint32 liCount = moThreadManager.Start(WorkerThread, this, miWorkerCount, (char*)"task_worker");
+	return liCount == miWorkerCount;
+}
+
+unsigned int CTaskProcessor::WorkerThread(STRU_THREAD_CONTEXT& apContext)
+{
+	try
+	{
+		CTaskProcessor *p = reinterpret_cast<CTaskProcessor*>(apContext.mpWorkContext);
+		ASSERT(p != NULL);
+		STRU_TASK_WORKER &loWorker = p->mpWorker[apContext.moThreadStat.GetThreadIndex()];
+		CTaskRequest *lpRequest = NULL;
+		while(!p->moThreadManager.IsStop())
+		{
+			if(!loWorker.moQueue.Pop(lpRequest))
+			{
+				loWorker.moNotify.BeginWait();
+				if(loWorker.moQueue.IsEmpty())
+				{
+					loWorker.moNotify.Wait(DEF_TASK_LOOP_TIMEOUT);
+				}
+				else
+				{
+					loWorker.moNotify.EndWait();
+				}
+				continue;
+			}
+			p->m_pTaskProcess->TaskProcessAsync(lpRequest);
+		}
+	}
+	catch (...)
+	{
+		TRACE(1, "CTaskProcessor::WorkerThread 쳣");
+	}
+	return 0;
+}
+
+void CTaskProcessor::OnAccept(int fd)
+{
+	if(fd < 0)
+		return;
+	if((uint32)fd >= moConnSeq.size())
+	{
+		moConnSeq.resize(fd + 1024, 0);
+	}
+	++moConnSeq[fd];
+}
+
+void CTaskProcessor::DealData(int fd, char *buffer, int length)
 {
 	try
 	{
-		char rtn[DEF_BUFFER_LEN];
-		memset(rtn, 0, DEF_BUFFER_LEN);
-		int rtn_len = 0;
-		m_pTaskProcess->TaskProcessFun(buffer, length, rtn, rtn_len);
-		fd->SendData(rtn, rtn_len);
-		fd->moSendStat = SENDINT;
+		uint32 liRequestId = 0;
+		int liHeadLen = 0;
+		if(m_pConfig->pipeline)
+		{
+			liHeadLen = sizeof(STRU_TASK_HEAD);
+			if(length < liHeadLen)
+			{
+				TRACE(1, "CTaskProcessor::DealData ûͷfd = "<<fd<<" length = "<<length);
+				return;
+			}
+			STRU_TASK_HEAD loHead;
+			memcpy(&loHead, buffer, sizeof(loHead));
+			liRequestId = ntohl(loHead.miRequestId);
+		}
+		uint32 liConnSeq = ((uint32)fd < moConnSeq.size()) ? moConnSeq[fd] : 0;
+		CTaskRequest *lpRequest = new CTaskRequest(this, fd, liConnSeq, liRequestId,
+			buffer + liHeadLen, length - liHeadLen, liHeadLen);
+
+		if(0 == miWorkerCount)
+		{
+			ProcessInLoop(lpRequest);
+			return;
+		}
+		if(!m_pConfig->pipeline)
+		{
+			//һһӹ̶ͬһ̣߳Ӧܰ˳򷵻
+			//ʱҲֱ߳Ӵŵͬһӵǰ
+			STRU_TASK_WORKER &loPinned = mpWorker[fd % miWorkerCount];
+			if(!loPinned.moBacklog.empty() || !loPinned.moQueue.Push(lpRequest))
+			{
+				TRACE(3, "CTaskProcessor::DealData ̶߳ݴ档fd = "<<fd);
+				loPinned.moBacklog.push_back(lpRequest);
+				++miBacklogCount;
+				return;
+			}
+			loPinned.moNotify.Notify();
+			return;
+		}
+		STRU_TASK_WORKER &loWorker = mpWorker[miNextWorker];
+		miNextWorker = (miNextWorker + 1) % miWorkerCount;
+		if(!loWorker.moQueue.Push(lpRequest))
+		{
+			//̻߳ѹʱֱ߳ӴˮߵӦIDҪ˳
+			TRACE(3, "CTaskProcessor::DealData ̶߳fd = "<<fd);
+			ProcessInLoop(lpRequest);
+			return;
+		}
+		loWorker.moNotify.Notify();
 	}
 	catch (...)
 	{
@@ -207,6 +479,138 @@ void CTaskProcessor::DealData(CNetSocket* fd, char *buffer, int length)
 	}
 }
 
+void CTaskProcessor::ProcessInLoop(CTaskRequest *apRequest)
+{
+	mbInLoopProcess = true;
+	m_pTaskProcess->TaskProcessAsync(apRequest);
+	mbInLoopProcess = false;
+	OnWakeup();
+}
+
+void CTaskProcessor::FlushBacklog()
+{
+	for(uint32 i = 0; i < miWorkerCount; i++)
+	{
+		STRU_TASK_WORKER &loWorker = mpWorker[i];
+		if(loWorker.moBacklog.empty())
+			continue;
+		uint32 liPushed = 0;
+		while(!loWorker.moBacklog.empty() && loWorker.moQueue.Push(loWorker.moBacklog.front()))
+		{
+			loWorker.moBacklog.pop_front();
+			++liPushed;
+		}
+		if(liPushed > 0)
+		{
+			miBacklogCount -= liPushed;
+			loWorker.moNotify.Notify();
+		}
+	}
+}
+
+void CTaskProcessor::PostDone(CTaskRequest *apRequest)
+{
+	bool lbInLoop = pthread_equal(pthread_self(), moLoopThread);
+	while(!moDoneQueue.Push(apRequest))
+	{
+		if(lbInLoop)
+		{
+			OnWakeup();
+			continue;
+		}
+		moNetEpoll.Wakeup();
+		usleep(1000);
+	}
+	//̴߳ŷͣû
+	if(!(lbInLoop && mbInLoopProcess))
+	{
+		moNetEpoll.Wakeup();
+	}
+}
+
+void CTaskProcessor::OnWakeup()
+{
+	CTaskRequest *lpRequest[64];
+	uint32 liCount = 0;
+	while((liCount = moDoneQueue.PopBatch(lpRequest, 64)) > 0)
+	{
+		for(uint32 i = 0; i < liCount; i++)
+		{
+			int fd = lpRequest[i]->miFd;
+			//ѾϿӸõģӦ
+			if((uint32)fd < moConnSeq.size() && moConnSeq[fd] == lpRequest[i]->miConnSeq)
+			{
+				SendReply(lpRequest[i]);
+			}
+			delete lpRequest[i];
+		}
+	}
+}
+
+void CTaskProcessor::SendReply(CTaskRequest *apRequest)
+{
+	int fd = apRequest->miFd;
+	std::vector<CNetChunk*> &loSegment = apRequest->moSegment;
+	if(m_pConfig->pipeline)
+	{
+		//ûӦҲһֻͷİͻ˾ݴ˽
+		if(loSegment.empty())
+		{
+			CNetChunk *lpChunk = CNetChunk::Alloc(DEF_TASK_SEGMENT_LEN);
+			if(NULL == lpChunk)
+			{
+				return;
+			}
+			lpChunk->miLength = sizeof(STRU_TASK_HEAD);
+			loSegment.push_back(lpChunk);
+		}
+		for(size_t i = 0; i < loSegment.size(); i++)
+		{
+			STRU_TASK_HEAD loHead;
+			loHead.miRequestId = htonl(apRequest->miRequestId);
+			loHead.miFlag = htonl((i + 1 < loSegment.size()) ? TASK_FLAG_MORE : 0);
+			memcpy(loSegment[i]->GetBuffer(), &loHead, sizeof(loHead));
+			moNetEpoll.SendData(fd, loSegment[i]->GetBuffer(), loSegment[i]->miLength);
+		}
+	}
+	else
+	{
+		for(size_t i = 0; i < loSegment.size(); i++)
+		{
+			moNetEpoll.SendData(fd, loSegment[i]->GetBuffer(), loSegment[i]->miLength);
+		}
+	}
+	//ӦرգܻRecvFromصsocketܵɾ
+	//ͳһŵ¼CloseSentConnectرգӦϴʱȷͶз
+	if(!m_pConfig->keep_alive)
+	{
+		moClosing.push_back(std::make_pair(fd, apRequest->miConnSeq));
+	}
+}
+
+void CTaskProcessor::CloseSentConnect()
+{
+	size_t liKeep = 0;
+	for(size_t i = 0; i < moClosing.size(); i++)
+	{
+		int fd = moClosing[i].first;
+		if((uint32)fd >= moConnSeq.size() || moConnSeq[fd] != moClosing[i].second)
+		{
+			continue;
+		}
+		int liBytes = moNetEpoll.GetSendQueueBytes(fd);
+		if(liBytes > 0)
+		{
+			moClosing[liKeep++] = moClosing[i];
+		}
+		else if(0 == liBytes)
+		{
+			moNetEpoll.Delfd(fd);
+		}
+	}
+	moClosing.resize(liKeep);
+}
+
 void CTaskProcessor::SetDealDataPtr(ITaskProcess *apTaskProcessPtr)
 {
 	ASSERT(apTaskProcessPtr != NULL);
@@ -17,11 +17,77 @@
 #include "NetAddress.h"
 #include "NetEpoll.h"
 #include "NetSocket.h"
+#include "NetChunk.h"
+#include "RingQueue.h"
+#include "ThreadGroup.h"
 #include "TaskProcessorConfig.h"
 #include "ITaskProcess.h"
+#include <vector>
+#include <deque>
+
+//߳û¼ʱȴʱ䣬ʱ鸸̺ͼ״̬
+#define DEF_TASK_LOOP_TIMEOUT 1000
+#define DEF_TASK_QUEUE_SIZE 1024
+#define DEF_TASK_DONE_QUEUE_SIZE 65536
+#define DEF_MAX_TASK_WORKER 64
+//ӽ̳ʼʧܵ˳룬̾ݴӳؽ
+#define DEF_TASK_INIT_FAILED 2
+//ӽʼʧܵ
+#define DEF_TASK_MAX_INIT_FAILED 5
+//һӦƬ()󳤶ȣͷͼܲ
+#define DEF_TASK_SEGMENT_LEN (DEF_BUFFER_LEN - 64)
+//滹ͬһӦƬ
+#define TASK_FLAG_MORE 0x1
+
+//ˮģʽÿӦƬǰͷֽ
+struct STRU_TASK_HEAD
+{
+	uint32 miRequestId;
+	uint32 miFlag;
+};
+
+class CTaskProcessor;
+
+//һ̴߳ɺComplete̷߳Ͳͷ
+class CTaskRequest : public ITaskRequest
+{
+public:
+	CTaskRequest(CTaskProcessor *apProcessor, int fd, uint32 aiConnSeq, uint32 aiRequestId,
+		const char *buffer, int length, int aiHeadLen);
+	virtual ~CTaskRequest();
+
+	virtual const char* GetData(){ return mstrData.c_str(); }
+	virtual int GetLength(){ return (int)mstrData.size(); }
+	virtual uint32 GetRequestId(){ return miRequestId; }
+	virtual bool Append(const char *buffer, int length);
+	virtual void Complete();
+
+public:
+	int miFd;
+	//ӵţʱһ˵fdѾ
+	uint32 miConnSeq;
+	uint32 miRequestId;
+	//ӦƬÿƬǰmiHeadLenֽSTRU_TASK_HEAD
+	std::vector<CNetChunk*> moSegment;
+	int miHeadLen;
+
+private:
+	CTaskProcessor *m_pProcessor;
+	std::string mstrData;
+};
+
+//̵̣߳߳
+struct STRU_TASK_WORKER
+{
+	CSpscRingQueue<CTaskRequest*> moQueue;
+	CQueueNotify moNotify;
+	//һһģʽʱ˳ݴ棬̷ֻ߳
+	std::deque<CTaskRequest*> moBacklog;
+};
 
 class CTaskProcessor : public sigslot::has_slots<>
 {
+	friend class CTaskRequest;
 public:
 	CTaskProcessor();
 	~CTaskProcessor();
@@ -29,15 +95,48 @@ public:
 	void SetConfigInfo(CTaskProcessorConfig *apConfig);
 	void SetDealDataPtr(ITaskProcess *apTaskProcessPtr);
 	int Run();
-	void DealData(CNetSocket* fd, char *buffer, int length);
+	void DealData(int fd, char *buffer, int length);
+	void OnAccept(int fd);
+	void OnWakeup();
 	static void ChildProcess(void *parameter);
+	static unsigned int WorkerThread(STRU_THREAD_CONTEXT& apContext);
 
 private:
+	bool ForkChild();
 	void ChildProcessFun();
+	bool InitListener(bool abReusePort);
+	bool StartWorker();
+	//߳ｻҵɵһ
+	void ProcessInLoop(CTaskRequest *apRequest);
+	//ݴŻش̶߳
+	void FlushBacklog();
+	//̵߳ã󽻻߳
+	void PostDone(CTaskRequest *apRequest);
+	void SendReply(CTaskRequest *apRequest);
+	//Ӧر
+	void CloseSentConnect();
 private:
 	CTaskProcessorConfig *m_pConfig;
 	ITaskProcess *m_pTaskProcess;
+	CNetPackVersion1 moNetPack;
 	CNetSocket m_Listener;
+	//ֻӽʹ
+	CNetEpoll moNetEpoll;
+	//fd -> ţʱ1
+	std::vector<uint32> moConnSeq;
+	//Ӧ𡢵ȷͶзٹرյĶӣfd
+	std::vector<std::pair<int, uint32> > moClosing;
+	STRU_TASK_WORKER *mpWorker;
+	uint32 miWorkerCount;
+	uint32 miNextWorker;
+	//߳ݴ
+	uint32 miBacklogCount;
+	//ɵ߳ȡ
+	CMpscRingQueue<CTaskRequest*> moDoneQueue;
+	pthread_t moLoopThread;
+	//߳ڵҵʱ߳ɵû
+	bool mbInLoopProcess;
+	CThreadGroup moThreadManager;
 };
 
 #endif//_TASK_PROCESSOR_H_
@@ -14,10 +14,18 @@
 
 CTaskProcessorConfig::CTaskProcessorConfig()
 {
+	tps_ip = 0;
 	tps_port = 0;
 	max_processor = 0;
 	max_connected = 0;
 	connected_time_out = 0;
+	keep_alive = false;
+	worker_threads = 0;
+	worker_queue_size = 0;
+	reuse_port = true;
+	pipeline = false;
+	compress_type = COMPRESS_NONE;
+	compress_threshold = DEF_COMPRESS_THRESHOLD;
 }
 
 CTaskProcessorConfig::~CTaskProcessorConfig()
@@ -60,6 +68,36 @@ bool CTaskProcessorConfig::parse_value(const char* key, const char* value)
 		keep_alive = (bool)strtol(value, NULL, 0);
 		return true;
 	}
+	if (!strcmp(key, "worker_thread_number")) 
+	{
+		worker_threads = (uint32)strtol(value, NULL, 0);
+		return true;
+	}
+	if (!strcmp(key, "reuse_port")) 
+	{
+		reuse_port = (bool)strtol(value, NULL, 0);
+		return true;
+	}
+	if (!strcmp(key, "worker_queue_size")) 
+	{
+		worker_queue_size = (uint32)strtol(value, NULL, 0);
+		return true;
+	}
+	if (!strcmp(key, "pipeline")) 
+	{
+		pipeline = (bool)strtol(value, NULL, 0);
+		return true;
+	}
+	if (!strcmp(key, "compress_type")) 
+	{
+		compress_type = (int)strtol(value, NULL, 0);
+		return true;
+	}
+	if (!strcmp(key, "compress_threshold")) 
+	{
+		compress_threshold = (int)strtol(value, NULL, 0);
+		return true;
+	}
 	return true;
 }
 
@@ -14,6 +14,7 @@
 
 #include "include.h"
 #include "Configure.h"
+#include "NetCompress.h"
 
 class CTaskProcessorConfig : public CConfigure
 {
@@ -28,6 +29,18 @@ public:
 	uint32 max_connected;
 	uint64 connected_time_out;
 	bool keep_alive;
+	//ÿӽ̴߳0ʾֱ߳Ӵ
+	uint32 worker_threads;
+	//ÿ̵߳гȣ0ΪĬֵDEF_TASK_QUEUE_SIZE
+	uint32 worker_queue_size;
+	//ÿӽSO_REUSEPORTԼں˷ַ
+	bool reuse_port;
+	//ӦǰSTRU_TASK_HEADͬһӿͬʱжӦ˳򷵻
+	bool pipeline;
+	//Ӧѹ㷨(ENUM_COMPRESS_TYPE)ֻڰͷܽѹ㷨ĿͻЧ
+	int compress_type;
+	//岻СڸóȲѹ
+	int compress_threshold;
 };
 
 #endif//_TASK_PROCESSOR_CONFIG_H_
@@ -18,8 +18,12 @@
 
 const string gstrTaskProcessorVersion = "1.0.0.1";
 
+CDebugTrace *goDebugTrace = NULL;
+
 int main(int argc, char* argv[])
 {
+	goDebugTrace = new CDebugTrace;
+
 	//óʼʱ־ѡ
 	SET_TRACE_LEVEL(5);
 	unsigned liOptions = (CDebugTrace::Timestamp | CDebugTrace::LogLevel\
@@ -35,7 +39,7 @@ int main(int argc, char* argv[])
 	CFileStream::CreatePath(lszLogFileName);
 
 	//TRACEļ
-	char lszFileDate[30] = "";
+	char lszFileDate[64] = "";
 	time_t loSystemTime;
 	time(&loSystemTime);
 	struct tm* lptm = localtime(&loSystemTime);
@@ -0,0 +1,96 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mps_buf_pool.h"
+
+int Init_BufPool(STRU_BUF_POOL &stPool, size_t uBufSize, size_t uMaxBufs)
+{
+    assert(uBufSize > 0);
+
+    bzero(&stPool, sizeof(stPool));
+
+    // ʱͷָ
+    if (uBufSize < sizeof(void*))
+    {
+        uBufSize = sizeof(void*);
+    }
+    stPool.uBufSize = (uBufSize + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+    stPool.uMaxBufs = uMaxBufs;
+
+    return 0;
+}
+
+void Destroy_BufPool(STRU_BUF_POOL &stPool)
+{
+    STRU_BUF_POOL_SLAB *pSlab = stPool.pSlabs;
+    while (pSlab)
+    {
+        STRU_BUF_POOL_SLAB *pNext = pSlab->pNext;
+        free(pSlab);
+        pSlab = pNext;
+    }
+
+    bzero(&stPool, sizeof(stPool));
+}
+
+/*!
+ * : һƬҵ
+ */
+static int Grow_BufPool(STRU_BUF_POOL &stPool)
+{
+    size_t uBufs = BUF_POOL_SLAB_BUFS;
+    if (stPool.uMaxBufs > 0)
+    {
+        if (stPool.uTotalBufs >= stPool.uMaxBufs)
+        {
+            return -1;
+        }
+        if (stPool.uTotalBufs + uBufs > stPool.uMaxBufs)
+        {
+            uBufs = stPool.uMaxBufs - stPool.uTotalBufs;
+        }
+    }
+
+    // ƬͷָС, 
+    STRU_BUF_POOL_SLAB *pSlab = (STRU_BUF_POOL_SLAB*)malloc(sizeof(STRU_BUF_POOL_SLAB) + uBufs * stPool.uBufSize);
+    if (!pSlab)
+    {
+        return -1;
+    }
+    pSlab->pNext = stPool.pSlabs;
+    stPool.pSlabs = pSlab;
+
+    char *pBuf = (char*)(pSlab + 1);
+    for (size_t i = 0; i < uBufs; i++, pBuf += stPool.uBufSize)
+    {
+        *(void**)pBuf = stPool.pFreeList;
+        stPool.pFreeList = pBuf;
+    }
+    stPool.uTotalBufs += uBufs;
+
+    return 0;
+}
+
+char* Alloc_Buf(STRU_BUF_POOL &stPool)
+{
+    if (!stPool.pFreeList && (Grow_BufPool(stPool) < 0))
+    {
+        return NULL;
+    }
+
+    char *pBuf = (char*)stPool.pFreeList;
+    stPool.pFreeList = *(void**)pBuf;
+    stPool.uUsedBufs++;
+
+    return pBuf;
+}
+
+void Free_Buf(STRU_BUF_POOL &stPool, char *pBuf)
+{
+    assert(pBuf && (stPool.uUsedBufs > 0));
+
+    *(void**)pBuf = stPool.pFreeList;
+    stPool.pFreeList = pBuf;
+    stPool.uUsedBufs--;
+}
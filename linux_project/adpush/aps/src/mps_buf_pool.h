@@ -0,0 +1,44 @@
+/*! @file mps_buf_pool.h
+ * *****************************************************************************
+ * @n</PRE>
+ * @nģ       : շ
+ * @nļ       : mps_buf_pool.h
+ * @nļ     : mps_buf_pool.cpp
+ * @nļʵֹ : Ƭ(slab)ϵͳ, ֻдʱ
+ * @n---------------------------------------------------------------------------
+ * @nע: , ֻepoll߳ʹ.
+ * @n      黹Ļһؿ, Ƭϵͳ, ֵɸ.
+ * @n---------------------------------------------------------------------------
+ * @n</PRE>
+ ******************************************************************************/
+#ifndef __MPS_BUF_POOL_H__
+#define __MPS_BUF_POOL_H__
+
+#include <sys/types.h>
+
+// ÿƬĻ
+#define BUF_POOL_SLAB_BUFS 64
+
+typedef struct _STRU_BUF_POOL_SLAB
+{
+    struct _STRU_BUF_POOL_SLAB *pNext;
+} STRU_BUF_POOL_SLAB;
+
+typedef struct
+{
+    size_t uBufSize;                    // ÿĴС
+    size_t uMaxBufs;                    // Ļ, 0ʾ
+    size_t uTotalBufs;                  // ѷĻ
+    size_t uUsedBufs;                   // δĻ
+    void *pFreeList;                    // л, ָڻͷ
+    STRU_BUF_POOL_SLAB *pSlabs;         // Ƭ
+} STRU_BUF_POOL;
+
+int Init_BufPool(STRU_BUF_POOL &stPool, size_t uBufSize, size_t uMaxBufs);
+void Destroy_BufPool(STRU_BUF_POOL &stPool);
+
+// ûпѴ޻ƬʧʱNULL
+char* Alloc_Buf(STRU_BUF_POOL &stPool);
+void Free_Buf(STRU_BUF_POOL &stPool, char *pBuf);
+
+#endif
@@ -85,6 +85,9 @@ typedef struct
 
     size_t uClientCnt;
     struct sockaddr_in stClientAddr[MAX_SRV_NUM];
+
+    // ӳʱ, ֲ, ÿΪSocketıͷ
+    int nTimerWheel[CONN_TIMER_WHEEL_SIZE];
 } STRU_RUNTIME;
 
 using namespace std;
@@ -127,6 +130,7 @@ int CloseSocket(int nSocket)
 
     // ӶɾǰSocket
     conn_rmv_list(nSocket, g_stRuntime.pSocketContext, g_stRuntime.nConn_Queue_Root);
+    timer_rmv_list(nSocket, g_stRuntime.pSocketContext, g_stRuntime.nTimerWheel);
 
     // Ƴepoll¼
     if (HJ_unregister_epoll_event(g_stRuntime.nEpfd, nSocket) < 0)
@@ -160,24 +164,44 @@ int ClearTimeoutConnections(time_t &tm_before)
 {
     time_t tm_now = time(NULL);
 
-    if (abs(tm_now - tm_before) < 5)
+    if (tm_now <= tm_before)
     {
+        // ͬһѾ, ʱӻز
+        tm_before = tm_now;
         return 0;
     }
-    else
+
+    // ֻϴμ֮ڵĲ, һȦʱÿ۴һ
+    time_t tm_slot = tm_before + 1;
+    if (tm_now - tm_before > CONN_TIMER_WHEEL_SIZE)
     {
-        tm_before = tm_now;
+        tm_slot = tm_now - CONN_TIMER_WHEEL_SIZE + 1;
     }
+    tm_before = tm_now;
 
-    time_t tm_interval;
+    time_t tm_expire;
     int nNextIndex;
-    for (int i = g_stRuntime.nConn_Queue_Root; i != -1; i = nNextIndex)
+    for (; tm_slot <= tm_now; tm_slot++)
     {
-        nNextIndex = g_stRuntime.pSocketContext[i].nNextIndex;
-
-        tm_interval = abs(tm_now - g_stRuntime.pSocketContext[i].tm_LastActive);
-        if (tm_interval > g_stConfig.lConnTimeout)
+        for (int i = g_stRuntime.nTimerWheel[tm_slot % CONN_TIMER_WHEEL_SIZE]; i != -1; i = nNextIndex)
         {
+            STRU_SOCKET_CONTEXT &stSocketContext = g_stRuntime.pSocketContext[i];
+            nNextIndex = stSocketContext.nTimerNext;
+
+            if (stSocketContext.tm_Expire > tm_now)
+            {
+                continue; // ҪתȦ
+            }
+
+            timer_rmv_list(i, g_stRuntime.pSocketContext, g_stRuntime.nTimerWheel);
+            tm_expire = stSocketContext.tm_LastActive + g_stConfig.lConnTimeout + 1;
+            if (tm_expire > tm_now)
+            {
+                // ڼй, ʱ¹
+                timer_add_list(i, g_stRuntime.pSocketContext, g_stRuntime.nTimerWheel, tm_expire);
+                continue;
+            }
+
             DEBUG_PRINT(LM_INFO, "ConnTimeout and CloseSocket iSocket:%d\n", i);
             CloseSocket(i);
         }
@@ -194,7 +218,12 @@ int ClearTimeoutConnections(time_t &tm_before)
  */
 int CheckConnStatus(void)
 {
+#if defined(USE_CLR_TIMEOUT)
+    // û¼ʱҲҪʱ鳬ʱ
+    int iRet = epoll_wait(g_stRuntime.nEpfd, g_stRuntime.pEvents, (int)g_stRuntime.uMaxSocketNum, 1000);
+#else
     int iRet = epoll_wait(g_stRuntime.nEpfd, g_stRuntime.pEvents, (int)g_stRuntime.uMaxSocketNum, -1);
+#endif
     if (iRet > 0)
     {
         return iRet;
@@ -301,6 +330,10 @@ int CheckAndAcceptConns(int nListenSocket)
 
         // ӵSocket뵽Ӷ
         conn_add_list(nNewSocket, g_stRuntime.pSocketContext, g_stRuntime.nConn_Queue_Root);
+#if defined(USE_CLR_TIMEOUT)
+        timer_add_list(nNewSocket, g_stRuntime.pSocketContext, g_stRuntime.nTimerWheel
+            , g_stRuntime.pSocketContext[nNewSocket].tm_LastActive + g_stConfig.lConnTimeout + 1);
+#endif
 
         uCurSocketNum++;
     } // end while (true)
@@ -766,6 +799,7 @@ int InitializeChildProcess(void)
             break;
         }
         bzero(g_stRuntime.pSocketContext, (g_stRuntime.uMaxSocketNum * sizeof(STRU_SOCKET_CONTEXT)));
+        memset(g_stRuntime.nTimerWheel, -1, sizeof(g_stRuntime.nTimerWheel));
 
         // ʼ׽ص״̬
         g_stRuntime.pSocketContext[g_stRuntime.nListen_Socket].nSocketType = LISTENER;
@@ -104,6 +104,10 @@ typedef struct
     int nPrevIndex;                     // Ӷеǰ
     int nNextIndex;                     // Ӷеĺ
 
+    int nTimerPrev;                     // ʱֲڵǰ
+    int nTimerNext;                     // ʱֲڵĺ
+    time_t tm_Expire;                   // ڳʱϵĵʱ, 0ʾδ
+
     int  nSocketType;                   // Socket״̬
     time_t tm_LoginTime;                // ӵ¼ʱ
     time_t tm_LastActive;               // ʱ
@@ -0,0 +1,211 @@
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+
+#include "mps_shm_ring.h"
+
+static inline STRU_SHM_RING_SLOT* Get_ShmRingSlot(STRU_SHM_RING &stRing, UINT64 u64Seq)
+{
+    return (STRU_SHM_RING_SLOT*)(stRing.pSlots + (u64Seq & (stRing.u64SlotNum - 1)) * stRing.uSlotSize);
+}
+
+int Create_ShmRing(STRU_SHM_RING &stRing, size_t uSlotNum, size_t uSlotDataLen, size_t uReaderNum)
+{
+    assert((uSlotNum > 0) && (uSlotDataLen > 0) && (uReaderNum > 0));
+
+    bzero(&stRing, sizeof(stRing));
+
+    UINT64 u64SlotNum = 2;
+    while (u64SlotNum < uSlotNum)
+    {
+        u64SlotNum <<= 1;
+    }
+
+    // ۰ж, ڲ۵д뻥
+    size_t uSlotSize = sizeof(STRU_SHM_RING_SLOT) + uSlotDataLen;
+    uSlotSize = (uSlotSize + SHM_RING_CACHE_LINE - 1) / SHM_RING_CACHE_LINE * SHM_RING_CACHE_LINE;
+
+    size_t uMapLen = sizeof(STRU_SHM_RING_HEAD) + uReaderNum * sizeof(STRU_SHM_RING_READER)
+        + u64SlotNum * uSlotSize;
+    char *pMap = (char*)mmap(NULL, uMapLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (pMap == MAP_FAILED)
+    {
+        return -1;
+    }
+
+    stRing.pHead = (STRU_SHM_RING_HEAD*)pMap;
+    stRing.pReaders = (STRU_SHM_RING_READER*)(pMap + sizeof(STRU_SHM_RING_HEAD));
+    stRing.pSlots = pMap + sizeof(STRU_SHM_RING_HEAD) + uReaderNum * sizeof(STRU_SHM_RING_READER);
+    stRing.u64SlotNum = u64SlotNum;
+    stRing.uSlotSize = uSlotSize;
+    stRing.uSlotDataLen = uSlotDataLen;
+    stRing.uReaderNum = uReaderNum;
+    stRing.uMapLen = uMapLen;
+
+    // ӳ, ֻòһȦŶ
+    for (UINT64 i = 0; i < u64SlotNum; i++)
+    {
+        Get_ShmRingSlot(stRing, i)->u64Seq = SHM_RING_SEQ_WRITING;
+    }
+
+    for (size_t i = 0; i < uReaderNum; i++)
+    {
+        stRing.pReaders[i].nEventFd = -1;
+    }
+    for (size_t i = 0; i < uReaderNum; i++)
+    {
+        stRing.pReaders[i].nEventFd = eventfd(0, 0);
+        if (stRing.pReaders[i].nEventFd < 0)
+        {
+            Destroy_ShmRing(stRing);
+            return -2;
+        }
+    }
+
+    return 0;
+}
+
+void Destroy_ShmRing(STRU_SHM_RING &stRing)
+{
+    if (!stRing.pHead)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < stRing.uReaderNum; i++)
+    {
+        if (stRing.pReaders[i].nEventFd >= 0)
+        {
+            close(stRing.pReaders[i].nEventFd);
+        }
+    }
+    munmap(stRing.pHead, stRing.uMapLen);
+    bzero(&stRing, sizeof(stRing));
+}
+
+int Push_ShmRing(STRU_SHM_RING &stRing, const char *pData, size_t uLen)
+{
+    if (uLen > stRing.uSlotDataLen)
+    {
+        return -1;
+    }
+
+    UINT64 u64Seq = stRing.pHead->u64WriteSeq;
+    STRU_SHM_RING_SLOT *pSlot = Get_ShmRingSlot(stRing, u64Seq);
+
+    // ȱǸд, ڶ۵߶ᷢű
+    pSlot->u64Seq = SHM_RING_SEQ_WRITING;
+    __sync_synchronize();
+    pSlot->u32Len = (UINT32)uLen;
+    memcpy(pSlot->szData, pData, uLen);
+    __sync_synchronize();
+    pSlot->u64Seq = u64Seq;
+    stRing.pHead->u64WriteSeq = u64Seq + 1;
+
+    return 0;
+}
+
+void Notify_ShmRing(STRU_SHM_RING &stRing)
+{
+    // ߵ"ȴټһд", ֤©
+    __sync_synchronize();
+
+    UINT64 u64Value = 1;
+    for (size_t i = 0; i < stRing.uReaderNum; i++)
+    {
+        STRU_SHM_RING_READER &stReader = stRing.pReaders[i];
+        if (stReader.nWaiting && __sync_bool_compare_and_swap(&stReader.nWaiting, 1, 0))
+        {
+            while ((write(stReader.nEventFd, &u64Value, sizeof(u64Value)) < 0) && (errno == EINTR))
+            {
+            }
+        }
+    }
+}
+
+int Pop_ShmRing(STRU_SHM_RING &stRing, size_t uReader, char *pBuffer, size_t uBufLen, UINT64 &u64GapPkgs)
+{
+    assert(uReader < stRing.uReaderNum);
+
+    STRU_SHM_RING_READER &stReader = stRing.pReaders[uReader];
+    UINT64 u64Read = stReader.u64ReadSeq;
+    UINT64 u64Gap = 0;
+    int nLen = 0;
+
+    for (;;)
+    {
+        UINT64 u64Write = stRing.pHead->u64WriteSeq;
+        __sync_synchronize();
+        if (u64Read == u64Write)
+        {
+            break;
+        }
+
+        // 󳬹һȦ, ֱûǵһ
+        if (u64Write - u64Read > stRing.u64SlotNum)
+        {
+            u64Gap += u64Write - stRing.u64SlotNum - u64Read;
+            u64Read = u64Write - stRing.u64SlotNum;
+        }
+
+        STRU_SHM_RING_SLOT *pSlot = Get_ShmRingSlot(stRing, u64Read);
+        size_t uLen = pSlot->u32Len;
+        if ((pSlot->u64Seq != u64Read) || (uLen > uBufLen))
+        {
+            // ձд׷ϸ
+            u64Gap++;
+            u64Read++;
+            continue;
+        }
+        __sync_synchronize();
+        memcpy(pBuffer, pSlot->szData, uLen);
+        __sync_synchronize();
+        if (pSlot->u64Seq != u64Read)
+        {
+            // ڼ䱻, ݲ
+            u64Gap++;
+            u64Read++;
+            continue;
+        }
+
+        u64Read++;
+        nLen = (int)uLen;
+        break;
+    }
+
+    stReader.u64ReadSeq = u64Read;
+    if (u64Gap > 0)
+    {
+        stReader.u64GapPkgs += u64Gap;
+        u64GapPkgs += u64Gap;
+    }
+
+    return nLen;
+}
+
+int Wait_ShmRing(STRU_SHM_RING &stRing, size_t uReader)
+{
+    assert(uReader < stRing.uReaderNum);
+
+    STRU_SHM_RING_READER &stReader = stRing.pReaders[uReader];
+
+    stReader.nWaiting = 1;
+    __sync_synchronize();
+    if (stRing.pHead->u64WriteSeq != stReader.u64ReadSeq)
+    {
+        // ȴ֮Ϣ; дѾ㲢, ´εȴ
+        __sync_bool_compare_and_swap(&stReader.nWaiting, 1, 0);
+        return 0;
+    }
+
+    UINT64 u64Value;
+    if ((read(stReader.nEventFd, &u64Value, sizeof(u64Value)) < 0) && (errno != EINTR))
+    {
+        return -1;
+    }
+
+    return 0;
+}
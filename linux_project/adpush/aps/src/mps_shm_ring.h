@@ -0,0 +1,80 @@
+/*! @file mps_shm_ring.h
+ * *****************************************************************************
+ * @n</PRE>
+ * @nģ       : ڴ㲥
+ * @nļ       : mps_shm_ring.h
+ * @nļ     : mps_shm_ring.cpp
+ * @nļʵֹ : ӿڻӽ̹㲥Ϣ, һд߶
+ * @n---------------------------------------------------------------------------
+ * @nע: forkӽ֮ǰ, ӽ̹ͬһڴ.
+ * @n      дߴӲȴ, 󳬹һȦʱǵϢΪ.
+ * @n      ÿһeventfd, ֻڶȴʱд.
+ * @n---------------------------------------------------------------------------
+ * @n</PRE>
+ ******************************************************************************/
+#ifndef __MPS_SHM_RING_H__
+#define __MPS_SHM_RING_H__
+
+#include <sys/types.h>
+
+#include "mps_pkg.h"
+
+#define SHM_RING_CACHE_LINE 64
+
+// дڸдʱϵ
+#define SHM_RING_SEQ_WRITING ((UINT64)-1)
+
+// ͷ, ֻд޸
+typedef struct
+{
+    volatile UINT64 u64WriteSeq;        // һϢ
+    char szPad[SHM_RING_CACHE_LINE - sizeof(UINT64)];
+} STRU_SHM_RING_HEAD;
+
+// ״̬, ֻжӦĶ޸(nWaitingд)
+typedef struct
+{
+    volatile UINT64 u64ReadSeq;         // һҪ
+    volatile UINT64 u64GapPkgs;         // ۼϢ
+    volatile int nWaiting;              // ȴ
+    int nEventFd;                       // 
+    char szPad[SHM_RING_CACHE_LINE - 2 * sizeof(UINT64) - 2 * sizeof(int)];
+} STRU_SHM_RING_READER;
+
+// Ϣ, ݽڲͷ
+typedef struct
+{
+    volatile UINT64 u64Seq;             // Ϣ
+    UINT32 u32Len;                      // Ϣ
+    char szData[0];
+} STRU_SHM_RING_SLOT;
+
+// ľ, forkӽ̸һ, ָͬһ鹲ڴ
+typedef struct
+{
+    STRU_SHM_RING_HEAD *pHead;
+    STRU_SHM_RING_READER *pReaders;
+    char *pSlots;
+    UINT64 u64SlotNum;                  // , 2
+    size_t uSlotSize;                   // ÿռõֽ
+    size_t uSlotDataLen;                // ÿϢ󳤶
+    size_t uReaderNum;
+    size_t uMapLen;
+} STRU_SHM_RING;
+
+// , ȡΪ2
+int Create_ShmRing(STRU_SHM_RING &stRing, size_t uSlotNum, size_t uSlotDataLen, size_t uReaderNum);
+void Destroy_ShmRing(STRU_SHM_RING &stRing);
+
+// д: дһϢ, Ѷ, -1
+int Push_ShmRing(STRU_SHM_RING &stRing, const char *pData, size_t uLen);
+// д: ڵȴĶ, һϢдһ
+void Notify_ShmRing(STRU_SHM_RING &stRing);
+
+// : ȡһϢpBuffer, س, ûϢ0
+// u64GapPkgsۼӱϢ
+int Pop_ShmRing(STRU_SHM_RING &stRing, size_t uReader, char *pBuffer, size_t uBufLen, UINT64 &u64GapPkgs);
+// : ûϢʱȴ
+int Wait_ShmRing(STRU_SHM_RING &stRing, size_t uReader);
+
+#endif
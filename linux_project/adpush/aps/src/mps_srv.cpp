@@ -32,6 +32,8 @@
 #include <string.h>
 #include <strings.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/resource.h>
@@ -57,6 +59,9 @@
 #include "mps_srv.h"
 #include "mps_pkg.h"
 #include "mps_util.h"
+#include "mps_shm_ring.h"
+#include "mps_svc_index.h"
+#include "mps_buf_pool.h"
 
 #if USE_LOAD_BALANCE
 const char szSrvAddrs[][16] = {"123.103.66.50", "123.103.66.51", "123.103.66.52"};
@@ -69,11 +74,14 @@ STRU_CONFIG          g_stConfig;
 // ûϢڴ
 CHJMemPool g_UsrInfoMempool;
 
+// ӿڻӽ̹㲥ϢĹڴ滷, fork֮ǰ
+STRU_SHM_RING g_stShmRing;
+
 typedef struct
 {
     // ǰ̵ĴID
     size_t uProcessId;
-    // ǰ̼Ϣudp socket
+    // ӿڻ̼Ϣudp socket
     int    nUdpSocket;
 
     // ǰÿֵ֧׽־С
@@ -100,6 +108,20 @@ typedef struct
     // ǰ¼û
     size_t uLoginUserNum;
 #endif
+
+    // ӳʱ, ֲ, ÿΪSocketıͷ
+    int nTimerWheel[CONN_TIMER_WHEEL_SIZE];
+
+    // ҵĶ, ҵ/ȫԱʱɨ
+    STRU_SVC_INDEX stSvcIndex;
+
+    // շ, ֻepoll߳ʹ
+    STRU_BUF_POOL stRecvBufPool;
+    STRU_BUF_POOL stSendBufPool;
+
+    // ַ߳ͶϢ, дϢӹ(ȳ), eventfdepoll߳
+    volatile int nSendReadyRoot;
+    int nSendNotifyFd;
 } STRU_RUNTIME;
 
 STRU_RUNTIME g_stRuntime = {0, -1, 0, -1, NULL, -1, NULL, -1, false, 0, NULL
@@ -117,17 +139,49 @@ using namespace std;
  */
 int ResetSocketContext(STRU_SOCKET_CONTEXT &stSocketContext)
 {
-    HJ_xchg(&stSocketContext.lSendLock, 0);
     stSocketContext.tm_LoginTime = stSocketContext.tm_LastActive = time(NULL);
     stSocketContext.bCloseOnSendAll = false;
     stSocketContext.lPkgLen = 0;
     stSocketContext.pUserinfo = NULL;
     stSocketContext.lRecvBytes = 0;
     stSocketContext.lToSendBytes = 0;
+    stSocketContext.lDropPkgs = 0;
+    // շڹرʱѾ黹; pSendQueue, ͶݸӵϢ,
+    // ҪDrainSendQueues, ظ
 
     return 0;
 }
 
+// ûδʱ黹ջ
+inline void ReleaseRecvBuffer(STRU_SOCKET_CONTEXT &stSocketContext)
+{
+    if (stSocketContext.pRecvBuffer && (stSocketContext.lRecvBytes == 0))
+    {
+        Free_Buf(g_stRuntime.stRecvBufPool, stSocketContext.pRecvBuffer);
+        stSocketContext.pRecvBuffer = NULL;
+    }
+}
+
+// ûд͵ʱ黹ͻ
+inline void ReleaseSendBuffer(STRU_SOCKET_CONTEXT &stSocketContext)
+{
+    if (stSocketContext.pSendBuffer && (stSocketContext.lToSendBytes == 0))
+    {
+        Free_Buf(g_stRuntime.stSendBufPool, stSocketContext.pSendBuffer);
+        stSocketContext.pSendBuffer = NULL;
+    }
+}
+
+// һӴͶݵϢ, һͷ
+inline void ReleaseSendNode(STRU_SEND_NODE *pNode)
+{
+    STRU_SEND_BLOCK *pBlock = pNode->pBlock;
+    if (__sync_sub_and_fetch(&pBlock->lRef, 1) == 0)
+    {
+        free(pBlock);
+    }
+}
+
 /*!
  * : رָsocket
  * @n: huangjun
@@ -149,6 +203,7 @@ int CloseSocket(int nSocket)
 
     // ӶɾǰSocket
     conn_rmv_list(nSocket, g_stRuntime.pSocketContext, g_stRuntime.nConn_Queue_Root);
+    timer_rmv_list(nSocket, g_stRuntime.pSocketContext, g_stRuntime.nTimerWheel);
 
     // Ƴepoll¼
     if (HJ_unregister_epoll_event(g_stRuntime.nEpfd, nSocket) < 0)
@@ -160,6 +215,8 @@ int CloseSocket(int nSocket)
     // صûϢ
     if (stSocketContext.pUserinfo)
     {
+        Remove_Subscriber(g_stRuntime.stSvcIndex, (unsigned short)nSocket);
+
         STRU_USERINFO_ACS *pUserinfoTmp = Remove_Userinfo(&g_stRuntime.pstUserListRoot[stSocketContext.pUserinfo->u16SvcId]
             , stSocketContext.pUserinfo->u64UsrId, (unsigned short)nSocket);
         if (pUserinfoTmp != stSocketContext.pUserinfo)
@@ -179,7 +236,12 @@ int CloseSocket(int nSocket)
 
     close(nSocket);
     stSocketContext.nSocketType = NOT_USED;
-    HJ_xchg(&stSocketContext.lSendLock, 0);
+    stSocketContext.u32Generation++;
+
+    stSocketContext.lRecvBytes = 0;
+    stSocketContext.lToSendBytes = 0;
+    ReleaseRecvBuffer(stSocketContext);
+    ReleaseSendBuffer(stSocketContext);
 
     g_stConfig.uCurSocketNum--;
 #ifdef TRACE_USER
@@ -197,6 +259,62 @@ int CloseSocket(int nSocket)
     return -1;
 }
 
+/*!
+ * : ʱ
+ * @nע: ֻʱϵڵĲ, ޹
+ */
+#if defined(USE_CLR_TIMEOUT)
+int ClearTimeoutConnections(time_t &tm_before)
+{
+    time_t tm_now = time(NULL);
+
+    if (tm_now <= tm_before)
+    {
+        // ͬһѾ, ʱӻز
+        tm_before = tm_now;
+        return 0;
+    }
+
+    // ֻϴμ֮ڵĲ, һȦʱÿ۴һ
+    time_t tm_slot = tm_before + 1;
+    if (tm_now - tm_before > CONN_TIMER_WHEEL_SIZE)
+    {
+        tm_slot = tm_now - CONN_TIMER_WHEEL_SIZE + 1;
+    }
+    tm_before = tm_now;
+
+    time_t tm_expire;
+    int nNextIndex;
+    for (; tm_slot <= tm_now; tm_slot++)
+    {
+        for (int i = g_stRuntime.nTimerWheel[tm_slot % CONN_TIMER_WHEEL_SIZE]; i != -1; i = nNextIndex)
+        {
+            STRU_SOCKET_CONTEXT &stSocketContext = g_stRuntime.pSocketContext[i];
+            nNextIndex = stSocketContext.nTimerNext;
+
+            if (stSocketContext.tm_Expire > tm_now)
+            {
+                continue; // ҪתȦ
+            }
+
+            timer_rmv_list(i, g_stRuntime.pSocketContext, g_stRuntime.nTimerWheel);
+            tm_expire = stSocketContext.tm_LastActive + g_stConfig.lConnTimeout + 1;
+            if (tm_expire > tm_now)
+            {
+                // ڼйշ, ʱ¹
+                timer_add_list(i, g_stRuntime.pSocketContext, g_stRuntime.nTimerWheel, tm_expire);
+                continue;
+            }
+
+            DEBUG_PRINT(LM_INFO, "ConnTimeout and CloseSocket iSocket:%d\n", i);
+            CloseSocket(i);
+        }
+    }
+
+    return 0;
+}
+#endif
+
 /*!
  * : еSocket¼
  * @n: huangjun
@@ -204,7 +322,12 @@ int CloseSocket(int nSocket)
  */
 int CheckConnStatus(void)
 {
+#if defined(USE_CLR_TIMEOUT)
+    // û¼ʱҲҪʱ鳬ʱ
+    int iRet = epoll_wait(g_stRuntime.nEpfd, g_stRuntime.pEvents, (int)g_stRuntime.uMaxSocketNum, 1000);
+#else
     int iRet = epoll_wait(g_stRuntime.nEpfd, g_stRuntime.pEvents, (int)g_stRuntime.uMaxSocketNum, -1);
+#endif
     if (iRet > 0)
     {
         return iRet;
@@ -321,6 +444,10 @@ int CheckAndAcceptConns(int nListenSocket)
 
         // ӵSocket뵽Ӷ
         conn_add_list(nNewSocket, g_stRuntime.pSocketContext, g_stRuntime.nConn_Queue_Root);
+#if defined(USE_CLR_TIMEOUT)
+        timer_add_list(nNewSocket, g_stRuntime.pSocketContext, g_stRuntime.nTimerWheel
+            , g_stRuntime.pSocketContext[nNewSocket].tm_LastActive + g_stConfig.lConnTimeout + 1);
+#endif
 
         uCurSocketNum++;
     } // end while (true)
@@ -333,6 +460,7 @@ int CheckAndAcceptConns(int nListenSocket)
  * : nSocketΪҪݵsocket, pPkgָݰ, uPkgLenΪݳ(ܳMAX_SEND_BUF_SIZEֽ)
  *       bCloseOnSendAll-Ƿڷݺͽйر
  * : 0 - ɹ; <0 - ʧ, >0-ηʧ
+ * ע: ֻepoll̵߳, ߳ͨPostPushMsgͶ
  */
 int SendPkg(int nSocket, const char *pPkg, size_t uPkgLen, bool bCloseOnSendAll = false)
 {
@@ -341,7 +469,6 @@ int SendPkg(int nSocket, const char *pPkg, size_t uPkgLen, bool bCloseOnSendAll
     assert(uPkgLen != 0);
 
     STRU_SOCKET_CONTEXT &stSocketContext = g_stRuntime.pSocketContext[nSocket];
-    CAutoLock AutoLock(&stSocketContext.lSendLock);
     if (ACCEPTED != stSocketContext.nSocketType)
     {
         DEBUG_PRINT(LM_ERROR, "uPkgLen(%Zu) - nSocketType(%d)\n"
@@ -355,13 +482,20 @@ int SendPkg(int nSocket, const char *pPkg, size_t uPkgLen, bool bCloseOnSendAll
     }
     if (stSocketContext.lToSendBytes > 0)
     {
-        if ((stSocketContext.lToSendBytes + uPkgLen) > sizeof(stSocketContext.szSendBuffer))
+        if ((stSocketContext.lToSendBytes + uPkgLen) > MAX_SEND_BUF_SIZE)
         {
-            DEBUG_PRINT(LM_ERROR, "ͻʧܣ\n");
+            ++stSocketContext.lDropPkgs;
+            DEBUG_PRINT(LM_ERROR, "ͻʧܣnSocket: %d, lToSendBytes: %ld, lDropPkgs: %ld\n"
+                , nSocket, stSocketContext.lToSendBytes, stSocketContext.lDropPkgs);
+            if (SEND_QUEUE_DISCONNECT == g_stConfig.nSendQueuePolicy)
+            {
+                // epollѭյҶ¼ر
+                shutdown(nSocket, SHUT_RDWR);
+            }
             return 1;
         }
         // DEBUG_PRINT(LM_DEBUG, "ͻ!\n");
-        memcpy(stSocketContext.szSendBuffer + stSocketContext.lToSendBytes, pPkg, uPkgLen);
+        memcpy(stSocketContext.pSendBuffer + stSocketContext.lToSendBytes, pPkg, uPkgLen);
         stSocketContext.lToSendBytes += uPkgLen;
 
         return 0;
@@ -391,13 +525,22 @@ int SendPkg(int nSocket, const char *pPkg, size_t uPkgLen, bool bCloseOnSendAll
         return 0;
     }
 
+    stSocketContext.pSendBuffer = Alloc_Buf(g_stRuntime.stSendBufPool);
+    if (!stSocketContext.pSendBuffer)
+    {
+        ++stSocketContext.lDropPkgs;
+        DEBUG_PRINT(LM_ERROR, "ͻѿգʧܣnSocket: %d\n", nSocket);
+        return -6;
+    }
+
     if (0 != HJ_modify_epoll_event(g_stRuntime.nEpfd, nSocket, EPOLLIN | EPOLLOUT | EPOLLET))
     {
+        ReleaseSendBuffer(stSocketContext);
         return -5;
     }
 
     stSocketContext.lToSendBytes = uPkgLen - nBytesSent;
-    memcpy(stSocketContext.szSendBuffer, (char*)pPkg + nBytesSent, stSocketContext.lToSendBytes);
+    memcpy(stSocketContext.pSendBuffer, (char*)pPkg + nBytesSent, stSocketContext.lToSendBytes);
 
     return 0;
 }
@@ -421,13 +564,13 @@ int HandlePkgHead(STRU_SOCKET_CONTEXT &stSocketContext, size_t &uPkgLen)
         return 1;
     }
 
-    if (stSocketContext.szRecvBuffer[0] != STX)
+    if (stSocketContext.pRecvBuffer[0] != STX)
     {
         return -1;
     }
 
     STRU_MSGPUSH_PKG_HEAD *pstMsgpushPkgHead
-        = (STRU_MSGPUSH_PKG_HEAD*)(stSocketContext.szRecvBuffer + sizeof(UINT8));
+        = (STRU_MSGPUSH_PKG_HEAD*)(stSocketContext.pRecvBuffer + sizeof(UINT8));
 
     UINT16 u16MsgType = ntohs(pstMsgpushPkgHead->u16MsgType);
     if (u16MsgType != LOGIN_REQ)
@@ -457,16 +600,16 @@ int HandlePkg(int nSocket, STRU_SOCKET_CONTEXT &stSocketContext)
     // const bool &bTrace = stSocketContext.bTrace;
 #endif
 
-    // HJ_hex_show(stSocketContext.szRecvBuffer, stSocketContext.lPkgLen);
+    // HJ_hex_show(stSocketContext.pRecvBuffer, stSocketContext.lPkgLen);
 
-    if (stSocketContext.szRecvBuffer[stSocketContext.lPkgLen - 1] != ETX)
+    if (stSocketContext.pRecvBuffer[stSocketContext.lPkgLen - 1] != ETX)
     {
         DEBUG_PRINT(LM_ERROR, "ݽβʶǷ\n");
         return -1;
     }
-    stSocketContext.szRecvBuffer[stSocketContext.lPkgLen - 1] = '\0';
+    stSocketContext.pRecvBuffer[stSocketContext.lPkgLen - 1] = '\0';
 
-    STRU_MSGPUSH_PKG *pstMsgpush_Pkg = (STRU_MSGPUSH_PKG*)stSocketContext.szRecvBuffer;
+    STRU_MSGPUSH_PKG *pstMsgpush_Pkg = (STRU_MSGPUSH_PKG*)stSocketContext.pRecvBuffer;
 
     //////////////////////////////////////////////////////////////////////////
     STRU_REG_MSG *pstRegMsg = (STRU_REG_MSG*)pstMsgpush_Pkg->szBody;
@@ -520,10 +663,13 @@ int HandlePkg(int nSocket, STRU_SOCKET_CONTEXT &stSocketContext)
                 pUserinfo->u32CommAttr = pstRegMsg->u32CommAttr;
                 memcpy(pUserinfo->chPrivateAttr, pstRegMsg->chPrivateAttr
                     , sizeof(pUserinfo->chPrivateAttr));
+                Update_Subscriber(g_stRuntime.stSvcIndex, (unsigned short)nSocket, pUserinfo->u32CommAttr);
                 bUpdateUserinfo = true;
             }
             else
             {
+                Remove_Subscriber(g_stRuntime.stSvcIndex, (unsigned short)nSocket);
+
                 // RBƳǰλãͷŽڵ㣬ýڵԱڵƵ
                 STRU_USERINFO_ACS *pUserinfoTmp = Remove_Userinfo(&g_stRuntime.pstUserListRoot[pUserinfo->u16SvcId]
                     , pUserinfo->u64UsrId, (unsigned short)nSocket);
@@ -563,11 +709,23 @@ int HandlePkg(int nSocket, STRU_SOCKET_CONTEXT &stSocketContext)
             pUserinfo->pNext = NULL;
             //////////////////////////////////////////////////////////////////////////
 
+            if (0 != Insert_Subscriber(g_stRuntime.stSvcIndex, pUserinfo->u16SvcId, (unsigned short)nSocket
+                , pUserinfo->u32CommAttr))
+            {
+                DEBUG_PRINT(LM_ERROR, "Insert_Subscriber %" PRIu64 " failed!\n"
+                    , pUserinfo->u64UsrId);
+                g_UsrInfoMempool.Free(pUserinfo);
+                pUserinfo = NULL;
+                nRetCode = -3;
+                break;
+            }
+
             if (0 != Insert_Userinfo(&g_stRuntime.pstUserListRoot[pUserinfo->u16SvcId], pUserinfo
                 , (unsigned short)nSocket))
             {
                 DEBUG_PRINT(LM_ERROR, "Insert_Userinfo %" PRIu64 " failed!\n"
                     , pUserinfo->u64UsrId);
+                Remove_Subscriber(g_stRuntime.stSvcIndex, (unsigned short)nSocket);
                 g_UsrInfoMempool.Free(pUserinfo);
                 pUserinfo = NULL;
                 nRetCode = -4;
@@ -650,9 +808,9 @@ int HandlePkg(int nSocket, STRU_SOCKET_CONTEXT &stSocketContext)
         return -3;
     }
     pstMsgpush_Pkg->stHead.u16PkgLen = htons((unsigned short)uSendLen);
-    stSocketContext.szRecvBuffer[uSendLen - 1] = ETX;
+    stSocketContext.pRecvBuffer[uSendLen - 1] = ETX;
 
-    if (0 != SendPkg(nSocket, stSocketContext.szRecvBuffer, uSendLen, (nRetCode < 0)))
+    if (0 != SendPkg(nSocket, stSocketContext.pRecvBuffer, uSendLen, (nRetCode < 0)))
     {
         return -4;
     }
@@ -670,7 +828,6 @@ int HandleSend(int nSocket)
     assert(g_stRuntime.pSocketContext && (nSocket >= 0) && ((size_t)nSocket < g_stRuntime.uMaxSocketNum));
 
     STRU_SOCKET_CONTEXT &stSocketContext = g_stRuntime.pSocketContext[nSocket];
-    CAutoLock AutoLock(&stSocketContext.lSendLock);
     if (ACCEPTED != stSocketContext.nSocketType)
     {
         return -1;
@@ -686,7 +843,7 @@ int HandleSend(int nSocket)
         return 1;
     }
 
-    int nBytesSent = send(nSocket, stSocketContext.szRecvBuffer, stSocketContext.lToSendBytes, 0);
+    int nBytesSent = send(nSocket, stSocketContext.pSendBuffer, stSocketContext.lToSendBytes, 0);
     if (nBytesSent <= 0)
     {
         if ((nBytesSent < 0) && ((EAGAIN == errno) || (EINTR == errno)))
@@ -704,6 +861,7 @@ int HandleSend(int nSocket)
     if (nBytesSent >= stSocketContext.lToSendBytes)
     {
         stSocketContext.lToSendBytes = 0;
+        ReleaseSendBuffer(stSocketContext);
 
         // Ѿ˷͹رӣزر
         if (stSocketContext.bCloseOnSendAll)
@@ -722,7 +880,7 @@ int HandleSend(int nSocket)
     else
     {
         stSocketContext.lToSendBytes -= nBytesSent;
-        memmove(stSocketContext.szSendBuffer, stSocketContext.szSendBuffer + nBytesSent
+        memmove(stSocketContext.pSendBuffer, stSocketContext.pSendBuffer + nBytesSent
             , stSocketContext.lToSendBytes);
     }
 
@@ -752,11 +910,21 @@ int HandleRecv(int nSocket)
     ssize_t nBytesReceived;
     size_t uPkgLen;
 
+    if (!stSocketContext.pRecvBuffer)
+    {
+        stSocketContext.pRecvBuffer = Alloc_Buf(g_stRuntime.stRecvBufPool);
+        if (!stSocketContext.pRecvBuffer)
+        {
+            DEBUG_PRINT(LM_ERROR, "ջѿգnSocket: %d\n", nSocket);
+            return -1;
+        }
+    }
+
     for (;;)
     {
         // ǰջдС
-        nBytesReceived = recv(nSocket, stSocketContext.szRecvBuffer + stSocketContext.lRecvBytes
-            , sizeof(stSocketContext.szRecvBuffer) - stSocketContext.lRecvBytes - 1, 0);
+        nBytesReceived = recv(nSocket, stSocketContext.pRecvBuffer + stSocketContext.lRecvBytes
+            , MAX_RECV_BUF_SIZE - stSocketContext.lRecvBytes - 1, 0);
         stSocketContext.tm_LastActive = time(NULL);
         if (nBytesReceived <= 0)
         {
@@ -773,14 +941,14 @@ int HandleRecv(int nSocket)
             }
         }
         stSocketContext.lRecvBytes += nBytesReceived;
-        stSocketContext.szRecvBuffer[stSocketContext.lRecvBytes] = '\0';
+        stSocketContext.pRecvBuffer[stSocketContext.lRecvBytes] = '\0';
 
         // ǰջǷ
-        bRecvFull = ((sizeof(stSocketContext.szRecvBuffer) - stSocketContext.lRecvBytes - 1) == 0);
+        bRecvFull = ((MAX_RECV_BUF_SIZE - stSocketContext.lRecvBytes - 1) == 0);
 
         for (;;)
         {
-            bRecvable = ((sizeof(stSocketContext.szRecvBuffer) - stSocketContext.lRecvBytes - 1) != 0);
+            bRecvable = ((MAX_RECV_BUF_SIZE - stSocketContext.lRecvBytes - 1) != 0);
 
             // δǰͷ, Ƚн
             if (stSocketContext.lPkgLen == 0)
@@ -810,7 +978,7 @@ int HandleRecv(int nSocket)
                 else if (nRetCode == 0)      // ɹ
                 {
                     // ͷָʾİڻֱӶϿ
-                    if (uPkgLen >= sizeof(stSocketContext.szRecvBuffer))
+                    if (uPkgLen >= MAX_RECV_BUF_SIZE)
                     {
                         nRetCode = -2;
                     }
@@ -823,7 +991,7 @@ int HandleRecv(int nSocket)
                 if (nRetCode < 0)           // 
                 {
                     DEBUG_PRINT(LM_ERROR, "ܵͷʽ\n");
-                    // HJ_hex_show(stSocketContext.szRecvBuffer, stSocketContext.lRecvBytes);
+                    // HJ_hex_show(stSocketContext.pRecvBuffer, stSocketContext.lRecvBytes);
                     return -1;
                 }
             }
@@ -857,9 +1025,9 @@ int HandleRecv(int nSocket)
             // ջδϢ
             if (stSocketContext.lRecvBytes > 0)
             {
-                memmove(stSocketContext.szRecvBuffer, (stSocketContext.szRecvBuffer + stSocketContext.lPkgLen)
+                memmove(stSocketContext.pRecvBuffer, (stSocketContext.pRecvBuffer + stSocketContext.lPkgLen)
                     , stSocketContext.lRecvBytes);
-                stSocketContext.szRecvBuffer[stSocketContext.lRecvBytes] = '\0';
+                stSocketContext.pRecvBuffer[stSocketContext.lRecvBytes] = '\0';
             }
             stSocketContext.lPkgLen = 0;
 
@@ -880,61 +1048,247 @@ int HandleRecv(int nSocket)
     return 0;
 }
 
-// ҵϢ
-int Batch_PushMsg_2_SrvId(struct HJ_RB_node *pUserinfo_RBRoot, const char *pSendBuffer, size_t uSendLen
-    , STRU_PUSH_MSG *pPushMsg
-#ifdef TRACE_USER
-    , size_t &uSendCnt
-#endif
-    )
+/*!
+ * : ͬһͶݸռһ, ɸepoll̷߳
+ * @nֵ: Ͷݵ, <0 - ڴʧ
+ * @nע: ̵߳. ݺнڵһ, ÿӵĶCASѹ,
+ *         ɿձΪǿյٹ, ɿձΪǿʱeventfd
+ */
+int PostPushMsg(const unsigned short *pusSocket, size_t uNum, const char *pPkg, size_t uPkgLen)
 {
-    assert(pSendBuffer && pPushMsg);
+    assert(pPkg && (uPkgLen > 0));
 
-    if (pUserinfo_RBRoot)
+    if (uNum == 0)
     {
-        Batch_PushMsg_2_SrvId(pUserinfo_RBRoot->pLeft, pSendBuffer, uSendLen, pPushMsg
-#ifdef TRACE_USER
-            , uSendCnt
-#endif
-            );
+        return 0;
+    }
 
-        //////////////////////////////////////////////////////////////////////////
-        STRU_USERINFO_ACS *pUserinfo = HJ_RB_Entery(pUserinfo_RBRoot, STRU_USERINFO_ACS, rbNode);
-        while (pUserinfo)
+    STRU_SEND_BLOCK *pBlock = (STRU_SEND_BLOCK*)malloc(sizeof(STRU_SEND_BLOCK)
+        + uNum * sizeof(STRU_SEND_NODE) + uPkgLen);
+    if (!pBlock)
+    {
+        DEBUG_PRINT(LM_ERROR, "malloc STRU_SEND_BLOCK for %Zu sockets failed!\n", uNum);
+        return -1;
+    }
+    pBlock->lRef = (long)uNum;
+    pBlock->uPkgLen = uPkgLen;
+    pBlock->pPkg = (char*)(pBlock->stNodes + uNum);
+    memcpy(pBlock->pPkg, pPkg, uPkgLen);
+
+    bool bNotify = false;
+    STRU_SEND_NODE *pHead;
+    int nRoot;
+    for (size_t i = 0; i < uNum; i++)
+    {
+        int nSocket = pusSocket[i];
+        STRU_SOCKET_CONTEXT &stSocketContext = g_stRuntime.pSocketContext[nSocket];
+        STRU_SEND_NODE *pNode = &pBlock->stNodes[i];
+        pNode->pBlock = pBlock;
+        pNode->u32Generation = stSocketContext.u32Generation;
+
+        do
+        {
+            pHead = stSocketContext.pSendQueue;
+            pNode->pNext = pHead;
+        } while (!__sync_bool_compare_and_swap(&stSocketContext.pSendQueue, pHead, pNode));
+
+        if (!pHead)
         {
-            if ((pPushMsg->u32CommAttr == 0) || (pUserinfo->u32CommAttr & pPushMsg->u32CommAttr))
+            do
             {
-                SendPkg(pUserinfo->usCommSocket, pSendBuffer, uSendLen);
-#ifdef TRACE_USER
-                uSendCnt++;
-#endif
+                nRoot = g_stRuntime.nSendReadyRoot;
+                stSocketContext.nReadyNext = nRoot;
+            } while (!__sync_bool_compare_and_swap(&g_stRuntime.nSendReadyRoot, nRoot, nSocket));
+            bNotify = bNotify || (nRoot == -1);
+        }
+    }
+
+    if (bNotify)
+    {
+        UINT64 u64Value = 1;
+        while ((write(g_stRuntime.nSendNotifyFd, &u64Value, sizeof(u64Value)) < 0) && (errno == EINTR))
+        {
+        }
+    }
+
+    return (int)uNum;
+}
+
+/*!
+ * : ߳ͶݸӵϢ
+ * @nע: ֻepoll̵߳. ȡ, ȡӵĶ,
+ *         ȶnReadyNextȡ, ȡߺַ߳̿¹
+ */
+int DrainSendQueues(void)
+{
+    UINT64 u64Value;
+    while ((read(g_stRuntime.nSendNotifyFd, &u64Value, sizeof(u64Value)) < 0) && (errno == EINTR))
+    {
+    }
+
+    int nSocket = __sync_lock_test_and_set(&g_stRuntime.nSendReadyRoot, -1);
+    while (nSocket != -1)
+    {
+        STRU_SOCKET_CONTEXT &stSocketContext = g_stRuntime.pSocketContext[nSocket];
+        int nNextSocket = stSocketContext.nReadyNext;
+        STRU_SEND_NODE *pNode = __sync_lock_test_and_set(&stSocketContext.pSendQueue, (STRU_SEND_NODE*)NULL);
+
+        // Ǻȳ, תͶ˳
+        STRU_SEND_NODE *pOrdered = NULL, *pNext;
+        while (pNode)
+        {
+            pNext = pNode->pNext;
+            pNode->pNext = pOrdered;
+            pOrdered = pNode;
+            pNode = pNext;
+        }
+
+        for (pNode = pOrdered; pNode; pNode = pNext)
+        {
+            pNext = pNode->pNext;
+            // Ͷ֮ѾرջӸõ, ֱӶ
+            if ((stSocketContext.nSocketType == ACCEPTED)
+                && (pNode->u32Generation == stSocketContext.u32Generation))
+            {
+                SendPkg(nSocket, pNode->pBlock->pPkg, pNode->pBlock->uPkgLen);
             }
-            pUserinfo = pUserinfo->pNext;
+            ReleaseSendNode(pNode);
         }
-        //////////////////////////////////////////////////////////////////////////
 
-        Batch_PushMsg_2_SrvId(pUserinfo_RBRoot->pRight, pSendBuffer, uSendLen, pPushMsg
-#ifdef TRACE_USER
-            , uSendCnt
-#endif
-            );
+        nSocket = nNextSocket;
     }
 
     return 0;
 }
 
-// ҵϢȻַ߳
-void* Dispatch_Msg_Thread(void *pThreadId)
+/*!
+ * : Udp socketĽջ, SO_RXQ_OVFLԱͳں˶
+ * @nע: ûCAP_NET_ADMINȨʱSO_RCVBUFFORCEʧ, ˻SO_RCVBUF(rmem_max)
+ */
+int InitUdpSocketOpt(int nUdpSocket)
 {
-    assert(pThreadId);
+    if (g_stConfig.nUdpRecvBufSize > 0)
+    {
+        int nBufSize = g_stConfig.nUdpRecvBufSize;
+        if ((setsockopt(nUdpSocket, SOL_SOCKET, SO_RCVBUFFORCE, &nBufSize, sizeof(nBufSize)) < 0)
+            && (setsockopt(nUdpSocket, SOL_SOCKET, SO_RCVBUF, &nBufSize, sizeof(nBufSize)) < 0))
+        {
+            DEBUG_PRINT(LM_ERROR, "Udpջʧ: %d, errno: %d\n", nBufSize, errno);
+        }
+    }
 
-    // int nThreadId = *((int*)pThreadId);
+    int nOn = 1;
+    if (setsockopt(nUdpSocket, SOL_SOCKET, SO_RXQ_OVFL, &nOn, sizeof(nOn)) < 0)
+    {
+        DEBUG_PRINT(LM_ERROR, "SO_RXQ_OVFLʧ, errno: %d\n", errno);
+    }
 
-    struct sockaddr_in stAddrFrom;
-    socklen_t uAddrLen = sizeof(stAddrFrom);
+    return 0;
+}
 
-    char szRecvBuffer[MAX_PUSH_PKG_LEN] = {0}, szSendBuffer[MAX_PUSH_PKG_LEN] = {0};
-    int nRecvLen = 0;
+// ջеi
+inline char* UdpBatchBuffer(STRU_UDP_BATCH &stBatch, size_t i)
+{
+    return stBatch.pBuffers + i * (MAX_PUSH_PKG_LEN + 1);
+}
+
+/*!
+ * : ͷUdpյĻ
+ */
+void FreeUdpBatch(STRU_UDP_BATCH &stBatch)
+{
+    delete []stBatch.pMsgs;
+    delete []stBatch.pIovs;
+    delete []stBatch.pAddrs;
+    delete []stBatch.pBuffers;
+    delete []stBatch.pCtrlBufs;
+    bzero(&stBatch, sizeof(stBatch));
+}
+
+/*!
+ * : UdpյĻ
+ */
+int InitUdpBatch(STRU_UDP_BATCH &stBatch, size_t uBatchSize)
+{
+    bzero(&stBatch, sizeof(stBatch));
+    stBatch.uBatchSize = uBatchSize;
+    stBatch.pMsgs = new(nothrow) struct mmsghdr[uBatchSize];
+    stBatch.pIovs = new(nothrow) struct iovec[uBatchSize];
+    stBatch.pAddrs = new(nothrow) struct sockaddr_in[uBatchSize];
+    // ÿһֽڷŽ
+    stBatch.pBuffers = new(nothrow) char[uBatchSize * (MAX_PUSH_PKG_LEN + 1)];
+    stBatch.pCtrlBufs = new(nothrow) char[uBatchSize * UDP_BATCH_CTRL_LEN];
+    if (!stBatch.pMsgs || !stBatch.pIovs || !stBatch.pAddrs || !stBatch.pBuffers || !stBatch.pCtrlBufs)
+    {
+        FreeUdpBatch(stBatch);
+        return -1;
+    }
+
+    bzero(stBatch.pMsgs, uBatchSize * sizeof(struct mmsghdr));
+    for (size_t i = 0; i < uBatchSize; i++)
+    {
+        struct msghdr &stHdr = stBatch.pMsgs[i].msg_hdr;
+        stBatch.pIovs[i].iov_base = UdpBatchBuffer(stBatch, i);
+        stHdr.msg_name = &stBatch.pAddrs[i];
+        stHdr.msg_iov = &stBatch.pIovs[i];
+        stHdr.msg_iovlen = 1;
+        stHdr.msg_control = stBatch.pCtrlBufs + i * UDP_BATCH_CTRL_LEN;
+    }
+
+    return 0;
+}
+
+/*!
+ * : Udp, ٵȵһ, ֮жն(uBatchSize)
+ * @nֵ: յİ, -1
+ * @nע: iΪUdpBatchBuffer(stBatch, i), ΪpMsgs[i].msg_len
+ */
+int RecvUdpBatch(int nUdpSocket, STRU_UDP_BATCH &stBatch)
+{
+    // һתʱܸĹiov_len, ںҲдַͿϢ, ÿ
+    for (size_t i = 0; i < stBatch.uBatchSize; i++)
+    {
+        struct msghdr &stHdr = stBatch.pMsgs[i].msg_hdr;
+        stBatch.pIovs[i].iov_len = MAX_PUSH_PKG_LEN;
+        stHdr.msg_namelen = sizeof(struct sockaddr_in);
+        stHdr.msg_controllen = UDP_BATCH_CTRL_LEN;
+        stHdr.msg_flags = 0;
+    }
+
+    int nRecvNum = recvmmsg(nUdpSocket, stBatch.pMsgs, stBatch.uBatchSize, MSG_WAITFORONE, NULL);
+    if (nRecvNum <= 0)
+    {
+        return -1;
+    }
+
+    // SO_RXQ_OVFLǸsocketۼƱİ, ȡһϵֵ
+    UINT32 u32Overrun = stBatch.u32LastOverrun;
+    struct msghdr &stLast = stBatch.pMsgs[nRecvNum - 1].msg_hdr;
+    for (struct cmsghdr *pCmsg = CMSG_FIRSTHDR(&stLast); pCmsg; pCmsg = CMSG_NXTHDR(&stLast, pCmsg))
+    {
+        if ((pCmsg->cmsg_level == SOL_SOCKET) && (pCmsg->cmsg_type == SO_RXQ_OVFL))
+        {
+            memcpy(&u32Overrun, CMSG_DATA(pCmsg), sizeof(u32Overrun));
+        }
+    }
+    if (u32Overrun != stBatch.u32LastOverrun)
+    {
+        HJ_Rpt_API(RPT_ID_UDP_OVERRUN_PKGS, (UINT32)(u32Overrun - stBatch.u32LastOverrun));
+        stBatch.u32LastOverrun = u32Overrun;
+    }
+    HJ_Rpt_API(RPT_ID_UDP_RECV_PKGS, nRecvNum);
+
+    return nRecvNum;
+}
+
+/*!
+ * : һҵϢ, ҵ/û̵ַ
+ * @nֵ: 0 - ɹ, -1 - ʽ, -2 - ҵǷ
+ * @nע: szRecvBufferҪnRecvLen + 1ֽ, ԭתֽ
+ *         pusSocketΪҵ/ȫԱʱռĿ, uMaxSocketNum
+ */
+int DispatchPushMsg(char *szRecvBuffer, int nRecvLen, char *szSendBuffer, unsigned short *pusSocket)
+{
     size_t uSendLen = 0;
     UINT16 u16PkgLen = 0, u16PkgBodyLen = 0;
 
@@ -947,242 +1301,262 @@ void* Dispatch_Msg_Thread(void *pThreadId)
     STRU_ACK_MSG *pstAckMsg = (STRU_ACK_MSG*)pstRecvPkg->szBody;
 #endif
 
-    //////////////////////////////////////////////////////////////////////////
-    // ʼͱ̶ݶ
-    pstSendPkg->u8Stx = STX;
-    pstSendPkg->stHead.u16MsgType = htons(PUSH_MSG_REQ);
-    pstSendPkg->stHead.u16Verion = htons(0x0100);
-    //////////////////////////////////////////////////////////////////////////
-
     size_t uSocketId = 0;
-    int nNextIndex = 0, nRetCode = 0;
+    size_t uSubscriberNum = 0;
 
-    for (;;)
+    szRecvBuffer[nRecvLen] = '\0';
+
+    // HJ_hex_show(szRecvBuffer, nRecvLen);
+
+    if ((szRecvBuffer[0] != STX)
+        || (szRecvBuffer[nRecvLen - 1] != ETX))
     {
-        // 
-        nRecvLen = recvfrom(g_stRuntime.nUdpSocket, szRecvBuffer, sizeof(szRecvBuffer)
-            , 0, (struct sockaddr*)&stAddrFrom, &uAddrLen);
-        if (nRecvLen <= 0)
+        DEBUG_PRINT(LM_ERROR, "PushϢβʶ\n");
+        return -1;
+    }
+
+    int nRetCode = 0;
+    do
+    {
+        if (ntohs(pstRecvPkg->stHead.u16MsgType) != DISPATCH_MSG_REQ)
         {
-            continue;
+            DEBUG_PRINT(LM_ERROR, "PushϢ\n");
+            nRetCode = -1;
+            break;
         }
-        szRecvBuffer[nRecvLen] = '\0';
-
-        // HJ_hex_show(szRecvBuffer, nRecvLen);
 
-        if ((szRecvBuffer[0] != STX)
-            || (szRecvBuffer[nRecvLen - 1] != ETX))
+        u16PkgLen = ntohs(pstRecvPkg->stHead.u16PkgLen);
+        if ((u16PkgLen != (UINT16)nRecvLen)
+            || (u16PkgLen < (sizeof(STRU_MSGPUSH_PKG_HEAD) + 2 * sizeof(UINT8))))
         {
-            DEBUG_PRINT(LM_ERROR, "PushϢβʶ\n");
-            continue;
+            DEBUG_PRINT(LM_ERROR, "PushϢ\n");
+            nRetCode = -1;
+            break;
         }
 
-        nRetCode = 0;
-        do
+        u16PkgBodyLen = u16PkgLen - sizeof(STRU_MSGPUSH_PKG_HEAD) - 2 * sizeof(UINT8);
+        // DEBUG_PRINT(LM_DEBUG, "u16PkgLen: %lu, u16PkgBodyLen: %lu\n"
+        //     , u16PkgLen, u16PkgBodyLen);
+        if (u16PkgBodyLen < sizeof(STRU_PUSH_MSG))
         {
-            if (ntohs(pstRecvPkg->stHead.u16MsgType) != DISPATCH_MSG_REQ)
-            {
-                DEBUG_PRINT(LM_ERROR, "PushϢ\n");
-                nRetCode = -1;
-                break;
-            }
-
-            u16PkgLen = ntohs(pstRecvPkg->stHead.u16PkgLen);
-            if ((u16PkgLen != (UINT16)nRecvLen)
-                || (u16PkgLen < (sizeof(STRU_MSGPUSH_PKG_HEAD) + 2 * sizeof(UINT8))))
-            {
-                DEBUG_PRINT(LM_ERROR, "PushϢ\n");
-                nRetCode = -1;
-                break;
-            }
-
-            u16PkgBodyLen = u16PkgLen - sizeof(STRU_MSGPUSH_PKG_HEAD) - 2 * sizeof(UINT8);
-            // DEBUG_PRINT(LM_DEBUG, "u16PkgLen: %lu, u16PkgBodyLen: %lu\n"
-            //     , u16PkgLen, u16PkgBodyLen);
-            if (u16PkgBodyLen < sizeof(STRU_PUSH_MSG))
-            {
-                DEBUG_PRINT(LM_ERROR, "u16PkgBodyLen: (%u)\n", u16PkgBodyLen);
-                nRetCode = -1;
-                break;
-            }
+            DEBUG_PRINT(LM_ERROR, "u16PkgBodyLen: (%u)\n", u16PkgBodyLen);
+            nRetCode = -1;
+            break;
+        }
 
-            //////////////////////////////////////////////////////////////////////////
-            pPushMsg->u16MsgLen = ntohs(pPushMsg->u16MsgLen);
-            if (pPushMsg->u16MsgLen != (u16PkgBodyLen - sizeof(STRU_PUSH_MSG)))
-            {
-                DEBUG_PRINT(LM_ERROR, "u16MsgLen: (%u)\n", pPushMsg->u16MsgLen);
-                nRetCode = -1;
-                break;
-            }
+        //////////////////////////////////////////////////////////////////////////
+        pPushMsg->u16MsgLen = ntohs(pPushMsg->u16MsgLen);
+        if (pPushMsg->u16MsgLen != (u16PkgBodyLen - sizeof(STRU_PUSH_MSG)))
+        {
+            DEBUG_PRINT(LM_ERROR, "u16MsgLen: (%u)\n", pPushMsg->u16MsgLen);
+            nRetCode = -1;
+            break;
+        }
 
-            pPushMsg->u64UsrId = ntohq(pPushMsg->u64UsrId);
-            pPushMsg->u16SvcId = ntohs(pPushMsg->u16SvcId);
-            pPushMsg->u32CommAttr = ntohl(pPushMsg->u32CommAttr);
+        pPushMsg->u64UsrId = ntohq(pPushMsg->u64UsrId);
+        pPushMsg->u16SvcId = ntohs(pPushMsg->u16SvcId);
+        pPushMsg->u32CommAttr = ntohl(pPushMsg->u32CommAttr);
 
-            if (pPushMsg->u16SvcId >= g_stRuntime.uMaxServiceNum)
-            {
-                DEBUG_PRINT(LM_ERROR, "u16SvcIdֵ: (%u - %Zu)\n", pPushMsg->u16SvcId, g_stRuntime.uMaxServiceNum);
-                nRetCode = -2;
-                break;;
-            }
+        if (pPushMsg->u16SvcId >= g_stRuntime.uMaxServiceNum)
+        {
+            DEBUG_PRINT(LM_ERROR, "u16SvcIdֵ: (%u - %Zu)\n", pPushMsg->u16SvcId, g_stRuntime.uMaxServiceNum);
+            nRetCode = -2;
+            break;;
+        }
 
-            //////////////////////////////////////////////////////////////////////////
-            // DEBUG_PRINT(LM_INFO, "UsrId: %" PRIu64 ",SrvId: %u,CommAttr: %u,Msg: %s\n"
-            //    , pPushMsg->u64UsrId, pPushMsg->u16SvcId, pPushMsg->u32CommAttr, pPushMsg->szMsg);
-
-            uSendLen = 2 * sizeof(UINT8) + sizeof(STRU_MSGPUSH_PKG_HEAD) + sizeof(UINT8) + sizeof(UINT16) + pPushMsg->u16MsgLen;
-            pstSendPkg->stHead.u16PkgLen = htons(uSendLen);
-            // DEBUG_PRINT(LM_DEBUG, "MsgEncoding: %u-\n", pPushMsg->u8MsgEncoding);
-            // Ϣݱ
-            *((UINT8*)(&pstSendPkg->szBody[0])) = pPushMsg->u8MsgEncoding;
-            // Ϣݳ
-            *((UINT16*)(&pstSendPkg->szBody[sizeof(UINT8)])) = htons(pPushMsg->u16MsgLen);
-            // Ϣ
-            memcpy((pstSendPkg->szBody + sizeof(UINT8) + sizeof(UINT16)), pPushMsg->szMsg, pPushMsg->u16MsgLen);
-            szSendBuffer[uSendLen - 1] = ETX;
-            // DEBUG_PRINT(LM_DEBUG, "%uBytes\n", pPushMsg->u16MsgLen);
-
-            if (pPushMsg->u16SvcId != 0)
+        //////////////////////////////////////////////////////////////////////////
+        // DEBUG_PRINT(LM_INFO, "UsrId: %" PRIu64 ",SrvId: %u,CommAttr: %u,Msg: %s\n"
+        //    , pPushMsg->u64UsrId, pPushMsg->u16SvcId, pPushMsg->u32CommAttr, pPushMsg->szMsg);
+
+        uSendLen = 2 * sizeof(UINT8) + sizeof(STRU_MSGPUSH_PKG_HEAD) + sizeof(UINT8) + sizeof(UINT16) + pPushMsg->u16MsgLen;
+        pstSendPkg->stHead.u16PkgLen = htons(uSendLen);
+        // DEBUG_PRINT(LM_DEBUG, "MsgEncoding: %u-\n", pPushMsg->u8MsgEncoding);
+        // Ϣݱ
+        *((UINT8*)(&pstSendPkg->szBody[0])) = pPushMsg->u8MsgEncoding;
+        // Ϣݳ
+        *((UINT16*)(&pstSendPkg->szBody[sizeof(UINT8)])) = htons(pPushMsg->u16MsgLen);
+        // Ϣ
+        memcpy((pstSendPkg->szBody + sizeof(UINT8) + sizeof(UINT16)), pPushMsg->szMsg, pPushMsg->u16MsgLen);
+        szSendBuffer[uSendLen - 1] = ETX;
+        // DEBUG_PRINT(LM_DEBUG, "%uBytes\n", pPushMsg->u16MsgLen);
+
+        if (pPushMsg->u16SvcId != 0)
+        {
+            if (pPushMsg->u64UsrId != 0)
             {
-                if (pPushMsg->u64UsrId != 0)
+                // ָû, ͬһûж
+                STRU_USERINFO_ACS* pUserinfo = Search_Userinfo(&g_stRuntime.pstUserListRoot[pPushMsg->u16SvcId]
+                    , pPushMsg->u64UsrId);
+                while (pUserinfo)
                 {
-#ifdef TRACE_USER
-                    size_t uSendCnt = 0;
-#endif
-
-                    // ָû
-                    STRU_USERINFO_ACS* pUserinfo = Search_Userinfo(&g_stRuntime.pstUserListRoot[pPushMsg->u16SvcId]
-                        , pPushMsg->u64UsrId);
-                    while (pUserinfo)
+                    uSocketId = pUserinfo->usCommSocket;
+                    if (uSocketId < g_stConfig.uMaxSocketNum)
                     {
-                        // DEBUG_PRINT(LM_DEBUG, "SendPkg to %ld - %s\n"
-                        //     , pPushMsg->u64UsrId, pPushMsg->szMsg);
-                        uSocketId = pUserinfo->usCommSocket;
-                        if ((uSocketId < g_stConfig.uMaxSocketNum)
-                            && (g_stRuntime.pSocketContext[uSocketId].nSocketType == ACCEPTED))
-                        {
-                            SendPkg((int)uSocketId, (const char*)szSendBuffer, uSendLen);
-#ifdef TRACE_USER
-                            uSendCnt++;
-#endif
-                        }
-                        pUserinfo = pUserinfo->pNext;
+                        pusSocket[uSubscriberNum++] = (unsigned short)uSocketId;
                     }
-#ifdef TRACE_USER
-                    DEBUG_PRINT(LM_DEBUG, "TotalOnlineUser: %Zu, TotalLoginUser: %Zu, Send %ZuUsers\n"
-                        , g_stRuntime.uOnlineUserNum, g_stRuntime.uLoginUserNum, uSendCnt);
-                    // printf("%Zu+\n", uSendCnt);
-#endif
+                    pUserinfo = pUserinfo->pNext;
                 }
-                else
-                {
-                    // ҵ
-#ifdef TRACE_USER
-                    size_t uSendCnt = 0;
-#endif
-                    Batch_PushMsg_2_SrvId(g_stRuntime.pstUserListRoot[pPushMsg->u16SvcId].pRBNode
-                        , (const char*)szSendBuffer, uSendLen, pPushMsg
+                PostPushMsg(pusSocket, uSubscriberNum, (const char*)szSendBuffer, uSendLen);
 #ifdef TRACE_USER
-                        , uSendCnt
-#endif
-                        );
-#ifdef TRACE_USER
-                    DEBUG_PRINT(LM_DEBUG, "TotalOnlineUser: %Zu, TotalLoginUser: %Zu, Send %ZuUsers\n"
-                        , g_stRuntime.uOnlineUserNum, g_stRuntime.uLoginUserNum, uSendCnt);
-                    // printf("%Zu+\n", uSendCnt);
+                size_t uSendCnt = uSubscriberNum;
+                DEBUG_PRINT(LM_DEBUG, "TotalOnlineUser: %Zu, TotalLoginUser: %Zu, Send %ZuUsers\n"
+                    , g_stRuntime.uOnlineUserNum, g_stRuntime.uLoginUserNum, uSendCnt);
+                // printf("%Zu+\n", uSendCnt);
 #endif
-                }
             }
             else
             {
-                // ȫԱ
+                // ҵ, ռĿ, Ͷݸepoll̷߳
+                uSubscriberNum = Collect_Subscribers(g_stRuntime.stSvcIndex, pPushMsg->u16SvcId
+                    , pPushMsg->u32CommAttr, pusSocket);
+                PostPushMsg(pusSocket, uSubscriberNum, (const char*)szSendBuffer, uSendLen);
 #ifdef TRACE_USER
-                size_t uSendCnt = 0;
+                size_t uSendCnt = uSubscriberNum;
 #endif
-                for (int i = g_stRuntime.nConn_Queue_Root; i != -1; i = nNextIndex)
-                {
-                    nNextIndex = g_stRuntime.pSocketContext[i].nNextIndex;
-
-                    if ((g_stRuntime.pSocketContext[i].nSocketType != ACCEPTED)
-                        || !g_stRuntime.pSocketContext[i].pUserinfo
-                        || ((pPushMsg->u32CommAttr != 0)
-                        && (g_stRuntime.pSocketContext[i].pUserinfo->u32CommAttr & pPushMsg->u32CommAttr == 0))
-                        )
-                    {
-                        continue;
-                    }
-                    SendPkg(i, (const char*)szSendBuffer, uSendLen);
-#ifdef TRACE_USER
-                    uSendCnt++;
-#endif
-                }
 #ifdef TRACE_USER
                 DEBUG_PRINT(LM_DEBUG, "TotalOnlineUser: %Zu, TotalLoginUser: %Zu, Send %ZuUsers\n"
                     , g_stRuntime.uOnlineUserNum, g_stRuntime.uLoginUserNum, uSendCnt);
-#endif
                 // printf("%Zu+\n", uSendCnt);
+#endif
             }
-        } while (false);
+        }
+        else
+        {
+            // ȫԱ, ֻƸѵ¼
+            uSubscriberNum = Collect_AllSubscribers(g_stRuntime.stSvcIndex, pPushMsg->u32CommAttr, pusSocket);
+            PostPushMsg(pusSocket, uSubscriberNum, (const char*)szSendBuffer, uSendLen);
+#ifdef TRACE_USER
+            size_t uSendCnt = uSubscriberNum;
+#endif
+#ifdef TRACE_USER
+            DEBUG_PRINT(LM_DEBUG, "TotalOnlineUser: %Zu, TotalLoginUser: %Zu, Send %ZuUsers\n"
+                , g_stRuntime.uOnlineUserNum, g_stRuntime.uLoginUserNum, uSendCnt);
+#endif
+            // printf("%Zu+\n", uSendCnt);
+        }
+    } while (false);
 
-        // طӦ
+    // طӦ
 #if 0
-        //////////////////////////////////////////////////////////////////////////
-        // ע⣺ⲿֻ޸ĽջݣʱԱ֤Ḳһ
-        //       ݣԲ
-        pstRecvPkg->stHead.u16MsgType = htons(PUSH_MSG_ACK);
-        uSendLen = 0;
+    //////////////////////////////////////////////////////////////////////////
+    // ע⣺ⲿֻ޸ĽջݣʱԱ֤Ḳһ
+    //       ݣԲ
+    pstRecvPkg->stHead.u16MsgType = htons(PUSH_MSG_ACK);
+    uSendLen = 0;
 
-        pstAckMsg->u8ErrMsgEncoding = CHARSET_GB2312;
-        switch (nRetCode)
+    pstAckMsg->u8ErrMsgEncoding = CHARSET_GB2312;
+    switch (nRetCode)
+    {
+    case 0 :
         {
-        case 0 :
+            pstAckMsg->u16RetCode = htons(PUSH_SUCCESS);
+            uSendLen = 2 * sizeof(UINT8) + sizeof(STRU_MSGPUSH_PKG_HEAD) + sizeof(UINT16);
+        }
+        break;
+    case -1 :
+        {
+            pstAckMsg->u16RetCode = htons(PUSH_ILLEGAL);
+            const char *pFormatErr = "Ϣʽ";
+            int nFormatErrLen = snprintf(pstAckMsg->szErrMsg, sizeof(pstAckMsg->szErrMsg), "%s", pFormatErr);
+            if (nFormatErrLen <= 0)
             {
-                pstAckMsg->u16RetCode = htons(PUSH_SUCCESS);
-                uSendLen = 2 * sizeof(UINT8) + sizeof(STRU_MSGPUSH_PKG_HEAD) + sizeof(UINT16);
+                break;
             }
-            break;
-        case -1 :
+            pstAckMsg->u16ErrMsgLen = htons((unsigned short)nFormatErrLen);
+            uSendLen = 2 * sizeof(UINT8) + sizeof(STRU_MSGPUSH_PKG_HEAD) + 3 * sizeof(UINT16) + size_t(nFormatErrLen);
+        }
+        break;
+    case -2 :
+        {
+            pstAckMsg->u16RetCode = htons(PUSH_UNALLOW);
+            const char *pSysParamErr = "ҵǷ";
+            int nSysParamErrLen = snprintf(pstAckMsg->szErrMsg, sizeof(pstAckMsg->szErrMsg), "%s", pSysParamErr);
+            if (nSysParamErrLen <= 0)
             {
-                pstAckMsg->u16RetCode = htons(PUSH_ILLEGAL);
-                const char *pFormatErr = "Ϣʽ";
-                int nFormatErrLen = snprintf(pstAckMsg->szErrMsg, sizeof(pstAckMsg->szErrMsg), "%s", pFormatErr);
-                if (nFormatErrLen <= 0)
-                {
-                    break;
-                }
-                pstAckMsg->u16ErrMsgLen = htons((unsigned short)nFormatErrLen);
-                uSendLen = 2 * sizeof(UINT8) + sizeof(STRU_MSGPUSH_PKG_HEAD) + 3 * sizeof(UINT16) + size_t(nFormatErrLen);
+                break;
             }
-            break;
-        case -2 :
+            pstAckMsg->u16ErrMsgLen = htons((unsigned short)nSysParamErrLen);
+            uSendLen = 2 * sizeof(UINT8) + sizeof(STRU_MSGPUSH_PKG_HEAD) + 3 * sizeof(UINT16) + size_t(nSysParamErrLen);
+        }
+        break;
+    default :
+        break;
+    }
+
+    if (uSendLen > 0)
+    {
+        pstRecvPkg->stHead.u16PkgLen = htons((unsigned short)uSendLen);
+        szRecvBuffer[uSendLen - 1] = ETX;
+
+        sendto(g_stRuntime.nUdpSocket, szRecvBuffer, uSendLen, 0
+            , (const struct sockaddr*)&stAddrFrom, sizeof(stAddrFrom));
+    }
+#endif
+    //////////////////////////////////////////////////////////////////////////
+
+    return nRetCode;
+}
+
+// ҵϢȻַ߳
+void* Dispatch_Msg_Thread(void *pThreadId)
+{
+    assert(pThreadId);
+
+    // int nThreadId = *((int*)pThreadId);
+
+    char szSendBuffer[MAX_PUSH_PKG_LEN] = {0};
+    STRU_MSGPUSH_PKG *pstSendPkg = (STRU_MSGPUSH_PKG*)szSendBuffer;
+
+    //////////////////////////////////////////////////////////////////////////
+    // ʼͱ̶ݶ
+    pstSendPkg->u8Stx = STX;
+    pstSendPkg->stHead.u16MsgType = htons(PUSH_MSG_REQ);
+    pstSendPkg->stHead.u16Verion = htons(0x0100);
+    //////////////////////////////////////////////////////////////////////////
+
+    // ҵ/ȫԱʱռĿ
+    unsigned short *pusSocket = new(nothrow) unsigned short[g_stRuntime.uMaxSocketNum];
+    if (!pusSocket)
+    {
+        DEBUG_PRINT(LM_ERROR, "new pusSocket[%Zu] failed!\n", g_stRuntime.uMaxSocketNum);
+        return NULL;
+    }
+
+    // ڹڴ滷ϵĶ
+    size_t uReader = g_stRuntime.uProcessId - 1;
+    char szRecvBuffer[MAX_PUSH_PKG_LEN + 1];
+    int nRecvLen = 0;
+    unsigned long ulBadPkgs = 0;
+    UINT64 u64GapPkgs = 0;
+
+    for (;;)
+    {
+        // ѻϵϢϱ, Ȼ
+        ulBadPkgs = 0;
+        u64GapPkgs = 0;
+        while ((nRecvLen = Pop_ShmRing(g_stShmRing, uReader, szRecvBuffer, MAX_PUSH_PKG_LEN, u64GapPkgs)) > 0)
+        {
+            if (DispatchPushMsg(szRecvBuffer, nRecvLen, szSendBuffer, pusSocket) != 0)
             {
-                pstAckMsg->u16RetCode = htons(PUSH_UNALLOW);
-                const char *pSysParamErr = "ҵǷ";
-                int nSysParamErrLen = snprintf(pstAckMsg->szErrMsg, sizeof(pstAckMsg->szErrMsg), "%s", pSysParamErr);
-                if (nSysParamErrLen <= 0)
-                {
-                    break;
-                }
-                pstAckMsg->u16ErrMsgLen = htons((unsigned short)nSysParamErrLen);
-                uSendLen = 2 * sizeof(UINT8) + sizeof(STRU_MSGPUSH_PKG_HEAD) + 3 * sizeof(UINT16) + size_t(nSysParamErrLen);
+                ulBadPkgs++;
             }
-            break;
-        default :
-            break;
         }
 
-        if (uSendLen > 0)
+        if (u64GapPkgs > 0)
         {
-            pstRecvPkg->stHead.u16PkgLen = htons((unsigned short)uSendLen);
-            szRecvBuffer[uSendLen - 1] = ETX;
-
-            sendto(g_stRuntime.nUdpSocket, szRecvBuffer, uSendLen, 0
-                , (const struct sockaddr*)&stAddrFrom, sizeof(stAddrFrom));
+            DEBUG_PRINT(LM_ERROR, "ӽ%Zu, %" PRIu64 "ǵϢ\n"
+                , g_stRuntime.uProcessId, u64GapPkgs);
+            HJ_Rpt_API(RPT_ID_SHM_RING_GAP_PKGS, (unsigned long)u64GapPkgs);
         }
-#endif
-        //////////////////////////////////////////////////////////////////////////
+        if (ulBadPkgs > 0)
+        {
+            HJ_Rpt_API(RPT_ID_UDP_BAD_PKGS, ulBadPkgs);
+        }
+
+        Wait_ShmRing(g_stShmRing, uReader);
     }
 
+    delete []pusSocket;
     return NULL;
 }
 
@@ -1199,6 +1573,12 @@ int CheckAndProcessOnSockets(int nSocketNum)
     for (int i = 0; i < nSocketNum; i++)
     {
         nSocket = g_stRuntime.pEvents[i].data.fd;
+        if (nSocket == g_stRuntime.nSendNotifyFd)
+        {
+            DrainSendQueues();
+            continue;
+        }
+
         if ((nSocket < 0) || (nSocket >= (int)g_stRuntime.uMaxSocketNum)
             || (g_stRuntime.pSocketContext[nSocket].nSocketType == NOT_USED))
         {
@@ -1236,6 +1616,7 @@ int CheckAndProcessOnSockets(int nSocketNum)
                     CloseSocket(nSocket);
                     continue;
                 }
+                ReleaseRecvBuffer(g_stRuntime.pSocketContext[nSocket]);
             }
 
             if (g_stRuntime.pEvents[i].events & EPOLLOUT)
@@ -1262,6 +1643,7 @@ int CheckAndProcessOnSockets(int nSocketNum)
 int InitializeChildProcess(void)
 {
     bool bInitFailed = true;
+    g_stRuntime.nSendNotifyFd = -1;
 
     do
     {
@@ -1271,23 +1653,21 @@ int InitializeChildProcess(void)
             break;
         }
 
-        g_stRuntime.nUdpSocket = HJ_UDP_Server(g_stConfig.szLocalIp
-            , (g_stConfig.usUdpPort + g_stRuntime.uProcessId));
-        if (g_stRuntime.nUdpSocket < 0)
-        {
-            printf("Call HJ_UDP_Server(%s-%u) failed!\n"
-                , g_stConfig.szLocalIp, (unsigned short)(g_stConfig.usUdpPort + g_stRuntime.uProcessId));
-            break;
-        }
-
         // ʼSocket״̬
-        g_stRuntime.pSocketContext = new(nothrow) STRU_SOCKET_CONTEXT[g_stRuntime.uMaxSocketNum];
-        if (!g_stRuntime.pSocketContext)
+        // ӳnew + bzero, ӳ䱾, ֻõľڵҳռڴ
+        void *pMap = mmap(NULL, g_stRuntime.uMaxSocketNum * sizeof(STRU_SOCKET_CONTEXT)
+            , PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (pMap == MAP_FAILED)
         {
-            printf("new g_stRuntime.pSocketContext[%Zu] failed!\n", g_stRuntime.uMaxSocketNum);
+            printf("mmap g_stRuntime.pSocketContext[%Zu] failed!\n", g_stRuntime.uMaxSocketNum);
             break;
         }
-        bzero(g_stRuntime.pSocketContext, (g_stRuntime.uMaxSocketNum * sizeof(STRU_SOCKET_CONTEXT)));
+        g_stRuntime.pSocketContext = (STRU_SOCKET_CONTEXT*)pMap;
+        memset(g_stRuntime.nTimerWheel, -1, sizeof(g_stRuntime.nTimerWheel));
+
+        // շ, ÿһ
+        Init_BufPool(g_stRuntime.stRecvBufPool, MAX_RECV_BUF_SIZE, g_stRuntime.uMaxSocketNum);
+        Init_BufPool(g_stRuntime.stSendBufPool, MAX_SEND_BUF_SIZE, g_stRuntime.uMaxSocketNum);
 
         // ʼ׽ص״̬
         g_stRuntime.pSocketContext[g_stRuntime.nListen_Socket].nSocketType = LISTENER;
@@ -1309,6 +1689,12 @@ int InitializeChildProcess(void)
             break;
         }
 
+        if (Create_SvcIndex(g_stRuntime.stSvcIndex, g_stRuntime.uMaxServiceNum, g_stRuntime.uMaxSocketNum) < 0)
+        {
+            printf("Call Create_SvcIndex(%Zu, %Zu) failed!\n", g_stRuntime.uMaxServiceNum, g_stRuntime.uMaxSocketNum);
+            break;
+        }
+
         g_stRuntime.nEpfd = epoll_create(g_stRuntime.uMaxSocketNum);
         if (g_stRuntime.nEpfd < 0)
         {
@@ -1323,6 +1709,20 @@ int InitializeChildProcess(void)
         }
         g_stRuntime.bListen_Epoll_Added = true;
 
+        // ַ߳ͶϢepoll߳
+        g_stRuntime.nSendReadyRoot = -1;
+        g_stRuntime.nSendNotifyFd = eventfd(0, EFD_NONBLOCK);
+        if (g_stRuntime.nSendNotifyFd < 0)
+        {
+            printf("Call eventfd() failed!\n");
+            break;
+        }
+        if (HJ_register_epoll_event(g_stRuntime.nEpfd, g_stRuntime.nSendNotifyFd, EPOLLIN) < 0)
+        {
+            printf("Call HJ_register_epoll_event() for adding send notify fd failed!\n");
+            break;
+        }
+
         bInitFailed = false;
     } while (false);
 
@@ -1330,6 +1730,12 @@ int InitializeChildProcess(void)
     {
         g_UsrInfoMempool.Destroy();
 
+        if (g_stRuntime.nSendNotifyFd >= 0)
+        {
+            close(g_stRuntime.nSendNotifyFd);
+            g_stRuntime.nSendNotifyFd = -1;
+        }
+
         if (g_stRuntime.nEpfd >= 0)
         {
             if (HJ_unregister_epoll_event(g_stRuntime.nEpfd, g_stRuntime.nListen_Socket) >= 0)
@@ -1345,6 +1751,7 @@ int InitializeChildProcess(void)
             delete []g_stRuntime.pstUserListRoot;
             g_stRuntime.pstUserListRoot = NULL;
         }
+        Destroy_SvcIndex(g_stRuntime.stSvcIndex);
 
         if (g_stRuntime.pEvents)
         {
@@ -1354,15 +1761,11 @@ int InitializeChildProcess(void)
 
         if (g_stRuntime.pSocketContext)
         {
-            delete []g_stRuntime.pSocketContext;
+            munmap(g_stRuntime.pSocketContext, g_stRuntime.uMaxSocketNum * sizeof(STRU_SOCKET_CONTEXT));
             g_stRuntime.pSocketContext = NULL;
         }
-
-        if (g_stRuntime.nUdpSocket >= 0)
-        {
-            close(g_stRuntime.nUdpSocket);
-            g_stRuntime.nUdpSocket = -1;
-        }
+        Destroy_BufPool(g_stRuntime.stRecvBufPool);
+        Destroy_BufPool(g_stRuntime.stSendBufPool);
 
         return -1;
     }
@@ -1395,60 +1798,85 @@ int InterfaceProcess(void)
         return -1;
     }
 
-    struct sockaddr_in stAddrFrom, stAddrTo;
-    socklen_t uAddrLen = sizeof(stAddrFrom);
-    char szRecvBuffer[MAX_PUSH_PKG_LEN];
-    int nRecvLen = 0;
+    InitUdpSocketOpt(g_stRuntime.nUdpSocket);
 
-    bzero(&stAddrTo, sizeof(stAddrTo));
-    stAddrTo.sin_family = AF_INET;
-    stAddrTo.sin_addr.s_addr = inet_addr(g_stConfig.szLocalIp);
-    // stAddrTo.sin_port = htons((unsigned short)(g_stConfig.usUdpPort + g_stRuntime.uProcessId));
+    STRU_UDP_BATCH stBatch;
+    if (InitUdpBatch(stBatch, g_stConfig.uUdpBatchSize) < 0)
+    {
+        DEBUG_PRINT(LM_ERROR, "Call InitUdpBatch(%Zu) failed!\n", g_stConfig.uUdpBatchSize);
+        kill(0, SIGKILL);
+        return -1;
+    }
 
-    STRU_MSGPUSH_PKG *pstMsgpushPkg = (STRU_MSGPUSH_PKG*)szRecvBuffer;
+    int nRecvNum = 0, nRecvLen = 0;
+    size_t uFwdNum = 0;
+    unsigned long ulBadPkgs = 0;
+    char *pRecvBuffer = NULL;
+    STRU_MSGPUSH_PKG *pstMsgpushPkg = NULL;
     UINT16 u16PkgLen = 0;
 
     for (;;)
     {
-        // 
-        nRecvLen = recvfrom(g_stRuntime.nUdpSocket, szRecvBuffer, sizeof(szRecvBuffer)
-            , 0, (struct sockaddr*)&stAddrFrom, &uAddrLen);
-        if (nRecvLen <= 0)
+        // 
+        nRecvNum = RecvUdpBatch(g_stRuntime.nUdpSocket, stBatch);
+        if (nRecvNum <= 0)
         {
             continue;
         }
 
-        // HJ_hex_show(szRecvBuffer, nRecvLen);
-
-        if ((szRecvBuffer[0] != STX)
-            || (szRecvBuffer[nRecvLen - 1] != ETX))
+        uFwdNum = 0;
+        ulBadPkgs = 0;
+        for (int n = 0; n < nRecvNum; n++)
         {
-            DEBUG_PRINT(LM_ERROR, "PushϢβʶ\n");
-            continue;
-        }
+            pRecvBuffer = UdpBatchBuffer(stBatch, n);
+            nRecvLen = (int)stBatch.pMsgs[n].msg_len;
+            pstMsgpushPkg = (STRU_MSGPUSH_PKG*)pRecvBuffer;
 
-        if (ntohs(pstMsgpushPkg->stHead.u16MsgType) != DISPATCH_MSG_REQ)
-        {
-            DEBUG_PRINT(LM_ERROR, "PushϢ(%u)\n", ntohs(pstMsgpushPkg->stHead.u16MsgType));
-            continue;
+            // HJ_hex_show(pRecvBuffer, nRecvLen);
+
+            if ((nRecvLen <= 0)
+                || (pRecvBuffer[0] != STX)
+                || (pRecvBuffer[nRecvLen - 1] != ETX))
+            {
+                DEBUG_PRINT(LM_ERROR, "PushϢβʶ\n");
+                ulBadPkgs++;
+                continue;
+            }
+
+            if (ntohs(pstMsgpushPkg->stHead.u16MsgType) != DISPATCH_MSG_REQ)
+            {
+                DEBUG_PRINT(LM_ERROR, "PushϢ(%u)\n", ntohs(pstMsgpushPkg->stHead.u16MsgType));
+                ulBadPkgs++;
+                continue;
+            }
+
+            u16PkgLen = ntohs(pstMsgpushPkg->stHead.u16PkgLen);
+            if ((u16PkgLen != (UINT16)nRecvLen)
+                || (u16PkgLen < (sizeof(STRU_MSGPUSH_PKG_HEAD) + 2 * sizeof(UINT8))))
+            {
+                DEBUG_PRINT(LM_ERROR, "PushϢ\n");
+                ulBadPkgs++;
+                continue;
+            }
+
+            // д빲ڴ滷, ӽԼȥȡ
+            Push_ShmRing(g_stShmRing, pRecvBuffer, nRecvLen);
+            uFwdNum++;
         }
 
-        u16PkgLen = ntohs(pstMsgpushPkg->stHead.u16PkgLen);
-        if ((u16PkgLen != (UINT16)nRecvLen)
-            || (u16PkgLen < (sizeof(STRU_MSGPUSH_PKG_HEAD) + 2 * sizeof(UINT8))))
+        if (uFwdNum > 0)
         {
-            DEBUG_PRINT(LM_ERROR, "PushϢ\n");
-            continue;
+            Notify_ShmRing(g_stShmRing);
+            HJ_Rpt_API(RPT_ID_UDP_FORWARD_PKGS, uFwdNum);
         }
-
-        for (size_t i = 0; i < g_stConfig.uProcessNum; i++)
+        if (ulBadPkgs > 0)
         {
-            stAddrTo.sin_port = htons((unsigned short)(g_stConfig.usUdpPort + 1 + i));
-            sendto(g_stRuntime.nUdpSocket, szRecvBuffer, nRecvLen, 0
-                , (const struct sockaddr*)&stAddrTo, sizeof(stAddrTo));
+            HJ_Rpt_API(RPT_ID_UDP_BAD_PKGS, ulBadPkgs);
         }
     }
 
+    FreeUdpBatch(stBatch);
+
     return 0;
 }
 
@@ -1472,8 +1900,16 @@ int ChildProcess(void)
         return -1;
     }
 
+#if defined(USE_CLR_TIMEOUT)
+    time_t tm_before = time(NULL);
+#endif
+
     while (true)
     {
+#if defined(USE_CLR_TIMEOUT)
+        ClearTimeoutConnections(tm_before);
+#endif
+
         iRetCode = CheckConnStatus();
         if (iRetCode < 0)
         {
@@ -1537,7 +1973,7 @@ int InitializeMainProcess(char *pConfigFile)
         return -1;
     }
 
-    int nServerId, nUdpPort, nServerPort, nProcessNum, nMaxSocketNum, nMaxServiceNum;
+    int nServerId, nUdpPort, nServerPort, nProcessNum, nMaxSocketNum, nMaxServiceNum, nUdpBatchSize, nShmRingSize;
 
     printf("Initializing...\nUse config file: %s\n", pConfigFile);
 
@@ -1558,6 +1994,12 @@ int InitializeMainProcess(char *pConfigFile)
 
         , "MaxServiceNum", CFG_INT, &nMaxServiceNum, (int)DEFAULT_MAX_SERVICE_NUM
 
+        , "SendQueuePolicy", CFG_INT, &(g_stConfig.nSendQueuePolicy), (int)DEFAULT_SEND_QUEUE_POLICY
+
+        , "UdpBatchSize", CFG_INT, &nUdpBatchSize, (int)DEFAULT_UDP_BATCH_SIZE
+        , "UdpRecvBufSize", CFG_INT, &(g_stConfig.nUdpRecvBufSize), (int)DEFAULT_UDP_RECV_BUF_SIZE
+        , "ShmRingSize", CFG_INT, &nShmRingSize, (int)DEFAULT_SHM_RING_SIZE
+
         , "LogFilePath", CFG_STRING, g_stConfig.szLogFilePath, DEFAULT_LOG_FILE
             , sizeof(g_stConfig.szLogFilePath)
         , "MaxLogSize", CFG_LONG, &(g_stConfig.lMaxLogSize), (long)MAX_LOG_SIZE
@@ -1572,6 +2014,17 @@ int InitializeMainProcess(char *pConfigFile)
     g_stConfig.uMaxSocketNum = (size_t)nMaxSocketNum;
     g_stConfig.uMaxServiceNum = (size_t)nMaxServiceNum;
 
+    if (nUdpBatchSize < 1)
+    {
+        nUdpBatchSize = 1;
+    }
+    else if (nUdpBatchSize > MAX_UDP_BATCH_SIZE)
+    {
+        nUdpBatchSize = MAX_UDP_BATCH_SIZE;
+    }
+    g_stConfig.uUdpBatchSize = (size_t)nUdpBatchSize;
+    g_stConfig.uShmRingSize = (nShmRingSize > 0) ? (size_t)nShmRingSize : DEFAULT_SHM_RING_SIZE;
+
     if (g_stConfig.uMaxSocketNum < RESERVE_OTHER_SOCKET_NUM)
     {
         printf("MaxSocketNum: %Zu is illegal!\n", g_stConfig.uMaxSocketNum);
@@ -1589,7 +2042,11 @@ int InitializeMainProcess(char *pConfigFile)
     printf("PidFilePath: %s\n\n", g_stConfig.szPidFilePath);
     printf("MaxSocketNum: %Zu\n\n", g_stConfig.uMaxSocketNum);
     printf("ConnTimeout: %ld\n", g_stConfig.lConnTimeout);
-    printf("MaxServiceNum: %Zu\n\n", g_stConfig.uMaxServiceNum);
+    printf("MaxServiceNum: %Zu\n", g_stConfig.uMaxServiceNum);
+    printf("SendQueuePolicy: %d\n\n", g_stConfig.nSendQueuePolicy);
+    printf("UdpBatchSize: %Zu\n", g_stConfig.uUdpBatchSize);
+    printf("UdpRecvBufSize: %d\n", g_stConfig.nUdpRecvBufSize);
+    printf("ShmRingSize: %Zu\n\n", g_stConfig.uShmRingSize);
     printf("LogFilePath: %s\n", g_stConfig.szLogFilePath);
     printf("MaxLogSize: %ld\n", g_stConfig.lMaxLogSize);
     printf("MaxLogNum: %d\n\n", g_stConfig.nMaxLogNum);
@@ -1674,6 +2131,14 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    // ӽ̼̳ӳeventfd, fork֮ǰ
+    nRet = Create_ShmRing(g_stShmRing, g_stConfig.uShmRingSize, MAX_PUSH_PKG_LEN, g_stConfig.uProcessNum);
+    if (nRet < 0)
+    {
+        printf("Call Create_ShmRing(%Zu) failed!\n", g_stConfig.uShmRingSize);
+        return -1;
+    }
+
     if (ForkChildProcesses(g_stRuntime.uProcessId, g_stConfig.uProcessNum) < 0)
     {
         printf("Call ForkChildProcesses() failed!\n");
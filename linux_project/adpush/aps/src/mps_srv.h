@@ -19,6 +19,8 @@
 #define __MPS_SRV_H__
 
 #include <dirent.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
 
 #include "mps_usrinfo_acs.h"
 
@@ -79,9 +81,29 @@ typedef enum
 
 #define RESERVE_OTHER_SOCKET_NUM 20     // Ϊ̴򿪵ļĸ
 
+// ͻʱĴ
+#define SEND_QUEUE_DROP_NEWEST 0        // °
+#define SEND_QUEUE_DISCONNECT  1        // Ͽ
+#define DEFAULT_SEND_QUEUE_POLICY SEND_QUEUE_DROP_NEWEST
+
 // Ĭ֧ҵ
 #define DEFAULT_MAX_SERVICE_NUM  1024
 
+// UdpϢÿrecvmmsg/sendmmsgշ
+#define DEFAULT_UDP_BATCH_SIZE   32
+#define MAX_UDP_BATCH_SIZE       256
+// Udp socketĽջС, 0ʾʹϵͳĬֵ
+#define DEFAULT_UDP_RECV_BUF_SIZE (4 * 1024 * 1024)
+// ӿڻӽ̵Ĺڴ滷Ĳ, ÿMAX_PUSH_PKG_LENֽ
+#define DEFAULT_SHM_RING_SIZE    2048
+
+// ϱϱID, ۼϱ
+#define RPT_ID_UDP_RECV_PKGS     51001  // յUdp
+#define RPT_ID_UDP_BAD_PKGS      51002  // ʽ󱻶İ
+#define RPT_ID_UDP_OVERRUN_PKGS  51003  // ջں˶İ
+#define RPT_ID_UDP_FORWARD_PKGS  51004  // ӿڻд빲ڴ滷İ
+#define RPT_ID_SHM_RING_GAP_PKGS 51006  // ӽ̹İ
+
 typedef struct
 {
     size_t uServerId;                   // ڶ̨ͬͬServerʶԼ
@@ -100,11 +122,36 @@ typedef struct
 
     size_t uMaxServiceNum;              // ÿֵ֧̿ҵ
 
+    int nSendQueuePolicy;               // ͻʱĴ
+
+    size_t uUdpBatchSize;               // Udpÿշ
+    int nUdpRecvBufSize;                // Udp socketĽջС
+    size_t uShmRingSize;                // ڴ滷Ĳ
+
     char szLogFilePath[MAXNAMLEN - 32]; // ־ļ·
     long lMaxLogSize;                   // ־ļС
     int  nMaxLogNum;                    // ־ļ
 } STRU_CONFIG;
 
+// ߳ͶݸӵĴϢ
+// ַ߳ÿֻһڴ, ĿӵĽڵһ, üʱͷ
+struct _STRU_SEND_BLOCK;
+
+typedef struct _STRU_SEND_NODE
+{
+    struct _STRU_SEND_NODE *pNext;
+    struct _STRU_SEND_BLOCK *pBlock;
+    UINT32 u32Generation;               // ͶʱӵĴ
+} STRU_SEND_NODE;
+
+typedef struct _STRU_SEND_BLOCK
+{
+    volatile long lRef;                 // δ͵Ľڵ
+    size_t uPkgLen;
+    char *pPkg;
+    STRU_SEND_NODE stNodes[0];
+} STRU_SEND_BLOCK;
+
 typedef struct
 {
 #ifdef TRACE_IP
@@ -114,7 +161,9 @@ typedef struct
     int nPrevIndex;                     // Ӷеǰ
     int nNextIndex;                     // Ӷеĺ
 
-    volatile long lSendLock;            // ִзͲlock
+    int nTimerPrev;                     // ʱֲڵǰ
+    int nTimerNext;                     // ʱֲڵĺ
+    time_t tm_Expire;                   // ڳʱϵĵʱ, 0ʾδ
 
     int  nSocketType;                   // Socket״̬
     time_t tm_LoginTime;                // ӵ¼ʱ
@@ -130,11 +179,31 @@ typedef struct
 
     STRU_USERINFO_ACS *pUserinfo;       // ǰӵûϢ
 
+    // շֻдʱӻؽ, Ӳռ
     long lRecvBytes;                    // ǰѾյֽ
-    char szRecvBuffer[MAX_RECV_BUF_SIZE]; // ܻ
+    char *pRecvBuffer;                  // ջ, MAX_RECV_BUF_SIZEֽ
 
     long lToSendBytes;                  // ͻҪ͵ֽ
-    char szSendBuffer[MAX_SEND_BUF_SIZE]; // ݻ
+    char *pSendBuffer;                  // ݻ, MAX_SEND_BUF_SIZEֽ
+    long lDropPkgs;                     // ͻʱİ
+
+    volatile UINT32 u32Generation;      // ӹرʱ1, ͶݸӵϢ
+    STRU_SEND_NODE *volatile pSendQueue; // ߳ͶݵĴϢ, ȳ, epoll߳ȡ
+    int nReadyNext;                     // ĺ
 } STRU_SOCKET_CONTEXT;
 
+// UdpõĻ, ÿ߳һ
+#define UDP_BATCH_CTRL_LEN CMSG_SPACE(sizeof(unsigned int))
+
+typedef struct
+{
+    size_t uBatchSize;                  // ÿյİ
+    struct mmsghdr *pMsgs;              // recvmmsgϢͷ
+    struct iovec *pIovs;                // ÿݻ
+    struct sockaddr_in *pAddrs;         // ÿԴַ
+    char *pBuffers;                     // , ÿMAX_PUSH_PKG_LEN + 1ֽ
+    char *pCtrlBufs;                    // Ϣ, ȡSO_RXQ_OVFL
+    unsigned int u32LastOverrun;        // ϴζںۼƶ
+} STRU_UDP_BATCH;
+
 #endif
@@ -0,0 +1,211 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mps_svc_index.h"
+#include "mps_util.h"
+
+int Create_SvcIndex(STRU_SVC_INDEX &stIndex, size_t uSvcNum, size_t uMaxSocketNum)
+{
+    assert((uSvcNum > 0) && (uMaxSocketNum > 0));
+
+    bzero(&stIndex, sizeof(stIndex));
+
+    stIndex.pSvcs = (STRU_SVC_SUBSCRIBERS*)calloc(uSvcNum, sizeof(STRU_SVC_SUBSCRIBERS));
+    stIndex.pu16SvcId = (UINT16*)calloc(uMaxSocketNum, sizeof(UINT16));
+    stIndex.pnPos = (int*)malloc(uMaxSocketNum * sizeof(int));
+    if (!stIndex.pSvcs || !stIndex.pu16SvcId || !stIndex.pnPos)
+    {
+        Destroy_SvcIndex(stIndex);
+        return -1;
+    }
+    memset(stIndex.pnPos, -1, uMaxSocketNum * sizeof(int));
+
+    stIndex.uSvcNum = uSvcNum;
+    stIndex.uMaxSocketNum = uMaxSocketNum;
+
+    return 0;
+}
+
+void Destroy_SvcIndex(STRU_SVC_INDEX &stIndex)
+{
+    if (stIndex.pSvcs)
+    {
+        for (size_t i = 0; i < stIndex.uSvcNum; i++)
+        {
+            free(stIndex.pSvcs[i].pu32CommAttr);
+            free(stIndex.pSvcs[i].pusSocket);
+        }
+        free(stIndex.pSvcs);
+    }
+    free(stIndex.pu16SvcId);
+    free(stIndex.pnPos);
+
+    bzero(&stIndex, sizeof(stIndex));
+}
+
+/*!
+ * : ɱչҵ, ҵ
+ */
+static int Grow_SvcSubscribers(STRU_SVC_SUBSCRIBERS &stSvc)
+{
+    size_t uCapacity = (stSvc.uCapacity > 0) ? (stSvc.uCapacity * 2) : SVC_INDEX_INIT_SIZE;
+
+    UINT32 *pu32CommAttr = (UINT32*)realloc(stSvc.pu32CommAttr, uCapacity * sizeof(UINT32));
+    if (!pu32CommAttr)
+    {
+        return -1;
+    }
+    stSvc.pu32CommAttr = pu32CommAttr;
+
+    unsigned short *pusSocket = (unsigned short*)realloc(stSvc.pusSocket, uCapacity * sizeof(unsigned short));
+    if (!pusSocket)
+    {
+        return -1;
+    }
+    stSvc.pusSocket = pusSocket;
+
+    stSvc.uCapacity = uCapacity;
+
+    return 0;
+}
+
+int Insert_Subscriber(STRU_SVC_INDEX &stIndex, UINT16 u16SvcId, unsigned short usSocket
+    , UINT32 u32CommAttr)
+{
+    assert((u16SvcId < stIndex.uSvcNum) && (usSocket < stIndex.uMaxSocketNum));
+
+    if (stIndex.pnPos[usSocket] >= 0)
+    {
+        Remove_Subscriber(stIndex, usSocket);
+    }
+
+    STRU_SVC_SUBSCRIBERS &stSvc = stIndex.pSvcs[u16SvcId];
+    CAutoLock AutoLock(&stSvc.lLock);
+
+    if ((stSvc.uNum == stSvc.uCapacity) && (Grow_SvcSubscribers(stSvc) < 0))
+    {
+        return -1;
+    }
+
+    stSvc.pu32CommAttr[stSvc.uNum] = u32CommAttr;
+    stSvc.pusSocket[stSvc.uNum] = usSocket;
+    stIndex.pu16SvcId[usSocket] = u16SvcId;
+    stIndex.pnPos[usSocket] = (int)stSvc.uNum;
+    stSvc.uNum++;
+
+    return 0;
+}
+
+int Update_Subscriber(STRU_SVC_INDEX &stIndex, unsigned short usSocket, UINT32 u32CommAttr)
+{
+    assert(usSocket < stIndex.uMaxSocketNum);
+
+    int nPos = stIndex.pnPos[usSocket];
+    if (nPos < 0)
+    {
+        return -1;
+    }
+
+    STRU_SVC_SUBSCRIBERS &stSvc = stIndex.pSvcs[stIndex.pu16SvcId[usSocket]];
+    CAutoLock AutoLock(&stSvc.lLock);
+    stSvc.pu32CommAttr[nPos] = u32CommAttr;
+
+    return 0;
+}
+
+int Remove_Subscriber(STRU_SVC_INDEX &stIndex, unsigned short usSocket)
+{
+    assert(usSocket < stIndex.uMaxSocketNum);
+
+    int nPos = stIndex.pnPos[usSocket];
+    if (nPos < 0)
+    {
+        return -1;
+    }
+
+    STRU_SVC_SUBSCRIBERS &stSvc = stIndex.pSvcs[stIndex.pu16SvcId[usSocket]];
+    CAutoLock AutoLock(&stSvc.lLock);
+
+    // ĩβԪλ
+    size_t uLast = stSvc.uNum - 1;
+    if ((size_t)nPos != uLast)
+    {
+        unsigned short usMoved = stSvc.pusSocket[uLast];
+        stSvc.pu32CommAttr[nPos] = stSvc.pu32CommAttr[uLast];
+        stSvc.pusSocket[nPos] = usMoved;
+        stIndex.pnPos[usMoved] = nPos;
+    }
+    stSvc.uNum = uLast;
+    stIndex.pnPos[usSocket] = -1;
+
+    return 0;
+}
+
+/*!
+ * : ɨһҵĶ, ҵ
+ * @nע: ޷֧д, д뵱ǰλ, ֻвǰ.
+ *         дλòȡλ, ԽuNum
+ */
+static inline size_t Scan_SvcSubscribers(const STRU_SVC_SUBSCRIBERS &stSvc, UINT32 u32CommAttr
+    , unsigned short *pusSocket)
+{
+    size_t uNum = stSvc.uNum;
+    if (u32CommAttr == 0)
+    {
+        memcpy(pusSocket, stSvc.pusSocket, uNum * sizeof(unsigned short));
+        return uNum;
+    }
+
+    const UINT32 *pu32CommAttr = stSvc.pu32CommAttr;
+    const unsigned short *pusFrom = stSvc.pusSocket;
+    size_t uHit = 0;
+    for (size_t i = 0; i < uNum; i++)
+    {
+        pusSocket[uHit] = pusFrom[i];
+        uHit += ((pu32CommAttr[i] & u32CommAttr) != 0);
+    }
+
+    return uHit;
+}
+
+size_t Collect_Subscribers(STRU_SVC_INDEX &stIndex, UINT16 u16SvcId, UINT32 u32CommAttr
+    , unsigned short *pusSocket)
+{
+    assert((u16SvcId < stIndex.uSvcNum) && pusSocket);
+
+    STRU_SVC_SUBSCRIBERS &stSvc = stIndex.pSvcs[u16SvcId];
+    if (stSvc.uNum == 0)
+    {
+        return 0;
+    }
+
+    CAutoLock AutoLock(&stSvc.lLock);
+    return Scan_SvcSubscribers(stSvc, u32CommAttr, pusSocket);
+}
+
+size_t Collect_AllSubscribers(STRU_SVC_INDEX &stIndex, UINT32 u32CommAttr
+    , unsigned short *pusSocket)
+{
+    assert(pusSocket);
+
+    size_t uTotal = 0;
+    for (size_t i = 0; i < stIndex.uSvcNum; i++)
+    {
+        STRU_SVC_SUBSCRIBERS &stSvc = stIndex.pSvcs[i];
+        if (stSvc.uNum == 0)
+        {
+            continue;
+        }
+
+        CAutoLock AutoLock(&stSvc.lLock);
+        // ɨڼӸĵ¼ҵʱܱظռ, ֹԽ
+        if (uTotal + stSvc.uNum > stIndex.uMaxSocketNum)
+        {
+            break;
+        }
+        uTotal += Scan_SvcSubscribers(stSvc, u32CommAttr, pusSocket + uTotal);
+    }
+
+    return uTotal;
+}
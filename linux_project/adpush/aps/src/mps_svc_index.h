@@ -0,0 +1,60 @@
+/*! @file mps_svc_index.h
+ * *****************************************************************************
+ * @n</PRE>
+ * @nģ       : ҵ
+ * @nļ       : mps_svc_index.h
+ * @nļ     : mps_svc_index.cpp
+ * @nļʵֹ : ҵIdѵ¼ӵĽ, ҵ/ȫԱʱ˳ɨ
+ * @n---------------------------------------------------------------------------
+ * @nע: ÿҵ, ͨԺSocketIdֿ, Թֻ˳һڴ.
+ * @n      ɾʱĩβԪλ, ÿSocketеλõ¼.
+ * @n      ¼/עepoll߳, ɨڷַ߳, ÿҵһ.
+ * @n---------------------------------------------------------------------------
+ * @n</PRE>
+ ******************************************************************************/
+#ifndef __MPS_SVC_INDEX_H__
+#define __MPS_SVC_INDEX_H__
+
+#include <sys/types.h>
+
+#include "mps_pkg.h"
+
+// ÿҵʼ, ʱɱչ
+#define SVC_INDEX_INIT_SIZE 64
+
+// һҵĶ
+typedef struct
+{
+    volatile long lLock;                // ¼/עɨ֮
+    size_t uNum;                        // ǰ
+    size_t uCapacity;                   // 
+    UINT32 *pu32CommAttr;               // ߵͨ
+    unsigned short *pusSocket;          // ߵSocketId, pu32CommAttrһһӦ
+} STRU_SVC_SUBSCRIBERS;
+
+typedef struct
+{
+    size_t uSvcNum;                     // ҵ
+    size_t uMaxSocketNum;               // SocketId + 1
+    STRU_SVC_SUBSCRIBERS *pSvcs;        // ҵId±
+    UINT16 *pu16SvcId;                  // Socketҵ
+    int *pnPos;                         // Socketҵе±, -1ʾδ¼
+} STRU_SVC_INDEX;
+
+int Create_SvcIndex(STRU_SVC_INDEX &stIndex, size_t uSvcNum, size_t uMaxSocketNum);
+void Destroy_SvcIndex(STRU_SVC_INDEX &stIndex);
+
+// SocketʱƳԭλ, 0ɹ, <0չʧ
+int Insert_Subscriber(STRU_SVC_INDEX &stIndex, UINT16 u16SvcId, unsigned short usSocket
+    , UINT32 u32CommAttr);
+int Update_Subscriber(STRU_SVC_INDEX &stIndex, unsigned short usSocket, UINT32 u32CommAttr);
+int Remove_Subscriber(STRU_SVC_INDEX &stIndex, unsigned short usSocket);
+
+// ͨu32CommAttrн(u32CommAttrΪ0ʱȫ)SocketId׷ӵpusSocket,
+// ׷ӵĸ. pusSocketҪܷuMaxSocketNum
+size_t Collect_Subscribers(STRU_SVC_INDEX &stIndex, UINT16 u16SvcId, UINT32 u32CommAttr
+    , unsigned short *pusSocket);
+size_t Collect_AllSubscribers(STRU_SVC_INDEX &stIndex, UINT32 u32CommAttr
+    , unsigned short *pusSocket);
+
+#endif
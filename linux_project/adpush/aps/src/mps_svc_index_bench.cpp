@@ -0,0 +1,172 @@
+/*! @file mps_svc_index_bench.cpp
+ * *****************************************************************************
+ * @n</PRE>
+ * @nģ       : ҵѹ
+ * @nļ       : mps_svc_index_bench.cpp
+ * @nļ     : mps_svc_index.h, mps_usrinfo_acs.h
+ * @nļʵֹ : ȽϰҵʱRBɨ趩ĺʱ
+ * @n---------------------------------------------------------------------------
+ * @nע: ÷ mps_svc_index_bench [ ...], Ĭ500050000.
+ * @n      ûϢڴصӴɢ, ÿǰˢһ黺, ģڴ.
+ * @n      ַҵSocketIdϲһʱ1.
+ * @n---------------------------------------------------------------------------
+ * @n</PRE>
+ ******************************************************************************/
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "mps_usrinfo_acs.h"
+#include "mps_svc_index.h"
+
+// ѹʹõҵIdҵ
+#define BENCH_SVC_ID 1
+#define BENCH_SVC_NUM 4
+// ÿʹ
+#define BENCH_PUSH_NUM 200
+// ÿǰˢڴС, ĩ
+#define BENCH_EVICT_SIZE (32 << 20)
+// ÿ߷伸ûϢٴɢ, ģڴ¼עķֲ
+#define BENCH_SCATTER 4
+
+static double Now_Us()
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return stTime.tv_sec * 1e6 + stTime.tv_nsec / 1e3;
+}
+
+// ԭİҵ: RB, pNextͬһû
+static void Walk_Userinfo(struct HJ_RB_node *pNode, UINT32 u32CommAttr, std::vector<unsigned short> &vecSocket)
+{
+    if (!pNode)
+    {
+        return;
+    }
+    Walk_Userinfo(pNode->pLeft, u32CommAttr, vecSocket);
+    for (STRU_USERINFO_ACS *pUserinfo = HJ_RB_Entery(pNode, STRU_USERINFO_ACS, rbNode); pUserinfo
+        ; pUserinfo = pUserinfo->pNext)
+    {
+        if ((u32CommAttr == 0) || (pUserinfo->u32CommAttr & u32CommAttr))
+        {
+            vecSocket.push_back(pUserinfo->usCommSocket);
+        }
+    }
+    Walk_Userinfo(pNode->pRight, u32CommAttr, vecSocket);
+}
+
+static void Evict_Cache(std::vector<char> &vecJunk)
+{
+    for (size_t i = 0; i < vecJunk.size(); i += 64)
+    {
+        vecJunk[i]++;
+    }
+}
+
+// 0ɹ, 1ַһ
+static int Run_Case(size_t uNum)
+{
+    srand(1);
+
+    struct HJ_RB_root stRoot;
+    bzero(&stRoot, sizeof(stRoot));
+    STRU_SVC_INDEX stIndex;
+    if (Create_SvcIndex(stIndex, BENCH_SVC_NUM, uNum) != 0)
+    {
+        printf("Create_SvcIndexʧ, num=%zu\n", uNum);
+        return 1;
+    }
+
+    std::vector<STRU_USERINFO_ACS*> vecUserinfo;
+    for (size_t i = 0; i < uNum * BENCH_SCATTER; i++)
+    {
+        vecUserinfo.push_back(new STRU_USERINFO_ACS);
+    }
+    std::random_shuffle(vecUserinfo.begin(), vecUserinfo.end());
+    for (size_t i = 0; i < uNum; i++)
+    {
+        STRU_USERINFO_ACS *pUserinfo = vecUserinfo[i];
+        bzero(pUserinfo, sizeof(*pUserinfo));
+        pUserinfo->u64UsrId = ((UINT64)rand() << 32) | rand();
+        pUserinfo->u16SvcId = BENCH_SVC_ID;
+        pUserinfo->u32CommAttr = 1u << (rand() % 8);
+        pUserinfo->usCommSocket = (unsigned short)i;
+        Insert_Userinfo(&stRoot, pUserinfo, (unsigned short)i);
+        Insert_Subscriber(stIndex, BENCH_SVC_ID, (unsigned short)i, pUserinfo->u32CommAttr);
+    }
+
+    int nRet = 0;
+    std::vector<char> vecJunk(BENCH_EVICT_SIZE);
+    std::vector<unsigned short> vecWalk;
+    std::vector<unsigned short> vecIndex(uNum);
+    vecWalk.reserve(uNum);
+    UINT32 arrAttr[2] = {0, 0x5};
+    for (int k = 0; k < 2; k++)
+    {
+        double dWalk = 0;
+        double dIndex = 0;
+        size_t uFound = 0;
+        for (int r = 0; r < BENCH_PUSH_NUM; r++)
+        {
+            Evict_Cache(vecJunk);
+            vecWalk.clear();
+            double dBegin = Now_Us();
+            Walk_Userinfo(stRoot.pRBNode, arrAttr[k], vecWalk);
+            dWalk += Now_Us() - dBegin;
+
+            Evict_Cache(vecJunk);
+            dBegin = Now_Us();
+            uFound = Collect_Subscribers(stIndex, BENCH_SVC_ID, arrAttr[k], &vecIndex[0]);
+            dIndex += Now_Us() - dBegin;
+        }
+
+        std::vector<unsigned short> vecSorted(vecIndex.begin(), vecIndex.begin() + uFound);
+        std::sort(vecSorted.begin(), vecSorted.end());
+        std::sort(vecWalk.begin(), vecWalk.end());
+        bool bSame = (vecSorted == vecWalk);
+        if (!bSame)
+        {
+            nRet = 1;
+        }
+        printf("num=%-7zu attr=0x%x found=%-7zu rbtree %9.1f us/push  index %9.1f us/push  %s\n"
+            , uNum, arrAttr[k], uFound, dWalk / BENCH_PUSH_NUM, dIndex / BENCH_PUSH_NUM
+            , bSame ? "ok" : "MISMATCH");
+    }
+
+    Destroy_SvcIndex(stIndex);
+    for (size_t i = 0; i < vecUserinfo.size(); i++)
+    {
+        delete vecUserinfo[i];
+    }
+    return nRet;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<size_t> vecNum;
+    for (int i = 1; i < argc; i++)
+    {
+        long lNum = strtol(argv[i], NULL, 10);
+        if ((lNum <= 0) || (lNum > 65535))
+        {
+            printf("÷: %s [ ...], Ϊ1~65535\n", argv[0]);
+            return 2;
+        }
+        vecNum.push_back((size_t)lNum);
+    }
+    if (vecNum.empty())
+    {
+        vecNum.push_back(5000);
+        vecNum.push_back(50000);
+    }
+
+    int nFailed = 0;
+    for (size_t i = 0; i < vecNum.size(); i++)
+    {
+        nFailed += Run_Case(vecNum[i]);
+    }
+    return (nFailed > 0) ? 1 : 0;
+}
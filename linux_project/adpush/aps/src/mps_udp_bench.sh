@@ -0,0 +1,86 @@
+#!/bin/bash
+# UDPѹ
+# ÷: mps_udp_bench.sh mps_srv· ļ paced ÿ [=4] [Ϣ=200]
+#       mps_udp_bench.sh mps_srv· ļ drain [=0.3] [Ϣ=200]
+# paced: ٷ, ͳUdpPortں˶ͷÿϢCPU
+# drain: ͣ, Ϣѹڽն, ٻָ, ͳſٶȺÿϢCPU
+# UdpBatchSizeUdpRecvBufSizeļ; ͬĿ¼mps_udp_blast, BLASTָ
+
+if [ $# -lt 3 ]; then
+    sed -n '2,7p' $0
+    exit 2
+fi
+
+SRV=$1
+CONF=$2
+MODE=$3
+NAME=$(basename $SRV | cut -c1-15)
+BLAST=${BLAST:-$(dirname $0)/mps_udp_blast}
+PORT=$(awk '$1 == "UdpPort" {print $2}' $CONF)
+PORT=${PORT:-15000}
+HZ=$(getconf CLK_TCK)
+
+# UdpPortںۼƶ
+udp_drops()
+{
+    awk -v p=$(printf ":%04X" $PORT) '$2 ~ p"$" {print $NF}' /proc/net/udp
+}
+
+# UdpPortնеֽ
+udp_rxq()
+{
+    local q=$(awk -v p=$(printf ":%04X" $PORT) '$2 ~ p"$" {split($5, a, ":"); print a[2]}' /proc/net/udp)
+    echo $((16#${q:-0}))
+}
+
+# н̡߳ۼƵCPUʱ
+srv_cpu()
+{
+    local t=0
+    for p in $PIDS; do
+        for s in /proc/$p/task/*/stat; do
+            [ -f $s ] && t=$((t + $(sed 's/.*) //' $s | awk '{print $12 + $13}')))
+        done
+    done
+    echo $t
+}
+
+pkill -9 -x $NAME; sleep 0.5
+$SRV $CONF > /dev/null 2>&1
+sleep 1.5
+PIDS=$(pgrep -x $NAME)
+if [ -z "$PIDS" ]; then
+    echo "$SRV ʧ"
+    exit 1
+fi
+
+if [ "$MODE" = "paced" ]; then
+    d0=$(udp_drops); c0=$(srv_cpu)
+    out=$($BLAST $PORT ${5:-4} ${6:-200} $4)
+    sleep 0.5
+    d1=$(udp_drops); c1=$(srv_cpu)
+    sent=$(echo $out | awk '{print $2}')
+    echo "$NAME paced rate=$4 $out drops=$((d1 - d0))" \
+        "cpu=$(awk -v c=$((c1 - c0)) -v n=$sent -v hz=$HZ 'BEGIN{printf "%.2f", c * 1e6 / hz / n}')us/msg"
+elif [ "$MODE" = "drain" ]; then
+    d0=$(udp_drops)
+    kill -STOP $PIDS
+    out=$($BLAST $PORT ${4:-0.3} ${5:-200})
+    sent=$(echo $out | awk '{print $2}')
+    c0=$(srv_cpu); t0=$(date +%s.%N)
+    kill -CONT $PIDS
+    while [ "$(udp_rxq)" != "0" ]; do sleep 0.01; done
+    t1=$(date +%s.%N)
+    # п˻Ҫȷ̴ַ߳
+    c1=$(srv_cpu)
+    while sleep 0.05; c2=$(srv_cpu); [ $c2 != $c1 ]; do c1=$c2; t1=$(date +%s.%N); done
+    d1=$(udp_drops)
+    n=$((sent - (d1 - d0)))
+    echo "$NAME drain queued=$n drops=$((d1 - d0))" \
+        "$(awk -v n=$n -v t0=$t0 -v t1=$t1 -v c=$((c1 - c0)) -v hz=$HZ \
+        'BEGIN{printf "drain=%.3fs rate=%.0f/s cpu=%.2fus/msg", t1 - t0, n / (t1 - t0), c * 1e6 / hz / n}')"
+else
+    echo "δ֪ģʽ: $MODE"
+fi
+
+pkill -9 -x $NAME
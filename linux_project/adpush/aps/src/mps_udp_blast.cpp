@@ -0,0 +1,108 @@
+/*! @file mps_udp_blast.cpp
+ * *****************************************************************************
+ * @n</PRE>
+ * @nģ       : UDPѹⷢ
+ * @nļ       : mps_udp_blast.cpp
+ * @nļ     : mps_pkg.h, mps_udp_bench.sh
+ * @nļʵֹ : mps_srvUdpPortϢ, 
+ * @n---------------------------------------------------------------------------
+ * @nע: ÷ mps_udp_blast ˿  [Ϣ=200] [ÿ=0] [ҵId=1]
+ * @n      ʱ "sent  in  = /s", mps_udp_bench.shʽȡ.
+ * @n---------------------------------------------------------------------------
+ * @n</PRE>
+ ******************************************************************************/
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hj_net.h"
+#include "mps_pkg.h"
+
+// ÿ͵, ʱÿ֮˯
+#define BLAST_ROUND_NUM 64
+#define BLAST_BUF_SIZE 4096
+
+static double Now_Sec()
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return stTime.tv_sec + stTime.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        printf("÷: %s ˿  [Ϣ=200] [ÿ=0] [ҵId=1]\n", argv[0]);
+        return 2;
+    }
+    int nPort = atoi(argv[1]);
+    double dSecs = atof(argv[2]);
+    int nMsgLen = (argc > 3) ? atoi(argv[3]) : 200;
+    double dRate = (argc > 4) ? atof(argv[4]) : 0;
+    int nSvcId = (argc > 5) ? atoi(argv[5]) : 1;
+
+    int nPkgLen = 1 + sizeof(STRU_MSGPUSH_PKG_HEAD) + sizeof(STRU_PUSH_MSG) + nMsgLen + 1;
+    if ((nMsgLen < 0) || (nPkgLen > BLAST_BUF_SIZE))
+    {
+        printf("Ϣ0~%d֮\n", (int)(BLAST_BUF_SIZE - nPkgLen + nMsgLen));
+        return 2;
+    }
+
+    char szBuf[BLAST_BUF_SIZE];
+    bzero(szBuf, sizeof(szBuf));
+    STRU_MSGPUSH_PKG *pPkg = (STRU_MSGPUSH_PKG*)szBuf;
+    pPkg->u8Stx = STX;
+    pPkg->stHead.u16PkgLen = htons(nPkgLen);
+    pPkg->stHead.u16Verion = htons(0x100);
+    pPkg->stHead.u16MsgType = htons(DISPATCH_MSG_REQ);
+    STRU_PUSH_MSG *pPushMsg = (STRU_PUSH_MSG*)pPkg->szBody;
+    pPushMsg->u64UsrId = htonq((UINT64)12345);
+    pPushMsg->u16SvcId = htons(nSvcId);
+    pPushMsg->u16MsgLen = htons(nMsgLen);
+    memset(pPushMsg->szMsg, 'a', nMsgLen);
+    szBuf[nPkgLen - 1] = ETX;
+
+    int nSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in stAddr;
+    bzero(&stAddr, sizeof(stAddr));
+    stAddr.sin_family = AF_INET;
+    stAddr.sin_port = htons(nPort);
+    stAddr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    if ((nSocket < 0) || (connect(nSocket, (struct sockaddr*)&stAddr, sizeof(stAddr)) != 0))
+    {
+        perror("connect");
+        return 1;
+    }
+
+    long lSent = 0;
+    double dBegin = Now_Sec();
+    while (Now_Sec() - dBegin < dSecs)
+    {
+        for (int i = 0; i < BLAST_ROUND_NUM; i++)
+        {
+            if (send(nSocket, szBuf, nPkgLen, 0) > 0)
+            {
+                lSent++;
+            }
+        }
+        if (dRate > 0)
+        {
+            double dAhead = lSent / dRate - (Now_Sec() - dBegin);
+            if (dAhead > 0)
+            {
+                struct timespec stSleep = {(time_t)dAhead, (long)((dAhead - (time_t)dAhead) * 1e9)};
+                nanosleep(&stSleep, NULL);
+            }
+        }
+    }
+    double dElapsed = Now_Sec() - dBegin;
+    printf("sent %ld in %.2fs = %.0f/s\n", lSent, dElapsed, lSent / dElapsed);
+    close(nSocket);
+    return 0;
+}
@@ -135,4 +135,67 @@ int user_rmv_list(STRU_ELEMENT *pEle, STRU_ELEMENT* &pEle_Root)
     return 0;
 }
 
+// ӳʱֵĲ, ÿ1, ʱֵڲʱڵתȦ
+#define CONN_TIMER_WHEEL_SIZE 1024
+
+/*!
+ * : SocketĹҵʱtm_ExpireӦĲ
+ * @nע: ӻԾʱֻtm_LastActive, ʱٰtm_LastActive¹,
+ *        ԾӲƶڵ, 鳬ʱֻڵĲ
+ */
+template<class STRU_SOCKET_CONTEXT>
+int timer_add_list(int nSockFd, STRU_SOCKET_CONTEXT *pSocketContent, int *pWheel, time_t tm_Expire)
+{
+    assert((nSockFd >= 0) && pSocketContent && pWheel && (tm_Expire > 0));
+
+    int &slot_root = pWheel[tm_Expire % CONN_TIMER_WHEEL_SIZE];
+    pSocketContent[nSockFd].tm_Expire = tm_Expire;
+    pSocketContent[nSockFd].nTimerPrev = -1;
+    pSocketContent[nSockFd].nTimerNext = slot_root;
+
+    if (slot_root != -1)
+    {
+        pSocketContent[slot_root].nTimerPrev = nSockFd;
+    }
+
+    slot_root = nSockFd;
+
+    return 0;
+}
+
+/*!
+ * : SocketĴӳʱժ, δʱֱӷ
+ */
+template<class STRU_SOCKET_CONTEXT>
+int timer_rmv_list(int nSockFd, STRU_SOCKET_CONTEXT *pSocketContent, int *pWheel)
+{
+    assert((nSockFd >= 0) && pSocketContent && pWheel);
+
+    if (0 == pSocketContent[nSockFd].tm_Expire)
+    {
+        return 0;
+    }
+
+    int &slot_root = pWheel[pSocketContent[nSockFd].tm_Expire % CONN_TIMER_WHEEL_SIZE];
+    int &nPrev = pSocketContent[nSockFd].nTimerPrev;
+    int &nNext = pSocketContent[nSockFd].nTimerNext;
+    if (nNext != -1)
+    {
+        pSocketContent[nNext].nTimerPrev = nPrev;
+    }
+    if (nPrev != -1)
+    {
+        pSocketContent[nPrev].nTimerNext = nNext;
+    }
+
+    if (nSockFd == slot_root)
+    {
+        slot_root = nNext;
+    }
+    nPrev = nNext = -1;
+    pSocketContent[nSockFd].tm_Expire = 0;
+
+    return 0;
+}
+
 #endif
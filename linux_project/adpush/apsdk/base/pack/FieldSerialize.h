@@ -0,0 +1,395 @@
+/*********************************************************************************
+ļ	FieldSerialize.h
+˵		ֶαлñչֶαֶεCStandardSerialize
+
+ÿCFieldTraits<>һֶαģչ
+1 (PODֶΡбĳǰ׺)ڱͣÿֻһԽ
+2 䳤(ݡбԪ)ʣռۼֶαȽϻ
+3 -1쳣
+ϸʽCStandardSerializeֶлȫһ£
+PODsizeofԭΪ2ֽڳ+(β0)бΪ+Ԫ
+
+÷
+template<> struct CFieldTraits<STRU_XXX>
+{
+	typedef STRU_XXX Owner;
+	enum { PACK_TYPE = UC_XXX };	//ֻΪԪʹõĽṹԲ
+	typedef CFields<
+		FIELD_POD(int64_t, mi64UserID),
+		FIELD_STR(macNickName)
+	> Fields;
+};
+**********************************************************************************/
+
+#ifndef _FIELD_SERIALIZE_H_
+#define _FIELD_SERIALIZE_H_
+
+#include "../include.h"
+#include "StandardSerialize.h"
+
+//ÿػһΣļͷ˵
+template<class S>
+struct CFieldTraits;
+
+//PODֶ
+template<class S, class T, T S::*M>
+struct CPodField
+{
+	enum { FIXED_SIZE = sizeof(T) };
+
+	static inline int Store(const S &aoValue, char *&apPos, int &aiSpare)
+	{
+		memcpy(apPos, &(aoValue.*M), sizeof(T));
+		apPos += sizeof(T);
+		return 1;
+	}
+	static inline int Load(S &aoValue, const char *&apPos, int &aiSpare)
+	{
+		memcpy(&(aoValue.*M), apPos, sizeof(T));
+		apPos += sizeof(T);
+		return 1;
+	}
+};
+
+//0βĴȱСС
+template<class S, int N, char (S::*M)[N]>
+struct CStrField
+{
+	enum { FIXED_SIZE = sizeof(uint16_t) };
+
+	static inline int Store(const S &aoValue, char *&apPos, int &aiSpare)
+	{
+		const char *lpValue = aoValue.*M;
+		const char *lpEnd = (const char *)memchr(lpValue, 0, N);
+		if (lpEnd == NULL)
+			return -1;
+		uint16_t lwLen = (uint16_t)(lpEnd - lpValue);
+		if (lwLen > aiSpare)
+			return -1;
+		aiSpare -= lwLen;
+		memcpy(apPos, &lwLen, sizeof(uint16_t));
+		memcpy(apPos + sizeof(uint16_t), lpValue, lwLen);
+		apPos += sizeof(uint16_t) + lwLen;
+		return 1;
+	}
+	static inline int Load(S &aoValue, const char *&apPos, int &aiSpare)
+	{
+		uint16_t lwLen;
+		memcpy(&lwLen, apPos, sizeof(uint16_t));
+		if ((lwLen >= N) || (lwLen > aiSpare))
+			return -1;
+		aiSpare -= lwLen;
+		char *lpValue = aoValue.*M;
+		CStandardSerialize::copyData(lpValue, apPos + sizeof(uint16_t), lwLen);
+		lpValue[lwLen] = '\0';
+		apPos += sizeof(uint16_t) + lwLen;
+		return 1;
+	}
+};
+
+//+ԪбԪEҲҪCFieldTraits
+//ԪصĶְһοۼʱnewбɰԼͷ
+template<class S, class C, C S::*Count, class E, E* S::*List>
+struct CListField
+{
+	typedef typename CFieldTraits<E>::Fields ElemFields;
+	enum { FIXED_SIZE = sizeof(C) };
+
+	static inline int Store(const S &aoValue, char *&apPos, int &aiSpare)
+	{
+		C lCount = aoValue.*Count;
+		int liNeed = (int)lCount * ElemFields::FIXED_SIZE;
+		if (liNeed > aiSpare)
+			return -1;
+		aiSpare -= liNeed;
+		memcpy(apPos, &lCount, sizeof(C));
+		apPos += sizeof(C);
+		const E *lpList = aoValue.*List;
+		for (int i = 0; i < (int)lCount; i++)
+		{
+			if (ElemFields::Store(lpList[i], apPos, aiSpare) == -1)
+				return -1;
+		}
+		return 1;
+	}
+	static inline int Load(S &aoValue, const char *&apPos, int &aiSpare)
+	{
+		C lCount;
+		memcpy(&lCount, apPos, sizeof(C));
+		apPos += sizeof(C);
+		int liNeed = (int)lCount * ElemFields::FIXED_SIZE;
+		if (liNeed > aiSpare)
+			return -1;
+		aiSpare -= liNeed;
+
+		aoValue.*Count = lCount;
+		E *&lpList = aoValue.*List;
+		if (lpList != NULL)
+		{
+			delete [] lpList;
+			lpList = NULL;
+		}
+		if (lCount <= 0)
+			return 1;
+		lpList = new E[lCount];
+		for (int i = 0; i < (int)lCount; i++)
+		{
+			if (ElemFields::Load(lpList[i], apPos, aiSpare) == -1)
+				return -1;
+		}
+		return 1;
+	}
+};
+
+//ֶαβ
+struct CFieldEnd
+{
+	enum { FIXED_SIZE = 0 };
+
+	template<class S>
+	static inline int Store(const S &aoValue, char *&apPos, int &aiSpare)
+	{
+		return 1;
+	}
+	template<class S>
+	static inline int Load(S &aoValue, const char *&apPos, int &aiSpare)
+	{
+		return 1;
+	}
+};
+
+//ֶα32ֶΣδõλCFieldEnd
+//ֶ˳չǵݹ飬֤ı붼һ
+//λúʣռȡֲдֶʱΪǱдڴ
+template<
+	class F1 = CFieldEnd, class F2 = CFieldEnd, class F3 = CFieldEnd, class F4 = CFieldEnd,
+	class F5 = CFieldEnd, class F6 = CFieldEnd, class F7 = CFieldEnd, class F8 = CFieldEnd,
+	class F9 = CFieldEnd, class F10 = CFieldEnd, class F11 = CFieldEnd, class F12 = CFieldEnd,
+	class F13 = CFieldEnd, class F14 = CFieldEnd, class F15 = CFieldEnd, class F16 = CFieldEnd,
+	class F17 = CFieldEnd, class F18 = CFieldEnd, class F19 = CFieldEnd, class F20 = CFieldEnd,
+	class F21 = CFieldEnd, class F22 = CFieldEnd, class F23 = CFieldEnd, class F24 = CFieldEnd,
+	class F25 = CFieldEnd, class F26 = CFieldEnd, class F27 = CFieldEnd, class F28 = CFieldEnd,
+	class F29 = CFieldEnd, class F30 = CFieldEnd, class F31 = CFieldEnd, class F32 = CFieldEnd>
+struct CFields
+{
+	enum { FIXED_SIZE =
+		F1::FIXED_SIZE + F2::FIXED_SIZE + F3::FIXED_SIZE + F4::FIXED_SIZE +
+		F5::FIXED_SIZE + F6::FIXED_SIZE + F7::FIXED_SIZE + F8::FIXED_SIZE +
+		F9::FIXED_SIZE + F10::FIXED_SIZE + F11::FIXED_SIZE + F12::FIXED_SIZE +
+		F13::FIXED_SIZE + F14::FIXED_SIZE + F15::FIXED_SIZE + F16::FIXED_SIZE +
+		F17::FIXED_SIZE + F18::FIXED_SIZE + F19::FIXED_SIZE + F20::FIXED_SIZE +
+		F21::FIXED_SIZE + F22::FIXED_SIZE + F23::FIXED_SIZE + F24::FIXED_SIZE +
+		F25::FIXED_SIZE + F26::FIXED_SIZE + F27::FIXED_SIZE + F28::FIXED_SIZE +
+		F29::FIXED_SIZE + F30::FIXED_SIZE + F31::FIXED_SIZE + F32::FIXED_SIZE };
+
+	template<class S>
+	static inline int Store(const S &aoValue, char *&apPos, int &aiSpare)
+	{
+		char *lpPos = apPos;
+		int liSpare = aiSpare;
+		if (F1::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F2::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F3::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F4::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F5::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F6::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F7::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F8::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F9::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F10::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F11::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F12::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F13::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F14::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F15::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F16::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F17::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F18::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F19::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F20::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F21::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F22::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F23::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F24::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F25::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F26::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F27::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F28::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F29::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F30::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F31::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F32::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		apPos = lpPos;
+		aiSpare = liSpare;
+		return 1;
+	}
+	template<class S>
+	static inline int Load(S &aoValue, const char *&apPos, int &aiSpare)
+	{
+		const char *lpPos = apPos;
+		int liSpare = aiSpare;
+		if (F1::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F2::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F3::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F4::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F5::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F6::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F7::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F8::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F9::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F10::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F11::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F12::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F13::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F14::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F15::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F16::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F17::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F18::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F19::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F20::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F21::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F22::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F23::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F24::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F25::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F26::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F27::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F28::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F29::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F30::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F31::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		if (F32::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		apPos = lpPos;
+		aiSpare = liSpare;
+		return 1;
+	}
+};
+
+//CFieldTraitsʹãOwnerΪ
+#define FIELD_POD(T, M) CPodField<Owner, T, &Owner::M>
+#define FIELD_STR(M) CStrField<Owner, sizeof(((Owner *)0)->M), &Owner::M>
+#define FIELD_LIST(C, COUNT, E, LIST) CListField<Owner, C, &Owner::COUNT, E, &Owner::LIST>
+
+template<class S>
+class CFieldSerialize
+{
+public:
+	typedef typename CFieldTraits<S>::Fields Fields;
+
+	//+ֶΣݳȣ-1ʧ
+	static int Pack(const S &aoValue, char *apBuffer, int alLen)
+	{
+		int liSpare = alLen - (int)sizeof(uint16_t) - Fields::FIXED_SIZE;
+		if (liSpare < 0)
+			return -1;
+		uint16_t lwPackType = CFieldTraits<S>::PACK_TYPE;
+		memcpy(apBuffer, &lwPackType, sizeof(uint16_t));
+		char *lpPos = apBuffer + sizeof(uint16_t);
+		if (Fields::Store(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		return (int)(lpPos - apBuffer);
+	}
+
+	//ͽֶΣʹõĳȣ-1ʧ
+	static int UnPack(S &aoValue, const char *apBuffer, int alLen)
+	{
+		int liSpare = alLen - (int)sizeof(uint16_t) - Fields::FIXED_SIZE;
+		if (liSpare < 0)
+			return -1;
+		const char *lpPos = apBuffer + sizeof(uint16_t);
+		if (Fields::Load(aoValue, lpPos, liSpare) == -1)
+			return -1;
+		return (int)(lpPos - apBuffer);
+	}
+
+	//ǶCStandardSerializeʱʹã1ɹ-1ʧ
+	static int Serialize(S &aoValue, CStandardSerialize &aoSerialize)
+	{
+		int liSpare = aoSerialize.getSpareLen() - Fields::FIXED_SIZE;
+		if (liSpare < 0)
+			return -1;
+		char *lpBegin = aoSerialize.getCurrent();
+		if (aoSerialize.mbyType == CStandardSerialize::LOAD)
+		{
+			const char *lpPos = lpBegin;
+			if (Fields::Load(aoValue, lpPos, liSpare) == -1)
+				return -1;
+			aoSerialize.skip((int)(lpPos - lpBegin));
+		}
+		else
+		{
+			char *lpPos = lpBegin;
+			if (Fields::Store(aoValue, lpPos, liSpare) == -1)
+				return -1;
+			aoSerialize.skip((int)(lpPos - lpBegin));
+		}
+		return 1;
+	}
+};
+
+#endif //_FIELD_SERIALIZE_H_
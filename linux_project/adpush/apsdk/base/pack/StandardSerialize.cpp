@@ -125,4 +125,7 @@ int	CStandardSerialize::Serialize(unsigned char *apValue, uint16_t awLen)
 	return 1;
 }
 
-
+void CStandardSerialize::copyData(char *apDest, const char *apSrc, uint16_t awLen)
+{
+	memcpy(apDest, apSrc, awLen);
+}
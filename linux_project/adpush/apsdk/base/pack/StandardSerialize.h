@@ -69,6 +69,13 @@ public:
 
 	//ȡ
 	int	getDataLen();
+
+	//ֶαл(FieldSerialize.h)ֱӶдǰλ
+	inline char * getCurrent() { return mpBuffer + mlDataLen; }
+	inline int getSpareLen() { return mlBufLen - mlDataLen; }
+	inline void skip(int alLen) { mlDataLen += alLen; }
+	//ֶα⴮ãcppﲻޱ֪ʱgccmemcpyչrep movs̴ȿ⺯
+	static void copyData(char *apDest, const char *apSrc, uint16_t awLen);
 	
 	ENUM_TYPE	mbyType;		//л
 private:	
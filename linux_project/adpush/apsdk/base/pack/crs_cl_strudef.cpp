@@ -577,126 +577,54 @@ int STRU_UC_CL_CRS_LOGIN_HALL_RQ_2007::Serialize( CStandardSerialize & aoStandar
 
 //ҵ¼Ӧ
 
-int STRU_UC_CL_CRS_LOGIN_HALL_RS_2007::Pack( char* apBuffer , int alLen ) 											
-{ 																							
-
-	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::STORE );		
-	uint16_t lwPackType=UC_CL_CRS_LOGIN_HALL_RS_2007; 											
-	loSerialize.Serialize( lwPackType ); 												
-	if( Serialize(loSerialize) == -1 ) 													
-	{ 																					
-		return -1; 																	
-	} 																					
-	return loSerialize.getDataLen(); 													
-
-} 																							
-
-int STRU_UC_CL_CRS_LOGIN_HALL_RS_2007::UnPack( char* apBuffer , int alLen ) 											
-{ 																							
-
-	CStandardSerialize loSerialize( apBuffer, alLen, CStandardSerialize::LOAD );		
-	uint16_t lwPackType ; 																	
-	loSerialize.Serialize(lwPackType); 													
-	if ( Serialize(loSerialize) == -1 ) 												
-	{ 																					
-		return -1; 																		
-	} 																					
-	return 1; 																			
-
-}																							
-
-
-int STRU_UC_CL_CRS_LOGIN_HALL_RS_2007::Serialize(CStandardSerialize & aoStandardSerialize)   
+int STRU_UC_CL_CRS_LOGIN_HALL_RS_2007::Pack( char* apBuffer , int alLen )
 {
+	return CFieldSerialize<STRU_UC_CL_CRS_LOGIN_HALL_RS_2007>::Pack(*this, apBuffer, alLen);
+}
 
-	aoStandardSerialize.Serialize(mulToken);
-	aoStandardSerialize.Serialize(mbyResult);
-	aoStandardSerialize.Serialize(mlHallID);
-	aoStandardSerialize.Serialize(mlRoomMaxPlayer);
-	aoStandardSerialize.Serialize(macErrInfo,ERR_BUF_LEN + 1);
-	aoStandardSerialize.Serialize(mszVoiceIp , 64 );
-	aoStandardSerialize.Serialize(musVoicePort);
-	aoStandardSerialize.Serialize(macTopic , UC_CHATROOM_TOPIC_LEN + 1);
-	aoStandardSerialize.Serialize(macSalutatory , UC_CHATROOM_SALUTATORY_LEN + 1);
-	aoStandardSerialize.Serialize(macPwd,UC_HALL_PWD_LEN + 1);
-	aoStandardSerialize.Serialize(macImvName,CHATROOM_IMV_NAME_LEN+1);
-	aoStandardSerialize.Serialize(mlHallProperty);
-	aoStandardSerialize.Serialize(mlHallState);
-	aoStandardSerialize.Serialize(mbyMicNum);
-	aoStandardSerialize.Serialize(macWUserURL,ERR_BUF_LEN + 1);
-
+int STRU_UC_CL_CRS_LOGIN_HALL_RS_2007::UnPack( char* apBuffer , int alLen )
+{
+	if (CFieldSerialize<STRU_UC_CL_CRS_LOGIN_HALL_RS_2007>::UnPack(*this, apBuffer, alLen) == -1)
+	{
+		return -1;
+	}
 	return 1;
 }
 
-//ҵ¼Ӧ
-
-int STRU_UC_CL_CRS_LOGIN_HALL_RS_2009::Pack( char* apBuffer , int alLen ) 											
-{ 																							
-
-	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::STORE );		
-	uint16_t lwPackType=UC_CL_CRS_LOGIN_HALL_RS_2009; 											
-	loSerialize.Serialize( lwPackType ); 												
-	if( Serialize(loSerialize) == -1 ) 													
-	{ 																					
-		return -1; 																	
-	} 																					
-	return loSerialize.getDataLen(); 													
 
-} 																							
+int STRU_UC_CL_CRS_LOGIN_HALL_RS_2007::Serialize(CStandardSerialize & aoStandardSerialize)
+{
+	return CFieldSerialize<STRU_UC_CL_CRS_LOGIN_HALL_RS_2007>::Serialize(*this, aoStandardSerialize);
+}
 
-int STRU_UC_CL_CRS_LOGIN_HALL_RS_2009::UnPack( char* apBuffer , int alLen ) 											
-{ 																							
+//ҵ¼Ӧ
 
-	CStandardSerialize loSerialize( apBuffer, alLen, CStandardSerialize::LOAD );		
-	uint16_t lwPackType ; 																	
-	loSerialize.Serialize(lwPackType); 													
-	if ( Serialize(loSerialize) == -1 ) 												
-	{ 																					
-		return -1; 																		
-	} 																					
-	return 1; 																			
+int STRU_UC_CL_CRS_LOGIN_HALL_RS_2009::Pack( char* apBuffer , int alLen )
+{
+	return CFieldSerialize<STRU_UC_CL_CRS_LOGIN_HALL_RS_2009>::Pack(*this, apBuffer, alLen);
+}
 
-}																							
+int STRU_UC_CL_CRS_LOGIN_HALL_RS_2009::UnPack( char* apBuffer , int alLen )
+{
+	if (CFieldSerialize<STRU_UC_CL_CRS_LOGIN_HALL_RS_2009>::UnPack(*this, apBuffer, alLen) == -1)
+	{
+		return -1;
+	}
+	return 1;
+}
 
 
 
-int STRU_UC_CL_CRS_LOGIN_HALL_RS_2009::Serialize(CStandardSerialize & aoStandardSerialize)   
+int STRU_UC_CL_CRS_LOGIN_HALL_RS_2009::Serialize(CStandardSerialize & aoStandardSerialize)
 {
-
-	aoStandardSerialize.Serialize(mulToken);
-	aoStandardSerialize.Serialize(mbyResult);
-	aoStandardSerialize.Serialize(mlHallID);
-	aoStandardSerialize.Serialize(mlRoomMaxPlayer);
-	aoStandardSerialize.Serialize(macErrInfo,ERR_BUF_LEN + 1);
-	aoStandardSerialize.Serialize(mszVoiceIp , 64 );
-	aoStandardSerialize.Serialize(musVoicePort);
-	aoStandardSerialize.Serialize(macTopic , UC_CHATROOM_TOPIC_LEN + 1);
-	aoStandardSerialize.Serialize(macSalutatory , UC_CHATROOM_SALUTATORY_LEN + 1);
-	aoStandardSerialize.Serialize(macPwd,UC_HALL_PWD_LEN + 1);
-	aoStandardSerialize.Serialize(macImvName,CHATROOM_IMV_NAME_LEN+1);
-	//aoStandardSerialize.Serialize(mlHallProperty);
-	aoStandardSerialize.Serialize(mlHallState);
-	aoStandardSerialize.Serialize(mbyMicNum);
-	aoStandardSerialize.Serialize(macWUserURL,ERR_BUF_LEN + 1);
-
-	aoStandardSerialize.Serialize(mi64HallProperty);
-
-	return 1;
+	return CFieldSerialize<STRU_UC_CL_CRS_LOGIN_HALL_RS_2009>::Serialize(*this, aoStandardSerialize);
 }
 
 
 
 int STRU_CHATROOM_USER_INFO_2007::Serialize(CStandardSerialize & aoStandardSerialize)
 {
-	aoStandardSerialize.Serialize(mi64UserId);
-	aoStandardSerialize.Serialize(macNickName,NICK_NAME_LEN+1);
-	aoStandardSerialize.Serialize(mwPhotoNum);
-	aoStandardSerialize.Serialize(mbyPower);
-	aoStandardSerialize.Serialize(mlUserState);
-	aoStandardSerialize.Serialize(mbyVoiceState);
-	aoStandardSerialize.Serialize(mbyUserLanguage);
-	aoStandardSerialize.Serialize(miRedMemTime);
-	return 1;
+	return CFieldSerialize<STRU_CHATROOM_USER_INFO_2007>::Serialize(*this, aoStandardSerialize);
 }
 
 STRU_UC_CL_CRS_USER_INFO_ID_2007::~STRU_UC_CL_CRS_USER_INFO_ID_2007()
@@ -709,54 +637,25 @@ STRU_UC_CL_CRS_USER_INFO_ID_2007::~STRU_UC_CL_CRS_USER_INFO_ID_2007()
 }
 
 
-int STRU_UC_CL_CRS_USER_INFO_ID_2007::Pack( char* apBuffer , int alLen ) 											
-{ 																							
-
-	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::STORE );		
-	uint16_t lwPackType=UC_CL_CRS_USER_INFO_ID_2007; 											
-	loSerialize.Serialize( lwPackType ); 												
-	if( Serialize(loSerialize) == -1 ) 													
-	{ 																					
-		return -1; 																	
-	} 																					
-	return loSerialize.getDataLen(); 													
-
-} 																							
-
-int STRU_UC_CL_CRS_USER_INFO_ID_2007::UnPack( char* apBuffer , int alLen ) 											
-{ 																							
-
-	CStandardSerialize loSerialize( apBuffer, alLen, CStandardSerialize::LOAD );		
-	uint16_t lwPackType ; 																	
-	loSerialize.Serialize(lwPackType); 													
-	if ( Serialize(loSerialize) == -1 ) 												
-	{ 																					
-		return -1; 																		
-	} 																					
-	return 1; 																			
+int STRU_UC_CL_CRS_USER_INFO_ID_2007::Pack( char* apBuffer , int alLen )
+{
+	return CFieldSerialize<STRU_UC_CL_CRS_USER_INFO_ID_2007>::Pack(*this, apBuffer, alLen);
+}
 
-}																							
+int STRU_UC_CL_CRS_USER_INFO_ID_2007::UnPack( char* apBuffer , int alLen )
+{
+	if (CFieldSerialize<STRU_UC_CL_CRS_USER_INFO_ID_2007>::UnPack(*this, apBuffer, alLen) == -1)
+	{
+		return -1;
+	}
+	return 1;
+}
 
 
 
 int STRU_UC_CL_CRS_USER_INFO_ID_2007::Serialize(CStandardSerialize & aoStandardSerialize)
 {
-
-	aoStandardSerialize.Serialize(mlChatroomID);
-	aoStandardSerialize.Serialize(mwUserCount);
-	if (aoStandardSerialize.mbyType == CStandardSerialize::LOAD)
-	{
-		mpUserIDList = NULL;
-		if (mwUserCount > 0)
-		{
-			mpUserIDList = new STRU_CHATROOM_USER_INFO_2007[mwUserCount];
-		}
-	}
-	for(int i = 0; i < mwUserCount; i++)
-	{
-		mpUserIDList[i].Serialize(aoStandardSerialize);
-	}
-	return 1;
+	return CFieldSerialize<STRU_UC_CL_CRS_USER_INFO_ID_2007>::Serialize(*this, aoStandardSerialize);
 }
 
 
@@ -3183,134 +3082,54 @@ int STRU_UC_CL_CRS_INSERT_MIC_ID::Serialize(CStandardSerialize & aoStandardSeria
 
 //SinaShow1.3¼ӵ
 
-int STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009::Pack( char* apBuffer , int alLen ) 											
-{ 																																												
-	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::STORE );		
-	uint16_t lwPackType=UC_CL_CRS_ENTRY_OTHERUSER_ID_2009; 											
-	loSerialize.Serialize( lwPackType ); 												
-	if( Serialize(loSerialize) == -1 ) 													
-	{ 																					
-		return -1; 																	
-	} 																					
-	return loSerialize.getDataLen(); 																																		
-} 																							
-
-int STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009::UnPack( char* apBuffer , int alLen ) 											
-{ 																																												
-	CStandardSerialize loSerialize( apBuffer, alLen, CStandardSerialize::LOAD );		
-	uint16_t lwPackType ; 																	
-	loSerialize.Serialize(lwPackType); 													
-	if ( Serialize(loSerialize) == -1 ) 												
-	{ 																					
-		return -1; 																		
-	} 																					
-	return 1; 																																								
-}																							
-
-
-
-int STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009::Serialize(CStandardSerialize & aoStandardSerialize)
+int STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009::Pack( char* apBuffer , int alLen )
 {
-	aoStandardSerialize.Serialize(mlChatroomID);
-	aoStandardSerialize.Serialize(mi64UserID);
-	aoStandardSerialize.Serialize(macNickName,NICK_NAME_LEN + 1);
-	aoStandardSerialize.Serialize(mwPhotoNum);
-	aoStandardSerialize.Serialize(mbyPower);
-	aoStandardSerialize.Serialize(mlUserState);	
-	aoStandardSerialize.Serialize(mbyUserLanguage); //
-	aoStandardSerialize.Serialize(miRedMemTime);
-
-	aoStandardSerialize.Serialize(mstrUniName,DEF_USER_UNINAME_LEN+1);
-	aoStandardSerialize.Serialize(mstrUserMood,DEF_USER_MOOD_LENGTH+1);
-	aoStandardSerialize.Serialize(mstrUserImageURL,URL_LINK_LEN+1);
-	aoStandardSerialize.Serialize(mbyUserSex);
-	aoStandardSerialize.Serialize(miUserOnLineTime);
-	aoStandardSerialize.Serialize(miUserCharm);
-	aoStandardSerialize.Serialize(miUserWealth);
-	aoStandardSerialize.Serialize(miUserActivity);
-	aoStandardSerialize.Serialize(mlVipRooomID);
-	aoStandardSerialize.Serialize(mbyShowBar);
-	aoStandardSerialize.Serialize(mstrUserBirthDay,DEF_USER_BIRTHDAY_LEN+1);
-	//aoStandardSerialize.Serialize(mbyShopUser);
-
-	return 1;
+	return CFieldSerialize<STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009>::Pack(*this, apBuffer, alLen);
 }
 
-int STRU_CHATROOM_USER_INFO_2009::Serialize( CStandardSerialize & aoStandardSerialize )
+int STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009::UnPack( char* apBuffer , int alLen )
 {
-	aoStandardSerialize.Serialize(mi64UserId);
-	aoStandardSerialize.Serialize(macNickName,NICK_NAME_LEN+1);
-	aoStandardSerialize.Serialize(mwPhotoNum);
-	aoStandardSerialize.Serialize(mbyPower);
-	aoStandardSerialize.Serialize(mlUserState);
-	aoStandardSerialize.Serialize(mbyVoiceState);
-	aoStandardSerialize.Serialize(mbyUserLanguage);
-	aoStandardSerialize.Serialize(miRedMemTime);
-
-	//aoStandardSerialize.Serialize(macVersion,VERSION_LEN+1);
-	aoStandardSerialize.Serialize(mstrUniName,DEF_USER_UNINAME_LEN+1);
-	aoStandardSerialize.Serialize(mstrUserMood,DEF_USER_MOOD_LENGTH+1);
-	aoStandardSerialize.Serialize(mstrUserImageURL,URL_LINK_LEN+1);
-	aoStandardSerialize.Serialize(mbyUserSex);
-	aoStandardSerialize.Serialize(miUserOnLineTime);	
-	aoStandardSerialize.Serialize(miUserCharm);	
-	aoStandardSerialize.Serialize(miUserWealth);	
-	aoStandardSerialize.Serialize(miUserActivity);	
-	aoStandardSerialize.Serialize(mlVipRooomID);	
-	aoStandardSerialize.Serialize(mbyShowBar);	
-	aoStandardSerialize.Serialize(mstrUserBirthDay,DEF_USER_BIRTHDAY_LEN+1);
-	//aoStandardSerialize.Serialize(mbyShopUser);
-
+	if (CFieldSerialize<STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009>::UnPack(*this, apBuffer, alLen) == -1)
+	{
+		return -1;
+	}
 	return 1;
 }
 
 
-int STRU_UC_CL_CRS_USER_INFO_ID_2009::Pack( char* apBuffer , int alLen ) 											
-{ 																																											
-	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::STORE );		
-	uint16_t lwPackType=UC_CL_CRS_USER_INFO_ID_2009; 											
-	loSerialize.Serialize( lwPackType ); 												
-	if( Serialize(loSerialize) == -1 ) 													
-	{ 																					
-		return -1; 																	
-	} 																					
-	return loSerialize.getDataLen(); 																																		
-} 																							
 
-int STRU_UC_CL_CRS_USER_INFO_ID_2009::UnPack( char* apBuffer , int alLen ) 											
-{ 																							
+int STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009::Serialize(CStandardSerialize & aoStandardSerialize)
+{
+	return CFieldSerialize<STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009>::Serialize(*this, aoStandardSerialize);
+}
 
-	CStandardSerialize loSerialize( apBuffer, alLen, CStandardSerialize::LOAD );		
-	uint16_t lwPackType ; 																	
-	loSerialize.Serialize(lwPackType); 													
-	if ( Serialize(loSerialize) == -1 ) 												
-	{ 																					
-		return -1; 																		
-	} 																					
-	return 1; 																																								
-}																							
+int STRU_CHATROOM_USER_INFO_2009::Serialize(CStandardSerialize & aoStandardSerialize)
+{
+	return CFieldSerialize<STRU_CHATROOM_USER_INFO_2009>::Serialize(*this, aoStandardSerialize);
+}
 
 
+int STRU_UC_CL_CRS_USER_INFO_ID_2009::Pack( char* apBuffer , int alLen )
+{
+	return CFieldSerialize<STRU_UC_CL_CRS_USER_INFO_ID_2009>::Pack(*this, apBuffer, alLen);
+}
 
-int STRU_UC_CL_CRS_USER_INFO_ID_2009::Serialize( CStandardSerialize & aoStandardSerialize )
+int STRU_UC_CL_CRS_USER_INFO_ID_2009::UnPack( char* apBuffer , int alLen )
 {
-	aoStandardSerialize.Serialize(mlChatroomID);
-	aoStandardSerialize.Serialize(mwUserCount);
-	if (aoStandardSerialize.mbyType == CStandardSerialize::LOAD)
-	{
-		mpUserIDList = NULL;
-		if (mwUserCount > 0)
-		{
-			mpUserIDList = new STRU_CHATROOM_USER_INFO_2009[mwUserCount];
-		}
-	}
-	for(int i = 0; i < mwUserCount; i++)
+	if (CFieldSerialize<STRU_UC_CL_CRS_USER_INFO_ID_2009>::UnPack(*this, apBuffer, alLen) == -1)
 	{
-		mpUserIDList[i].Serialize(aoStandardSerialize);
+		return -1;
 	}
 	return 1;
 }
 
+
+
+int STRU_UC_CL_CRS_USER_INFO_ID_2009::Serialize(CStandardSerialize & aoStandardSerialize)
+{
+	return CFieldSerialize<STRU_UC_CL_CRS_USER_INFO_ID_2009>::Serialize(*this, aoStandardSerialize);
+}
+
 STRU_UC_CL_CRS_USER_INFO_ID_2009::~STRU_UC_CL_CRS_USER_INFO_ID_2009()
 {
 	if(mpUserIDList)
@@ -3324,201 +3143,96 @@ STRU_UC_CL_CRS_USER_INFO_ID_2009::~STRU_UC_CL_CRS_USER_INFO_ID_2009()
 
 
 
-int STRU_UC_CL_CRS_GIFT_PROP_USE_RQ::Pack( char* apBuffer , int alLen ) 											
-{ 																																												
-	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::STORE );		
-	uint16_t lwPackType=UC_CL_CRS_GIFT_PROP_USE_RQ; 											
-	loSerialize.Serialize( lwPackType ); 												
-	if( Serialize(loSerialize) == -1 ) 													
-	{ 																					
-		return -1; 																	
-	} 																					
-	return loSerialize.getDataLen(); 																																		
-} 																							
-
-int STRU_UC_CL_CRS_GIFT_PROP_USE_RQ::UnPack( char* apBuffer , int alLen ) 											
-{ 																																												
-	CStandardSerialize loSerialize( apBuffer, alLen, CStandardSerialize::LOAD );		
-	uint16_t lwPackType ; 																	
-	loSerialize.Serialize(lwPackType); 													
-	if ( Serialize(loSerialize) == -1 ) 												
-	{ 																					
-		return -1; 																		
-	} 																					
-	return 1; 																																								
-}																							
-
-
-
-int STRU_UC_CL_CRS_GIFT_PROP_USE_RQ::Serialize(CStandardSerialize &aoStandardSerialize)	 
+int STRU_UC_CL_CRS_GIFT_PROP_USE_RQ::Pack( char* apBuffer , int alLen )
 {
-	aoStandardSerialize.Serialize(mi64UserID);
-	aoStandardSerialize.Serialize(mi64DestID);
-	aoStandardSerialize.Serialize(miContentID);
-	aoStandardSerialize.Serialize(mszContentName,DEF_CONTENT_NAME_LEN+1);
-	aoStandardSerialize.Serialize(miUseCount);
+	return CFieldSerialize<STRU_UC_CL_CRS_GIFT_PROP_USE_RQ>::Pack(*this, apBuffer, alLen);
+}
 
+int STRU_UC_CL_CRS_GIFT_PROP_USE_RQ::UnPack( char* apBuffer , int alLen )
+{
+	if (CFieldSerialize<STRU_UC_CL_CRS_GIFT_PROP_USE_RQ>::UnPack(*this, apBuffer, alLen) == -1)
+	{
+		return -1;
+	}
 	return 1;
 }
 
-//ʹӦ
-
-int STRU_UC_CL_CRS_GIFT_PROP_USE_RS::Pack( char* apBuffer , int alLen ) 											
-{ 																							
-
-	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::STORE );		
-	uint16_t lwPackType=UC_CL_CRS_GIFT_PROP_USE_RS; 											
-	loSerialize.Serialize( lwPackType ); 												
-	if( Serialize(loSerialize) == -1 ) 													
-	{ 																					
-		return -1; 																	
-	} 																					
-	return loSerialize.getDataLen(); 																																		
-} 																							
 
-int STRU_UC_CL_CRS_GIFT_PROP_USE_RS::UnPack( char* apBuffer , int alLen ) 											
-{ 																																											
-	CStandardSerialize loSerialize( apBuffer, alLen, CStandardSerialize::LOAD );		
-	uint16_t lwPackType ; 																	
-	loSerialize.Serialize(lwPackType); 													
-	if ( Serialize(loSerialize) == -1 ) 												
-	{ 																					
-		return -1; 																		
-	} 																					
-	return 1; 																																								
-}																							
 
+int STRU_UC_CL_CRS_GIFT_PROP_USE_RQ::Serialize(CStandardSerialize & aoStandardSerialize)
+{
+	return CFieldSerialize<STRU_UC_CL_CRS_GIFT_PROP_USE_RQ>::Serialize(*this, aoStandardSerialize);
+}
 
+//ʹӦ
 
-int STRU_UC_CL_CRS_GIFT_PROP_USE_RS::Serialize(CStandardSerialize &aoStandardSerialize)	 
+int STRU_UC_CL_CRS_GIFT_PROP_USE_RS::Pack( char* apBuffer , int alLen )
 {
-	aoStandardSerialize.Serialize(mbyResult);
-	aoStandardSerialize.Serialize(mi64UserID);
-	aoStandardSerialize.Serialize(mi64DestID);
-	aoStandardSerialize.Serialize(miContentID);		
-	aoStandardSerialize.Serialize(mszContentName,DEF_CONTENT_NAME_LEN+1);
-	aoStandardSerialize.Serialize(miUseCount);
-	aoStandardSerialize.Serialize(miResidualValue);
+	return CFieldSerialize<STRU_UC_CL_CRS_GIFT_PROP_USE_RS>::Pack(*this, apBuffer, alLen);
+}
 
+int STRU_UC_CL_CRS_GIFT_PROP_USE_RS::UnPack( char* apBuffer , int alLen )
+{
+	if (CFieldSerialize<STRU_UC_CL_CRS_GIFT_PROP_USE_RS>::UnPack(*this, apBuffer, alLen) == -1)
+	{
+		return -1;
+	}
 	return 1;
 }
 
-//ʹ֪ͨ
 
 
+int STRU_UC_CL_CRS_GIFT_PROP_USE_RS::Serialize(CStandardSerialize & aoStandardSerialize)
+{
+	return CFieldSerialize<STRU_UC_CL_CRS_GIFT_PROP_USE_RS>::Serialize(*this, aoStandardSerialize);
+}
 
-int STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY::Pack( char* apBuffer , int alLen ) 											
-{ 																							
+//ʹ֪ͨ
 
-	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::STORE );		
-	uint16_t lwPackType=UC_CL_CRS_GIFT_PROP_USE_NOTIFY; 											
-	loSerialize.Serialize( lwPackType ); 												
-	if( Serialize(loSerialize) == -1 ) 													
-	{ 																					
-		return -1; 																	
-	} 																					
-	return loSerialize.getDataLen(); 																																	
-} 																							
 
-int STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY::UnPack( char* apBuffer , int alLen ) 											
-{ 																							
 
-	CStandardSerialize loSerialize( apBuffer, alLen, CStandardSerialize::LOAD );		
-	uint16_t lwPackType ; 																	
-	loSerialize.Serialize(lwPackType); 													
-	if ( Serialize(loSerialize) == -1 ) 												
-	{ 																					
-		return -1; 																		
-	} 																					
-	return 1; 																			
+int STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY::Pack( char* apBuffer , int alLen )
+{
+	return CFieldSerialize<STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY>::Pack(*this, apBuffer, alLen);
+}
 
-}																							
+int STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY::UnPack( char* apBuffer , int alLen )
+{
+	if (CFieldSerialize<STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY>::UnPack(*this, apBuffer, alLen) == -1)
+	{
+		return -1;
+	}
+	return 1;
+}
 
 
 
 int STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY::Serialize(CStandardSerialize & aoStandardSerialize)
 {
-	aoStandardSerialize.Serialize(mi64UserID);
-	aoStandardSerialize.Serialize(mi64DestID);
-	aoStandardSerialize.Serialize(miContentID);		
-	aoStandardSerialize.Serialize(mszContentName,DEF_CONTENT_NAME_LEN+1);
-	aoStandardSerialize.Serialize(miUseCount);
-
-	aoStandardSerialize.Serialize(miRecvCount);
-	aoStandardSerialize.Serialize(miPackMark);		
-	aoStandardSerialize.Serialize(miPackBeginNum);
-	aoStandardSerialize.Serialize(miPackUseNum);
-
-	aoStandardSerialize.Serialize(mszUserName, NICK_NAME_LEN + 1);
-	aoStandardSerialize.Serialize(mszDestName, NICK_NAME_LEN + 1);
-	return 1;
+	return CFieldSerialize<STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY>::Serialize(*this, aoStandardSerialize);
 }
 
 //ʹô֪ͨ
 
-int STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY::Pack( char* apBuffer , int alLen ) 											
-{ 																							
-
-	CStandardSerialize loSerialize(apBuffer, alLen, CStandardSerialize::STORE );		
-	uint16_t lwPackType=UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY; 											
-	loSerialize.Serialize( lwPackType ); 												
-	if( Serialize(loSerialize) == -1 ) 													
-	{ 																					
-		return -1; 																	
-	} 																					
-	return loSerialize.getDataLen(); 													
-
-} 																							
-
-int STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY::UnPack( char* apBuffer , int alLen ) 											
-{ 																							
-
-	CStandardSerialize loSerialize( apBuffer, alLen, CStandardSerialize::LOAD );		
-	uint16_t lwPackType ; 																	
-	loSerialize.Serialize(lwPackType); 													
-	if ( Serialize(loSerialize) == -1 ) 												
-	{ 																					
-		return -1; 																		
-	} 																					
-	return 1; 																			
+int STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY::Pack( char* apBuffer , int alLen )
+{
+	return CFieldSerialize<STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY>::Pack(*this, apBuffer, alLen);
+}
 
-}																							
+int STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY::UnPack( char* apBuffer , int alLen )
+{
+	if (CFieldSerialize<STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY>::UnPack(*this, apBuffer, alLen) == -1)
+	{
+		return -1;
+	}
+	return 1;
+}
 
 
 
 int STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY::Serialize(CStandardSerialize & aoStandardSerialize)
 {
-	aoStandardSerialize.Serialize(mi64UserID);
-	aoStandardSerialize.Serialize(mszUserName,DEF_CONTENT_NAME_LEN+1);
-	aoStandardSerialize.Serialize(mi64DestID);
-	aoStandardSerialize.Serialize(mszDestName,DEF_CONTENT_NAME_LEN+1);
-	aoStandardSerialize.Serialize(miContentID);		
-	aoStandardSerialize.Serialize(mszContentName,DEF_CONTENT_NAME_LEN+1);
-	aoStandardSerialize.Serialize(miUseCount);
-	aoStandardSerialize.Serialize(mlChatroomID);
-	aoStandardSerialize.Serialize(mstruRoomName,DEF_CONTENT_NAME_LEN+1);
-	aoStandardSerialize.Serialize(mstruTimeStamp);
-
-	aoStandardSerialize.Serialize(miHallIP);      //IP
-	aoStandardSerialize.Serialize(miHallPort);      //PORT
-	aoStandardSerialize.Serialize(miHallProperty);     //
-	aoStandardSerialize.Serialize(miHallPropertyEx);    //չ
-
-	aoStandardSerialize.Serialize(mbyShowStar);     //Ǽ1~60Ϊ
-	aoStandardSerialize.Serialize(mbyNobleman);     //弶1~30Ϊǹ
-	aoStandardSerialize.Serialize(mbyManager);      //Ա
-	aoStandardSerialize.Serialize(mbyWeekStar);     //ǣ1~3
-	aoStandardSerialize.Serialize(mbySell);      //ٷۣ0ۣ1
-	aoStandardSerialize.Serialize(mbyDstShowStar);     //ĿûǼ1~60Ϊ
-	aoStandardSerialize.Serialize(mbyDstNobleman);     //Ŀû弶1~30Ϊǹ
-	aoStandardSerialize.Serialize(mbyDstManager);     //ĿûԱ
-	aoStandardSerialize.Serialize(mbyDstWeekStar);     //Ŀûǣ1~3
-	aoStandardSerialize.Serialize(mbyDstSell);      //Ŀûٷۣ0ۣ1
-
-	aoStandardSerialize.Serialize(miReserved1);     //Ԥ1
-	aoStandardSerialize.Serialize(miReserved2);     //Ԥ2
-
-	return 1;
+	return CFieldSerialize<STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY>::Serialize(*this, aoStandardSerialize);
 }
 
 //u֪ͨ
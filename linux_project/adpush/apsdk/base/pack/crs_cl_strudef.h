@@ -4,6 +4,7 @@
 #include "../include.h"
 #include "../constdef.h"
 #include "MediaInfo.h"
+#include "FieldSerialize.h"
 
 #define VERSION_LEN					10		//汾Ϣ		
 #define MAX_USER_ID_NUM				20		///ûϸϢID б
@@ -1385,6 +1386,21 @@ struct	STRU_CHATROOM_USER_INFO_2007
 };
 typedef	STRU_CHATROOM_USER_INFO_2007* PSTRU_CHATROOM_USER_INFO_2007 ;
 
+template<> struct CFieldTraits<STRU_CHATROOM_USER_INFO_2007>
+{
+	typedef STRU_CHATROOM_USER_INFO_2007 Owner;
+	typedef CFields<
+		FIELD_POD(int64_t, mi64UserId),
+		FIELD_STR(macNickName),
+		FIELD_POD(uint16_t, mwPhotoNum),
+		FIELD_POD(uint8_t, mbyPower),
+		FIELD_POD(int, mlUserState),
+		FIELD_POD(uint8_t, mbyVoiceState),
+		FIELD_POD(uint8_t, mbyUserLanguage),
+		FIELD_POD(int, miRedMemTime)
+	> Fields;
+};
+
 /*********************************************************************************************/
 //ûϢ
 //޸ˣ	HJH
@@ -1411,6 +1427,16 @@ struct	STRU_UC_CL_CRS_USER_INFO_ID_2007
 };
 typedef	STRU_UC_CL_CRS_USER_INFO_ID_2007* PSTRU_UC_CL_CRS_USER_INFO_ID_2007;
 
+template<> struct CFieldTraits<STRU_UC_CL_CRS_USER_INFO_ID_2007>
+{
+	typedef STRU_UC_CL_CRS_USER_INFO_ID_2007 Owner;
+	enum { PACK_TYPE = UC_CL_CRS_USER_INFO_ID_2007 };
+	typedef CFields<
+		FIELD_POD(int, mlChatroomID),
+		FIELD_LIST(uint16_t, mwUserCount, STRU_CHATROOM_USER_INFO_2007, mpUserIDList)
+	> Fields;
+};
+
 /*********************************************************************************************/
 //ûϢṹ
 //޸ˣ	Fanyunfeng
@@ -1830,6 +1856,29 @@ struct STRU_UC_CL_CRS_LOGIN_HALL_RS_2007
 	int Serialize(CStandardSerialize& aoStandardSerialize);
 };
 
+template<> struct CFieldTraits<STRU_UC_CL_CRS_LOGIN_HALL_RS_2007>
+{
+	typedef STRU_UC_CL_CRS_LOGIN_HALL_RS_2007 Owner;
+	enum { PACK_TYPE = UC_CL_CRS_LOGIN_HALL_RS_2007 };
+	typedef CFields<
+		FIELD_POD(unsigned int, mulToken),
+		FIELD_POD(uint8_t, mbyResult),
+		FIELD_POD(int, mlHallID),
+		FIELD_POD(int, mlRoomMaxPlayer),
+		FIELD_STR(macErrInfo),
+		FIELD_STR(mszVoiceIp),
+		FIELD_POD(unsigned short, musVoicePort),
+		FIELD_STR(macTopic),
+		FIELD_STR(macSalutatory),
+		FIELD_STR(macPwd),
+		FIELD_STR(macImvName),
+		FIELD_POD(int, mlHallProperty),
+		FIELD_POD(int, mlHallState),
+		FIELD_POD(uint8_t, mbyMicNum),
+		FIELD_STR(macWUserURL)
+	> Fields;
+};
+
 struct STRU_UC_CL_CRS_LOGIN_HALL_RS_2009
 {
 	unsigned int	mulToken;							//ûTokenֵ
@@ -1860,6 +1909,29 @@ struct STRU_UC_CL_CRS_LOGIN_HALL_RS_2009
 	int UnPack(char* apBuffer,int alLen);
 	int Serialize(CStandardSerialize& aoStandardSerialize);
 };
+
+template<> struct CFieldTraits<STRU_UC_CL_CRS_LOGIN_HALL_RS_2009>
+{
+	typedef STRU_UC_CL_CRS_LOGIN_HALL_RS_2009 Owner;
+	enum { PACK_TYPE = UC_CL_CRS_LOGIN_HALL_RS_2009 };
+	typedef CFields<
+		FIELD_POD(unsigned int, mulToken),
+		FIELD_POD(uint8_t, mbyResult),
+		FIELD_POD(int, mlHallID),
+		FIELD_POD(int, mlRoomMaxPlayer),
+		FIELD_STR(macErrInfo),
+		FIELD_STR(mszVoiceIp),
+		FIELD_POD(unsigned short, musVoicePort),
+		FIELD_STR(macTopic),
+		FIELD_STR(macSalutatory),
+		FIELD_STR(macPwd),
+		FIELD_STR(macImvName),
+		FIELD_POD(int, mlHallState),
+		FIELD_POD(uint8_t, mbyMicNum),
+		FIELD_STR(macWUserURL),
+		FIELD_POD(uint64_t, mi64HallProperty)
+	> Fields;
+};
 /*********************************************************************************************/
 //Ա
 //;Ա
@@ -2403,6 +2475,33 @@ struct STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009
 	int    UnPack(char * apBuffer,int    alLen);
 };
 
+template<> struct CFieldTraits<STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009>
+{
+	typedef STRU_UC_CL_CRS_ENTRY_OTHERUSER_ID_2009 Owner;
+	enum { PACK_TYPE = UC_CL_CRS_ENTRY_OTHERUSER_ID_2009 };
+	typedef CFields<
+		FIELD_POD(int, mlChatroomID),
+		FIELD_POD(int64_t, mi64UserID),
+		FIELD_STR(macNickName),
+		FIELD_POD(uint16_t, mwPhotoNum),
+		FIELD_POD(uint8_t, mbyPower),
+		FIELD_POD(int, mlUserState),
+		FIELD_POD(uint8_t, mbyUserLanguage),
+		FIELD_POD(int, miRedMemTime),
+		FIELD_STR(mstrUniName),
+		FIELD_STR(mstrUserMood),
+		FIELD_STR(mstrUserImageURL),
+		FIELD_POD(uint8_t, mbyUserSex),
+		FIELD_POD(int, miUserOnLineTime),
+		FIELD_POD(int, miUserCharm),
+		FIELD_POD(int, miUserWealth),
+		FIELD_POD(int, miUserActivity),
+		FIELD_POD(int, mlVipRooomID),
+		FIELD_POD(uint8_t, mbyShowBar),
+		FIELD_STR(mstrUserBirthDay)
+	> Fields;
+};
+
 //ͻûϢӦ(SinaShow1.3)
 typedef struct	STRU_CHATROOM_USER_INFO_2009
 {
@@ -2435,6 +2534,32 @@ typedef struct	STRU_CHATROOM_USER_INFO_2009
 	}
 }*PSTRU_CHATROOM_USER_INFO_2009;
 
+template<> struct CFieldTraits<STRU_CHATROOM_USER_INFO_2009>
+{
+	typedef STRU_CHATROOM_USER_INFO_2009 Owner;
+	typedef CFields<
+		FIELD_POD(int64_t, mi64UserId),
+		FIELD_STR(macNickName),
+		FIELD_POD(uint16_t, mwPhotoNum),
+		FIELD_POD(uint8_t, mbyPower),
+		FIELD_POD(int, mlUserState),
+		FIELD_POD(uint8_t, mbyVoiceState),
+		FIELD_POD(uint8_t, mbyUserLanguage),
+		FIELD_POD(int, miRedMemTime),
+		FIELD_STR(mstrUniName),
+		FIELD_STR(mstrUserMood),
+		FIELD_STR(mstrUserImageURL),
+		FIELD_POD(uint8_t, mbyUserSex),
+		FIELD_POD(int, miUserOnLineTime),
+		FIELD_POD(int, miUserCharm),
+		FIELD_POD(int, miUserWealth),
+		FIELD_POD(int, miUserActivity),
+		FIELD_POD(int, mlVipRooomID),
+		FIELD_POD(uint8_t, mbyShowBar),
+		FIELD_STR(mstrUserBirthDay)
+	> Fields;
+};
+
 typedef struct	STRU_UC_CL_CRS_USER_INFO_ID_2009
 {
 	int		mlChatroomID;      					//id
@@ -2452,6 +2577,16 @@ typedef struct	STRU_UC_CL_CRS_USER_INFO_ID_2009
 	int    UnPack(char * apBuffer,int    alLen);
 }PSTRU_UC_CL_CRS_USER_INFO_ID_2009;
 
+template<> struct CFieldTraits<STRU_UC_CL_CRS_USER_INFO_ID_2009>
+{
+	typedef STRU_UC_CL_CRS_USER_INFO_ID_2009 Owner;
+	enum { PACK_TYPE = UC_CL_CRS_USER_INFO_ID_2009 };
+	typedef CFields<
+		FIELD_POD(int, mlChatroomID),
+		FIELD_LIST(uint16_t, mwUserCount, STRU_CHATROOM_USER_INFO_2009, mpUserIDList)
+	> Fields;
+};
+
 //Ƶ
 typedef struct STRU_UC_CL_CRS_GIFT_PROP_USE_RQ
 {
@@ -2470,6 +2605,19 @@ typedef struct STRU_UC_CL_CRS_GIFT_PROP_USE_RQ
 	int    UnPack(char * apBuffer,int    alLen);
 }STRU_UC_CL_CRS_GIFT_PROP_USE_RQ,*PSTRU_UC_CL_CRS_GIFT_PROP_USE_RQ;
 
+template<> struct CFieldTraits<STRU_UC_CL_CRS_GIFT_PROP_USE_RQ>
+{
+	typedef STRU_UC_CL_CRS_GIFT_PROP_USE_RQ Owner;
+	enum { PACK_TYPE = UC_CL_CRS_GIFT_PROP_USE_RQ };
+	typedef CFields<
+		FIELD_POD(int64_t, mi64UserID),
+		FIELD_POD(int64_t, mi64DestID),
+		FIELD_POD(int, miContentID),
+		FIELD_STR(mszContentName),
+		FIELD_POD(int, miUseCount)
+	> Fields;
+};
+
 //ƵӦ
 typedef struct STRU_UC_CL_CRS_GIFT_PROP_USE_RS
 {
@@ -2490,6 +2638,21 @@ typedef struct STRU_UC_CL_CRS_GIFT_PROP_USE_RS
 	int    UnPack(char * apBuffer,int    alLen);
 }STRU_UC_CL_CRS_GIFT_PROP_USE_RS,*PSTRU_UC_CL_CRS_GIFT_PROP_USE_RS;
 
+template<> struct CFieldTraits<STRU_UC_CL_CRS_GIFT_PROP_USE_RS>
+{
+	typedef STRU_UC_CL_CRS_GIFT_PROP_USE_RS Owner;
+	enum { PACK_TYPE = UC_CL_CRS_GIFT_PROP_USE_RS };
+	typedef CFields<
+		FIELD_POD(uint8_t, mbyResult),
+		FIELD_POD(int64_t, mi64UserID),
+		FIELD_POD(int64_t, mi64DestID),
+		FIELD_POD(int, miContentID),
+		FIELD_STR(mszContentName),
+		FIELD_POD(int, miUseCount),
+		FIELD_POD(int, miResidualValue)
+	> Fields;
+};
+
 //Ƶ߹㲥
 typedef struct STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY
 {
@@ -2516,6 +2679,25 @@ typedef struct STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY
 	int    UnPack(char * apBuffer,int    alLen);
 }STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY,*PSTRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY;
 
+template<> struct CFieldTraits<STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY>
+{
+	typedef STRU_UC_CL_CRS_GIFT_PROP_USE_NOTIFY Owner;
+	enum { PACK_TYPE = UC_CL_CRS_GIFT_PROP_USE_NOTIFY };
+	typedef CFields<
+		FIELD_POD(int64_t, mi64UserID),
+		FIELD_POD(int64_t, mi64DestID),
+		FIELD_POD(int, miContentID),
+		FIELD_STR(mszContentName),
+		FIELD_POD(int, miUseCount),
+		FIELD_POD(int, miRecvCount),
+		FIELD_POD(int, miPackMark),
+		FIELD_POD(int, miPackBeginNum),
+		FIELD_POD(int, miPackUseNum),
+		FIELD_STR(mszUserName),
+		FIELD_STR(mszDestName)
+	> Fields;
+};
+
 //㲥
 typedef struct STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY
 {
@@ -2558,6 +2740,40 @@ typedef struct STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY
 	int    UnPack(char * apBuffer,int    alLen);
 }STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY,*PSTRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY;
 
+template<> struct CFieldTraits<STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY>
+{
+	typedef STRU_UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY Owner;
+	enum { PACK_TYPE = UC_CL_CRS_BIG_GIFT_PROP_USE_NOTIFY };
+	typedef CFields<
+		FIELD_POD(int64_t, mi64UserID),
+		FIELD_STR(mszUserName),
+		FIELD_POD(int64_t, mi64DestID),
+		FIELD_STR(mszDestName),
+		FIELD_POD(int, miContentID),
+		FIELD_STR(mszContentName),
+		FIELD_POD(int, miUseCount),
+		FIELD_POD(int, mlChatroomID),
+		FIELD_STR(mstruRoomName),
+		FIELD_POD(int, mstruTimeStamp),
+		FIELD_POD(int, miHallIP),
+		FIELD_POD(short, miHallPort),
+		FIELD_POD(int, miHallProperty),
+		FIELD_POD(int, miHallPropertyEx),
+		FIELD_POD(uint8_t, mbyShowStar),
+		FIELD_POD(uint8_t, mbyNobleman),
+		FIELD_POD(uint8_t, mbyManager),
+		FIELD_POD(uint8_t, mbyWeekStar),
+		FIELD_POD(uint8_t, mbySell),
+		FIELD_POD(uint8_t, mbyDstShowStar),
+		FIELD_POD(uint8_t, mbyDstNobleman),
+		FIELD_POD(uint8_t, mbyDstManager),
+		FIELD_POD(uint8_t, mbyDstWeekStar),
+		FIELD_POD(uint8_t, mbyDstSell),
+		FIELD_POD(int, miReserved1),
+		FIELD_POD(int, miReserved2)
+	> Fields;
+};
+
 //U֪ͨ
 typedef struct STRU_UC_CRS_CL_BALANCE_NOTIFY
 {
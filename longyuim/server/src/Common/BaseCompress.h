@@ -1,15 +1,18 @@
 #ifndef _BASE_COMPRESS_H_
 #define _BASE_COMPRESS_H_
 
-CBaseCompress
+#include "include.h"
+
+class CBaseCompress
 {
 public:
 	CBaseCompress(){}
 	virtual ~CBaseCompress(){}
 
-	virtual Compress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length) = 0;
-	virtual Decompress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length) = 0;
+	//out_length Сʵʳ
+	virtual bool Compress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length) = 0;
+	virtual bool Decompress(const char* in_buffer, uint32 in_length, char* out_buffer, uint32 &out_length) = 0;
 
 };
 
-#endif //_BASE_COMPRESS_H_
\ No newline at end of file
+#endif //_BASE_COMPRESS_H_
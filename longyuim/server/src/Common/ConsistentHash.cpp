@@ -0,0 +1,156 @@
+#include "ConsistentHash.h"
+#include <algorithm>
+
+int ParseNodeAddrList(const char *apValue, std::vector<STRU_NODE_ADDR> &aoList)
+{
+	aoList.clear();
+	if(NULL == apValue)
+	{
+		return 0;
+	}
+	std::string lstrValue = apValue;
+	std::string::size_type liBegin = 0;
+	while(liBegin < lstrValue.size())
+	{
+		std::string::size_type liEnd = lstrValue.find(',', liBegin);
+		if(std::string::npos == liEnd)
+		{
+			liEnd = lstrValue.size();
+		}
+		std::string lstrItem = lstrValue.substr(liBegin, liEnd - liBegin);
+		liBegin = liEnd + 1;
+		//ȥβհ
+		std::string::size_type liFirst = lstrItem.find_first_not_of(" \t");
+		if(std::string::npos == liFirst)
+		{
+			continue;
+		}
+		lstrItem = lstrItem.substr(liFirst, lstrItem.find_last_not_of(" \t") - liFirst + 1);
+
+		std::string::size_type liColon = lstrItem.find(':');
+		if(std::string::npos == liColon)
+		{
+			return -1;
+		}
+		STRU_NODE_ADDR loAddr;
+		std::string lstrIp = lstrItem.substr(0, liColon);
+		in_addr_t liIp = inet_addr(lstrIp.c_str());
+		long liPort = strtol(lstrItem.c_str() + liColon + 1, NULL, 0);
+		if(INADDR_NONE == liIp || liPort <= 0 || liPort > 65535)
+		{
+			return -1;
+		}
+		loAddr.miIp = ntohl(liIp);
+		loAddr.miPort = (uint16)liPort;
+		//ְ淶ʽɣдͬʱҲһ
+		struct in_addr addr;
+		addr.s_addr = liIp;
+		char lszName[64];
+		snprintf(lszName, sizeof(lszName), "%s:%u", inet_ntoa(addr), (unsigned int)loAddr.miPort);
+		loAddr.mstrName = lszName;
+		aoList.push_back(loAddr);
+	}
+	return aoList.size();
+}
+
+CConsistentHash::CConsistentHash()
+{
+}
+
+CConsistentHash::~CConsistentHash()
+{
+}
+
+int CConsistentHash::AddNode(const char *apName, unsigned int aiVirtualCount /* = DEF_HASH_VIRTUAL_COUNT */)
+{
+	ASSERT(apName != NULL);
+	int liNode = moNodeName.size();
+	moNodeName.push_back(apName);
+	char lszPoint[256];
+	for(unsigned int i = 0; i < aiVirtualCount; ++i)
+	{
+		int liLen = snprintf(lszPoint, sizeof(lszPoint), "%s#%u", apName, i);
+		STRU_HASH_POINT loPoint;
+		loPoint.miHash = HashString(lszPoint, liLen);
+		loPoint.miNode = liNode;
+		moPoint.push_back(loPoint);
+	}
+	return liNode;
+}
+
+void CConsistentHash::Build()
+{
+	std::sort(moPoint.begin(), moPoint.end());
+}
+
+unsigned int CConsistentHash::FindPoint(uint32 aiHash) const
+{
+	unsigned int liLow = 0;
+	unsigned int liHigh = moPoint.size();
+	while(liLow < liHigh)
+	{
+		unsigned int liMid = (liLow + liHigh) / 2;
+		if(moPoint[liMid].miHash < aiHash)
+		{
+			liLow = liMid + 1;
+		}
+		else
+		{
+			liHigh = liMid;
+		}
+	}
+	return liLow == moPoint.size() ? 0 : liLow;
+}
+
+int CConsistentHash::GetNode(uint32 aiKey) const
+{
+	if(moPoint.empty())
+	{
+		return -1;
+	}
+	return moPoint[FindPoint(HashKey(aiKey))].miNode;
+}
+
+int CConsistentHash::GetNode(uint32 aiKey, const bool *apAlive) const
+{
+	if(moPoint.empty())
+	{
+		return -1;
+	}
+	unsigned int liIndex = FindPoint(HashKey(aiKey));
+	for(unsigned int i = 0; i < moPoint.size(); ++i)
+	{
+		int liNode = moPoint[liIndex].miNode;
+		if(apAlive[liNode])
+		{
+			return liNode;
+		}
+		if(++liIndex == moPoint.size())
+		{
+			liIndex = 0;
+		}
+	}
+	return -1;
+}
+
+uint32 CConsistentHash::HashKey(uint32 aiKey)
+{
+	aiKey ^= aiKey >> 16;
+	aiKey *= 0x85ebca6b;
+	aiKey ^= aiKey >> 13;
+	aiKey *= 0xc2b2ae35;
+	aiKey ^= aiKey >> 16;
+	return aiKey;
+}
+
+uint32 CConsistentHash::HashString(const char *apData, unsigned int aiLen)
+{
+	//FNV-1aٻһõλҲɢ
+	uint32 liHash = 2166136261u;
+	for(unsigned int i = 0; i < aiLen; ++i)
+	{
+		liHash ^= (uint8)apData[i];
+		liHash *= 16777619u;
+	}
+	return HashKey(liHash);
+}
@@ -0,0 +1,85 @@
+/********************************************************************
+	file base:	ConsistentHash
+	file ext:	h
+
+	purpose:	һԹϣ
+				ÿڵ㰴(һ"ip:port")ڻϷ㣬˳ʱһĽڵ㡣
+				ڵֻӰļֻҪڵбͬĹͬ
+				˳޹ء
+				úֻԶ߳ͬʱѯ
+*********************************************************************/
+#ifndef _CONSISTENT_HASH_H_
+#define _CONSISTENT_HASH_H_
+
+#include "include.h"
+#include <vector>
+#include <string>
+
+//ÿڵ
+#define DEF_HASH_VIRTUAL_COUNT 160
+//ȺĽڵ
+#define DEF_MAX_CLUSTER_NODE 64
+
+//Ⱥڵַ
+struct STRU_NODE_ADDR
+{
+	STRU_NODE_ADDR()
+	{
+		miIp = 0;
+		miPort = 0;
+	}
+	//ֽ
+	uint32 miIp;
+	uint16 miPort;
+	//"ip:port"ΪϵĽڵ
+	std::string mstrName;
+};
+
+//"ip:port,ip:port"ؽڵʽ󷵻-1
+int ParseNodeAddrList(const char *apValue, std::vector<STRU_NODE_ADDR> &aoList);
+
+class CConsistentHash
+{
+public:
+	CConsistentHash();
+	~CConsistentHash();
+
+	//ּڵ㣬ؽڵ(˳)
+	int AddNode(const char *apName, unsigned int aiVirtualCount = DEF_HASH_VIRTUAL_COUNT);
+	//ڵ
+	void Build();
+
+	//ĽڵţΪշ-1
+	int GetNode(uint32 aiKey) const;
+	//apAlive[i]ΪfalseĽڵ㣬˳ʱҵһýڵ㣬ȫ÷-1
+	int GetNode(uint32 aiKey, const bool *apAlive) const;
+
+	inline unsigned int GetNodeCount() const{ return moNodeName.size(); }
+	inline const std::string& GetNodeName(int aiNode) const{ return moNodeName[aiNode]; }
+
+	static uint32 HashKey(uint32 aiKey);
+	static uint32 HashString(const char *apData, unsigned int aiLen);
+
+private:
+	struct STRU_HASH_POINT
+	{
+		uint32 miHash;
+		int miNode;
+		bool operator < (const STRU_HASH_POINT &aoOther) const
+		{
+			if(miHash != aoOther.miHash)
+			{
+				return miHash < aoOther.miHash;
+			}
+			return miNode < aoOther.miNode;
+		}
+	};
+	//һϣֵСaiHashĵ㣬ûʱص
+	unsigned int FindPoint(uint32 aiHash) const;
+
+private:
+	std::vector<STRU_HASH_POINT> moPoint;
+	std::vector<std::string> moNodeName;
+};
+
+#endif //_CONSISTENT_HASH_H_
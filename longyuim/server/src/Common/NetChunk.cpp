@@ -0,0 +1,77 @@
+
+#include "NetChunk.h"
+
+CPool<CNetChunk> CNetChunk::moChunkPool(DEF_NET_CHUNK_POOL_SIZE);
+
+CNetChunk::CNetChunk()
+{
+	miLength = 0;
+	miType = 0;
+	miRef = 0;
+	mpBuffer = mszBuffer;
+	miCapacity = DEF_NET_CHUNK_SIZE;
+}
+
+CNetChunk::~CNetChunk()
+{
+	if(mpBuffer != mszBuffer)
+	{
+		delete [] mpBuffer;
+		mpBuffer = NULL;
+	}
+}
+
+CNetChunk* CNetChunk::Alloc(int aiSize)
+{
+	CNetChunk *lpChunk = NULL;
+	if(aiSize <= DEF_NET_CHUNK_SIZE)
+	{
+		lpChunk = moChunkPool.Malloc();
+	}
+	else
+	{
+		lpChunk = new(std::nothrow) CNetChunk;
+		if(lpChunk != NULL)
+		{
+			lpChunk->mpBuffer = new(std::nothrow) char[aiSize];
+			lpChunk->miCapacity = aiSize;
+			if(NULL == lpChunk->mpBuffer)
+			{
+				lpChunk->mpBuffer = lpChunk->mszBuffer;
+				delete lpChunk;
+				lpChunk = NULL;
+			}
+		}
+	}
+	if(NULL == lpChunk)
+	{
+		TRACE(1, "CNetChunk::Alloc ݿʧܡsize = "<<aiSize);
+		return NULL;
+	}
+	lpChunk->miLength = 0;
+	lpChunk->miType = 0;
+	lpChunk->miRef = 1;
+	return lpChunk;
+}
+
+void CNetChunk::Release()
+{
+	if(__sync_sub_and_fetch(&miRef, 1) != 0)
+	{
+		return;
+	}
+	if(mpBuffer == mszBuffer)
+	{
+		miLength = 0;
+		moChunkPool.Free(this);
+	}
+	else
+	{
+		delete this;
+	}
+}
+
+void CNetChunk::Dump()
+{
+	moChunkPool.Dump();
+}
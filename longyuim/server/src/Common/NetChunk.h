@@ -0,0 +1,51 @@
+
+#ifndef _NET_CHUNK_H_
+#define _NET_CHUNK_H_
+
+#include "include.h"
+#include "Pool.h"
+#include "NetPack.h"
+
+//ݿʱ
+#define DEF_NET_CHUNK_SIZE DEF_BUFFER_LEN
+#define DEF_NET_CHUNK_POOL_SIZE 1024
+
+//ݿ
+//һðͷݰü㲥ʱĿӹͬһݿ
+class CNetChunk
+{
+public:
+	CNetChunk();
+	~CNetChunk();
+
+	//aiSizeֽڵݿ飬üΪ1
+	static CNetChunk* Alloc(int aiSize);
+
+	inline void AddRef()
+	{
+		__sync_add_and_fetch(&miRef, 1);
+	}
+	//üΪ0ʱ黹
+	void Release();
+
+	inline char* GetBuffer(){ return mpBuffer; }
+	inline int GetCapacity(){ return miCapacity; }
+
+	static void Dump();
+
+public:
+	//Чݳ
+	int miLength;
+	//Ϣͣбͺϲʱʹã0ʾϲ
+	int miType;
+
+private:
+	volatile int miRef;
+	char *mpBuffer;
+	int miCapacity;
+	char mszBuffer[DEF_NET_CHUNK_SIZE];
+
+	static CPool<CNetChunk> moChunkPool;
+};
+
+#endif //_NET_CHUNK_H_
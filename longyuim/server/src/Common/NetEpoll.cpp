@@ -8,6 +8,11 @@ CNetEpoll::CNetEpoll()
 	mbHasListenFd = false;
 	mbKeepAlive = true;
 	miMaxFdNumber = 102400;
+	miSlowSendLength = DEF_SLOW_SEND_LENGTH;
+	miSendScanAll = 0;
+	miRecvScanAll = 0;
+	miMaxUsedfd = -1;
+	miConnectedSize = 0;
 }
 
 CNetEpoll::~CNetEpoll()
@@ -24,50 +29,116 @@ bool CNetEpoll::Init(unsigned int aiMaxSocketSize /* = DEF_EPOLL_SIZE */)
 		return false;
 	}
 
-	mSendEvent.Create();
-	mRecvEvent.Create();
+	if(!moSendReady.Init(DEF_READY_QUEUE_SIZE) || !moRecvReady.Init(DEF_READY_QUEUE_SIZE))
+	{
+		TRACE(1, "CNetEpoll::Init зʧܡ");
+		return false;
+	}
+	if(!moSendNotify.Create() || !moRecvNotify.Create())
+	{
+		TRACE(1, "CNetEpoll::Init ֪ͨʧܡ");
+		return false;
+	}
 
+	//fdһС䣬Ȱ䣬ʱ
+	CAutoLock lock(moFdSection);
+	if(moSocketSlot.size() < aiMaxSocketSize)
+	{
+		moSocketSlot.resize(aiMaxSocketSize, NULL);
+	}
 	return true;
 }
 
 bool CNetEpoll::Destroy()
 {
 	CAutoLock lock(moFdSection);
-	while(moNetSocketList.size() != 0)
+	for(int fd = miMaxUsedfd; fd >= 0; --fd)
 	{
-		NET_SOCKET_LIST_ITER iter = moNetSocketList.begin();
-		int fd = iter->first;
-		Delfd(fd);
+		if(moSocketSlot[fd] != NULL)
+		{
+			Delfd(fd);
+		}
 	}
 	if(miEpfd != -1)
 	{
 		close(miEpfd);
 	}
 
-	mSendEvent.Close();
-	mRecvEvent.Close();
+	moSendNotify.Close();
+	moRecvNotify.Close();
 	return true;
 }
 
 bool CNetEpoll::WaitSendEvent()
 {
-	int nRet = mSendEvent.WaitForEvent(-1);
+	moSendNotify.BeginWait();
+	if(!moSendReady.IsEmpty() || miSendScanAll)
+	{
+		moSendNotify.EndWait();
+		return true;
+	}
+	return moSendNotify.Wait(DEF_READY_WAIT_TIMEOUT);
 }
 
 bool CNetEpoll::WaitRecvEvent()
 {
-	int nRet = mRecvEvent.WaitForEvent(-1);
+	moRecvNotify.BeginWait();
+	if(!moRecvReady.IsEmpty() || miRecvScanAll)
+	{
+		moRecvNotify.EndWait();
+		return true;
+	}
+	return moRecvNotify.Wait(DEF_READY_WAIT_TIMEOUT);
 }
 
-bool CNetEpoll::Addfd(CNetSocket* apNetSocket)
+void CNetEpoll::PostSend(CNetSocket *apNetSocket)
+{
+	if(0 == __sync_lock_test_and_set(&apNetSocket->miSendQueued, 1))
+	{
+		if(!moSendReady.Push(apNetSocket->miSocket))
+		{
+			miSendScanAll = 1;
+		}
+	}
+	moSendNotify.Notify();
+}
+
+void CNetEpoll::PostRecv(CNetSocket *apNetSocket)
+{
+	if(0 == __sync_lock_test_and_set(&apNetSocket->miRecvQueued, 1))
+	{
+		if(!moRecvReady.Push(apNetSocket->miSocket))
+		{
+			miRecvScanAll = 1;
+		}
+	}
+	moRecvNotify.Notify();
+}
+
+bool CNetEpoll::Addfd(CNetSocket* apNetSocket, bool abExclusive /* = false */)
 {
 	ASSERT(apNetSocket != NULL);
 	CAutoLock lock(moFdSection);
-	if(apNetSocket != NULL)
+	if(!SetNetSocket(apNetSocket->miSocket, apNetSocket))
 	{
-		moNetSocketList[apNetSocket->miSocket] = apNetSocket;
+		TRACE(1, "CNetEpoll::Addfd * fd fd = "<<apNetSocket->miSocket);
+		return false;
 	}
-	if(AddEpollEvent(apNetSocket->miSocket, EPOLLIN | EPOLLET) < 0)
+	//socketϿãϴεͣ
+	apNetSocket->mbRecvPaused = false;
+	uint32 liEvents = EPOLLIN | EPOLLET;
+	if(abExclusive)
+	{
+		liEvents |= EPOLLEXCLUSIVE;
+	}
+	int liRet = AddEpollEvent(apNetSocket->miSocket, liEvents);
+	if(liRet < 0 && abExclusive && EINVAL == errno)
+	{
+		//ں˲֧EPOLLEXCLUSIVE˻ͨע
+		TRACE(1, "CNetEpoll::Addfd ֧EPOLLEXCLUSIVE fd = "<<apNetSocket->miSocket);
+		liRet = AddEpollEvent(apNetSocket->miSocket, EPOLLIN | EPOLLET);
+	}
+	if(liRet < 0)
 	{
 		TRACE(1, "CNetEpoll::Addfd * ʧܡ errno = "<<errno);
 		return false;
@@ -82,7 +153,10 @@ bool CNetEpoll::Addfd(int fd)
 	lpNetSocket->miSocket = fd;
 	lpNetSocket->moNetStat = COMMON_TCP_ESTABLISHED;
 	lpNetSocket->mbListenSocket = false;
-	moNetSocketList[fd] = lpNetSocket;
+	//acceptsocket̳з̳߳sendʱ
+	lpNetSocket->SetNoBlock();
+	lpNetSocket->SetSendQueueLimit(moSendQueueLimit);
+	SetNetSocket(fd, lpNetSocket);
 
 	if(AddEpollEvent(fd, EPOLLIN | EPOLLET) < 0)
 	{
@@ -95,12 +169,7 @@ bool CNetEpoll::Addfd(int fd)
 bool CNetEpoll::Delfd(int fd)
 {
 	CAutoLock lock(moFdSection);
-	CNetSocket *lpNetSocket = NULL;
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.find(fd);
-	if(iter != moNetSocketList.end())
-	{
-		lpNetSocket = iter->second;
-	}
+	CNetSocket *lpNetSocket = GetNetSocket(fd);
 	if(NULL == lpNetSocket)
 	{
 		return true;
@@ -109,12 +178,13 @@ bool CNetEpoll::Delfd(int fd)
 	{
 		TRACE(1, "CNetEpoll::Delfd ʧܡ errno = "<<errno);
 	}
+	ClearNetSocket(fd);
+	//socketʹ߹Ͽ
 	if(!lpNetSocket->mbListenSocket && !lpNetSocket->mbClientSocket)
 	{
 		delete lpNetSocket;
 		lpNetSocket = NULL;
 	}
-	moNetSocketList.erase(fd);
 	return true;
 }
 
@@ -125,52 +195,100 @@ bool CNetEpoll::Delfd(CNetSocket* apNetSocket)
 	{
 		return true;
 	}
-	if(DelEpollEvent(apNetSocket->miSocket) < 0)
+	int fd = apNetSocket->miSocket;
+	if(DelEpollEvent(fd) < 0)
 	{
 		TRACE(1, "CNetEpoll::Delfd ʧܡ errno = "<<errno);
 	}
+	if(GetNetSocket(fd) == apNetSocket)
+	{
+		ClearNetSocket(fd);
+	}
 	if(!apNetSocket->mbListenSocket && !apNetSocket->mbClientSocket)
 	{
 		delete apNetSocket;
 		apNetSocket = NULL;
 	}
-
-	moNetSocketList.erase(apNetSocket->miSocket);
 	return true;
 }
 
-bool CNetEpoll::Delfd(NET_SOCKET_LIST_ITER iter)
+bool CNetEpoll::SetNetSocket(int fd, CNetSocket *apNetSocket)
 {
-	CAutoLock lock(moFdSection);
-	CNetSocket *lpNetSocket = NULL;
-
-	lpNetSocket = iter->second;
-	if(NULL == lpNetSocket)
+	if(fd < 0)
 	{
-		return true;
+		return false;
 	}
-	if(DelEpollEvent(lpNetSocket->miSocket && !lpNetSocket->mbClientSocket) < 0)
+	if((unsigned int)fd >= moSocketSlot.size())
 	{
-		TRACE(1, "CNetEpoll::Delfd NET_SOCKET_LIST_ITER ʧܡ errno = "<<errno);
+		unsigned int liNewSize = moSocketSlot.empty() ? DEF_EPOLL_SIZE : moSocketSlot.size();
+		while(liNewSize <= (unsigned int)fd)
+		{
+			liNewSize *= 2;
+		}
+		moSocketSlot.resize(liNewSize, NULL);
 	}
-	if(!lpNetSocket->mbListenSocket)
+	if(NULL == moSocketSlot[fd])
 	{
-		delete lpNetSocket;
-		lpNetSocket = NULL;
+		++miConnectedSize;
+	}
+	moSocketSlot[fd] = apNetSocket;
+	if(fd > miMaxUsedfd)
+	{
+		miMaxUsedfd = fd;
 	}
-	moNetSocketList.erase(iter);
 	return true;
 }
 
+void CNetEpoll::ClearNetSocket(int fd)
+{
+	if(NULL == GetNetSocket(fd))
+	{
+		return;
+	}
+	moSocketSlot[fd] = NULL;
+	--miConnectedSize;
+	while(miMaxUsedfd >= 0 && NULL == moSocketSlot[miMaxUsedfd])
+	{
+		--miMaxUsedfd;
+	}
+}
+
 bool CNetEpoll::Findfd(int fd)
 {
 	CAutoLock lock(moFdSection);
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.find(fd);
-	if(iter != moNetSocketList.end())
+	return GetNetSocket(fd) != NULL;
+}
+
+bool CNetEpoll::PauseRecv(int fd)
+{
+	CAutoLock lock(moFdSection);
+	CNetSocket *lpNetSocket = GetNetSocket(fd);
+	if(NULL == lpNetSocket || lpNetSocket->mbListenSocket)
 	{
-		return true;
+		return false;
 	}
-	return false;
+	lpNetSocket->mbRecvPaused = true;
+	return true;
+}
+
+bool CNetEpoll::ResumeRecv(int fd)
+{
+	CAutoLock lock(moFdSection);
+	CNetSocket *lpNetSocket = GetNetSocket(fd);
+	if(NULL == lpNetSocket || !lpNetSocket->mbRecvPaused)
+	{
+		return false;
+	}
+	lpNetSocket->mbRecvPaused = false;
+	//شͣڼ䵽ݲ¼MODں˰ǰ״̬±
+	uint32 liEvents = EPOLLIN | EPOLLET;
+	if(!lpNetSocket->mbCanSend)
+	{
+		liEvents |= EPOLLOUT;
+	}
+	ModifyEpollEvent(fd, liEvents);
+	PostRecv(lpNetSocket);
+	return true;
 }
 
 int CNetEpoll::AddEpollEvent(int iSocket, unsigned int ulEvent)
@@ -233,17 +351,7 @@ int CNetEpoll::ProcessEpollEvent(int aiEventSize)
 	{
 		CAutoLock lock(moFdSection);
 		int fd = mstruEvent[i].data.fd;
-		CNetSocket *lpNetFd  = NULL;
-		NET_SOCKET_LIST_ITER iter = moNetSocketList.find(fd);
-		if(iter != moNetSocketList.end())
-		{
-			lpNetFd = iter->second;
-		}
-		else
-		{
-			continue;
-		}
-
+		CNetSocket *lpNetFd = GetNetSocket(fd);
 		if(NULL == lpNetFd)
 		{
 			continue;
@@ -270,7 +378,10 @@ int CNetEpoll::ProcessEpollEvent(int aiEventSize)
 					}
 					else
 					{
-						Addfd(_fd);
+						if(Addfd(_fd))
+						{
+							OnAccept(_fd);
+						}
 						unsigned int liCurrentFdNumber = GetConnectedSize();
 						if(liCurrentFdNumber > miMaxFdNumber)
 						{
@@ -292,162 +403,271 @@ int CNetEpoll::ProcessEpollEvent(int aiEventSize)
 				Delfd(lpNetFd->miSocket);
 				continue;
 			}
-			if(mstruEvent[i].events & EPOLLIN)
+			//ͣյӲָʱעEPOLLIN
+			if((mstruEvent[i].events & EPOLLIN) && !lpNetFd->mbRecvPaused)
 			{
 				if(!lpNetFd->RecvData())
 				{
 					OnErrorNotice(lpNetFd->miSocket);
 					Delfd(lpNetFd->miSocket);
+					continue;
 				}
-				mRecvEvent.SetEvent();
+				PostRecv(lpNetFd);
 			}
 			if(mstruEvent[i].events & EPOLLOUT)
 			{
 				lpNetFd->mbCanSend = true;
 				ModifyEpollEvent(lpNetFd->miSocket, EPOLLIN | EPOLLET);
-				mSendEvent.SetEvent();
+				PostSend(lpNetFd);
 			}
 		}
 	}
 	return 0;
 }
 
-bool CNetEpoll::SendData(int fd, const char* buffer, const int length)
+bool CNetEpoll::SendData(int fd, const char* buffer, const int length, int aiType)
 {
 	if(fd == 0)
 	{
 		return false;
 	}
 	CAutoLock lock(moFdSection);
-	CNetSocket *lpNetSocket = NULL;
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.find(fd);
-	if(iter != moNetSocketList.end())
-	{
-		lpNetSocket = iter->second;
-	}
+	CNetSocket *lpNetSocket = GetNetSocket(fd);
 	if(NULL == lpNetSocket)
 	{
 		TRACE(1, "CNetEpoll::SendData δ鵽û fd = "<<fd);
 		return false;
 	}
-	lpNetSocket->SendData(buffer, length);
-	mSendEvent.SetEvent();
+	int nRet = lpNetSocket->SendData(buffer, length, aiType);
+	if(-1 == nRet)
+	{
+		//б޶ҲΪϿ
+		OnErrorNotice(fd);
+		Delfd(fd);
+		return false;
+	}
+	PostSend(lpNetSocket);
+	return nRet > 0;
+}
+
+bool CNetEpoll::SendAllData(const char* buffer, const int length, int aiType)
+{
+	//ֻһΰ
+	CNetChunk *lpChunk = CNetSocket::PackChunk(buffer, length, aiType);
+	if(NULL == lpChunk)
+	{
+		TRACE(1, "CNetEpoll::SendAllData ʧܡ length = "<<length);
+		return false;
+	}
+	STRU_BROADCAST_STAT loStat;
+	SendAllData(lpChunk, loStat);
+	lpChunk->Release();
 	return true;
 }
 
-bool CNetEpoll::SendAllData(const char* buffer, const int length)
+int CNetEpoll::SendChunk(int fd, CNetChunk *apChunk)
 {
+	ASSERT(apChunk != NULL);
 	CAutoLock lock(moFdSection);
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.begin();
-	for(;iter != moNetSocketList.end();++iter)
+	CNetSocket *lpNetSocket = GetNetSocket(fd);
+	if(NULL == lpNetSocket)
 	{
-		CNetSocket *lpNetSocket = NULL;
-		lpNetSocket = iter->second;
-		if(NULL == lpNetSocket)
+		return -1;
+	}
+	if(miSlowSendLength > 0 && lpNetSocket->GetSendListLength() > (int)miSlowSendLength)
+	{
+		return 0;
+	}
+	int nRet = lpNetSocket->SendChunk(apChunk);
+	if(-1 == nRet)
+	{
+		OnErrorNotice(fd);
+		Delfd(fd);
+		return 0;
+	}
+	PostSend(lpNetSocket);
+	return nRet;
+}
+
+bool CNetEpoll::SendAllData(CNetChunk *apChunk, STRU_BROADCAST_STAT &aoStat)
+{
+	ASSERT(apChunk != NULL);
+	CAutoLock lock(moFdSection);
+	for(int fd = 0; fd <= miMaxUsedfd; ++fd)
+	{
+		CNetSocket *lpNetSocket = moSocketSlot[fd];
+		if(NULL == lpNetSocket || lpNetSocket->mbListenSocket || lpNetSocket->mbClientSocket)
+		{
+			continue;
+		}
+		++aoStat.miTargetCount;
+		if(miSlowSendLength > 0 && lpNetSocket->GetSendListLength() > (int)miSlowSendLength)
 		{
+			++aoStat.miSkipCount;
 			continue;
 		}
-		if(!lpNetSocket->mbListenSocket && !lpNetSocket->mbClientSocket)
+		int nRet = lpNetSocket->SendChunk(apChunk);
+		if(-1 == nRet)
 		{
-			lpNetSocket->SendData(buffer, length);
+			++aoStat.miSkipCount;
+			OnErrorNotice(fd);
+			Delfd(fd);
+			continue;
+		}
+		if(nRet > 0)
+		{
+			++aoStat.miSendCount;
+		}
+		else
+		{
+			++aoStat.miSkipCount;
 		}
 	}
-	mSendEvent.SetEvent();
+	//̫࣬ӣ÷߳ȫɨһ
+	miSendScanAll = 1;
+	moSendNotify.Notify();
 	return true;
 }
 
 bool CNetEpoll::SendData()
 {
-	bool isEmpty = true;
-	CAutoLock lock(moFdSection);
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.begin();
-	for(;iter != moNetSocketList.end();)
+	if(__sync_fetch_and_and(&miSendScanAll, 0))
 	{
-		CNetSocket *lpNetSocket = NULL;
-		lpNetSocket = iter->second;
-		if(NULL == lpNetSocket)
+		CAutoLock lock(moFdSection);
+		for(int fd = 0; fd <= miMaxUsedfd; ++fd)
 		{
-			iter++;
-			continue;
+			//SendSocketʱɾfd
+			SendSocket(moSocketSlot[fd]);
 		}
-		if(!lpNetSocket->mbListenSocket)
+	}
+
+	int lszFd[DEF_READY_BATCH];
+	unsigned int liCount = 0;
+	while((liCount = moSendReady.PopBatch(lszFd, DEF_READY_BATCH)) > 0)
+	{
+		CAutoLock lock(moFdSection);
+		for(unsigned int i = 0; i < liCount; ++i)
 		{
-			int nRet = lpNetSocket->SendData();
-			if(-1 == nRet)
-			{
-				OnErrorNotice(lpNetSocket->miSocket);
-				Delfd(iter++);
-				isEmpty &= false;
-			}
-			else if(1 == nRet)
-			{
-				ModifyEpollEvent(lpNetSocket->miSocket, EPOLLIN |EPOLLOUT | EPOLLET);
-				isEmpty &= false;
-			}
-			//else if (2 == nRet)
-			//{
-			//	TRACE(1, "CNetEpoll::SendData() бѾΪա");
-			//}
+			//ӿѾرգfdҲܱӸã߶෢һҲ޷
+			SendSocket(GetNetSocket(lszFd[i]));
 		}
-		iter++;
 	}
-	return isEmpty;
+	//PopBatchռλδдĲۻǰ0ʱв
+	return moSendReady.IsEmpty() && 0 == miSendScanAll;
+}
+
+void CNetEpoll::SendSocket(CNetSocket *apNetSocket)
+{
+	if(NULL == apNetSocket || apNetSocket->mbListenSocket)
+	{
+		return;
+	}
+	//־ٷͣڼ·ݻ
+	__sync_lock_release(&apNetSocket->miSendQueued);
+	int nRet = apNetSocket->SendData();
+	if(-1 == nRet)
+	{
+		int fd = apNetSocket->miSocket;
+		OnErrorNotice(fd);
+		Delfd(fd);
+	}
+	else if(1 == nRet)
+	{
+		//EPOLLOUTʱ
+		ModifyEpollEvent(apNetSocket->miSocket, EPOLLIN |EPOLLOUT | EPOLLET);
+	}
 }
 
 bool CNetEpoll::RecvData()
 {
-	bool isEmpty = true;
-	CAutoLock lock(moFdSection);
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.begin();
-	for(;iter != moNetSocketList.end();iter++)
+	if(__sync_fetch_and_and(&miRecvScanAll, 0))
 	{
-		CNetSocket *lpNetSocket = NULL;
-		lpNetSocket = iter->second;
-		if(NULL == lpNetSocket)
+		CAutoLock lock(moFdSection);
+		for(int fd = 0; fd <= miMaxUsedfd; ++fd)
 		{
-			continue;
+			RecvSocket(moSocketSlot[fd]);
 		}
-		if(!lpNetSocket->mbListenSocket)
+	}
+	DeliverRecv();
+
+	int lszFd[DEF_READY_BATCH];
+	unsigned int liCount = 0;
+	while((liCount = moRecvReady.PopBatch(lszFd, DEF_READY_BATCH)) > 0)
+	{
 		{
-			//ÿݰȫ
-			for(;;)
+			CAutoLock lock(moFdSection);
+			for(unsigned int i = 0; i < liCount; ++i)
 			{
-				char buffer[DEF_BUFFER_LEN];
-				memset(buffer, 0, DEF_BUFFER_LEN);
-				int length = DEF_BUFFER_LEN;
-				int nRet = lpNetSocket->RecvData(buffer, length);
-				if(nRet)
-				{
-					RecvFrom(lpNetSocket->miSocket, buffer, length);
-					isEmpty &= false;
-				}
-				else
-				{
-					//TRACE(1, "CNetEpoll::RecvData() бѾա");
-					break;
-				}
+				RecvSocket(GetNetSocket(lszFd[i]));
 			}
+		}
+		DeliverRecv();
+	}
+	return moRecvReady.IsEmpty() && 0 == miRecvScanAll;
+}
+
+void CNetEpoll::DeliverRecv()
+{
+	for(unsigned int i = 0; i < moRecvItem.size(); ++i)
+	{
+		STRU_RECV_ITEM &loItem = moRecvItem[i];
+		RecvFrom(loItem.miFd, &moRecvBuffer[loItem.miOffset], loItem.miLength);
+	}
+	moRecvItem.clear();
+	moRecvBuffer.clear();
+}
 
+void CNetEpoll::RecvSocket(CNetSocket *apNetSocket)
+{
+	if(NULL == apNetSocket || apNetSocket->mbListenSocket)
+	{
+		return;
+	}
+	__sync_lock_release(&apNetSocket->miRecvQueued);
+	//ͣڼѶİָʱ
+	if(apNetSocket->mbRecvPaused)
+	{
+		return;
+	}
+	//ÿݰȫ
+	for(;;)
+	{
+		//Ŀռ䲹0ԭÿmemsetһ
+		unsigned int liOffset = moRecvBuffer.size();
+		moRecvBuffer.resize(liOffset + DEF_BUFFER_LEN);
+		int length = DEF_BUFFER_LEN;
+		int nRet = apNetSocket->RecvData(&moRecvBuffer[liOffset], length);
+		if(nRet)
+		{
+			//һ0صַʱһ
+			moRecvBuffer.resize(liOffset + length + 1);
+			STRU_RECV_ITEM loItem;
+			loItem.miFd = apNetSocket->miSocket;
+			loItem.miOffset = liOffset;
+			loItem.miLength = length;
+			moRecvItem.push_back(loItem);
+		}
+		else
+		{
+			moRecvBuffer.resize(liOffset);
+			//TRACE(1, "CNetEpoll::RecvData() бѾա");
+			break;
 		}
 	}
-	return isEmpty;
 }
 
 unsigned int CNetEpoll::GetConnectedSize()
 {
 	CAutoLock lock(moFdSection);
-	unsigned int luiSize = moNetSocketList.size();
-	return luiSize;
+	return miConnectedSize;
 }
 
 bool CNetEpoll::CloseConnect()
 {
 	CAutoLock lock(moFdSection);
-	NET_SOCKET_LIST_ITER iter = moNetSocketList.begin();
-	for(;iter != moNetSocketList.end();iter++)
+	for(int fd = 0; fd <= miMaxUsedfd; ++fd)
 	{
-		CNetSocket *lpNetSocket = NULL;
-		lpNetSocket = iter->second;
+		CNetSocket *lpNetSocket = moSocketSlot[fd];
 		if(NULL == lpNetSocket)
 		{
 			continue;
@@ -463,9 +683,61 @@ bool CNetEpoll::CloseConnect()
 	return true;
 }
 
-void CNetEpoll::Dump()
+void CNetEpoll::SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit)
 {
+	CAutoLock lock(moFdSection);
+	moSendQueueLimit = aoLimit;
+	for(int fd = 0; fd <= miMaxUsedfd; ++fd)
+	{
+		CNetSocket *lpNetSocket = moSocketSlot[fd];
+		if(lpNetSocket != NULL && !lpNetSocket->mbListenSocket && !lpNetSocket->mbClientSocket)
+		{
+			lpNetSocket->SetSendQueueLimit(aoLimit);
+		}
+	}
+}
 
+void CNetEpoll::GetSendQueueStat(STRU_SEND_QUEUE_STAT &aoStat)
+{
+	CAutoLock lock(moFdSection);
+	for(int fd = 0; fd <= miMaxUsedfd; ++fd)
+	{
+		CNetSocket *lpNetSocket = moSocketSlot[fd];
+		if(NULL == lpNetSocket || lpNetSocket->mbListenSocket)
+		{
+			continue;
+		}
+		int liBytes = lpNetSocket->GetSendListLength();
+		int liCount = lpNetSocket->GetSendListCount();
+		aoStat.mui64TotalBytes += liBytes;
+		if(liBytes > aoStat.miMaxBytes)
+		{
+			aoStat.miMaxBytes = liBytes;
+		}
+		if(liCount > aoStat.miMaxCount)
+		{
+			aoStat.miMaxCount = liCount;
+		}
+		aoStat.mui64DropCount += lpNetSocket->GetSendDropCount();
+	}
+}
+
+void CNetEpoll::Dump()
+{
+	CAutoLock lock(moFdSection);
+	TRACE(2, "CNetEpoll::Dump : "<<miConnectedSize);
+	for(int fd = 0; fd <= miMaxUsedfd; ++fd)
+	{
+		CNetSocket *lpNetSocket = moSocketSlot[fd];
+		if(NULL == lpNetSocket || lpNetSocket->mbListenSocket)
+		{
+			continue;
+		}
+		TRACE(2, "CNetEpoll::Dump fd = "<<fd
+			<<" ͻѹֽ: "<<lpNetSocket->GetSendListLength()
+			<<" ͻѹ: "<<lpNetSocket->GetSendListCount()
+			<<" : "<<lpNetSocket->GetSendDropCount());
+	}
 }
 
 void CNetEpoll::TimeOutWork()
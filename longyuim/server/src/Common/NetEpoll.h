@@ -7,14 +7,63 @@
 #include "include.h"
 #include "CriticalSection.h"
 #include "NetSocket.h"
+#include "RingQueue.h"
 #include "sigslot.h"
 
-
-typedef std::map<int, CNetSocket*> NET_SOCKET_LIST;
-typedef std::map<int, CNetSocket*>::iterator NET_SOCKET_LIST_ITER;
+//4.5ǰںͷļûУʱֻ֧᷵EINVAL
+#ifndef EPOLLEXCLUSIVE
+#define EPOLLEXCLUSIVE (1u << 28)
+#endif
 
 #define DEF_EPOLL_SIZE 10240
 #define DEF_EPOLL_TIMEOUT 0
+//㲥ʱбѹֽΪӣ
+#define DEF_SLOW_SEND_LENGTH (1024*1024)
+//˻Ϊȫɨ
+#define DEF_READY_QUEUE_SIZE 65536
+///߳һδӾȡfd
+#define DEF_READY_BATCH 256
+//Ϊʱȴ
+#define DEF_READY_WAIT_TIMEOUT 1000
+
+//һι㲥ͳ
+struct STRU_BROADCAST_STAT
+{
+	STRU_BROADCAST_STAT()
+	{
+		miTargetCount = 0;
+		miSendCount = 0;
+		miSkipCount = 0;
+		mui64CostTime = 0;
+	}
+	//Ŀ
+	unsigned int miTargetCount;
+	//뷢б
+	unsigned int miSendCount;
+	//
+	unsigned int miSkipCount;
+	//ʱ΢
+	uint64 mui64CostTime;
+};
+
+//Ͷͳ
+struct STRU_SEND_QUEUE_STAT
+{
+	STRU_SEND_QUEUE_STAT()
+	{
+		mui64TotalBytes = 0;
+		miMaxBytes = 0;
+		miMaxCount = 0;
+		mui64DropCount = 0;
+	}
+	//ӻѹֽ
+	uint64 mui64TotalBytes;
+	//ѹֽ
+	int miMaxBytes;
+	int miMaxCount;
+	//İ
+	uint64 mui64DropCount;
+};
 
 class CNetEpoll
 {
@@ -32,44 +81,114 @@ public:
 	int DelEpollEvent(int iSocket);
 
 	int CheckEpollEvent(int time_out=0);
+	//ֻһ߳ãվǵߵ
 	int ProcessEpollEvent(int aiEventSize);
 
-	bool SendData(int fd, const char* buffer, const int length);
+	//aiTypeCNetSocket::SendDataSEND_POLICY_COALESCE
+	bool SendData(int fd, const char* buffer, const int length, int aiType = 0);
+	//̵߳ãֻ;
+	//trueʾȡգԵ֪ͨдҪȫɨʱfalseӦٵ
 	bool SendData();
-	bool SendAllData(const char* buffer, const int length);
+	bool SendAllData(const char* buffer, const int length, int aiType = 0);
+	//ͬһݿfdķб
+	// 1 ɹ 0 ӱݱӱϿ -1 δ鵽fd
+	int SendChunk(int fd, CNetChunk *apChunk);
+	//㲥ͬһݿ鵽ӣͳۼӵaoStat
+	//ԶϿӼ
+	bool SendAllData(CNetChunk *apChunk, STRU_BROADCAST_STAT &aoStat);
+	void SetSlowSendLength(unsigned int aiLength){ miSlowSendLength = aiLength; }
+	//̵߳ãֻվӣֵͬSendData()
 	bool RecvData();
 
-	bool Addfd(CNetSocket* apNetSocket);
+	//abExclusive epollͬһsocketʱEPOLLEXCLUSIVEעᣬֻһ
+	bool Addfd(CNetSocket* apNetSocket, bool abExclusive = false);
 	bool Delfd(CNetSocket* apNetSocket);
 	bool Addfd(int fd);
 	bool Delfd(int fd);
 	bool Findfd(int fd);
+	//ͣȡӵݣ̲߳ٴں˶̲߳ȡݻѹں˻
+	//TCPöԶ˷̵߳͡ãӲʱfalse
+	bool PauseRecv(int fd);
+	//ָȡעEPOLLINںδٴһΣѶİվ
+	bool ResumeRecv(int fd);
 
 	unsigned int GetConnectedSize();
 	bool CloseConnect();
 
+	//ýӵķб޶ͬʱЧ
+	void SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit);
+	//ͳۼӵaoStat
+	void GetSendQueueStat(STRU_SEND_QUEUE_STAT &aoStat);
+
 	void Dump();
 	void TimeOutWork();
 
+	//Ϊʱtrueʾ
 	bool WaitSendEvent();
 	bool WaitRecvEvent();
 
 private:
-	bool Delfd(NET_SOCKET_LIST_ITER iter);
+	//߳moFdSection
+	inline CNetSocket* GetNetSocket(int fd)
+	{
+		if(fd < 0 || fd > miMaxUsedfd)
+		{
+			return NULL;
+		}
+		return moSocketSlot[fd];
+	}
+	//fdӱʱ
+	bool SetNetSocket(int fd, CNetSocket *apNetSocket);
+	void ClearNetSocket(int fd);
+	//ӷ뷢/վУʱΪ´ȫɨ
+	void PostSend(CNetSocket *apNetSocket);
+	void PostRecv(CNetSocket *apNetSocket);
+	//һӵķбʱϿ߳moFdSection
+	void SendSocket(CNetSocket *apNetSocket);
+	//ȡһӵȫݴ浽moRecvBuffer߳moFdSection
+	void RecvSocket(CNetSocket *apNetSocket);
+	//ͷmoFdSectionٻصRecvFromصӦѵӷʱụ
+	void DeliverRecv();
 
 public:
-		sigslot::signal3<int, char*, int> RecvFrom;
-		sigslot::signal1<int> OnErrorNotice;
+		//հͳÿҪߵ·ֻһۣemitҲ
+		sigslot::single_signal3<int, char*, int> RecvFrom;
+		sigslot::single_signal1<int> OnErrorNotice;
+		//socket½ʱ֪ͨΪӵfd
+		sigslot::signal1<int> OnAccept;
 		bool mbHasListenFd;
 		bool mbKeepAlive;
 private:
-	NET_SOCKET_LIST moNetSocketList;
+	//fd±ӱҲmap
+	std::vector<CNetSocket*> moSocketSlot;
+	//õfdΪֹ
+	int miMaxUsedfd;
+	//еsocketsocket
+	unsigned int miConnectedSize;
 	CCriticalSection moFdSection;
 	int miEpfd;
 	struct epoll_event mstruEvent[DEF_EPOLL_SIZE];
-	CEvent mSendEvent;
-	CEvent mRecvEvent;
+	//ݴ͵fd̷߳룬߳ȡ
+	CMpscRingQueue<int> moSendReady;
+	//յݵfd̷߳룬߳ȡ
+	CSpscRingQueue<int> moRecvReady;
+	CQueueNotify moSendNotify;
+	CQueueNotify moRecvNotify;
+	//㲥1/߳´ȫɨ
+	volatile int miSendScanAll;
+	volatile int miRecvScanAll;
 	unsigned int miMaxFdNumber;
+	//㲥ʱжӵĻѹֽ0ʾ
+	unsigned int miSlowSendLength;
+	STRU_SEND_QUEUE_LIMIT moSendQueueLimit;
+	//߳ݴݰֻн̷߳
+	struct STRU_RECV_ITEM{
+		int miFd;
+		unsigned int miOffset;
+		int miLength;
+	};
+	std::vector<char> moRecvBuffer;
+	std::vector<STRU_RECV_ITEM> moRecvItem;
 };
 
 #endif //_NET_EPOLL_H_
@@ -0,0 +1,520 @@
+
+#include "NetEpollGroup.h"
+#include <sys/resource.h>
+#include <sys/time.h>
+
+static uint64 GetMicroTime()
+{
+	struct timeval loTime;
+	gettimeofday(&loTime, NULL);
+	return (uint64)loTime.tv_sec * 1000000 + loTime.tv_usec;
+}
+
+CNetReactor::CNetReactor(CNetEpollGroup *apGroup, int aiIndex)
+{
+	ASSERT(apGroup != NULL);
+	m_pGroup = apGroup;
+	miIndex = aiIndex;
+	m_pListenSocket = NULL;
+	mui64AcceptCount = 0;
+	mui64RecvCount = 0;
+	moNetEpoll.OnAccept.connect(this, &CNetReactor::OnAccept);
+	moNetEpoll.RecvFrom.connect(this, &CNetReactor::OnRecvFrom);
+	moNetEpoll.OnErrorNotice.connect(this, &CNetReactor::OnErrorNotice);
+}
+
+CNetReactor::~CNetReactor()
+{
+	moNetEpoll.OnAccept.disconnect(this);
+	moNetEpoll.RecvFrom.disconnect(this);
+	moNetEpoll.OnErrorNotice.disconnect(this);
+}
+
+void CNetReactor::OnAccept(int fd)
+{
+	++mui64AcceptCount;
+	m_pGroup->SetOwner(fd, miIndex);
+}
+
+void CNetReactor::OnRecvFrom(int fd, char *buffer, int length)
+{
+	++mui64RecvCount;
+	m_pGroup->RecvFrom(fd, buffer, length);
+}
+
+void CNetReactor::OnErrorNotice(int fd)
+{
+	m_pGroup->OnErrorNotice(fd);
+}
+
+CNetEpollGroup::CNetEpollGroup()
+{
+	memset(mpReactor, 0, sizeof(mpReactor));
+	miReactorCount = 0;
+	mpFdOwner = NULL;
+	miFdOwnerSize = 0;
+	miReactorMaxFd = 0;
+	mbSharedListen = false;
+}
+
+CNetEpollGroup::~CNetEpollGroup()
+{
+	Destroy();
+}
+
+bool CNetEpollGroup::InitReactor(unsigned int aiReactorCount, unsigned int aiMaxSocketSize)
+{
+	if(0 == aiReactorCount || aiReactorCount > DEF_MAX_REACTOR_COUNT)
+	{
+		TRACE(1, "CNetEpollGroup::InitReactor ӦѸcount = "<<aiReactorCount);
+		return false;
+	}
+
+	struct rlimit loLimit;
+	miFdOwnerSize = aiMaxSocketSize * aiReactorCount + 1024;
+	if(0 == getrlimit(RLIMIT_NOFILE, &loLimit) && loLimit.rlim_cur != RLIM_INFINITY
+		&& loLimit.rlim_cur > miFdOwnerSize)
+	{
+		miFdOwnerSize = loLimit.rlim_cur;
+	}
+	mpFdOwner = new int8[miFdOwnerSize];
+	memset(mpFdOwner, -1, miFdOwnerSize);
+
+	for(unsigned int i = 0; i < aiReactorCount; ++i)
+	{
+		CNetReactor *lpReactor = new CNetReactor(this, i);
+		mpReactor[i] = lpReactor;
+		miReactorCount = i + 1;
+		if(!lpReactor->moNetEpoll.Init(aiMaxSocketSize))
+		{
+			TRACE(1, "CNetEpollGroup::InitReactor EPOLLʼʧܡreactor = "<<i);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool CNetEpollGroup::AddListenfd(CNetReactor *apReactor)
+{
+	if(!apReactor->moNetEpoll.Addfd(apReactor->m_pListenSocket, mbSharedListen))
+	{
+		TRACE(1, "CNetEpollGroup::AddListenfd Ӽ˿ڵEPOLLʧܡreactor = "
+			<<apReactor->miIndex);
+		return false;
+	}
+	apReactor->moNetEpoll.mbHasListenFd = true;
+	return true;
+}
+
+bool CNetEpollGroup::Init(const char *ip, const short port, unsigned int aiReactorCount /* = 1 */,
+	unsigned int aiMaxSocketSize /* = DEF_EPOLL_SIZE */)
+{
+	if(!InitReactor(aiReactorCount, aiMaxSocketSize))
+	{
+		Destroy();
+		return false;
+	}
+
+	//ֻһӦʱҪ˿ڸ
+	bool lbReusePort = (aiReactorCount > 1);
+	for(unsigned int i = 0; i < miReactorCount; ++i)
+	{
+		CNetReactor *lpReactor = mpReactor[i];
+		CNetSocket &loListen = lpReactor->moListenSocket;
+		if(!loListen.CreateSocket(ip, port, lbReusePort))
+		{
+			TRACE(1, "CNetEpollGroup::Init 󶨶˿ʧܡreactor = "<<i<<" port = "<<port);
+			Destroy();
+			return false;
+		}
+		if(!loListen.SetNoBlock() || !loListen.Listen())
+		{
+			TRACE(1, "CNetEpollGroup::Init ˿ʧܡreactor = "<<i<<" port = "<<port);
+			Destroy();
+			return false;
+		}
+		loListen.moNetStat = COMMON_TCP_LISTEN;
+		loListen.mbListenSocket = true;
+		lpReactor->m_pListenSocket = &loListen;
+		if(!AddListenfd(lpReactor))
+		{
+			Destroy();
+			return false;
+		}
+	}
+	TRACE(1, "CNetEpollGroup::Init ӦѸ: "<<miReactorCount<<" port = "<<port);
+	return true;
+}
+
+bool CNetEpollGroup::InitShared(CNetSocket *apListenSocket, unsigned int aiReactorCount /* = 1 */,
+	unsigned int aiMaxSocketSize /* = DEF_EPOLL_SIZE */)
+{
+	ASSERT(apListenSocket != NULL);
+	if(!InitReactor(aiReactorCount, aiMaxSocketSize))
+	{
+		Destroy();
+		return false;
+	}
+
+	//ͬһsocketעᵽÿӦѵepollУ˭acceptӾ͹˭
+	//EPOLLEXCLUSIVEʹÿֻһӦ
+	mbSharedListen = true;
+	for(unsigned int i = 0; i < miReactorCount; ++i)
+	{
+		mpReactor[i]->m_pListenSocket = apListenSocket;
+		if(!AddListenfd(mpReactor[i]))
+		{
+			Destroy();
+			return false;
+		}
+	}
+	TRACE(1, "CNetEpollGroup::InitShared ӦѸ: "<<miReactorCount
+		<<" listen fd = "<<apListenSocket->miSocket);
+	return true;
+}
+
+bool CNetEpollGroup::Start()
+{
+	ASSERT(miReactorCount > 0);
+	if(moThreadManager.Start(CheckNetEvent, this, miReactorCount, "reactor_net_event") != miReactorCount)
+	{
+		TRACE(1, "CNetEpollGroup::Start ¼߳ʧܡ");
+		return false;
+	}
+	if(moThreadManager.Start(DealSendEvent, this, miReactorCount, "reactor_send_data") != miReactorCount)
+	{
+		TRACE(1, "CNetEpollGroup::Start ݷ߳ʧܡ");
+		return false;
+	}
+	if(moThreadManager.Start(DealRecvEvent, this, miReactorCount, "reactor_recv_data") != miReactorCount)
+	{
+		TRACE(1, "CNetEpollGroup::Start ݽ߳ʧܡ");
+		return false;
+	}
+	return true;
+}
+
+bool CNetEpollGroup::Destroy()
+{
+	if(!moThreadManager.IsStop())
+	{
+		moThreadManager.StopAll();
+	}
+	for(unsigned int i = 0; i < miReactorCount; ++i)
+	{
+		CNetReactor *lpReactor = mpReactor[i];
+		if(NULL == lpReactor)
+		{
+			continue;
+		}
+		lpReactor->moNetEpoll.Destroy();
+		lpReactor->moListenSocket.Close();
+		delete lpReactor;
+		mpReactor[i] = NULL;
+	}
+	miReactorCount = 0;
+	mbSharedListen = false;
+	if(mpFdOwner != NULL)
+	{
+		delete [] mpFdOwner;
+		mpFdOwner = NULL;
+	}
+	miFdOwnerSize = 0;
+	return true;
+}
+
+void CNetEpollGroup::SetMaxFdNumber(unsigned int aiMaxFdNumber)
+{
+	ASSERT(miReactorCount > 0);
+	miReactorMaxFd = aiMaxFdNumber / miReactorCount;
+	for(unsigned int i = 0; i < miReactorCount; ++i)
+	{
+		mpReactor[i]->moNetEpoll.SetMaxFdNumber(miReactorMaxFd);
+	}
+}
+
+void CNetEpollGroup::CheckListenfd(CNetReactor *apReactor)
+{
+	if(0 == miReactorMaxFd || NULL == apReactor->m_pListenSocket)
+	{
+		return;
+	}
+	CNetEpoll &loNetEpoll = apReactor->moNetEpoll;
+	unsigned int liConnected = loNetEpoll.GetConnectedSize();
+	if(liConnected >= miReactorMaxFd && loNetEpoll.mbHasListenFd)
+	{
+		TRACE(1, "CNetEpollGroup::CheckListenfd reactor = "<<apReactor->miIndex
+			<<" ǰ: "<<liConnected<<" Ӹ: "<<miReactorMaxFd);
+		loNetEpoll.Delfd(apReactor->m_pListenSocket);
+		loNetEpoll.mbHasListenFd = false;
+	}
+	else if(liConnected < miReactorMaxFd && !loNetEpoll.mbHasListenFd)
+	{
+		AddListenfd(apReactor);
+	}
+}
+
+unsigned int CNetEpollGroup::CheckNetEvent(STRU_THREAD_CONTEXT& apContext)
+{
+	try
+	{
+		CNetEpollGroup *p = reinterpret_cast<CNetEpollGroup*>(apContext.mpWorkContext);
+		ASSERT(p != NULL);
+		CNetReactor *lpReactor = p->mpReactor[apContext.moThreadStat.GetThreadIndex()];
+		ASSERT(lpReactor != NULL);
+		for(;;)
+		{
+			p->CheckListenfd(lpReactor);
+			int nRet = lpReactor->moNetEpoll.CheckEpollEvent(-1);
+			lpReactor->moNetEpoll.ProcessEpollEvent(nRet);
+		}
+	}
+	catch (...)
+	{
+		TRACE(1, "CNetEpollGroup::CheckNetEvent 쳣");
+	}
+	return 0;
+}
+
+unsigned int CNetEpollGroup::DealSendEvent(STRU_THREAD_CONTEXT& apContext)
+{
+	try
+	{
+		CNetEpollGroup *p = reinterpret_cast<CNetEpollGroup*>(apContext.mpWorkContext);
+		ASSERT(p != NULL);
+		CNetEpoll &loNetEpoll = p->mpReactor[apContext.moThreadStat.GetThreadIndex()]->moNetEpoll;
+		for(;;)
+		{
+			if(loNetEpoll.SendData())
+			{
+				loNetEpoll.WaitSendEvent();
+			}
+		}
+	}
+	catch (...)
+	{
+		TRACE(1, "CNetEpollGroup::DealSendEvent 쳣");
+	}
+	return 0;
+}
+
+unsigned int CNetEpollGroup::DealRecvEvent(STRU_THREAD_CONTEXT& apContext)
+{
+	try
+	{
+		CNetEpollGroup *p = reinterpret_cast<CNetEpollGroup*>(apContext.mpWorkContext);
+		ASSERT(p != NULL);
+		CNetEpoll &loNetEpoll = p->mpReactor[apContext.moThreadStat.GetThreadIndex()]->moNetEpoll;
+		for(;;)
+		{
+			if(loNetEpoll.RecvData())
+			{
+				loNetEpoll.WaitRecvEvent();
+			}
+		}
+	}
+	catch (...)
+	{
+		TRACE(1, "CNetEpollGroup::DealRecvEvent 쳣");
+	}
+	return 0;
+}
+
+void CNetEpollGroup::SetOwner(int fd, int aiReactor)
+{
+	if(fd < 0 || (unsigned int)fd >= miFdOwnerSize)
+	{
+		TRACE(1, "CNetEpollGroup::SetOwner fdΧfd = "<<fd);
+		return;
+	}
+	mpFdOwner[fd] = (int8)aiReactor;
+}
+
+CNetReactor* CNetEpollGroup::GetReactor(int fd)
+{
+	if(fd < 0 || (unsigned int)fd >= miFdOwnerSize)
+	{
+		return NULL;
+	}
+	int liOwner = mpFdOwner[fd];
+	if(liOwner < 0 || (unsigned int)liOwner >= miReactorCount)
+	{
+		return NULL;
+	}
+	return mpReactor[liOwner];
+}
+
+bool CNetEpollGroup::Addfd(CNetSocket *apNetSocket, unsigned int aiReactor /* = 0 */)
+{
+	ASSERT(apNetSocket != NULL);
+	if(aiReactor >= miReactorCount)
+	{
+		TRACE(1, "CNetEpollGroup::Addfd ӦŴreactor = "<<aiReactor);
+		return false;
+	}
+	if(!mpReactor[aiReactor]->moNetEpoll.Addfd(apNetSocket))
+	{
+		return false;
+	}
+	SetOwner(apNetSocket->miSocket, aiReactor);
+	return true;
+}
+
+bool CNetEpollGroup::Delfd(int fd)
+{
+	CNetReactor *lpReactor = GetReactor(fd);
+	if(NULL == lpReactor)
+	{
+		return true;
+	}
+	return lpReactor->moNetEpoll.Delfd(fd);
+}
+
+bool CNetEpollGroup::Findfd(int fd)
+{
+	CNetReactor *lpReactor = GetReactor(fd);
+	if(NULL == lpReactor)
+	{
+		return false;
+	}
+	return lpReactor->moNetEpoll.Findfd(fd);
+}
+
+bool CNetEpollGroup::PauseRecv(int fd)
+{
+	CNetReactor *lpReactor = GetReactor(fd);
+	if(NULL == lpReactor)
+	{
+		return false;
+	}
+	return lpReactor->moNetEpoll.PauseRecv(fd);
+}
+
+bool CNetEpollGroup::ResumeRecv(int fd)
+{
+	CNetReactor *lpReactor = GetReactor(fd);
+	if(NULL == lpReactor)
+	{
+		return false;
+	}
+	return lpReactor->moNetEpoll.ResumeRecv(fd);
+}
+
+bool CNetEpollGroup::SendData(int fd, const char* buffer, const int length, int aiType)
+{
+	CNetReactor *lpReactor = GetReactor(fd);
+	if(NULL == lpReactor)
+	{
+		TRACE(1, "CNetEpollGroup::SendData δ鵽û fd = "<<fd);
+		return false;
+	}
+	return lpReactor->moNetEpoll.SendData(fd, buffer, length, aiType);
+}
+
+bool CNetEpollGroup::Broadcast(const std::vector<int> &aoFdList, const char* buffer, const int length,
+	STRU_BROADCAST_STAT *apStat /* = NULL */, int aiType /* = 0 */)
+{
+	uint64 lui64Begin = GetMicroTime();
+	STRU_BROADCAST_STAT loStat;
+	CNetChunk *lpChunk = CNetSocket::PackChunk(buffer, length, aiType);
+	if(NULL == lpChunk)
+	{
+		TRACE(1, "CNetEpollGroup::Broadcast ʧܡ length = "<<length);
+		return false;
+	}
+	for(size_t i = 0; i < aoFdList.size(); ++i)
+	{
+		CNetReactor *lpReactor = GetReactor(aoFdList[i]);
+		if(NULL == lpReactor)
+		{
+			continue;
+		}
+		++loStat.miTargetCount;
+		int nRet = lpReactor->moNetEpoll.SendChunk(aoFdList[i], lpChunk);
+		if(nRet > 0)
+		{
+			++loStat.miSendCount;
+		}
+		else if(0 == nRet)
+		{
+			++loStat.miSkipCount;
+		}
+	}
+	lpChunk->Release();
+	loStat.mui64CostTime = GetMicroTime() - lui64Begin;
+	if(apStat != NULL)
+	{
+		*apStat = loStat;
+	}
+	return true;
+}
+
+bool CNetEpollGroup::SendAllData(const char* buffer, const int length, STRU_BROADCAST_STAT *apStat /* = NULL */,
+	int aiType /* = 0 */)
+{
+	uint64 lui64Begin = GetMicroTime();
+	STRU_BROADCAST_STAT loStat;
+	//зӦѹͬһݿ
+	CNetChunk *lpChunk = CNetSocket::PackChunk(buffer, length, aiType);
+	if(NULL == lpChunk)
+	{
+		TRACE(1, "CNetEpollGroup::SendAllData ʧܡ length = "<<length);
+		return false;
+	}
+	for(unsigned int i = 0; i < miReactorCount; ++i)
+	{
+		mpReactor[i]->moNetEpoll.SendAllData(lpChunk, loStat);
+	}
+	lpChunk->Release();
+	loStat.mui64CostTime = GetMicroTime() - lui64Begin;
+	if(apStat != NULL)
+	{
+		*apStat = loStat;
+	}
+	return true;
+}
+
+void CNetEpollGroup::SetSlowSendLength(unsigned int aiLength)
+{
+	for(unsigned int i = 0; i < miReactorCount; ++i)
+	{
+		mpReactor[i]->moNetEpoll.SetSlowSendLength(aiLength);
+	}
+}
+
+void CNetEpollGroup::SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit)
+{
+	for(unsigned int i = 0; i < miReactorCount; ++i)
+	{
+		mpReactor[i]->moNetEpoll.SetSendQueueLimit(aoLimit);
+	}
+}
+
+unsigned int CNetEpollGroup::GetConnectedSize()
+{
+	unsigned int luiSize = 0;
+	for(unsigned int i = 0; i < miReactorCount; ++i)
+	{
+		luiSize += mpReactor[i]->moNetEpoll.GetConnectedSize();
+	}
+	return luiSize;
+}
+
+void CNetEpollGroup::Dump()
+{
+	TRACE(2, "CNetEpollGroup::Dump ӦѸ: "<<miReactorCount);
+	for(unsigned int i = 0; i < miReactorCount; ++i)
+	{
+		CNetReactor *lpReactor = mpReactor[i];
+		STRU_SEND_QUEUE_STAT loStat;
+		lpReactor->moNetEpoll.GetSendQueueStat(loStat);
+		TRACE(2, "CNetEpollGroup::Dump reactor = "<<i
+			<<" : "<<lpReactor->moNetEpoll.GetConnectedSize()
+			<<" : "<<lpReactor->mui64AcceptCount
+			<<" հ: "<<lpReactor->mui64RecvCount
+			<<" ͻѹֽ: "<<loStat.mui64TotalBytes
+			<<" ѹֽ: "<<loStat.miMaxBytes
+			<<" ѹ: "<<loStat.miMaxCount
+			<<" : "<<loStat.mui64DropCount);
+	}
+}
@@ -0,0 +1,114 @@
+
+#ifndef _NET_EPOLL_GROUP_H_
+#define _NET_EPOLL_GROUP_H_
+
+#include "include.h"
+#include "NetEpoll.h"
+#include "ThreadGroup.h"
+#include "sigslot.h"
+
+#define DEF_MAX_REACTOR_COUNT 64
+
+//෴ӦEPOLL
+//ÿӦӵжepollfd//̣߳
+//ֻڽķӦѡӵķַַʽ
+//1 Init       ÿӦѴԼļsocket(SO_REUSEPORT)ں˷ַ
+//2 InitShared ӦѹһѾsocket(縸forkǰ)
+class CNetEpollGroup;
+
+class CNetReactor : public sigslot::has_slots<>
+{
+public:
+	CNetReactor(CNetEpollGroup *apGroup, int aiIndex);
+	~CNetReactor();
+
+	void OnAccept(int fd);
+	void OnRecvFrom(int fd, char *buffer, int length);
+	void OnErrorNotice(int fd);
+
+public:
+	int miIndex;
+	CNetEpollGroup *m_pGroup;
+	CNetEpoll moNetEpoll;
+	//ӦԼļsocket
+	CNetSocket moListenSocket;
+	//ʵʹõļsocket
+	CNetSocket *m_pListenSocket;
+	uint64 mui64AcceptCount;
+	uint64 mui64RecvCount;
+};
+
+class CNetEpollGroup : public sigslot::has_slots<>
+{
+	friend class CNetReactor;
+public:
+	CNetEpollGroup();
+	~CNetEpollGroup();
+
+	//ip port Ϊֽ
+	bool Init(const char *ip, const short port, unsigned int aiReactorCount = 1,
+		unsigned int aiMaxSocketSize = DEF_EPOLL_SIZE);
+	bool InitShared(CNetSocket *apListenSocket, unsigned int aiReactorCount = 1,
+		unsigned int aiMaxSocketSize = DEF_EPOLL_SIZE);
+	//зӦѵ硢߳͡
+	bool Start();
+	bool Destroy();
+
+	//ƽ䵽Ӧѣʱͣ
+	void SetMaxFdNumber(unsigned int aiMaxFdNumber);
+
+	//ӵsocketָķӦ
+	bool Addfd(CNetSocket *apNetSocket, unsigned int aiReactor = 0);
+	bool Delfd(int fd);
+	bool Findfd(int fd);
+	//ͣ/ָȡӵݣCNetEpoll::PauseRecv
+	bool PauseRecv(int fd);
+	bool ResumeRecv(int fd);
+
+	//aiTypeCNetSocket::SendDataSEND_POLICY_COALESCE
+	bool SendData(int fd, const char* buffer, const int length, int aiType = 0);
+	//㲥ֻһΰĿӹͬһݿ飬ӱ
+	//apStatΪNULLʱĿͺʱ
+	bool Broadcast(const std::vector<int> &aoFdList, const char* buffer, const int length,
+		STRU_BROADCAST_STAT *apStat = NULL, int aiType = 0);
+	bool SendAllData(const char* buffer, const int length, STRU_BROADCAST_STAT *apStat = NULL, int aiType = 0);
+	//㲥ʱбѹaiLengthֽڵӱ0ʾ
+	void SetSlowSendLength(unsigned int aiLength);
+	//зӦѽӵķб޶
+	void SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit);
+
+	unsigned int GetReactorCount(){ return miReactorCount; }
+	unsigned int GetConnectedSize();
+	void Dump();
+
+	static unsigned int CheckNetEvent(STRU_THREAD_CONTEXT& apContext);
+	static unsigned int DealSendEvent(STRU_THREAD_CONTEXT& apContext);
+	static unsigned int DealRecvEvent(STRU_THREAD_CONTEXT& apContext);
+
+private:
+	bool InitReactor(unsigned int aiReactorCount, unsigned int aiMaxSocketSize);
+	bool AddListenfd(CNetReactor *apReactor);
+	//ؼsocket
+	void CheckListenfd(CNetReactor *apReactor);
+	CNetReactor* GetReactor(int fd);
+	void SetOwner(int fd, int aiReactor);
+
+public:
+	//հͳÿҪߵ·ֻһۣemitҲ
+	sigslot::single_signal3<int, char*, int> RecvFrom;
+	sigslot::single_signal1<int> OnErrorNotice;
+
+private:
+	CNetReactor *mpReactor[DEF_MAX_REACTOR_COUNT];
+	unsigned int miReactorCount;
+	//fd -> Ӧ
+	int8 *mpFdOwner;
+	unsigned int miFdOwnerSize;
+	//ÿӦѵ0ʾ
+	unsigned int miReactorMaxFd;
+	//InitSharedӦѹüsocketEPOLLEXCLUSIVEע⾪Ⱥ
+	bool mbSharedListen;
+	CThreadGroup moThreadManager;
+};
+
+#endif //_NET_EPOLL_GROUP_H_
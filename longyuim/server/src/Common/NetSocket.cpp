@@ -1,11 +1,16 @@
 
 #include "NetSocket.h"
+#include <poll.h>
 
 CNetSocket::CNetSocket()
 {
 	miSocket = -1;
-	memset(mszResendBuffer, 0, DEF_BUFFER_LEN+1);
+	memset(mszResendBuffer, 0, DEF_RESEND_BUFFER_LEN+1);
 	miResendLength = 0;
+	miSendListLength = 0;
+	miSendListCount = 0;
+	mui64SendDropCount = 0;
+	mui64SendCallCount = 0;
 	memset(mszRecvCache, 0, DEF_BUFFER_LEN*2+1);
 	miRecvCacheLength = 0;
 	mbCanSend = true;
@@ -13,6 +18,10 @@ CNetSocket::CNetSocket()
 	mbListenSocket = false;
 	moSendStat = SEND_NULL;
 	mbClientSocket = false;
+	miSendQueued = 0;
+	miRecvQueued = 0;
+	mbRecvPaused = false;
+	miConnectTime = 0;
 }
 
 
@@ -32,7 +41,7 @@ bool CNetSocket::CreateSocket(void)
 	return true;
 }
 
-bool CNetSocket::CreateSocket(const char* ip, const short port)
+bool CNetSocket::CreateSocket(const char* ip, const short port, bool abReusePort /* = false */)
 {
 	miSocket = socket(AF_INET, SOCK_STREAM, 0);
 	if (miSocket < 0)
@@ -45,6 +54,24 @@ bool CNetSocket::CreateSocket(const char* ip, const short port)
 	//setsockopt(miSocket, SOL_SOCKET, SO_REUSEADDR, (void*)(&(iReuseAddr))
 	//	, sizeof(iReuseAddr));
 
+	if(abReusePort)
+	{
+#ifdef SO_REUSEPORT
+		int iReusePort = 1;
+		if(setsockopt(miSocket, SOL_SOCKET, SO_REUSEPORT, (void*)(&(iReusePort))
+			, sizeof(iReusePort)) < 0)
+		{
+			TRACE(1, "CNetSocket::CreateSocket SO_REUSEPORT ʧܡerrno = "<<errno);
+			close(miSocket);
+			return false;
+		}
+#else
+		TRACE(1, "CNetSocket::CreateSocket ϵͳ֧SO_REUSEPORT");
+		close(miSocket);
+		return false;
+#endif
+	}
+
 	struct sockaddr_in stAddr;
 	stAddr.sin_family = AF_INET;
 
@@ -74,17 +101,17 @@ bool CNetSocket::CreateSocket(const char* ip, const short port)
 bool CNetSocket::Close(int flag /* = 2 */)
 {
 	//ͻ
-	memset(mszResendBuffer, 0, DEF_BUFFER_LEN+1);
+	memset(mszResendBuffer, 0, DEF_RESEND_BUFFER_LEN+1);
 	miResendLength = 0;
 	//Ͷ
 	CAutoLock send_lock(moSendSection);
 	STRU_NET_DATA_INFO loNetDataInfo;
 	while(moSendList.PopFront(loNetDataInfo))
 	{
-		delete loNetDataInfo.buffer;
-		loNetDataInfo.buffer = NULL;
-		loNetDataInfo.length = 0;
+		loNetDataInfo.Free();
 	}
+	miSendListLength = 0;
+	miSendListCount = 0;
 
 	if(moSendList.IsEmpty())
 	{
@@ -158,11 +185,55 @@ bool CNetSocket::ConnectServer(const char* ip, const short port)
 			return false;
 		}
 		// ģʽδ
+		moNetStat = COMMON_TCP_CONNECTING;
+		miConnectTime = time(NULL);
+		return true;
 	}
 	moNetStat = COMMON_TCP_CONNECTED;
 	return true;
 }
 
+int CNetSocket::CheckConnect(int aiWaitMs, int aiTimeout)
+{
+	if(COMMON_TCP_CONNECTED == moNetStat)
+	{
+		return 1;
+	}
+	if(COMMON_TCP_CONNECTING != moNetStat)
+	{
+		return -1;
+	}
+	struct pollfd loPollFd;
+	loPollFd.fd = miSocket;
+	loPollFd.events = POLLOUT;
+	loPollFd.revents = 0;
+	int nRet = poll(&loPollFd, 1, aiWaitMs);
+	if(nRet < 0 && errno != EINTR)
+	{
+		TRACE(1, "CNetSocket::CheckConnect pollʧܡerrno = "<<errno<<" fd = "<<miSocket);
+		return -1;
+	}
+	if(nRet <= 0)
+	{
+		if(time(NULL) - miConnectTime >= aiTimeout)
+		{
+			TRACE(1, "CNetSocket::CheckConnect ӳʱfd = "<<miSocket);
+			return -1;
+		}
+		return 0;
+	}
+	//д֮SO_ERRORжǷɹ
+	int liError = 0;
+	socklen_t liLen = sizeof(liError);
+	if(getsockopt(miSocket, SOL_SOCKET, SO_ERROR, &liError, &liLen) < 0 || liError != 0)
+	{
+		TRACE(1, "CNetSocket::CheckConnect ʧܡerrno = "<<liError<<" fd = "<<miSocket);
+		return -1;
+	}
+	moNetStat = COMMON_TCP_CONNECTED;
+	return 1;
+}
+
 int CNetSocket::Accept(int &ip, short &port)
 {
 	sockaddr_in loSockAddr;
@@ -208,6 +279,21 @@ bool CNetSocket::SetNoBlock()
 	return true;
 }
 
+bool CNetSocket::SetSocketBuffer(int aiLength)
+{
+	if(setsockopt(miSocket, SOL_SOCKET, SO_RCVBUF, (char*)&aiLength, sizeof(aiLength)) == -1)
+	{
+		TRACE(1, "CNetSocket::SetSocketBuffer ýջʧܡlen = "<<aiLength);
+		return false;
+	}
+	if(setsockopt(miSocket, SOL_SOCKET, SO_SNDBUF, (char*)&aiLength, sizeof(aiLength)) == -1)
+	{
+		TRACE(1, "CNetSocket::SetSocketBuffer ÷ͻʧܡlen = "<<aiLength);
+		return false;
+	}
+	return true;
+}
+
 int CNetSocket::SetTcpSockKeepAlive(int nKeepAlive, int nKeepIdle, int nKeepInterval, int nKeepCnt)
 {
     if (setsockopt(miSocket, SOL_SOCKET, SO_KEEPALIVE, (void*)&nKeepAlive, sizeof(nKeepAlive)))
@@ -246,29 +332,153 @@ int CNetSocket::SetTcpSockKeepAlive(int nKeepAlive, int nKeepIdle, int nKeepInte
 }
 
 
-int CNetSocket::SendData(const char* buffer, const int length)
+CNetChunk* CNetSocket::PackChunk(const char* buffer, const int length, int aiType)
 {
-	CAutoLock lock(moSendSection);
-	char lszSendBuffer[DEF_BUFFER_LEN];
-	memset(lszSendBuffer, 0, DEF_BUFFER_LEN);
-	int liSendLen = DEF_BUFFER_LEN;
+	CNetChunk *lpChunk = CNetChunk::Alloc(NET_PACK_HEAD_SIZE + length);
+	if(NULL == lpChunk)
+	{
+		return NULL;
+	}
+	int liSendLen = lpChunk->GetCapacity();
 	CNetPackHead loNetPackHead;
 	loNetPackHead.miLength = length;
-	liSendLen = loNetPackHead.Pack(lszSendBuffer, liSendLen);
+	liSendLen = loNetPackHead.Pack(lpChunk->GetBuffer(), liSendLen);
 	ASSERT(liSendLen == sizeof(CNetPackHead));
-	memcpy(lszSendBuffer+liSendLen, buffer, length);
-	liSendLen += length;
+	memcpy(lpChunk->GetBuffer()+liSendLen, buffer, length);
+	lpChunk->miLength = liSendLen + length;
+	lpChunk->miType = aiType;
+	return lpChunk;
+}
 
-	STRU_NET_DATA_INFO struNetDataInfo;
-	struNetDataInfo.buffer =  new char[liSendLen];
-	memset(struNetDataInfo.buffer, 0, liSendLen);
-	memcpy(struNetDataInfo.buffer, lszSendBuffer, liSendLen);
-	struNetDataInfo.length = liSendLen;
+/************************************************************************
+ֵ 
+1   뷢б
+0   б޶ݱ
+-1  б޶ҪϿ
+-2  ʧܻ
+************************************************************************/
+int CNetSocket::SendData(const char* buffer, const int length, int aiType)
+{
+	CNetChunk *lpChunk = PackChunk(buffer, length, aiType);
+	if(NULL == lpChunk)
+	{
+		return -2;
+	}
+	int nRet = SendChunk(lpChunk);
+	lpChunk->Release();
+	return nRet;
+}
+
+//ֵͬSendData(buffer, length)
+int CNetSocket::SendChunk(CNetChunk *apChunk)
+{
+	ASSERT(apChunk != NULL);
+	//ͻİSendDataԶȥԶҲ
+	if(apChunk->miLength > DEF_RESEND_BUFFER_LEN)
+	{
+		TRACE(1, "CNetSocket::SendChunk fd = "<<miSocket<<" length = "<<apChunk->miLength);
+		return -2;
+	}
+	CAutoLock lock(moSendSection);
+	if(IsSendListFull(apChunk->miLength))
+	{
+		if(SEND_POLICY_DISCONNECT == moSendQueueLimit.moPolicy)
+		{
+			TRACE(1, "CNetSocket::SendChunk бϿӡfd = "<<miSocket
+				<<" bytes = "<<miSendListLength<<" count = "<<miSendListCount);
+			return -1;
+		}
+		int nRet = MakeSendListRoom(apChunk);
+		if(nRet < 0)
+		{
+			++mui64SendDropCount;
+			TRACE(3, "CNetSocket::SendChunk бݡfd = "<<miSocket
+				<<" bytes = "<<miSendListLength<<" count = "<<miSendListCount);
+			return 0;
+		}
+		//ͺϲʱѾ滻б
+		if(nRet > 0)
+		{
+			return 1;
+		}
+	}
 
+	apChunk->AddRef();
+	STRU_NET_DATA_INFO struNetDataInfo;
+	struNetDataInfo.buffer = apChunk->GetBuffer();
+	struNetDataInfo.length = apChunk->miLength;
+	struNetDataInfo.chunk = apChunk;
 	moSendList.PushBack(struNetDataInfo);
+	miSendListLength += struNetDataInfo.length;
+	++miSendListCount;
 	return 1;
 }
 
+void CNetSocket::SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit)
+{
+	CAutoLock lock(moSendSection);
+	moSendQueueLimit = aoLimit;
+}
+
+bool CNetSocket::IsSendListFull(int aiLength)
+{
+	if(moSendQueueLimit.miMaxBytes > 0 && miSendListLength + aiLength > moSendQueueLimit.miMaxBytes)
+	{
+		return true;
+	}
+	if(moSendQueueLimit.miMaxCount > 0 && miSendListCount >= moSendQueueLimit.miMaxCount)
+	{
+		return true;
+	}
+	return false;
+}
+
+//ҷбͬ͵Ĺݿ
+struct STRU_SAME_CHUNK_TYPE
+{
+	STRU_SAME_CHUNK_TYPE(int aiType) : miType(aiType) {}
+	bool operator()(const STRU_NET_DATA_INFO &aoInfo) const
+	{
+		return aoInfo.chunk != NULL && aoInfo.chunk->miType == miType;
+	}
+	int miType;
+};
+
+int CNetSocket::MakeSendListRoom(CNetChunk *apChunk)
+{
+	//беݻûпʼ(ѷһֵmszResendBuffer)Զ
+	if(SEND_POLICY_COALESCE == moSendQueueLimit.moPolicy && apChunk->miType != 0)
+	{
+		STRU_NET_DATA_INFO *lpInfo = moSendList.FindIf(STRU_SAME_CHUNK_TYPE(apChunk->miType));
+		if(lpInfo != NULL && (moSendQueueLimit.miMaxBytes <= 0
+			|| miSendListLength - lpInfo->length + apChunk->miLength <= moSendQueueLimit.miMaxBytes))
+		{
+			apChunk->AddRef();
+			miSendListLength += apChunk->miLength - lpInfo->length;
+			lpInfo->Free();
+			lpInfo->buffer = apChunk->GetBuffer();
+			lpInfo->length = apChunk->miLength;
+			lpInfo->chunk = apChunk;
+			++mui64SendDropCount;
+			return 1;
+		}
+	}
+	if(SEND_POLICY_DROP_OLDEST != moSendQueueLimit.moPolicy
+		&& SEND_POLICY_COALESCE != moSendQueueLimit.moPolicy)
+	{
+		return -1;
+	}
+	STRU_NET_DATA_INFO loNetDataInfo;
+	while(IsSendListFull(apChunk->miLength) && moSendList.PopFront(loNetDataInfo))
+	{
+		miSendListLength -= loNetDataInfo.length;
+		--miSendListCount;
+		loNetDataInfo.Free();
+		++mui64SendDropCount;
+	}
+	return IsSendListFull(apChunk->miLength) ? -1 : 0;
+}
+
 int CNetSocket::SendCacheData()
 {
 	if(miResendLength != 0)
@@ -295,7 +505,7 @@ int CNetSocket::SendCacheData()
 	}
 
 	miResendLength = 0;
-	memset(mszResendBuffer, 0, DEF_BUFFER_LEN+1);
+	memset(mszResendBuffer, 0, DEF_RESEND_BUFFER_LEN+1);
 	return 0;
 }
 
@@ -323,7 +533,7 @@ int CNetSocket::SendData()
 	//ݷϾwhile
 	while(moSendList.TryPop(loNetDataInfo))
 	{
-		if(miResendLength + loNetDataInfo.length <= DEF_BUFFER_LEN)
+		if(miResendLength + loNetDataInfo.length <= DEF_RESEND_BUFFER_LEN)
 		{
 			STRU_NET_DATA_INFO info;
 			moSendList.PopFront(info);
@@ -333,10 +543,10 @@ int CNetSocket::SendData()
 
 			memcpy(mszResendBuffer+miResendLength, loNetDataInfo.buffer, loNetDataInfo.length);
 			miResendLength += loNetDataInfo.length;
+			miSendListLength -= loNetDataInfo.length;
+			--miSendListCount;
 
-			delete [] loNetDataInfo.buffer;
-			loNetDataInfo.buffer = NULL;
-			loNetDataInfo.length = 0;
+			loNetDataInfo.Free();
 		}
 		else
 		{
@@ -358,6 +568,7 @@ int CNetSocket::SendData()
 
 int CNetSocket::_SendData(const char* buffer, const int length)
 {
+	++mui64SendCallCount;
 	int nRet = send(miSocket, buffer, length, MSG_NOSIGNAL);
 	if(nRet > 0)
 	{
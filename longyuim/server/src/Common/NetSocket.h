@@ -5,10 +5,18 @@
 #include "include.h"
 #include "CriticalSection.h"
 #include "NetPack.h"
+#include "NetChunk.h"
 #include "list.h"
 
 #define DEF_LOCAL_ADDR "127.0.0.1"
 #define DEF_SOCKET_CATCH_LEN (10*1024)
+//ÿӷбĬ޶
+#define DEF_SEND_QUEUE_MAX_BYTES (4*1024*1024)
+#define DEF_SEND_QUEUE_MAX_COUNT 8192
+//ӵĳʱʱ䣬
+#define DEF_CONNECT_TIMEOUT 10
+//ͻܷһİնҲոİ
+#define DEF_RESEND_BUFFER_LEN (DEF_BUFFER_LEN + NET_PACK_HEAD_SIZE)
 
 class STRU_NET_DATA_INFO
 {
@@ -17,6 +25,7 @@ public:
 	{
 		buffer = NULL;
 		length = 0;
+		chunk = NULL;
 	}	
 
 	~STRU_NET_DATA_INFO(){}
@@ -27,6 +36,7 @@ public:
 		{
 			buffer = info.buffer;
 			length = info.length;
+			chunk = info.chunk;
 		}
 	}
 	STRU_NET_DATA_INFO& operator = (const STRU_NET_DATA_INFO &info)
@@ -35,12 +45,30 @@ public:
 		{
 			buffer = info.buffer;
 			length = info.length;
+			chunk = info.chunk;
 		}
 		return *this;
 	}
+	//ͷݣݿֻ
+	void Free()
+	{
+		if(chunk != NULL)
+		{
+			chunk->Release();
+		}
+		else
+		{
+			delete [] buffer;
+		}
+		buffer = NULL;
+		length = 0;
+		chunk = NULL;
+	}
 public:
 	char* buffer;
 	int length;
+	//ΪNULLʱbufferָݿ
+	CNetChunk *chunk;
 };
 
 enum NET_STAT
@@ -62,6 +90,33 @@ enum SEND_STAT
 	SENDED
 };
 
+//б޶ʱĴ
+enum SEND_QUEUE_POLICY
+{
+	//
+	SEND_POLICY_DROP_NEWEST = 0,
+	//б
+	SEND_POLICY_DROP_OLDEST,
+	//Ͽ
+	SEND_POLICY_DISCONNECT,
+	//滻бͬ(SendDataaiType)ݣûͬʱ
+	SEND_POLICY_COALESCE
+};
+
+//б޶0ʾ
+struct STRU_SEND_QUEUE_LIMIT
+{
+	STRU_SEND_QUEUE_LIMIT()
+	{
+		miMaxBytes = DEF_SEND_QUEUE_MAX_BYTES;
+		miMaxCount = DEF_SEND_QUEUE_MAX_COUNT;
+		moPolicy = SEND_POLICY_DROP_NEWEST;
+	}
+	int miMaxBytes;
+	int miMaxCount;
+	SEND_QUEUE_POLICY moPolicy;
+};
+
 class CNetSocket
 {
 public:
@@ -69,23 +124,42 @@ public:
 	~CNetSocket();
 
 	//ֽ
-	bool CreateSocket(const char* ip, const short port);
+	//abReusePortΪtrueʱSO_REUSEPORTsocket԰ͬһ˿
+	bool CreateSocket(const char* ip, const short port, bool abReusePort = false);
 	bool CreateSocket(void);
 
 	bool Close(int flag = 2);
 
 	bool Listen();
 	//ֽ
+	//socketΪʱȴɣ״̬ΪCOMMON_TCP_CONNECTING֮CheckConnectȷ
 	bool ConnectServer(const char* ip, const short port);
+	//ȷϷӵĽȴaiWaitMs
+	// 1  0  -1 ʧܻʱ
+	int CheckConnect(int aiWaitMs = 0, int aiTimeout = DEF_CONNECT_TIMEOUT);
 
 	//ACCEPT ip  portΪֽ
 	int Accept(int &ip, short &port);
 
 	bool SetNoBlock();
+	//TCPշСSetNoBlock֮ûḲĬֵ
+	bool SetSocketBuffer(int aiLength);
 
-	int SendData(const char* buffer, const int length);
+	//aiTypeΪϢͣSEND_POLICY_COALESCEʱб滻ͬ͵ľݣ0ʾϲ
+	int SendData(const char* buffer, const int length, int aiType = 0);
+	//Ѵðݿҵбһ
+	int SendChunk(CNetChunk *apChunk);
+	//ϰͷ·ݿ飬ʧܷNULL
+	static CNetChunk* PackChunk(const char* buffer, const int length, int aiType = 0);
 
 	int SendData();
+	//беȴ͵ֽ
+	int GetSendListLength(){ return miSendListLength; }
+	int GetSendListCount(){ return miSendListCount; }
+	uint64 GetSendDropCount(){ return mui64SendDropCount; }
+	//sendۼƴֻɷ߳ۼ
+	uint64 GetSendCallCount(){ return mui64SendCallCount; }
+	void SetSendQueueLimit(const STRU_SEND_QUEUE_LIMIT &aoLimit);
 
 	bool RecvData(char* buffer, int &length);
 
@@ -99,6 +173,10 @@ public:
 private:
 	int _SendData(const char* buffer, const int length);
 	int SendCacheData(void);
+	bool IsSendListFull(int aiLength);
+	//ڳбռ
+	// 1 滻ͬ 0 ڳռ -1 ڲռ
+	int MakeSendListRoom(CNetChunk *apChunk);
 	//nKeepAlive-Ƿ
 	//nKeepIdle-೤ʱշ, ̽
 	//nKeepInterval-̽ⷢʱ
@@ -112,12 +190,24 @@ public:
 	bool mbClientSocket;
 	bool mbCanSend;
 	SEND_STAT moSendStat;
+	//ѷCNetEpollķ/վУͬһظ
+	volatile int miSendQueued;
+	volatile int miRecvQueued;
+	//ͣգCNetEpoll::PauseRecvmoFdSection޸
+	bool mbRecvPaused;
 private:
-	char mszResendBuffer[DEF_BUFFER_LEN+1];
+	//ʼӵʱ
+	time_t miConnectTime;
+	char mszResendBuffer[DEF_RESEND_BUFFER_LEN+1];
 	CCriticalSection moSendSection;
 	CCriticalSection moRecvSection;
 	int miResendLength;
 	_List<STRU_NET_DATA_INFO> moSendList;
+	int miSendListLength;
+	int miSendListCount;
+	STRU_SEND_QUEUE_LIMIT moSendQueueLimit;
+	uint64 mui64SendDropCount;
+	uint64 mui64SendCallCount;
 	_List<STRU_NET_DATA_INFO> moRecvList;
 	char mszRecvCache[DEF_BUFFER_LEN*2+1];
 	int miRecvCacheLength;
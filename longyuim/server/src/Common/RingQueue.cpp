@@ -0,0 +1,77 @@
+#include "RingQueue.h"
+#include <sys/eventfd.h>
+#include <poll.h>
+
+CQueueNotify::CQueueNotify()
+{
+	miEventFd = -1;
+	miWaiting = 0;
+}
+
+CQueueNotify::~CQueueNotify()
+{
+	Close();
+}
+
+bool CQueueNotify::Create()
+{
+	if(miEventFd != -1)
+	{
+		return true;
+	}
+	miEventFd = eventfd(0, EFD_NONBLOCK);
+	if(-1 == miEventFd)
+	{
+		TRACE(1, "CQueueNotify::Create eventfd ʧܡerrno = "<<errno);
+		return false;
+	}
+	return true;
+}
+
+void CQueueNotify::Close()
+{
+	if(miEventFd != -1)
+	{
+		close(miEventFd);
+		miEventFd = -1;
+	}
+}
+
+void CQueueNotify::Notify()
+{
+	//BeginWaitɶԣ֤ҪôݣҪô
+	__sync_synchronize();
+	if(0 == miWaiting || -1 == miEventFd)
+	{
+		return;
+	}
+	uint64 liValue = 1;
+	if(write(miEventFd, &liValue, sizeof(liValue)) < 0 && errno != EAGAIN)
+	{
+		TRACE(1, "CQueueNotify::Notify write ʧܡerrno = "<<errno);
+	}
+}
+
+bool CQueueNotify::Wait(int aiTimeOut)
+{
+	bool lbWake = false;
+	if(-1 == miEventFd)
+	{
+		usleep(aiTimeOut < 0 ? 1000 : aiTimeOut * 1000);
+	}
+	else
+	{
+		struct pollfd loPoll;
+		loPoll.fd = miEventFd;
+		loPoll.events = POLLIN;
+		loPoll.revents = 0;
+		if(poll(&loPoll, 1, aiTimeOut) > 0)
+		{
+			uint64 liValue = 0;
+			read(miEventFd, &liValue, sizeof(liValue));
+			lbWake = true;
+		}
+	}
+	miWaiting = 0;
+	return lbWake;
+}
@@ -0,0 +1,388 @@
+/********************************************************************
+	file base:	RingQueue
+	file ext:	h
+
+	purpose:	нζ
+				CSpscRingQueue ߵ
+				CMpscRingQueue ߵ(ÿ۴ţCASռλ)
+				InitʱȡΪ2ݣʱPushfalseɵ߾򽵼
+				ͷβ±ֿڲͬĻУߺ߻ʧЧ
+				ҪȴʱCQueueNotifyʹá
+*********************************************************************/
+#ifndef _RING_QUEUE_H_
+#define _RING_QUEUE_H_
+
+#include "include.h"
+
+#define DEF_CACHE_LINE_SIZE 64
+#define DEF_RING_QUEUE_SIZE 4096
+
+//x86¶ддᱻCPUţֹֻ
+#if defined(__i386__) || defined(__x86_64__)
+#define RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define RING_BARRIER() __sync_synchronize()
+#endif
+
+inline uint32 RoundUpPower2(uint32 aiValue)
+{
+	uint32 liSize = 2;
+	while(liSize < aiValue && liSize < 0x80000000)
+	{
+		liSize <<= 1;
+	}
+	return liSize;
+}
+
+/************************************************************************/
+/*
+ߵ
+*/
+/************************************************************************/
+template <class T>
+class CSpscRingQueue
+{
+public:
+	CSpscRingQueue()
+	{
+		mpBuffer = NULL;
+		miMask = 0;
+		miTail = 0;
+		miHeadCache = 0;
+		miHead = 0;
+		miTailCache = 0;
+	}
+	~CSpscRingQueue()
+	{
+		if(mpBuffer != NULL)
+		{
+			delete [] mpBuffer;
+			mpBuffer = NULL;
+		}
+	}
+
+	bool Init(unsigned int aiCapacity = DEF_RING_QUEUE_SIZE)
+	{
+		ASSERT(NULL == mpBuffer);
+		uint32 liSize = RoundUpPower2(aiCapacity);
+		mpBuffer = new T[liSize];
+		if(NULL == mpBuffer)
+		{
+			return false;
+		}
+		miMask = liSize - 1;
+		return true;
+	}
+
+	//ߵ
+	inline bool Push(const T &aoValue)
+	{
+		uint32 liTail = miTail;
+		if(liTail - miHeadCache > miMask)
+		{
+			miHeadCache = miHead;
+			if(liTail - miHeadCache > miMask)
+			{
+				return false;
+			}
+		}
+		mpBuffer[liTail & miMask] = aoValue;
+		RING_BARRIER();
+		miTail = liTail + 1;
+		return true;
+	}
+
+	//ߵãʵʷĸֻһ±
+	unsigned int PushBatch(const T *apValue, unsigned int aiCount)
+	{
+		uint32 liTail = miTail;
+		uint32 liFree = miMask + 1 - (liTail - miHeadCache);
+		if(liFree < aiCount)
+		{
+			miHeadCache = miHead;
+			liFree = miMask + 1 - (liTail - miHeadCache);
+		}
+		unsigned int liCount = (aiCount < liFree) ? aiCount : liFree;
+		for(unsigned int i = 0; i < liCount; ++i)
+		{
+			mpBuffer[(liTail + i) & miMask] = apValue[i];
+		}
+		RING_BARRIER();
+		miTail = liTail + liCount;
+		return liCount;
+	}
+
+	//ߵ
+	inline bool Pop(T &aoValue)
+	{
+		uint32 liHead = miHead;
+		if(liHead == miTailCache)
+		{
+			miTailCache = miTail;
+			if(liHead == miTailCache)
+			{
+				return false;
+			}
+		}
+		RING_BARRIER();
+		aoValue = mpBuffer[liHead & miMask];
+		RING_BARRIER();
+		miHead = liHead + 1;
+		return true;
+	}
+
+	//ߵãʵȡĸ
+	unsigned int PopBatch(T *apValue, unsigned int aiCount)
+	{
+		uint32 liHead = miHead;
+		uint32 liReady = miTailCache - liHead;
+		if(liReady < aiCount)
+		{
+			miTailCache = miTail;
+			liReady = miTailCache - liHead;
+		}
+		unsigned int liCount = (aiCount < liReady) ? aiCount : liReady;
+		RING_BARRIER();
+		for(unsigned int i = 0; i < liCount; ++i)
+		{
+			apValue[i] = mpBuffer[(liHead + i) & miMask];
+		}
+		RING_BARRIER();
+		miHead = liHead + liCount;
+		return liCount;
+	}
+
+	//ʱֻǽֵ
+	inline unsigned int GetCount() const
+	{
+		return miTail - miHead;
+	}
+	inline bool IsEmpty() const
+	{
+		return miTail == miHead;
+	}
+	inline unsigned int GetCapacity() const
+	{
+		return miMask + 1;
+	}
+
+private:
+	T *mpBuffer;
+	uint32 miMask;
+	char mszPad0[DEF_CACHE_LINE_SIZE];
+	//д
+	volatile uint32 miTail;
+	uint32 miHeadCache;
+	char mszPad1[DEF_CACHE_LINE_SIZE];
+	//д
+	volatile uint32 miHead;
+	uint32 miTailCache;
+	char mszPad2[DEF_CACHE_LINE_SIZE];
+};
+
+/************************************************************************/
+/*
+ߵ
+ŵ±ʱд±+1ʱɶȡߺһȦ
+*/
+/************************************************************************/
+template <class T>
+class CMpscRingQueue
+{
+	struct STRU_RING_CELL
+	{
+		volatile uint32 miSeq;
+		T moData;
+	};
+
+public:
+	CMpscRingQueue()
+	{
+		mpCell = NULL;
+		miMask = 0;
+		miTail = 0;
+		miHead = 0;
+	}
+	~CMpscRingQueue()
+	{
+		if(mpCell != NULL)
+		{
+			delete [] mpCell;
+			mpCell = NULL;
+		}
+	}
+
+	bool Init(unsigned int aiCapacity = DEF_RING_QUEUE_SIZE)
+	{
+		ASSERT(NULL == mpCell);
+		uint32 liSize = RoundUpPower2(aiCapacity);
+		mpCell = new STRU_RING_CELL[liSize];
+		if(NULL == mpCell)
+		{
+			return false;
+		}
+		for(uint32 i = 0; i < liSize; ++i)
+		{
+			mpCell[i].miSeq = i;
+		}
+		miMask = liSize - 1;
+		return true;
+	}
+
+	//̵߳
+	inline bool Push(const T &aoValue)
+	{
+		uint32 liPos = 0;
+		if(!Reserve(1, liPos))
+		{
+			return false;
+		}
+		STRU_RING_CELL &loCell = mpCell[liPos & miMask];
+		loCell.moData = aoValue;
+		RING_BARRIER();
+		loCell.miSeq = liPos + 1;
+		return true;
+	}
+
+	//̵߳ãһCASռĲۣռ䲻ʱԣʵʷĸ
+	unsigned int PushBatch(const T *apValue, unsigned int aiCount)
+	{
+		unsigned int liCount = (aiCount > miMask + 1) ? miMask + 1 : aiCount;
+		uint32 liPos = 0;
+		while(liCount > 0 && !Reserve(liCount, liPos))
+		{
+			liCount >>= 1;
+		}
+		for(unsigned int i = 0; i < liCount; ++i)
+		{
+			STRU_RING_CELL &loCell = mpCell[(liPos + i) & miMask];
+			loCell.moData = apValue[i];
+			RING_BARRIER();
+			loCell.miSeq = liPos + i + 1;
+		}
+		return liCount;
+	}
+
+	//ߵ
+	inline bool Pop(T &aoValue)
+	{
+		uint32 liHead = miHead;
+		STRU_RING_CELL &loCell = mpCell[liHead & miMask];
+		if(loCell.miSeq != liHead + 1)
+		{
+			return false;
+		}
+		RING_BARRIER();
+		aoValue = loCell.moData;
+		RING_BARRIER();
+		loCell.miSeq = liHead + miMask + 1;
+		miHead = liHead + 1;
+		return true;
+	}
+
+	//ߵãûдĲ۾ֹͣʵȡĸ
+	unsigned int PopBatch(T *apValue, unsigned int aiCount)
+	{
+		uint32 liHead = miHead;
+		unsigned int liCount = 0;
+		for(; liCount < aiCount; ++liCount)
+		{
+			STRU_RING_CELL &loCell = mpCell[(liHead + liCount) & miMask];
+			if(loCell.miSeq != liHead + liCount + 1)
+			{
+				break;
+			}
+			RING_BARRIER();
+			apValue[liCount] = loCell.moData;
+			RING_BARRIER();
+			loCell.miSeq = liHead + liCount + miMask + 1;
+		}
+		miHead = liHead + liCount;
+		return liCount;
+	}
+
+	//ʱֻǽֵռλûдĲ
+	inline unsigned int GetCount() const
+	{
+		return miTail - miHead;
+	}
+	inline bool IsEmpty() const
+	{
+		return miTail == miHead;
+	}
+	inline unsigned int GetCapacity() const
+	{
+		return miMask + 1;
+	}
+
+private:
+	//ռ[aiPos, aiPos+aiCount)һۿд˵ǰĶѱͷ
+	inline bool Reserve(unsigned int aiCount, uint32 &aiPos)
+	{
+		for(;;)
+		{
+			uint32 liPos = miTail;
+			uint32 liSeq = mpCell[(liPos + aiCount - 1) & miMask].miSeq;
+			int32 liDiff = (int32)(liSeq - (liPos + aiCount - 1));
+			if(0 == liDiff)
+			{
+				if(__sync_bool_compare_and_swap(&miTail, liPos, liPos + aiCount))
+				{
+					aiPos = liPos;
+					return true;
+				}
+			}
+			else if(liDiff < 0)
+			{
+				return false;
+			}
+		}
+	}
+
+private:
+	STRU_RING_CELL *mpCell;
+	uint32 miMask;
+	char mszPad0[DEF_CACHE_LINE_SIZE];
+	//CAS
+	volatile uint32 miTail;
+	char mszPad1[DEF_CACHE_LINE_SIZE];
+	//д
+	volatile uint32 miHead;
+	char mszPad2[DEF_CACHE_LINE_SIZE];
+};
+
+/************************************************************************/
+/*
+еȴeventfd
+ߣBeginWait() -> ټһζ -> ΪղWait()EndWait()
+ߣݺNotify()ûڵȴʱں
+*/
+/************************************************************************/
+class CQueueNotify
+{
+public:
+	CQueueNotify();
+	~CQueueNotify();
+
+	bool Create();
+	void Close();
+
+	void Notify();
+	inline void BeginWait()
+	{
+		miWaiting = 1;
+		__sync_synchronize();
+	}
+	inline void EndWait()
+	{
+		miWaiting = 0;
+	}
+	//aiTimeOut룬-1һֱȡtrueʾ
+	bool Wait(int aiTimeOut);
+
+private:
+	int miEventFd;
+	volatile int miWaiting;
+};
+
+#endif //_RING_QUEUE_H_
@@ -0,0 +1,204 @@
+#include "TimingWheel.h"
+#include <time.h>
+
+CTimingWheel::CTimingWheel()
+{
+	for(int i = 0; i < DEF_TW_ROOT_SIZE; ++i)
+	{
+		InitHead(&moRoot[i]);
+	}
+	for(int i = 0; i < DEF_TW_LEVEL_COUNT; ++i)
+	{
+		for(int j = 0; j < DEF_TW_LEVEL_SIZE; ++j)
+		{
+			InitHead(&moLevel[i][j]);
+		}
+	}
+	mui64CurrentTick = 0;
+	mui64StartTime = 0;
+	miTickMs = DEF_TW_TICK_MS;
+	miTimerCount = 0;
+}
+
+CTimingWheel::~CTimingWheel()
+{
+}
+
+void CTimingWheel::Init(uint64 aui64Now, unsigned int aiTickMs /* = DEF_TW_TICK_MS */)
+{
+	ASSERT(0 == miTimerCount);
+	mui64StartTime = aui64Now;
+	mui64CurrentTick = 0;
+	miTickMs = aiTickMs > 0 ? aiTickMs : DEF_TW_TICK_MS;
+}
+
+uint64 CTimingWheel::GetMonotonicTime()
+{
+	struct timespec loTime;
+	clock_gettime(CLOCK_MONOTONIC, &loTime);
+	return (uint64)loTime.tv_sec * 1000 + loTime.tv_nsec / 1000000;
+}
+
+void CTimingWheel::InitHead(STRU_TIMER_NODE *apHead)
+{
+	apHead->mpPrev = apHead;
+	apHead->mpNext = apHead;
+}
+
+void CTimingWheel::LinkTail(STRU_TIMER_NODE *apHead, STRU_TIMER_NODE *apNode)
+{
+	apNode->mpPrev = apHead->mpPrev;
+	apNode->mpNext = apHead;
+	apHead->mpPrev->mpNext = apNode;
+	apHead->mpPrev = apNode;
+}
+
+void CTimingWheel::Unlink(STRU_TIMER_NODE *apNode)
+{
+	apNode->mpPrev->mpNext = apNode->mpNext;
+	apNode->mpNext->mpPrev = apNode->mpPrev;
+	apNode->mpPrev = NULL;
+	apNode->mpNext = NULL;
+}
+
+void CTimingWheel::Splice(STRU_TIMER_NODE *apFrom, STRU_TIMER_NODE *apTo)
+{
+	if(apFrom->mpNext == apFrom)
+	{
+		return;
+	}
+	apTo->mpNext = apFrom->mpNext;
+	apTo->mpPrev = apFrom->mpPrev;
+	apTo->mpNext->mpPrev = apTo;
+	apTo->mpPrev->mpNext = apTo;
+	InitHead(apFrom);
+}
+
+void CTimingWheel::AddNode(STRU_TIMER_NODE *apNode)
+{
+	uint64 lui64Expire = apNode->mui64Expire;
+	if(lui64Expire < mui64CurrentTick)
+	{
+		lui64Expire = mui64CurrentTick;
+		apNode->mui64Expire = lui64Expire;
+	}
+	uint64 lui64Index = lui64Expire - mui64CurrentTick;
+	STRU_TIMER_NODE *lpHead = NULL;
+	if(lui64Index < DEF_TW_ROOT_SIZE)
+	{
+		lpHead = &moRoot[lui64Expire & DEF_TW_ROOT_MASK];
+	}
+	else
+	{
+		int liLevel = 0;
+		int liShift = DEF_TW_ROOT_BITS;
+		while(liLevel < DEF_TW_LEVEL_COUNT - 1
+			&& lui64Index >= ((uint64)1 << (liShift + DEF_TW_LEVEL_BITS)))
+			{
+			++liLevel;
+			liShift += DEF_TW_LEVEL_BITS;
+		}
+		//Χķ߲ԶĲۣʱٴηɢ
+		uint64 lui64Max = ((uint64)1 << (liShift + DEF_TW_LEVEL_BITS)) - 1;
+		if(lui64Index > lui64Max)
+		{
+			lui64Expire = mui64CurrentTick + lui64Max;
+		}
+		lpHead = &moLevel[liLevel][(lui64Expire >> liShift) & DEF_TW_LEVEL_MASK];
+	}
+	LinkTail(lpHead, apNode);
+}
+
+int CTimingWheel::Cascade(int aiLevel)
+{
+	int liIndex = (int)((mui64CurrentTick >> (DEF_TW_ROOT_BITS + aiLevel * DEF_TW_LEVEL_BITS))
+		& DEF_TW_LEVEL_MASK);
+	STRU_TIMER_NODE loList;
+	InitHead(&loList);
+	Splice(&moLevel[aiLevel][liIndex], &loList);
+	while(loList.mpNext != &loList)
+	{
+		STRU_TIMER_NODE *lpNode = loList.mpNext;
+		Unlink(lpNode);
+		AddNode(lpNode);
+	}
+	return liIndex;
+}
+
+void CTimingWheel::Arm(STRU_TIMER_NODE *apNode, unsigned int aiTimeOut)
+{
+	ASSERT(apNode != NULL);
+	if(apNode->IsArmed())
+	{
+		Unlink(apNode);
+	}
+	else
+	{
+		++miTimerCount;
+	}
+	uint64 lui64Ticks = (aiTimeOut + miTickMs - 1) / miTickMs;
+	if(0 == lui64Ticks)
+	{
+		lui64Ticks = 1;
+	}
+	apNode->mui64Expire = mui64CurrentTick + lui64Ticks;
+	AddNode(apNode);
+}
+
+void CTimingWheel::Cancel(STRU_TIMER_NODE *apNode)
+{
+	ASSERT(apNode != NULL);
+	if(!apNode->IsArmed())
+	{
+		return;
+	}
+	Unlink(apNode);
+	--miTimerCount;
+}
+
+int CTimingWheel::Advance(uint64 aui64Now)
+{
+	if(aui64Now < mui64StartTime)
+	{
+		return 0;
+	}
+	uint64 lui64Target = (aui64Now - mui64StartTime) / miTickMs;
+	//ûжʱʱֱǰ̶
+	if(0 == miTimerCount)
+	{
+		if(lui64Target >= mui64CurrentTick)
+		{
+			mui64CurrentTick = lui64Target + 1;
+		}
+		return 0;
+	}
+	int liCount = 0;
+	STRU_TIMER_NODE loList;
+	InitHead(&loList);
+	while(mui64CurrentTick <= lui64Target)
+	{
+		int liIndex = (int)(mui64CurrentTick & DEF_TW_ROOT_MASK);
+		//0תһȦʱϲ𼶷ɢ
+		if(0 == liIndex)
+		{
+			for(int i = 0; i < DEF_TW_LEVEL_COUNT; ++i)
+			{
+				if(Cascade(i) != 0)
+				{
+					break;
+				}
+			}
+		}
+		++mui64CurrentTick;
+		Splice(&moRoot[liIndex], &loList);
+		while(loList.mpNext != &loList)
+		{
+			STRU_TIMER_NODE *lpNode = loList.mpNext;
+			Unlink(lpNode);
+			--miTimerCount;
+			++liCount;
+			OnTimeOut(lpNode);
+		}
+	}
+	return liCount;
+}
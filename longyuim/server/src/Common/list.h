@@ -69,6 +69,20 @@ public:
 		value = first->_data;
 		return true;
 	}
+
+	//صһݣûзNULL
+	template <class Pred>
+	T* FindIf(Pred pred)
+	{
+		_Node<T> *node = first;
+		while(node)
+		{
+			if(pred(node->_data))
+				return &node->_data;
+			node = node->_link;
+		}
+		return NULL;
+	}
 	
 private:
 	_Node<T> *first;
@@ -1,11 +1,18 @@
 
 
 #include "DCSConfig.h"
+#include "NetSocket.h"
 
 CDCSConfig::CDCSConfig()
 {
 	server_ip = 0;
 	server_port = 0;
+	reactor_thread_count = 1;
+	send_queue_max_bytes = DEF_SEND_QUEUE_MAX_BYTES;
+	send_queue_max_count = DEF_SEND_QUEUE_MAX_COUNT;
+	send_queue_policy = SEND_POLICY_DROP_NEWEST;
+	shard_index = 0;
+	deal_thread_count = 0;
 }
 
 CDCSConfig::~CDCSConfig()
@@ -51,6 +58,56 @@ bool CDCSConfig::parse_value(const char* key, const char* value)
 		return true;
 	}
 
+	if (!strcmp(key, "reactor_thread_count")) 
+	{
+		reactor_thread_count = (unsigned short)strtol(value, NULL, 0);
+		if(0 == reactor_thread_count)
+		{
+			reactor_thread_count = 1;
+		}
+		return true;
+	}
+
+	if (!strcmp(key, "send_queue_max_bytes")) 
+	{
+		send_queue_max_bytes = (int)strtol(value, NULL, 0);
+		return true;
+	}
+
+	if (!strcmp(key, "send_queue_max_count")) 
+	{
+		send_queue_max_count = (int)strtol(value, NULL, 0);
+		return true;
+	}
+
+	if (!strcmp(key, "send_queue_policy")) 
+	{
+		send_queue_policy = (int)strtol(value, NULL, 0);
+		if(send_queue_policy < SEND_POLICY_DROP_NEWEST || send_queue_policy > SEND_POLICY_COALESCE)
+		{
+			send_queue_policy = SEND_POLICY_DROP_NEWEST;
+		}
+		return true;
+	}
+
+	if (!strcmp(key, "shard_list")) 
+	{
+		shard_list = value;
+		return true;
+	}
+
+	if (!strcmp(key, "shard_index")) 
+	{
+		shard_index = (unsigned short)strtol(value, NULL, 0);
+		return true;
+	}
+
+	if (!strcmp(key, "deal_thread_count")) 
+	{
+		deal_thread_count = (unsigned short)strtol(value, NULL, 0);
+		return true;
+	}
+
 	return true;
 }
 
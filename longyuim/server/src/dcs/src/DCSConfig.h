@@ -22,6 +22,19 @@ public:
 	unsigned short max_bind_time;
 	unsigned int log_file_update_time;
 	unsigned int dump_info_time;
+	//練Ӧ(epoll߳)1ΪӦ
+	unsigned short reactor_thread_count;
+	//ÿӷб޶0ʾ
+	int send_queue_max_bytes;
+	int send_queue_max_count;
+	//޶ʱĴ 0 1 2Ͽ 3Ϣͺϲ
+	int send_queue_policy;
+	//ȫƬĵַ"ip:port,ip:port"ƬDNSͬΪձʾֻһDCS
+	string shard_list;
+	//Ƭshard_listţ0ʼ
+	unsigned short shard_index;
+	//̸߳ͬһӵİͬһ̴߳0ʾڽֱ߳Ӵ
+	unsigned short deal_thread_count;
 };
 
 #endif//_DCS_CONFIG_H_
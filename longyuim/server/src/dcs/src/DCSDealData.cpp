@@ -129,6 +129,33 @@ uint32 CDCSDealData::DCSDealData(const char *apIn,
 			//TRACE(1, "CDCSDealData::DCSDealData  PACK_DCS_DNS_MESSAGE ip="<<inet_ntoa(ip)<<" id="<<pack_msg.m_iDnsId);
 			return 2;
 		}
+	case PACK_DCS_DNS_BATCH:
+		{
+			stru_DCS_DNS_BATCH pack_batch;
+			if(0 != pack_batch.UnPack(pack_data,pack_lengh))
+			{
+				TRACE(1, "CDCSDealData::DCSDealData PACK_DCS_DNS_BATCH UnPack ");
+				return 0;
+			}
+			//飬һ
+			uint32 liOffset = 0;
+			uint16 liCount = 0;
+			const char *lpItem = NULL;
+			uint16 liItemLen = 0;
+			while(GetBatchItem(pack_batch.m_cDataBuf, pack_batch.m_iDatalen, liOffset, lpItem, liItemLen))
+			{
+				++liCount;
+			}
+			if(liOffset != pack_batch.m_iDatalen || liCount != pack_batch.m_iCount)
+			{
+				TRACE(1, "CDCSDealData::DCSDealData PACK_DCS_DNS_BATCH ʽ: "<<pack_batch.m_iCount
+					<<" : "<<pack_batch.m_iDatalen);
+				return 0;
+			}
+			memcpy(apOut,pack_batch.m_cDataBuf,pack_batch.m_iDatalen);
+			aiOut = pack_batch.m_iDatalen;
+			return 3;
+		}
 	default:
 		{
 			TRACE(1, "CDCSDealData::DCSDealData δ֪ͣ͡"<<lui16type);
@@ -137,3 +164,30 @@ uint32 CDCSDealData::DCSDealData(const char *apIn,
 	}
 	return 0;
 }
+
+bool CDCSDealData::GetBatchItem(const char *apData, const uint32 aiLength, uint32 &aiOffset,
+	const char *&apItem, uint16 &aiItemLen)
+{
+	//ÿ uint16 + ͡IPIDݳȹ12ֽ + 
+	const uint32 liHeadLen = sizeof(uint16) + sizeof(uint32) * 2 + sizeof(uint16);
+	if(aiOffset + sizeof(uint16) + liHeadLen > aiLength)
+	{
+		return false;
+	}
+	const char *lpItem = apData + aiOffset + sizeof(uint16);
+	uint16 liItemLen = 0;
+	uint16 liType = 0;
+	uint16 liDataLen = 0;
+	memcpy(&liItemLen, apData + aiOffset, sizeof(uint16));
+	memcpy(&liType, lpItem, sizeof(uint16));
+	memcpy(&liDataLen, lpItem + liHeadLen - sizeof(uint16), sizeof(uint16));
+	if(liType != PACK_DCS_DNS_MESSAGE || liItemLen != liHeadLen + liDataLen
+		|| liDataLen < 14 || aiOffset + sizeof(uint16) + liItemLen > aiLength)
+	{
+		return false;
+	}
+	apItem = lpItem;
+	aiItemLen = liItemLen;
+	aiOffset += sizeof(uint16) + liItemLen;
+	return true;
+}
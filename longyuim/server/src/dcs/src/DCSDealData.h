@@ -16,10 +16,14 @@ public:
 			 0 κδ
 		     1 ظݸ
 			 2 ݹ㲥
+			 3 ϢapOutǼGetBatchItemȡַ
 	*/
 	/************************************************************************/
 	 uint32 DCSDealData(const char *apIn, 
 		const uint32 aiIn, char *apOut, uint32 &aiOut);
+	 //aiOffsetȡһðPACK_DCS_DNS_MESSAGEȡʽ󷵻false
+	 static bool GetBatchItem(const char *apData, const uint32 aiLength, uint32 &aiOffset,
+		 const char *&apItem, uint16 &aiItemLen);
 
 public:
 	sigslot::signal3<int, int, CBasePack*> DealDataComplete;
@@ -0,0 +1,438 @@
+#include "DCSShard.h"
+#include "dcs_dns.h"
+//ֻõϢͷЭ鶨DNSǷ
+#include "dns_crs.h"
+
+CDCSShard::CDCSShard()
+{
+	m_pDcsConfig = NULL;
+	m_pServer = NULL;
+	miSelf = 0;
+	memset(mbPeerAlive, 0, sizeof(mbPeerAlive));
+	mui64UnicastCount = 0;
+	mui64RelayCount = 0;
+	mui64BroadcastCount = 0;
+	mui64MissCount = 0;
+}
+
+CDCSShard::~CDCSShard()
+{
+	for(unsigned int i = 0; i < moPeerSocket.size(); ++i)
+	{
+		if(moPeerSocket[i] != NULL)
+		{
+			delete moPeerSocket[i];
+			moPeerSocket[i] = NULL;
+		}
+	}
+}
+
+bool CDCSShard::Init(CDCSConfig *apConfig, CNetEpollGroup *apServer)
+{
+	ASSERT(apConfig != NULL && apServer != NULL);
+	m_pDcsConfig = apConfig;
+	m_pServer = apServer;
+	if(apConfig->shard_list.empty())
+	{
+		//ֻһDCS
+		STRU_NODE_ADDR loAddr;
+		loAddr.miIp = apConfig->server_ip;
+		loAddr.miPort = apConfig->server_port;
+		char lszName[64];
+		struct in_addr addr;
+		addr.s_addr = htonl(loAddr.miIp);
+		snprintf(lszName, sizeof(lszName), "%s:%u", inet_ntoa(addr), loAddr.miPort);
+		loAddr.mstrName = lszName;
+		moShardAddr.push_back(loAddr);
+		miSelf = 0;
+	}
+	else
+	{
+		int liCount = ParseNodeAddrList(apConfig->shard_list.c_str(), moShardAddr);
+		if(liCount <= 0 || liCount > DEF_MAX_CLUSTER_NODE)
+		{
+			TRACE(1, "CDCSShard::Init shard_listôshard_list = "<<apConfig->shard_list.c_str());
+			return false;
+		}
+		if(apConfig->shard_index >= liCount)
+		{
+			TRACE(1, "CDCSShard::Init shard_indexΧshard_index = "<<apConfig->shard_index
+				<<" Ƭ: "<<liCount);
+			return false;
+		}
+		miSelf = apConfig->shard_index;
+	}
+
+	for(unsigned int i = 0; i < moShardAddr.size(); ++i)
+	{
+		moRing.AddNode(moShardAddr[i].mstrName.c_str());
+		moPeerSocket.push_back((int)i == miSelf ? NULL : new CNetSocket);
+		mbPeerAlive[i] = ((int)i == miSelf);
+	}
+	moRing.Build();
+	TRACE(1, "CDCSShard::Init Ƭ: "<<moShardAddr.size()<<" Ƭ: "<<miSelf
+		<<" "<<moShardAddr[miSelf].mstrName.c_str());
+	return true;
+}
+
+void CDCSShard::CheckPeer()
+{
+	for(unsigned int i = 0; i < moPeerSocket.size(); ++i)
+	{
+		CNetSocket *lpSocket = moPeerSocket[i];
+		if(NULL == lpSocket)
+		{
+			continue;
+		}
+		{
+			CAutoLock lock(moSection);
+			if(mbPeerAlive[i])
+			{
+				continue;
+			}
+		}
+		//һεѾEPOLLժص
+		if(lpSocket->miSocket >= 0 && lpSocket->moNetStat != COMMON_TCP_CONNECTING)
+		{
+			m_pServer->Delfd(lpSocket->miSocket);
+			lpSocket->Close();
+			lpSocket->miSocket = -1;
+		}
+		if(lpSocket->miSocket < 0)
+		{
+			if(!lpSocket->CreateSocket())
+			{
+				continue;
+			}
+			//ǰɷƬɴʱῨסʱ
+			lpSocket->SetNoBlock();
+			struct in_addr addr;
+			addr.s_addr = htonl(moShardAddr[i].miIp);
+			if(!lpSocket->ConnectServer(inet_ntoa(addr), moShardAddr[i].miPort))
+			{
+				lpSocket->Close();
+				lpSocket->miSocket = -1;
+				continue;
+			}
+		}
+		//ûϵ´ȷϣеsocketŽEPOLL
+		int liRet = lpSocket->CheckConnect();
+		if(0 == liRet)
+		{
+			continue;
+		}
+		if(liRet < 0)
+		{
+			lpSocket->Close();
+			lpSocket->miSocket = -1;
+			continue;
+		}
+		lpSocket->mbClientSocket = true;
+		if(!m_pServer->Addfd(lpSocket))
+		{
+			TRACE(1, "CDCSShard::CheckPeer ӷƬӵEPOLLʧܡƬ: "<<i);
+			lpSocket->Close();
+			lpSocket->miSocket = -1;
+			continue;
+		}
+
+		char buffer[DCS_DNS_BUFFER_LEN] = {0};
+		stru_DCS_PEER_LOGIN_RQ rq;
+		rq.m_iShardIndex = miSelf;
+		rq.m_iShardCount = moShardAddr.size();
+		int len = rq.Pack(buffer, DCS_DNS_BUFFER_LEN);
+		m_pServer->SendData(lpSocket->miSocket, buffer, len);
+		{
+			CAutoLock lock(moSection);
+			mbPeerAlive[i] = true;
+		}
+		TRACE(1, "CDCSShard::CheckPeer ϷƬ: "<<i<<" "<<moShardAddr[i].mstrName.c_str()
+			<<" fd = "<<lpSocket->miSocket);
+	}
+}
+
+void CDCSShard::Dump()
+{
+	CAutoLock lock(moSection);
+	unsigned int liAliveCount = 0;
+	for(unsigned int i = 0; i < moShardAddr.size(); ++i)
+	{
+		if(mbPeerAlive[i])
+		{
+			++liAliveCount;
+		}
+	}
+	TRACE(2, "CDCSShard::Dump Ƭ: "<<miSelf<<" Ƭ: "<<moShardAddr.size()
+		<<" ÷Ƭ: "<<liAliveCount<<" Ƭ: "<<moPeerFd.size()
+		<<" DNS: "<<moDnsFd.size()<<" : "<<moHallDns.size()
+		<<" : "<<mui64UnicastCount<<" ת: "<<mui64RelayCount
+		<<" 㲥: "<<mui64BroadcastCount<<" δ: "<<mui64MissCount);
+}
+
+bool CDCSShard::OnClose(int fd)
+{
+	CAutoLock lock(moSection);
+	for(unsigned int i = 0; i < moPeerSocket.size(); ++i)
+	{
+		if(moPeerSocket[i] != NULL && mbPeerAlive[i] && moPeerSocket[i]->miSocket == fd)
+		{
+			mbPeerAlive[i] = false;
+			TRACE(1, "CDCSShard::OnClose ƬӶϿƬ: "<<i<<" fd = "<<fd);
+			return true;
+		}
+	}
+	if(moPeerFd.erase(fd) > 0)
+	{
+		TRACE(1, "CDCSShard::OnClose ƬӶϿfd = "<<fd);
+		return true;
+	}
+	std::map<int, uint64>::iterator it = moFdDns.find(fd);
+	if(it != moFdDns.end())
+	{
+		uint64 lui64DnsKey = it->second;
+		moFdDns.erase(it);
+		std::map<uint64, int>::iterator iter = moDnsFd.find(lui64DnsKey);
+		if(iter != moDnsFd.end() && iter->second == fd)
+		{
+			moDnsFd.erase(iter);
+			//DNSȫͬ
+			ClearDnsHall(lui64DnsKey);
+		}
+	}
+	return false;
+}
+
+void CDCSShard::OnDnsLogin(int fd, uint32 aiDnsIp, uint32 aiDnsId)
+{
+	uint64 lui64DnsKey = MakeDnsKey(aiDnsIp, aiDnsId);
+	CAutoLock lock(moSection);
+	std::map<uint64, int>::iterator it = moDnsFd.find(lui64DnsKey);
+	if(it != moDnsFd.end() && it->second != fd)
+	{
+		moFdDns.erase(it->second);
+	}
+	moDnsFd[lui64DnsKey] = fd;
+	moFdDns[fd] = lui64DnsKey;
+}
+
+void CDCSShard::OnPeerLogin(int fd, const char *buffer, int length)
+{
+	stru_DCS_PEER_LOGIN_RQ rq;
+	if(0 != rq.UnPack(buffer, length))
+	{
+		TRACE(1, "CDCSShard::OnPeerLogin UnPack ");
+		return;
+	}
+	if(rq.m_iShardCount != moShardAddr.size())
+	{
+		TRACE(1, "CDCSShard::OnPeerLogin ƬͱƬòһ¡Ƭ: "<<rq.m_iShardIndex
+			<<" ԷƬ: "<<rq.m_iShardCount<<" Ƭ: "<<moShardAddr.size());
+	}
+	CAutoLock lock(moSection);
+	moPeerFd.insert(fd);
+	TRACE(1, "CDCSShard::OnPeerLogin Ƭ롣Ƭ: "<<rq.m_iShardIndex<<" fd = "<<fd);
+}
+
+void CDCSShard::DealHallDelta(int fd, const char *buffer, int length)
+{
+	stru_DCS_DNS_HALL_DELTA loDelta;
+	if(0 != loDelta.UnPack(buffer, length))
+	{
+		TRACE(1, "CDCSShard::DealHallDelta UnPack ");
+		return;
+	}
+	uint64 lui64DnsKey = MakeDnsKey(loDelta.m_iDnsIp, loDelta.m_iDnsId);
+	//ڱƬҪתƬĴ
+	std::map<int, std::vector<uint16> > loRelay;
+	std::map<int, int> loRelayFd;
+	{
+		CAutoLock lock(moSection);
+		bool lbFromPeer = moPeerFd.count(fd) > 0;
+		if(loDelta.m_iReset)
+		{
+			ClearDnsHall(lui64DnsKey);
+		}
+		for(uint16 i = 0; i < loDelta.m_iCount; ++i)
+		{
+			uint32 liHallId = loDelta.m_iHallId[i];
+			int liOwner = moRing.GetNode(liHallId);
+			if(!lbFromPeer && liOwner != miSelf && mbPeerAlive[liOwner])
+			{
+				loRelay[liOwner].push_back(i);
+				continue;
+			}
+			if(DCS_HALL_DELTA_LOGIN == loDelta.m_iOp[i])
+			{
+				moHallDns[liHallId] = lui64DnsKey;
+			}
+			else
+			{
+				std::map<uint32, uint64>::iterator it = moHallDns.find(liHallId);
+				if(it != moHallDns.end() && it->second == lui64DnsKey)
+				{
+					moHallDns.erase(it);
+				}
+			}
+		}
+		for(std::map<int, std::vector<uint16> >::iterator it = loRelay.begin(); it != loRelay.end(); ++it)
+		{
+			loRelayFd[it->first] = GetPeerFd(it->first);
+		}
+	}
+
+	for(std::map<int, std::vector<uint16> >::iterator it = loRelay.begin(); it != loRelay.end(); ++it)
+	{
+		stru_DCS_DNS_HALL_DELTA loRelayDelta;
+		loRelayDelta.m_iDnsIp = loDelta.m_iDnsIp;
+		loRelayDelta.m_iDnsId = loDelta.m_iDnsId;
+		std::vector<uint16> &loIndex = it->second;
+		for(unsigned int i = 0; i < loIndex.size(); ++i)
+		{
+			loRelayDelta.m_iHallId[i] = loDelta.m_iHallId[loIndex[i]];
+			loRelayDelta.m_iOp[i] = loDelta.m_iOp[loIndex[i]];
+		}
+		loRelayDelta.m_iCount = loIndex.size();
+		char lszBuffer[DCS_DNS_BUFFER_LEN] = {0};
+		int liLen = loRelayDelta.Pack(lszBuffer, DCS_DNS_BUFFER_LEN);
+		if(liLen > 0 && loRelayFd[it->first] >= 0)
+		{
+			m_pServer->SendData(loRelayFd[it->first], lszBuffer, liLen);
+		}
+	}
+}
+
+void CDCSShard::DispatchMessage(int fd, const char *buffer, int length)
+{
+	uint32 liTargetNode = 0;
+	if(!GetTargetNode(buffer, length, liTargetNode))
+	{
+		Broadcast(buffer, length);
+		return;
+	}
+	if(liTargetNode != 0)
+	{
+		int liSendFd = -1;
+		bool lbRelay = false;
+		{
+			CAutoLock lock(moSection);
+			int liOwner = moRing.GetNode(liTargetNode);
+			if(liOwner != miSelf && mbPeerAlive[liOwner] && 0 == moPeerFd.count(fd))
+			{
+				liSendFd = GetPeerFd(liOwner);
+				lbRelay = true;
+			}
+			else
+			{
+				std::map<uint32, uint64>::iterator it = moHallDns.find(liTargetNode);
+				if(it != moHallDns.end())
+				{
+					std::map<uint64, int>::iterator iter = moDnsFd.find(it->second);
+					if(iter != moDnsFd.end())
+					{
+						liSendFd = iter->second;
+					}
+				}
+			}
+		}
+		if(liSendFd >= 0 && m_pServer->SendData(liSendFd, buffer, length))
+		{
+			__sync_fetch_and_add(lbRelay ? &mui64RelayCount : &mui64UnicastCount, 1);
+			return;
+		}
+		//ûͬDNSնϿ˻ع㲥
+		__sync_fetch_and_add(&mui64MissCount, 1);
+	}
+	Broadcast(buffer, length);
+}
+
+bool CDCSShard::GetTargetNode(const char *buffer, int length, uint32 &aiTargetNode)
+{
+	//ֶ˳ͬstru_DCS_DNS_MESSAGEstru_DNS_CRS_MESSAGESerialize
+	try
+	{
+		CStandardSerialize loSerialize((char*)buffer, length, CStandardSerialize::LOAD);
+		uint16 lui16Type = 0;
+		uint32 liValue = 0;
+		uint16 lui16DataLen = 0;
+		loSerialize.Serialize(lui16Type);
+		if(lui16Type != PACK_DCS_DNS_MESSAGE)
+		{
+			return false;
+		}
+		loSerialize.Serialize(liValue);
+		loSerialize.Serialize(liValue);
+		loSerialize.Serialize(lui16DataLen);
+		if(lui16DataLen > length - loSerialize.getDataLen())
+		{
+			return false;
+		}
+		loSerialize.Serialize(lui16Type);
+		if(lui16Type != PACK_DNS_CRS_MESSAGE)
+		{
+			return false;
+		}
+		//m_i32NodeId m_i32GroupId m_i32TargetNode
+		loSerialize.Serialize(liValue);
+		loSerialize.Serialize(liValue);
+		loSerialize.Serialize(aiTargetNode);
+		return true;
+	}
+	catch(...)
+	{
+		return false;
+	}
+}
+
+void CDCSShard::ClearDnsHall(uint64 aiDnsKey)
+{
+	std::map<uint32, uint64>::iterator it = moHallDns.begin();
+	while(it != moHallDns.end())
+	{
+		if(it->second == aiDnsKey)
+		{
+			moHallDns.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+int CDCSShard::GetPeerFd(int aiShard)
+{
+	if(aiShard < 0 || aiShard >= (int)moPeerSocket.size() || NULL == moPeerSocket[aiShard]
+		|| !mbPeerAlive[aiShard])
+	{
+		return -1;
+	}
+	return moPeerSocket[aiShard]->miSocket;
+}
+
+void CDCSShard::Broadcast(const char *buffer, int length)
+{
+	__sync_fetch_and_add(&mui64BroadcastCount, 1);
+	STRU_BROADCAST_STAT loStat;
+	if(moShardAddr.size() > 1)
+	{
+		//Ƭ֮ҲͬһӦֻDNS
+		std::vector<int> loFdList;
+		{
+			CAutoLock lock(moSection);
+			for(std::map<int, uint64>::iterator it = moFdDns.begin(); it != moFdDns.end(); ++it)
+			{
+				loFdList.push_back(it->first);
+			}
+		}
+		m_pServer->Broadcast(loFdList, buffer, length, &loStat);
+	}
+	else
+	{
+		m_pServer->SendAllData(buffer, length, &loStat);
+	}
+	if(loStat.miSkipCount > 0)
+	{
+		TRACE(1, "CDCSShard::Broadcast ӡĿ: "<<loStat.miTargetCount
+			<<" : "<<loStat.miSkipCount<<" ʱ(us): "<<loStat.mui64CostTime);
+	}
+}
@@ -0,0 +1,75 @@
+#ifndef _DCS_SHARD_H_
+#define _DCS_SHARD_H_
+
+#include "include.h"
+#include "CriticalSection.h"
+#include "ConsistentHash.h"
+#include "NetEpollGroup.h"
+#include "DCSConfig.h"
+#include <map>
+#include <set>
+
+//DCSƬ
+//IDһԹϣָƬDNSȫƬѷĳϢֱӽƬ
+//Ѵ¼˳֪ͨƬƬ¼ԼĴĸDNSϣϢDNS
+//鲻ʱ˻ԭĹ㲥
+//Ƭ֮以ӣյԼϢ仯(DNSƬʱ)תƬ
+//ƬҲʱڱƬƬ֮תݲתȦ
+class CDCSShard
+{
+public:
+	CDCSShard();
+	~CDCSShard();
+
+	//Ƭ֮ҲapServer
+	bool Init(CDCSConfig *apConfig, CNetEpollGroup *apServer);
+	//ӻûϵķƬʱ
+	void CheckPeer();
+	void Dump();
+
+	//ӶϿtrueʾǷƬ֮
+	bool OnClose(int fd);
+	void OnDnsLogin(int fd, uint32 aiDnsIp, uint32 aiDnsId);
+	void OnPeerLogin(int fd, const char *buffer, int length);
+	void DealHallDelta(int fd, const char *buffer, int length);
+	//ĿתϢ㲥ȫDNS
+	void DispatchMessage(int fd, const char *buffer, int length);
+
+private:
+	inline static uint64 MakeDnsKey(uint32 aiDnsIp, uint32 aiDnsId)
+	{
+		return ((uint64)aiDnsIp << 32) | aiDnsId;
+	}
+	//ֻϢͷĿϢ
+	static bool GetTargetNode(const char *buffer, int length, uint32 &aiTargetNode);
+	//ɾĳDNSȫ÷
+	void ClearDnsHall(uint64 aiDnsKey);
+	//ƬfdûϷ-1÷
+	int GetPeerFd(int aiShard);
+	void Broadcast(const char *buffer, int length);
+
+private:
+	CDCSConfig *m_pDcsConfig;
+	CNetEpollGroup *m_pServer;
+	CConsistentHash moRing;
+	std::vector<STRU_NODE_ADDR> moShardAddr;
+	int miSelf;
+	//ƬsocketԼλΪNULL
+	std::vector<CNetSocket*> moPeerSocket;
+	bool mbPeerAlive[DEF_MAX_CLUSTER_NODE];
+	//Ƭfd
+	std::set<int> moPeerFd;
+	//DNS(ip<<32|ID) <-> fd
+	std::map<uint64, int> moDnsFd;
+	std::map<int, uint64> moFdDns;
+	//ƬĴ -> DNS
+	std::map<uint32, uint64> moHallDns;
+	CCriticalSection moSection;
+	//ͳ
+	volatile uint64 mui64UnicastCount;
+	volatile uint64 mui64RelayCount;
+	volatile uint64 mui64BroadcastCount;
+	volatile uint64 mui64MissCount;
+};
+
+#endif //_DCS_SHARD_H_
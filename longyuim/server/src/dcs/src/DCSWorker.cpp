@@ -1,10 +1,22 @@
 
 
 #include "DCSWorker.h"
+#include "dcs_dns.h"
+
+static uint64 GetMicroTime()
+{
+	struct timespec loTime;
+	clock_gettime(CLOCK_MONOTONIC, &loTime);
+	return (uint64)loTime.tv_sec * 1000000 + loTime.tv_nsec / 1000;
+}
 
 CDCSWorker::CDCSWorker()
 {
 	m_pDcsConfig = NULL;
+	mui64BatchCount = 0;
+	mui64BatchMsgCount = 0;
+	mpDealWorker = NULL;
+	miDealThreadCount = 0;
 	uint64 time_now = CTimeBase::get_current_time();
 	m_i64LastDumpTime = time_now;
 	m_i64LastLogTime = time_now;
@@ -15,6 +27,23 @@ CDCSWorker::~CDCSWorker()
 	m_ThreadManager.StopAll();
 	m_DcsServer.RecvFrom.disconnect(this);
 	m_DcsServer.OnErrorNotice.disconnect(this);
+	if(mpDealWorker != NULL)
+	{
+		STRU_DCS_DEAL_JOB loJob;
+		for(unsigned int i = 0; i < miDealThreadCount; ++i)
+		{
+			while(mpDealWorker[i].moQueue.Pop(loJob))
+			{
+				delete [] loJob.mpBuffer;
+			}
+			for(size_t j = 0; j < mpDealWorker[i].moOverflow.size(); ++j)
+			{
+				delete [] mpDealWorker[i].moOverflow[j].mpBuffer;
+			}
+		}
+		delete [] mpDealWorker;
+		mpDealWorker = NULL;
+	}
 }
 
 void CDCSWorker::SetConfig(CDCSConfig *apDcsConfig)
@@ -27,13 +56,13 @@ bool CDCSWorker::Init()
 {
 	m_DCSDealData.DealDataComplete.connect(this, &CDCSWorker::DealDataComplete);
 	bool lbBind = false;
-	unsigned short lusBindPort = m_pDcsConfig->server_port;
 	struct sockaddr_in addr;
 	addr.sin_addr.s_addr = htonl(m_pDcsConfig->server_ip);
 	for(int i = 0; i < m_pDcsConfig->max_bind_time;++i)
 	{
-		bool bRet = m_DcsListenFd.CreateSocket(inet_ntoa(addr.sin_addr), 
-			lusBindPort);
+		//ÿӦһsocketһӦʱʹSO_REUSEPORTں˷ַ
+		bool bRet = m_DcsServer.Init(inet_ntoa(addr.sin_addr), m_pDcsConfig->server_port,
+			m_pDcsConfig->reactor_thread_count);
 		if(bRet)
 		{
 			lbBind = true;
@@ -47,106 +76,180 @@ bool CDCSWorker::Init()
 		return false;
 	}
 
-	bool bRet = m_DcsListenFd.SetNoBlock();
-	if(!bRet)
+	m_DcsServer.RecvFrom.connect(this, &CDCSWorker::DealDnsData);
+	m_DcsServer.OnErrorNotice.connect(this, &CDCSWorker::OnDealErrorFd);
+
+	STRU_SEND_QUEUE_LIMIT loLimit;
+	loLimit.miMaxBytes = m_pDcsConfig->send_queue_max_bytes;
+	loLimit.miMaxCount = m_pDcsConfig->send_queue_max_count;
+	loLimit.moPolicy = (SEND_QUEUE_POLICY)m_pDcsConfig->send_queue_policy;
+	m_DcsServer.SetSendQueueLimit(loLimit);
+
+	if(!m_Shard.Init(m_pDcsConfig, &m_DcsServer))
 	{
-		m_DcsListenFd.Close();
-		TRACE(1, "CDCSWorker::Run ÷ʧܡ");
+		TRACE(1, "CDCSWorker::Init Ƭʼʧܡ");
 		return false;
 	}
-	bRet = m_DcsListenFd.Listen();
-	if(!bRet)
+
+	miDealThreadCount = m_pDcsConfig->deal_thread_count;
+	if(miDealThreadCount > DEF_MAX_DCS_DEAL_THREAD)
 	{
-		m_DcsListenFd.Close();
-		TRACE(1, "CDCSWorker::Run ˿ʧܡ");
-		return false;
+		miDealThreadCount = DEF_MAX_DCS_DEAL_THREAD;
+	}
+	if(miDealThreadCount > 0)
+	{
+		mpDealWorker = new STRU_DCS_DEAL_WORKER[miDealThreadCount];
+		for(unsigned int i = 0; i < miDealThreadCount; ++i)
+		{
+			if(!mpDealWorker[i].moQueue.Init(DEF_DCS_DEAL_QUEUE_SIZE) || !mpDealWorker[i].moNotify.Create())
+			{
+				TRACE(1, "CDCSWorker::Init ̶߳гʼʧܡ");
+				return false;
+			}
+		}
 	}
-	m_DcsListenFd.moNetStat = TCP_LISTEN;
-	m_DcsListenFd.mbListenSocket = true;
+	return true;
+}
 
-	bRet = m_DcsServer.Init();
-	if(!bRet)
+bool CDCSWorker::StartDealThread()
+{
+	if(0 == miDealThreadCount)
 	{
-		TRACE(1, "CDCSWorker::Run EPOLLʼʧܡ");
-		return false;
+		return true;
 	}
-	bRet = m_DcsServer.Addfd(&m_DcsListenFd);
-	if(!bRet)
+	unsigned int liCount = m_ThreadManager.Start(DealThread, this, miDealThreadCount, "dcs_deal");
+	if(liCount != miDealThreadCount)
 	{
-		TRACE(1, "CDCSWorker::Run Ӽ˿ڵEPOLLʧܡ");
-		m_DcsServer.Destroy();
+		TRACE(1, "CDCSWorker::StartDealThread ߳ʧܡ: "<<liCount
+			<<" Ҫ: "<<miDealThreadCount);
 		return false;
 	}
-
-	m_DcsServer.RecvFrom.connect(this, &CDCSWorker::DealDnsData);
-	m_DcsServer.OnErrorNotice.connect(this, &CDCSWorker::OnDealErrorFd);
-
+	TRACE(1, "CDCSWorker::StartDealThread ߳: "<<miDealThreadCount);
 	return true;
 }
 
-unsigned int CDCSWorker::DealSendEvent(STRU_THREAD_CONTEXT& apContext)
+unsigned int CDCSWorker::DealThread(STRU_THREAD_CONTEXT& apContext)
 {
 	try
 	{
-		CDCSWorker* p = reinterpret_cast<CDCSWorker*>(apContext.mpWorkContext);
+		CDCSWorker *p = reinterpret_cast<CDCSWorker*>(apContext.mpWorkContext);
 		ASSERT(p != NULL);
-		for(;;)
+		STRU_DCS_DEAL_WORKER &loWorker = p->mpDealWorker[apContext.moThreadStat.GetThreadIndex()];
+		STRU_DCS_DEAL_JOB lszJob[DEF_DCS_DEAL_BATCH];
+		while(!p->m_ThreadManager.IsStop())
 		{
-			bool bSendEmpty = true;
-			bSendEmpty = p->m_DcsServer.SendData();
-			if(bSendEmpty)
+			if(loWorker.miOverflow)
+			{
+				p->DealOverflow(loWorker);
+				continue;
+			}
+			unsigned int liCount = loWorker.moQueue.PopBatch(lszJob, DEF_DCS_DEAL_BATCH);
+			if(0 == liCount)
 			{
-				p->m_DcsServer.WaitSendEvent();
+				loWorker.moNotify.BeginWait();
+				if(!loWorker.moQueue.IsEmpty())
+				{
+					loWorker.moNotify.EndWait();
+					continue;
+				}
+				loWorker.moNotify.Wait(DEF_DCS_DEAL_WAIT_TIMEOUT);
+				continue;
 			}
+			p->DealJob(loWorker, lszJob, liCount);
 		}
 	}
 	catch (...)
 	{
-		TRACE(1, "CDCSWorker::DealSendEvent 쳣");
+		TRACE(1, "CDCSWorker::DealThread 쳣");
 	}
 	return 0;
 }
 
-unsigned int CDCSWorker::DealRecvEvent(STRU_THREAD_CONTEXT& apContext)
+void CDCSWorker::DealJob(STRU_DCS_DEAL_WORKER &aoWorker, STRU_DCS_DEAL_JOB *apJob, unsigned int aiCount)
 {
-	try
+	unsigned int liDepth = aiCount + aoWorker.moQueue.GetCount();
+	uint64 lui64WaitTime = 0;
+	uint64 lui64MaxWaitTime = 0;
+	uint64 lui64MaxDealTime = 0;
+	uint64 lui64Begin = GetMicroTime();
+	uint64 lui64Start = lui64Begin;
+	for(unsigned int i = 0; i < aiCount; ++i)
 	{
-		CDCSWorker* p = reinterpret_cast<CDCSWorker*>(apContext.mpWorkContext);
-		ASSERT(p != NULL);
-		for(;;)
+		STRU_DCS_DEAL_JOB &loJob = apJob[i];
+		uint64 lui64Wait = lui64Start > loJob.mui64PostTime ? lui64Start - loJob.mui64PostTime : 0;
+		lui64WaitTime += lui64Wait;
+		if(lui64Wait > lui64MaxWaitTime)
 		{
-			bool bRecvEmpty = true;
-			bRecvEmpty = p->m_DcsServer.RecvData();
-			if( bRecvEmpty)
-			{
-				p->m_DcsServer.WaitRecvEvent();
-			}
+			lui64MaxWaitTime = lui64Wait;
+		}
+		if(NULL == loJob.mpBuffer)
+		{
+			m_Shard.OnClose(loJob.miFd);
+		}
+		else
+		{
+			DealPacket(loJob.miFd, loJob.mpBuffer, loJob.miLength);
+			delete [] loJob.mpBuffer;
+		}
+		uint64 lui64End = GetMicroTime();
+		if(lui64End - lui64Start > lui64MaxDealTime)
+		{
+			lui64MaxDealTime = lui64End - lui64Start;
 		}
+		lui64Start = lui64End;
 	}
-	catch (...)
+
+	CAutoLock lock(aoWorker.moStatSection);
+	aoWorker.mui64DealCount += aiCount;
+	aoWorker.mui64WaitTime += lui64WaitTime;
+	aoWorker.mui64DealTime += lui64Start - lui64Begin;
+	if(lui64MaxWaitTime > aoWorker.mui64MaxWaitTime)
 	{
-		TRACE(1, "CDCSWorker::DealRecvEvent 쳣");
+		aoWorker.mui64MaxWaitTime = lui64MaxWaitTime;
+	}
+	if(lui64MaxDealTime > aoWorker.mui64MaxDealTime)
+	{
+		aoWorker.mui64MaxDealTime = lui64MaxDealTime;
+	}
+	if(liDepth > aoWorker.miMaxDepth)
+	{
+		aoWorker.miMaxDepth = liDepth;
 	}
-	return 0;
 }
 
-unsigned int CDCSWorker::CheckNetEvent(STRU_THREAD_CONTEXT& apContext)
+void CDCSWorker::DealOverflow(STRU_DCS_DEAL_WORKER &aoWorker)
 {
-	try
+	std::vector<STRU_DCS_DEAL_JOB> loJob;
+	std::vector<int> loPausedFd;
 	{
-		CDCSWorker* p = reinterpret_cast<CDCSWorker*>(apContext.mpWorkContext);
-		ASSERT(p != NULL);
-		for(;;)
+		CAutoLock lock(aoWorker.moOverflowSection);
+		loJob.swap(aoWorker.moOverflow);
+		loPausedFd.swap(aoWorker.moPausedFd);
+		//ȡպ־֮ǰȻݴ棬һ
+		if(loJob.empty())
 		{
-			int nRet = p->m_DcsServer.CheckEpollEvent(-1);
-			p->m_DcsServer.ProcessEpollEvent(nRet);
+			aoWorker.miOverflow = 0;
 		}
 	}
-	catch (...)
+	//Ķһݴ֮ǰ룬ȴ
+	//ռλûûдʱPopBatch0Ҫȵ
+	STRU_DCS_DEAL_JOB lszJob[DEF_DCS_DEAL_BATCH];
+	while(!aoWorker.moQueue.IsEmpty())
 	{
-		TRACE(1, "CDCSWorker::CheckNetEvent 쳣");
+		unsigned int liCount = aoWorker.moQueue.PopBatch(lszJob, DEF_DCS_DEAL_BATCH);
+		if(liCount > 0)
+		{
+			DealJob(aoWorker, lszJob, liCount);
+		}
+	}
+	if(!loJob.empty())
+	{
+		DealJob(aoWorker, &loJob[0], (unsigned int)loJob.size());
+	}
+	for(size_t i = 0; i < loPausedFd.size(); ++i)
+	{
+		m_DcsServer.ResumeRecv(loPausedFd[i]);
 	}
-	return 0;
 }
 
 void CDCSWorker::Run()
@@ -161,21 +264,15 @@ void CDCSWorker::Run()
 			return;
 		}
 
-		if (0 == m_ThreadManager.Start(CheckNetEvent, this, 1, "dcs_check_net_event")) 
-		{
-			TRACE(1,"CDCSWorker::Run: ¼߳ʧܣ˳");
-			return;
-		}
-
-		if (0 == m_ThreadManager.Start(DealSendEvent, this, 1, "dcs_send_data")) 
+		//߳ڽ߳
+		if(!StartDealThread())
 		{
-			TRACE(1,"CDCSWorker::Run: ݷ߳ʧܣ˳");
 			return;
 		}
 
-		if (0 == m_ThreadManager.Start(DealRecvEvent, this, 1, "dcs_recv_data")) 
+		if(!m_DcsServer.Start())
 		{
-			TRACE(1,"CDCSWorker::Run: ݽ߳ʧܣ˳");
+			TRACE(1,"CDCSWorker::Run: 練Ӧ߳ʧܣ˳");
 			return;
 		}
 
@@ -185,8 +282,6 @@ void CDCSWorker::Run()
 			usleep(1000*1000);
 		}
 
-		m_DcsServer.Delfd(m_DcsListenFd.miSocket);
-		m_DcsListenFd.Close();
 		m_DcsServer.Destroy();
 	}
 	catch (...)
@@ -197,7 +292,44 @@ void CDCSWorker::Run()
 
 void CDCSWorker::Dump()
 {
-
+	m_DcsServer.Dump();
+	m_Shard.Dump();
+	TRACE(2, "CDCSWorker::Dump յ: "<<mui64BatchCount<<" еϢ: "<<mui64BatchMsgCount);
+	for(unsigned int i = 0; i < miDealThreadCount; ++i)
+	{
+		STRU_DCS_DEAL_WORKER &loWorker = mpDealWorker[i];
+		uint64 lui64DealCount = 0;
+		uint64 lui64WaitTime = 0;
+		uint64 lui64MaxWaitTime = 0;
+		uint64 lui64DealTime = 0;
+		uint64 lui64MaxDealTime = 0;
+		unsigned int liMaxDepth = 0;
+		{
+			CAutoLock lock(loWorker.moStatSection);
+			lui64DealCount = loWorker.mui64DealCount;
+			lui64WaitTime = loWorker.mui64WaitTime;
+			lui64MaxWaitTime = loWorker.mui64MaxWaitTime;
+			lui64DealTime = loWorker.mui64DealTime;
+			lui64MaxDealTime = loWorker.mui64MaxDealTime;
+			liMaxDepth = loWorker.miMaxDepth;
+			loWorker.mui64DealCount = 0;
+			loWorker.mui64WaitTime = 0;
+			loWorker.mui64MaxWaitTime = 0;
+			loWorker.mui64DealTime = 0;
+			loWorker.mui64MaxDealTime = 0;
+			loWorker.miMaxDepth = 0;
+		}
+		uint64 lui64Divisor = lui64DealCount > 0 ? lui64DealCount : 1;
+		TRACE(2, "CDCSWorker::Dump ߳: "<<i
+			<<" : "<<lui64DealCount
+			<<" г: "<<loWorker.moQueue.GetCount()
+			<<" г: "<<liMaxDepth
+			<<" ƽŶ(us): "<<lui64WaitTime / lui64Divisor
+			<<" Ŷ(us): "<<lui64MaxWaitTime
+			<<" ƽ(us): "<<lui64DealTime / lui64Divisor
+			<<" (us): "<<lui64MaxDealTime
+			<<" ݴ: "<<__sync_fetch_and_and(&loWorker.mui64FullCount, 0));
+	}
 }
 
 void CDCSWorker::TimeOutWork()
@@ -209,6 +341,8 @@ void CDCSWorker::TimeOutWork()
 		m_i64LastDumpTime = time_now;
 	}
 
+	m_Shard.CheckPeer();
+
 	if(time_now > m_i64LastLogTime + m_pDcsConfig->log_file_update_time * 1000)
 	{
 		unsigned int process_id = CCommon::GetProcessId();
@@ -241,36 +375,108 @@ void CDCSWorker::TimeOutWork()
 void CDCSWorker::OnDealErrorFd(int fd)
 {
 	TRACE(1, "CDCSWorker::OnDealErrorFd fd = "<<fd);
+	if(0 == miDealThreadCount)
+	{
+		m_Shard.OnClose(fd);
+		return;
+	}
+	//յİ֮صʱͬݴ棬ȴ
+	STRU_DCS_DEAL_JOB loJob;
+	loJob.miFd = fd;
+	loJob.miLength = 0;
+	loJob.mpBuffer = NULL;
+	loJob.mui64PostTime = GetMicroTime();
+	PushDeal(GetDealWorker(fd), loJob, false);
 }
 
 void CDCSWorker::DealDnsData(int fd, char *buffer, int length)
+{
+	if(0 == miDealThreadCount)
+	{
+		DealPacket(fd, buffer, length);
+	}
+	else
+	{
+		PostDeal(fd, buffer, length);
+	}
+}
+
+void CDCSWorker::PostDeal(int fd, const char *buffer, int length)
+{
+	STRU_DCS_DEAL_JOB loJob;
+	loJob.miFd = fd;
+	loJob.miLength = length;
+	//һֽڱհĩβ0Լ
+	loJob.mpBuffer = new char[length + 1];
+	memcpy(loJob.mpBuffer, buffer, length);
+	loJob.mpBuffer[length] = 0;
+	loJob.mui64PostTime = GetMicroTime();
+
+	PushDeal(GetDealWorker(fd), loJob, true);
+}
+
+void CDCSWorker::PushDeal(STRU_DCS_DEAL_WORKER &aoWorker, const STRU_DCS_DEAL_JOB &aoJob, bool abPause)
+{
+	//ݴʱֱӷŶУԽͬһݴİ
+	if(0 == aoWorker.miOverflow && aoWorker.moQueue.Push(aoJob))
+	{
+		aoWorker.moNotify.Notify();
+		return;
+	}
+	//ܶҲԽǰİݴյİͬʱͣӵĽգ
+	//ѹں˻TCPöԶ˷̴߳ݴָ
+	//ͣڵǼ֮ǰָ̻߳ʱһѾͣ
+	bool lbPaused = abPause && m_DcsServer.PauseRecv(aoJob.miFd);
+	{
+		CAutoLock lock(aoWorker.moOverflowSection);
+		aoWorker.moOverflow.push_back(aoJob);
+		if(lbPaused && (aoWorker.moPausedFd.empty() || aoWorker.moPausedFd.back() != aoJob.miFd))
+		{
+			aoWorker.moPausedFd.push_back(aoJob.miFd);
+		}
+		aoWorker.miOverflow = 1;
+	}
+	__sync_fetch_and_add(&aoWorker.mui64FullCount, 1);
+	aoWorker.moNotify.Notify();
+}
+
+void CDCSWorker::DealPacket(int fd, char *buffer, int length)
 {
 	char rtn[DEF_BUFFER_LEN];
 	memset(rtn, 0, DEF_BUFFER_LEN);
 	uint32 rtn_len = 0;
-	uint32 rtn_del = m_DCSDealData.DCSDealData(buffer, length, rtn, rtn_len);
-	switch(rtn_del)
+	uint16 lui16type = 0;
+	if(length >= (int)sizeof(uint16))
 	{
-	case 0:
+		memcpy(&lui16type, buffer, sizeof(uint16));
+	}
+	switch(lui16type)
+	{
+	case PACK_DCS_DNS_HALL_DELTA:
 		{
-			break;
+			m_Shard.DealHallDelta(fd, buffer, length);
+			return;
 		}
-	case 1:
+	case PACK_DCS_PEER_LOGIN_RQ:
 		{
-			m_DcsServer.SendData(fd, rtn, rtn_len);
-			break;
+			m_Shard.OnPeerLogin(fd, buffer, length);
+			return;
 		}
-	case 2:
+	case PACK_DCS_DNS_LOGIN_RQ:
 		{
-			m_DcsServer.SendAllData(rtn, rtn_len);
+			//DNSӣӦDCSDealData
+			stru_DCS_DNS_LOGIN_RQ rq;
+			if(0 == rq.UnPack(buffer, length))
+			{
+				m_Shard.OnDnsLogin(fd, rq.m_iDnsIp, rq.m_iDnsId);
+			}
 			break;
 		}
 	default:
-		{
-			TRACE(1, "CDCSWorker::DealRecvData δ֪ͣ͡"<<rtn_del);
-			break;
-		}
+		break;
 	}
+	uint32 rtn_del = m_DCSDealData.DCSDealData(buffer, length, rtn, rtn_len);
+	DealDataComplete(rtn_del, fd, rtn, rtn_len);
 }
 
 void CDCSWorker::DealDataComplete(int rtn_op, int fd, CBasePack *pack)
@@ -311,4 +517,47 @@ void CDCSWorker::DealDataComplete(int rtn_op, int fd, CBasePack *pack)
 		}
 	}
 	return;
+}
+
+void CDCSWorker::DealDataComplete(int rtn_op, int fd, const char *apData, uint32 aiLength)
+{
+	//ڴ߳ʱֻǷŽӵķбӦѵķ̷߳
+	switch(rtn_op)
+	{
+	case 0:
+		{
+			break;
+		}
+	case 1:
+		{
+			m_DcsServer.SendData(fd, apData, aiLength);
+			break;
+		}
+	case 2:
+		{
+			m_Shard.DispatchMessage(fd, apData, aiLength);
+			break;
+		}
+	case 3:
+		{
+			//Ϣ𿪺͵Ϣһַ
+			uint32 liOffset = 0;
+			const char *lpItem = NULL;
+			uint16 liItemLen = 0;
+			uint64 liCount = 0;
+			while(CDCSDealData::GetBatchItem(apData, aiLength, liOffset, lpItem, liItemLen))
+			{
+				m_Shard.DispatchMessage(fd, lpItem, liItemLen);
+				++liCount;
+			}
+			__sync_fetch_and_add(&mui64BatchCount, 1);
+			__sync_fetch_and_add(&mui64BatchMsgCount, liCount);
+			break;
+		}
+	default:
+		{
+			TRACE(1, "CDCSWorker::DealRecvData δ֪ͣ͡"<<rtn_op);
+			break;
+		}
+	}
 }
\ No newline at end of file
@@ -6,9 +6,63 @@
 #include "Time.h"
 #include "FileStream.h"
 #include "DCSConfig.h"
-#include "NetEpoll.h"
+#include "NetEpollGroup.h"
 #include "DCSDealData.h"
 #include "ThreadGroup.h"
+#include "RingQueue.h"
+#include "DCSShard.h"
+
+#define DEF_MAX_DCS_DEAL_THREAD 64
+#define DEF_DCS_DEAL_QUEUE_SIZE 8192
+//߳һȡİ
+#define DEF_DCS_DEAL_BATCH 64
+//߳ûʱȴʱ䣬
+#define DEF_DCS_DEAL_WAIT_TIMEOUT 100
+
+//̵߳̽߳һmpBufferΪNULLʾӶϿ
+struct STRU_DCS_DEAL_JOB
+{
+	int miFd;
+	int miLength;
+	char *mpBuffer;
+	//еʱ䣬΢
+	uint64 mui64PostTime;
+};
+
+//̣߳ӦѵĽ߳
+struct STRU_DCS_DEAL_WORKER
+{
+	STRU_DCS_DEAL_WORKER()
+	{
+		mui64DealCount = 0;
+		mui64WaitTime = 0;
+		mui64MaxWaitTime = 0;
+		mui64DealTime = 0;
+		mui64MaxDealTime = 0;
+		miMaxDepth = 0;
+		miOverflow = 0;
+		mui64FullCount = 0;
+	}
+	CMpscRingQueue<STRU_DCS_DEAL_JOB> moQueue;
+	CQueueNotify moNotify;
+	//ͳɴ߳moStatSectionۼӣDumpʱȡ
+	CCriticalSection moStatSection;
+	uint64 mui64DealCount;
+	uint64 mui64WaitTime;
+	uint64 mui64MaxWaitTime;
+	uint64 mui64DealTime;
+	uint64 mui64MaxDealTime;
+	unsigned int miMaxDepth;
+	//İͶϿ֪ͨ˳ݴ棬ݴʱҲԽͬһǰİ
+	CCriticalSection moOverflowSection;
+	std::vector<STRU_DCS_DEAL_JOB> moOverflow;
+	//ݴʱͣ˽յӣ̴߳ݴָ
+	std::vector<int> moPausedFd;
+	//0ʾݴ棬moOverflowSection޸
+	volatile int miOverflow;
+	//ݴĸ
+	volatile uint64 mui64FullCount;
+};
 
 class CDCSWorker : public sigslot::has_slots<>
 {
@@ -18,27 +72,48 @@ public:
 
 	 void SetConfig(CDCSConfig *apDcsConfig);
 	 void Run();
-
-	 static unsigned int CheckNetEvent(STRU_THREAD_CONTEXT& apContext);
-	 static unsigned int DealSendEvent(STRU_THREAD_CONTEXT& apContext);
-	 static unsigned int DealRecvEvent(STRU_THREAD_CONTEXT& apContext);
+	 static unsigned int DealThread(STRU_THREAD_CONTEXT& apContext);
 
 private:
 	bool Init();
+	bool StartDealThread();
 	void Dump();
 	void TimeOutWork();
+	//̵߳Ļصд߳ʱfd̶Ĵ̣߳ͬһӵİյ˳
 	void DealDnsData(int fd, char *buffer, int length);
+	//DealDataComplete
+	void DealPacket(int fd, char *buffer, int length);
+	//̵߳ãʱݴ沢ͣӵĽգȴ
+	void PostDeal(int fd, const char *buffer, int length);
+	//봦̵߳ĶУݴʱݴ棬abPauseΪtrueʱͬʱͣӵĽ
+	void PushDeal(STRU_DCS_DEAL_WORKER &aoWorker, const STRU_DCS_DEAL_JOB &aoJob, bool abPause);
+	//̵߳ãһϿ֪ͨۼͳ
+	void DealJob(STRU_DCS_DEAL_WORKER &aoWorker, STRU_DCS_DEAL_JOB *apJob, unsigned int aiCount);
+	//̵߳ãȴٴݴģȻָͣ
+	void DealOverflow(STRU_DCS_DEAL_WORKER &aoWorker);
 	void DispatchData(const char *buffer, const uint32 length);
 	void DealDataComplete(int rtn_op, int fd, CBasePack* pack);
+	//rtn_opͬCDCSDealData::DCSDealDataķֵ
+	void DealDataComplete(int rtn_op, int fd, const char *apData, uint32 aiLength);
 	void OnDealErrorFd(int fd);
+	inline STRU_DCS_DEAL_WORKER& GetDealWorker(int fd)
+	{
+		return mpDealWorker[(unsigned int)fd % miDealThreadCount];
+	}
 private:
 	CDCSConfig *m_pDcsConfig;
 	uint64 m_i64LastDumpTime;
 	uint64 m_i64LastLogTime;
-	CNetEpoll m_DcsServer;
-	CNetSocket m_DcsListenFd;
+	CNetEpollGroup m_DcsServer;
 	CDCSDealData m_DCSDealData;
+	CDCSShard m_Shard;
 	CThreadGroup m_ThreadManager;
+	//յеϢ߳ۼ
+	volatile uint64 mui64BatchCount;
+	volatile uint64 mui64BatchMsgCount;
+	//̣߳Ϊ0ʱڽֱ߳Ӵ
+	STRU_DCS_DEAL_WORKER *mpDealWorker;
+	unsigned int miDealThreadCount;
 };
 
 #endif//_DCS_WORKER_H_
@@ -13,8 +13,21 @@
 #define PACK_DCS_DNS_LOGOUT_RQ		PACK_DCS_DNS_BASE+5
 #define PACK_DCS_DNS_LOGOUT_RS		PACK_DCS_DNS_BASE+6
 #define PACK_DCS_DNS_MESSAGE		PACK_DCS_DNS_BASE+7
+//DNS֪ͨƬ¼˳Ƭ֮Ҳת
+#define PACK_DCS_DNS_HALL_DELTA		PACK_DCS_DNS_BASE+8
+//Ƭ֮佨Ӻĵһ
+#define PACK_DCS_PEER_LOGIN_RQ		PACK_DCS_DNS_BASE+9
+//DNSѷͬһƬĶϢϳһ
+#define PACK_DCS_DNS_BATCH			PACK_DCS_DNS_BASE+10
 
 #define DCS_DNS_BUFFER_LEN			(3000-32)
+//仯
+#define DCS_HALL_DELTA_LOGOUT		0
+#define DCS_HALL_DELTA_LOGIN		1
+//һ仯Ĵ
+#define DCS_HALL_DELTA_MAX_COUNT	400
+//ȥ͡IPID14ֽںDCS_DNS_BUFFER_LEN
+#define DCS_DNS_BATCH_BUFFER_LEN	(DCS_DNS_BUFFER_LEN-14)
 #pragma  pack(1)
 struct stru_DCS_DNS_LOGIN_RQ : public CBasePack
 {
@@ -146,6 +159,71 @@ struct stru_DCS_DNS_MESSAGE: public CBasePack
 	virtual int Serialize(CStandardSerialize &aoStandardSerialize);
 };
 
+struct stru_DCS_DNS_HALL_DELTA: public CBasePack
+{
+	uint32 m_iDnsIp;
+	uint32 m_iDnsId;
+	//1ʾȫͬĵһƬɾDNSԭеĴ
+	uint8 m_iReset;
+	uint16 m_iCount;
+	uint32 m_iHallId[DCS_HALL_DELTA_MAX_COUNT];
+	uint8 m_iOp[DCS_HALL_DELTA_MAX_COUNT];
+	stru_DCS_DNS_HALL_DELTA()
+		:m_iDnsIp(0)
+		,m_iDnsId(0)
+		,m_iReset(0)
+		,m_iCount(0)
+	{
+		mui16PackType = PACK_DCS_DNS_HALL_DELTA;
+	}
+	virtual ~stru_DCS_DNS_HALL_DELTA()
+	{
+
+	}
+	virtual int Serialize(CStandardSerialize &aoStandardSerialize);
+};
+
+struct stru_DCS_PEER_LOGIN_RQ: public CBasePack
+{
+	uint32 m_iShardIndex;
+	uint32 m_iShardCount;
+	stru_DCS_PEER_LOGIN_RQ()
+		:m_iShardIndex(0)
+		,m_iShardCount(0)
+	{
+		mui16PackType = PACK_DCS_PEER_LOGIN_RQ;
+	}
+	virtual ~stru_DCS_PEER_LOGIN_RQ()
+	{
+
+	}
+	virtual int Serialize(CStandardSerialize &aoStandardSerialize);
+};
+
+//m_cDataBuf uint16 + ðPACK_DCS_DNS_MESSAGE
+struct stru_DCS_DNS_BATCH: public CBasePack
+{
+	uint32 m_iDnsIp;
+	uint32 m_iDnsId;
+	uint16 m_iCount;
+	uint16 m_iDatalen;
+	char  m_cDataBuf[DCS_DNS_BATCH_BUFFER_LEN];
+	stru_DCS_DNS_BATCH()
+		:m_iDnsIp(0)
+		,m_iDnsId(0)
+		,m_iCount(0)
+		,m_iDatalen(0)
+	{
+		mui16PackType = PACK_DCS_DNS_BATCH;
+		memset(m_cDataBuf,0,DCS_DNS_BATCH_BUFFER_LEN);
+	}
+	virtual ~stru_DCS_DNS_BATCH()
+	{
+
+	}
+	virtual int Serialize(CStandardSerialize &aoStandardSerialize);
+};
+
 #pragma  pack()
 
 #endif //_DCS_DNS_H_
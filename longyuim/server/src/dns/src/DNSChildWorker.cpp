@@ -11,7 +11,8 @@ CDNSChildWorker::CDNSChildWorker()
 	m_i64LastKeepLive = time_now;
 	m_i64LastLogTime = time_now;
 	m_i64LastDumpTime = time_now;
-	m_i64LastCheckTimeOut = time_now;
+	memset(mbShardAlive, 0, sizeof(mbShardAlive));
+	moRouteTable.Init(CRS_DNS_TIMEOUT * 1000);
 }
 
 CDNSChildWorker::~CDNSChildWorker()
@@ -19,6 +20,13 @@ CDNSChildWorker::~CDNSChildWorker()
 	m_ThreadManager.StopAll();
 	m_DnsServer.RecvFrom.disconnect(this);
 	m_DnsServer.OnErrorNotice.disconnect(this);
+	for(unsigned int i = 0; i < moShardSocket.size(); ++i)
+	{
+		delete moShardSocket[i];
+		delete moShardBatch[i];
+	}
+	moShardSocket.clear();
+	moShardBatch.clear();
 }
 
 void CDNSChildWorker::SetDnsListenFd(CNetSocket *apDnsListenFd)
@@ -39,158 +47,165 @@ void CDNSChildWorker::SetConfig(CDNSConfig *apDnsConfig)
 
 bool CDNSChildWorker::InitDnsServer()
 {
-	bool bRet = m_DnsServer.Init();
+	//̴ļsocketעᵽ̵ÿӦ
+	bool bRet = m_DnsServer.InitShared(m_pDnsListenFd, m_pDnsConfig->reactor_thread_count);
 	if(!bRet)
 	{
 		TRACE(1, "CDNSChildWorker::Run EPOLLʼʧܡ");
 		return false;
 	}
-	bRet = m_DnsServer.Addfd(m_pDnsListenFd);
-	if(!bRet)
-	{
-		TRACE(1, "CDNSChildWorker::Run Ӽ˿ڵEPOLLʧܡ");
-		m_DnsServer.Destroy();
-		return false;
-	}
-	m_DnsServer.mbHasListenFd = true;
 	m_DnsServer.RecvFrom.connect(this, &CDNSChildWorker::DealNetData);
 	m_DnsServer.OnErrorNotice.connect(this, &CDNSChildWorker::OnDealErrorFd);
 	m_DnsServer.SetMaxFdNumber(m_iMaxFd);
+
+	STRU_SEND_QUEUE_LIMIT loLimit;
+	loLimit.miMaxBytes = m_pDnsConfig->send_queue_max_bytes;
+	loLimit.miMaxCount = m_pDnsConfig->send_queue_max_count;
+	loLimit.moPolicy = (SEND_QUEUE_POLICY)m_pDnsConfig->send_queue_policy;
+	m_DnsServer.SetSendQueueLimit(loLimit);
 	return true;
 }
 
 bool CDNSChildWorker::InitDcsNode()
 {
-	//DCS
-	bool lbCreate = false;
-	lbCreate = m_DcsNodeFd.CreateSocket();
-	if(!lbCreate)
+	if(m_pDnsConfig->dcs_shard_list.empty())
 	{
-		TRACE(1, "CDNSChildWorker::InitDcsNode SOCKETʧܡ");
-		return false;
+		STRU_NODE_ADDR loAddr;
+		loAddr.miIp = m_pDnsConfig->dcs_ip;
+		loAddr.miPort = m_pDnsConfig->dcs_port;
+		loAddr.mstrName = "dcs";
+		moShardAddr.push_back(loAddr);
 	}
-
-	bool lbConnect = false;
-	int liConnectCount = 0;
-	while(m_DcsNodeFd.moNetStat != TCP_CONNECTED)
+	else
 	{
-		struct sockaddr_in addr;
-		addr.sin_addr.s_addr = htonl(m_pDnsConfig->dcs_ip);
-		lbConnect = m_DcsNodeFd.ConnectServer(inet_ntoa(addr.sin_addr), 
-			m_pDnsConfig->dcs_port);
-		if(!lbConnect)
+		int liCount = ParseNodeAddrList(m_pDnsConfig->dcs_shard_list.c_str(), moShardAddr);
+		if(liCount <= 0 || liCount > DEF_MAX_CLUSTER_NODE)
 		{
-			if(++liConnectCount >= m_pDnsConfig->max_connect_time)
-			{
-				TRACE(1, "CDNSChildWorker::InitDcsNode DCSʧܡ");
-				m_DcsNodeFd.Close();
-				return false;
-			}
-			else
-			{
-				usleep(1000*1000*3);
-				continue;
-			}
+			TRACE(1, "CDNSChildWorker::InitDcsNode dcs_shard_listôdcs_shard_list = "
+				<<m_pDnsConfig->dcs_shard_list.c_str());
+			return false;
 		}
 	}
-	
-	m_DcsNodeFd.mbClientSocket = true;
-	m_DcsNodeFd.SetNoBlock();
-	bool bRet = m_DnsServer.Addfd(&m_DcsNodeFd);
-	if(!bRet)
+	if(m_pDnsConfig->dcs_batch_window_us > 0 && !moBatchNotify.Create())
 	{
-		TRACE(1, "CDNSChildWorker::Run DCSNodeFdEPOLLʧܡ");
-		m_DnsServer.Destroy();
+		TRACE(1, "CDNSChildWorker::InitDcsNode ֪ͨʧܡ");
 		return false;
 	}
-	TRACE(1, "CDNSChildWorker::InitDcsNode DcsNode Fd = "<<m_DcsNodeFd.miSocket);
-	return true;
-}
+	for(unsigned int i = 0; i < moShardAddr.size(); ++i)
+	{
+		moShardRing.AddNode(moShardAddr[i].mstrName.c_str());
+		moShardSocket.push_back(new CNetSocket);
+		CDNSForwardBatch *lpBatch = new CDNSForwardBatch;
+		lpBatch->Init(&m_DnsServer, htonl(m_pDnsConfig->server_ip), getpid(), m_pDnsConfig->dcs_batch_window_us,
+			&moBatchNotify);
+		moShardBatch.push_back(lpBatch);
+		moShardSendCall.push_back(0);
+		mbShardAlive[i] = false;
+	}
+	moShardRing.Build();
 
-unsigned int CDNSChildWorker::CheckNetEvent(STRU_THREAD_CONTEXT& apContext)
-{
-	try
+	//һƬTimeOutWork
+	int liConnectCount = 0;
+	for(;;)
 	{
-		CDNSChildWorker* p = reinterpret_cast<CDNSChildWorker*>(apContext.mpWorkContext);
-		ASSERT(p != NULL);
-		for(;;)
+		bool lbConnect = false;
+		for(unsigned int i = 0; i < moShardSocket.size(); ++i)
 		{
-			if(p->m_DnsServer.GetConnectedSize() >= p->m_iMaxFd)
-			{
-				TRACE(1, "CDNSChildWorker::Run ǰ: "<<
-					p->m_DnsServer.GetConnectedSize()<<" Ӹ: "<<p->m_iMaxFd);
-				if(p->m_DnsServer.mbHasListenFd)
-				{
-					p->m_DnsServer.Delfd(p->m_pDnsListenFd);
-					p->m_DnsServer.mbHasListenFd = false;
-				}
-			}
-
-			if(p->m_DnsServer.GetConnectedSize() < p->m_iMaxFd)
+			if(!mbShardAlive[i] && ConnectShard(i, DEF_DCS_CONNECT_WAIT_MS))
 			{
-				if(!p->m_DnsServer.mbHasListenFd)
-				{
-					p->m_DnsServer.Addfd(p->m_pDnsListenFd);
-					p->m_DnsServer.mbHasListenFd = true;
-				}
+				mbShardAlive[i] = true;
+				lbConnect = true;
 			}
-
-			int nRet = p->m_DnsServer.CheckEpollEvent(-1);
-			p->m_DnsServer.ProcessEpollEvent(nRet);
 		}
+		if(lbConnect)
+		{
+			break;
+		}
+		if(++liConnectCount >= m_pDnsConfig->max_connect_time)
+		{
+			TRACE(1, "CDNSChildWorker::InitDcsNode DCSʧܡ");
+			return false;
+		}
+		usleep(1000*1000*3);
 	}
-	catch (...)
-	{
-		TRACE(1, "CDNSChildWorker::CheckCrsNetEvent 쳣");
-	}
-	return 0;
+	return true;
 }
 
-unsigned int CDNSChildWorker::DealSendEvent(STRU_THREAD_CONTEXT& apContext)
+bool CDNSChildWorker::ConnectShard(unsigned int aiShard, int aiWaitMs)
 {
-	try
+	CNetSocket *lpSocket = moShardSocket[aiShard];
+	//һεѾEPOLLժص
+	if(lpSocket->miSocket >= 0 && lpSocket->moNetStat != COMMON_TCP_CONNECTING)
 	{
-		CDNSChildWorker* p = reinterpret_cast<CDNSChildWorker*>(apContext.mpWorkContext);
-		ASSERT(p != NULL);
-		for(;;)
+		m_DnsServer.Delfd(lpSocket->miSocket);
+		lpSocket->Close();
+		lpSocket->miSocket = -1;
+	}
+	if(lpSocket->miSocket < 0)
+	{
+		if(!lpSocket->CreateSocket())
 		{
-			bool bSendEmpty = true;
-			bSendEmpty = p->m_DnsServer.SendData();
-			if(bSendEmpty)
-			{
-				p->m_DnsServer.WaitSendEvent();
-			}
+			TRACE(1, "CDNSChildWorker::ConnectShard SOCKETʧܡ");
+			return false;
+		}
+		//ǰɷƬɴʱῨסTimeOutWork
+		lpSocket->SetNoBlock();
+		//մ̫СʱͺӴĴڸ£DCSطϢᱻס
+		lpSocket->SetSocketBuffer(DEF_DCS_SOCKET_BUFFER_LEN);
+		struct sockaddr_in addr;
+		addr.sin_addr.s_addr = htonl(moShardAddr[aiShard].miIp);
+		if(!lpSocket->ConnectServer(inet_ntoa(addr.sin_addr), moShardAddr[aiShard].miPort))
+		{
+			lpSocket->Close();
+			lpSocket->miSocket = -1;
+			return false;
 		}
 	}
-	catch (...)
+	//еsocketŽEPOLLϺŵ¼ͬ
+	int liRet = lpSocket->CheckConnect(aiWaitMs);
+	if(0 == liRet)
 	{
-		TRACE(1, "CDNSChildWorker::DealSendEvent 쳣");
+		return false;
 	}
-	return 0;
+	if(liRet < 0)
+	{
+		lpSocket->Close();
+		lpSocket->miSocket = -1;
+		return false;
+	}
+	lpSocket->mbClientSocket = true;
+	if(!m_DnsServer.Addfd(lpSocket))
+	{
+		TRACE(1, "CDNSChildWorker::ConnectShard DCSƬӵEPOLLʧܡƬ: "<<aiShard);
+		lpSocket->Close();
+		lpSocket->miSocket = -1;
+		return false;
+	}
+	TRACE(1, "CDNSChildWorker::ConnectShard DCSƬ: "<<aiShard<<" "<<moShardAddr[aiShard].mstrName.c_str()
+		<<" fd = "<<lpSocket->miSocket);
+	return true;
 }
 
-unsigned int CDNSChildWorker::DealRecvEvent(STRU_THREAD_CONTEXT& apContext)
+void CDNSChildWorker::CheckShard()
 {
-	try
+	for(unsigned int i = 0; i < moShardSocket.size(); ++i)
 	{
-		CDNSChildWorker* p = reinterpret_cast<CDNSChildWorker*>(apContext.mpWorkContext);
-		ASSERT(p != NULL);
-		for(;;)
+		if(mbShardAlive[i])
 		{
-			bool bRecvEmpty = true;
-			bRecvEmpty = p->m_DnsServer.RecvData();
-			TRACE(1, "-----------------CDNSChildWorker::DealRecvEvent-----------------");
-			if(bRecvEmpty)
-			{
-				p->m_DnsServer.WaitRecvEvent();
-			}
+			continue;
 		}
+		//ѶϿӻûأ˵ûǨ
+		if(moShardSocket[i]->miSocket >= 0 && moShardSocket[i]->moNetStat != COMMON_TCP_CONNECTING)
+		{
+			MoveHalls(i);
+		}
+		if(!ConnectShard(i))
+		{
+			continue;
+		}
+		LoginShard(i);
+		SyncHalls(i);
 	}
-	catch (...)
-	{
-		TRACE(1, "CDNSChildWorker::DealRecvEvent 쳣");
-	}
-	return 0;
 }
 
 void CDNSChildWorker::Run()
@@ -224,21 +239,15 @@ void CDNSChildWorker::Run()
 			exit(0);
 		}
 
-		if (0 == m_ThreadManager.Start(CheckNetEvent, this, 1, "dns_check_net_event")) 
-		{
-			TRACE(1,"CDCSWorker::Run: DNS Server¼߳ʧܡ˳");
-			exit(0);
-		}
-
-		if (0 == m_ThreadManager.Start(DealSendEvent, this, 1, "dns_send_data")) 
+		if(!m_DnsServer.Start())
 		{
-			TRACE(1,"CDCSWorker::Run: DNS Server ݷ߳ʧܡ˳");
+			TRACE(1,"CDNSChildWorker::Run: DNS Server練Ӧ߳ʧܡ˳");
 			exit(0);
 		}
-
-		if (0 == m_ThreadManager.Start(DealRecvEvent, this, 1, "dns_recv_data")) 
+		if(m_pDnsConfig->dcs_batch_window_us > 0
+			&& m_ThreadManager.Start(FlushBatchThread, this, 1, "dcs_batch_flush") != 1)
 		{
-			TRACE(1,"CDCSWorker::Run: DNS Server ݽ߳ʧܡ˳");
+			TRACE(1,"CDNSChildWorker::Run: ߳ʧܡ˳");
 			exit(0);
 		}
 
@@ -269,8 +278,10 @@ void CDNSChildWorker::Run()
 
 		Logout();
 
-		m_DnsServer.Delfd(m_pDnsListenFd->miSocket);
-		m_DnsServer.Delfd(m_DcsNodeFd.miSocket);
+		for(unsigned int i = 0; i < moShardSocket.size(); ++i)
+		{
+			m_DnsServer.Delfd(moShardSocket[i]->miSocket);
+		}
 		m_DnsServer.Destroy();
 	}
 	catch (...)
@@ -282,11 +293,8 @@ void CDNSChildWorker::Run()
 
 void CDNSChildWorker::TimeOutWork()
 {
-	//DCS״̬
-	if(m_DcsNodeFd.moNetStat == TCP_CLOSED)
-	{
-		TRACE(1, "CDNSChildWorker::TimeOutWork DCSӶϿˡ");
-	}
+	//ϿDCSƬ
+	CheckShard();
 	uint64 time_now = CTimeBase::get_current_time();
 	//ʹ
 	if(time_now > m_i64LastKeepLive + KEEP_LIVE_TIME_OUT * 1000)
@@ -331,17 +339,87 @@ void CDNSChildWorker::TimeOutWork()
 		m_i64LastLogTime = time_now;
 	}
 
-	if(time_now > m_i64LastCheckTimeOut + CRS_DNS_TIMEOUT * 1000)
+	moRouteTable.CheckTimeOut();
+	FlushHallChange();
+}
+
+void CDNSChildWorker::Dump()
+{
+	m_DnsServer.Dump();
+	moRouteTable.Dump();
+	for(unsigned int i = 0; i < moShardBatch.size(); ++i)
 	{
-		CheckTimeOut();
-		//test();
-		m_i64LastCheckTimeOut = time_now;
+		STRU_FORWARD_BATCH_STAT loStat;
+		moShardBatch[i]->GetStat(loStat);
+		uint64 lui64SendCall = moShardSocket[i]->GetSendCallCount();
+		uint64 lui64CallCount = lui64SendCall - moShardSendCall[i];
+		moShardSendCall[i] = lui64SendCall;
+		if(0 == loStat.mui64MsgCount)
+		{
+			continue;
+		}
+		TRACE(2, "CDNSChildWorker::Dump Ƭ: "<<i<<" תϢ: "<<loStat.mui64MsgCount
+			<<" : "<<loStat.mui64BatchCount
+			<<" װ: "<<loStat.mui64SizeFlush
+			<<" ڷ: "<<loStat.mui64TimerFlush
+			<<" : "<<loStat.mui64UrgentFlush
+			<<" ÿϢsend: "<<(double)lui64CallCount / loStat.mui64MsgCount
+			<<" ƽȴ(us): "<<loStat.mui64WaitTime / loStat.mui64MsgCount
+			<<" ȴ(us): "<<loStat.mui64MaxWaitTime);
 	}
 }
 
-void CDNSChildWorker::Dump()
+unsigned int CDNSChildWorker::FlushBatchThread(STRU_THREAD_CONTEXT& apContext)
 {
+	try
+	{
+		CDNSChildWorker *p = reinterpret_cast<CDNSChildWorker*>(apContext.mpWorkContext);
+		ASSERT(p != NULL);
+		while(!p->m_ThreadManager.IsStop())
+		{
+			int64 li64WaitUs = p->GetBatchWaitTime();
+			if(li64WaitUs < 0)
+			{
+				//ȵǼǵȴȷһΣPush֮Ϣ©
+				p->moBatchNotify.BeginWait();
+				li64WaitUs = p->GetBatchWaitTime();
+				if(li64WaitUs < 0)
+				{
+					p->moBatchNotify.Wait(DEF_BATCH_IDLE_WAIT_MS);
+					continue;
+				}
+				p->moBatchNotify.EndWait();
+			}
+			if(li64WaitUs > 0)
+			{
+				//ʱ䴰ں£pollľȲ΢˯
+				usleep((useconds_t)li64WaitUs);
+			}
+			for(unsigned int i = 0; i < p->moShardBatch.size(); ++i)
+			{
+				p->moShardBatch[i]->FlushExpired();
+			}
+		}
+	}
+	catch (...)
+	{
+		TRACE(1, "CDNSChildWorker::FlushBatchThread 쳣");
+	}
+	return 0;
+}
 
+int64 CDNSChildWorker::GetBatchWaitTime()
+{
+	int64 li64WaitUs = -1;
+	for(unsigned int i = 0; i < moShardBatch.size(); ++i)
+	{
+		int64 li64Batch = moShardBatch[i]->GetWaitTime();
+		if(li64Batch >= 0 && (li64WaitUs < 0 || li64Batch < li64WaitUs))
+		{
+			li64WaitUs = li64Batch;
+		}
+	}
+	return li64WaitUs;
 }
 
 void CDNSChildWorker::KeepLive()
@@ -351,18 +429,179 @@ void CDNSChildWorker::KeepLive()
 	rq.m_iDnsIp = htonl(m_pDnsConfig->server_ip);
 	rq.m_iDnsId = getpid();
 	int len = rq.Pack(buffer,DCS_DNS_BUFFER_LEN);
-	m_DnsServer.SendData(m_DcsNodeFd.miSocket, buffer, len);
+	for(unsigned int i = 0; i < moShardSocket.size(); ++i)
+	{
+		if(mbShardAlive[i])
+		{
+			m_DnsServer.SendData(moShardSocket[i]->miSocket, buffer, len);
+		}
+	}
 }
 
 void CDNSChildWorker::Login()
+{
+	for(unsigned int i = 0; i < moShardSocket.size(); ++i)
+	{
+		if(mbShardAlive[i])
+		{
+			LoginShard(i);
+		}
+	}
+}
+
+void CDNSChildWorker::LoginShard(unsigned int aiShard)
 {
 	char buffer[DCS_DNS_BUFFER_LEN] = {0};
 	stru_DCS_DNS_LOGIN_RQ rq;
 	rq.m_iDnsIp = htonl(m_pDnsConfig->server_ip);
 	rq.m_iDnsId = getpid();
 	int len = rq.Pack(buffer,DCS_DNS_BUFFER_LEN);
-	m_DnsServer.SendData(m_DcsNodeFd.miSocket, buffer, len);
-	TRACE(1, "CDNSChildWorker::Login  PID ="<<getpid());
+	m_DnsServer.SendData(moShardSocket[aiShard]->miSocket, buffer, len);
+	TRACE(1, "CDNSChildWorker::Login  PID ="<<getpid()<<" Ƭ: "<<aiShard);
+}
+
+void CDNSChildWorker::SyncHalls(unsigned int aiShard)
+{
+	CAutoLock lock(moHallChangeSection);
+	//Ȱ֮ǰı仯Ƭ֮ı仯ŰµĿ÷Ƭ
+	FlushHallChange();
+	std::vector<uint32> loHallList;
+	moRouteTable.GetHallList(loHallList);
+	mbShardAlive[aiShard] = true;
+	std::vector<STRU_DNS_HALL_CHANGE> loList;
+	for(unsigned int i = 0; i < loHallList.size(); ++i)
+	{
+		if(PickShard(loHallList[i]) == (int)aiShard)
+		{
+			STRU_DNS_HALL_CHANGE loChange;
+			loChange.miHallId = loHallList[i];
+			loChange.miOp = DCS_HALL_DELTA_LOGIN;
+			loList.push_back(loChange);
+		}
+	}
+	//ûдҲҪðƬDNSľɼ¼
+	SendHallDelta(moShardSocket[aiShard]->miSocket, loList, true);
+	TRACE(1, "CDNSChildWorker::SyncHalls Ƭ: "<<aiShard<<" ͬ: "<<loList.size());
+}
+
+void CDNSChildWorker::MoveHalls(unsigned int aiDeadShard)
+{
+	CAutoLock lock(moHallChangeSection);
+	mbShardAlive[aiDeadShard] = false;
+	FlushHallChange();
+	std::vector<uint32> loHallList;
+	moRouteTable.GetHallList(loHallList);
+	std::vector<std::vector<STRU_DNS_HALL_CHANGE> > loShardChange(moShardSocket.size());
+	for(unsigned int i = 0; i < loHallList.size(); ++i)
+	{
+		if(moShardRing.GetNode(loHallList[i]) != (int)aiDeadShard)
+		{
+			continue;
+		}
+		int liShard = PickShard(loHallList[i]);
+		if(liShard >= 0)
+		{
+			STRU_DNS_HALL_CHANGE loChange;
+			loChange.miHallId = loHallList[i];
+			loChange.miOp = DCS_HALL_DELTA_LOGIN;
+			loShardChange[liShard].push_back(loChange);
+		}
+	}
+	for(unsigned int i = 0; i < loShardChange.size(); ++i)
+	{
+		if(!loShardChange[i].empty())
+		{
+			SendHallDelta(GetShardFd(i), loShardChange[i], false);
+			TRACE(1, "CDNSChildWorker::MoveHalls Ƭ: "<<aiDeadShard<<" ĴתƬ: "<<i
+				<<" : "<<loShardChange[i].size());
+		}
+	}
+}
+
+void CDNSChildWorker::FlushHallChange()
+{
+	CAutoLock lock(moHallChangeSection);
+	std::vector<STRU_DNS_HALL_CHANGE> loChange;
+	if(moRouteTable.PopHallChange(loChange) <= 0)
+	{
+		return;
+	}
+	//Ƭ飬ԭȺ˳
+	std::vector<std::vector<STRU_DNS_HALL_CHANGE> > loShardChange(moShardSocket.size());
+	for(unsigned int i = 0; i < loChange.size(); ++i)
+	{
+		int liShard = PickShard(loChange[i].miHallId);
+		if(liShard >= 0)
+		{
+			loShardChange[liShard].push_back(loChange[i]);
+		}
+	}
+	for(unsigned int i = 0; i < loShardChange.size(); ++i)
+	{
+		if(!loShardChange[i].empty())
+		{
+			SendHallDelta(GetShardFd(i), loShardChange[i], false);
+		}
+	}
+}
+
+void CDNSChildWorker::SendHallDelta(int fd, std::vector<STRU_DNS_HALL_CHANGE> &aoList, bool abReset)
+{
+	if(fd < 0)
+	{
+		return;
+	}
+	//ȷѺϲϢ˳ŵ֮ǰϢǰ
+	int liShard = GetShardIndex(fd);
+	if(liShard >= 0)
+	{
+		moShardBatch[liShard]->Flush();
+	}
+	char buffer[DCS_DNS_BUFFER_LEN] = {0};
+	stru_DCS_DNS_HALL_DELTA loDelta;
+	loDelta.m_iDnsIp = htonl(m_pDnsConfig->server_ip);
+	loDelta.m_iDnsId = getpid();
+	unsigned int liIndex = 0;
+	do
+	{
+		loDelta.m_iReset = (abReset && 0 == liIndex) ? 1 : 0;
+		loDelta.m_iCount = 0;
+		while(liIndex < aoList.size() && loDelta.m_iCount < DCS_HALL_DELTA_MAX_COUNT)
+		{
+			loDelta.m_iHallId[loDelta.m_iCount] = aoList[liIndex].miHallId;
+			loDelta.m_iOp[loDelta.m_iCount] = aoList[liIndex].miOp;
+			++loDelta.m_iCount;
+			++liIndex;
+		}
+		int len = loDelta.Pack(buffer, DCS_DNS_BUFFER_LEN);
+		if(len <= 0)
+		{
+			TRACE(1, "CDNSChildWorker::SendHallDelta ִ");
+			return;
+		}
+		m_DnsServer.SendData(fd, buffer, len);
+	}while(liIndex < aoList.size());
+}
+
+int CDNSChildWorker::GetShardFd(int aiShard)
+{
+	if(aiShard < 0 || aiShard >= (int)moShardSocket.size() || !mbShardAlive[aiShard])
+	{
+		return -1;
+	}
+	return moShardSocket[aiShard]->miSocket;
+}
+
+int CDNSChildWorker::GetShardIndex(int fd)
+{
+	for(unsigned int i = 0; i < moShardSocket.size(); ++i)
+	{
+		if(moShardSocket[i]->miSocket == fd)
+		{
+			return i;
+		}
+	}
+	return -1;
 }
 
 void CDNSChildWorker::Logout()
@@ -372,21 +611,36 @@ void CDNSChildWorker::Logout()
 	rq.m_iDnsIp = htonl(m_pDnsConfig->server_ip);
 	rq.m_iDnsId = getpid();
 	int len = rq.Pack(buffer,DCS_DNS_BUFFER_LEN);
-	m_DnsServer.SendData(m_DcsNodeFd.miSocket, buffer, len);
+	for(unsigned int i = 0; i < moShardSocket.size(); ++i)
+	{
+		moShardBatch[i]->Flush();
+		if(mbShardAlive[i])
+		{
+			m_DnsServer.SendData(moShardSocket[i]->miSocket, buffer, len);
+		}
+	}
 }
 
 void CDNSChildWorker::OnDealErrorFd(int fd)
 {
-	if(fd == m_DcsNodeFd.miSocket)
+	int liShard = GetShardIndex(fd);
+	if(liShard >= 0)
+	{
+		TRACE(1, "CDNSChildWorker::OnDealErrorFd dcs error Ƭ: "<<liShard);
+		//֮Ĵ仯ϢķƬǨƺTimeOutWork
+		//ĻصУٵmoHallChangeSection
+		mbShardAlive[liShard] = false;
+	}
+	else
 	{
-		TRACE(1, "CDNSChildWorker::OnDealErrorFd dcs error");
-		m_DcsNodeFd.moNetStat = TCP_CLOSED;
+		//仯TimeOutWork
+		moRouteTable.RemoveByFd(fd);
 	}
 	TRACE(1, "CDNSChildWorker::OnDealErrorFd fd error : fd = "<<fd);
 }
 void CDNSChildWorker::DealNetData(int fd, char *buffer, int length)
 {
-	if(fd == m_DcsNodeFd.miSocket)
+	if(GetShardIndex(fd) >= 0)
 	{
 		DealDcsData(buffer, length);
 	}
@@ -408,12 +662,8 @@ void CDNSChildWorker::DealCrsData(int fd, char *buffer, int length)
 			stru_DNS_CRS_LOGIN_RQ rq;
 			stru_DNS_CRS_LOGIN_RS rs;
 			rq.UnPack(buffer,length);
-			PSTRU_DNS_NODE_INFO  pHall_info = new STRU_DNS_NODE_INFO;
-			pHall_info->fd = fd;
-			pHall_info->m_i32NodeId = rq.m_i32NodeId;
-			pHall_info->m_i32GroupId = rq.m_i32GroupId;
-			pHall_info->m_iTimeStamp = CTimeBase::get_current_time();
-			SetAlive(rq.m_i32NodeId,pHall_info);
+			moRouteTable.Login(rq.m_i32NodeId, fd, rq.m_i32GroupId);
+			FlushHallChange();
 			rs.m_i32NodeId = rq.m_i32NodeId;
 			rs.m_iDnsId = getpid();
 			pack_length = rs.Pack(pack_buffer,DNS_CRS_BUFFER_LEN*2);
@@ -427,7 +677,7 @@ void CDNSChildWorker::DealCrsData(int fd, char *buffer, int length)
 			rq.UnPack(buffer,length);
 			rs.m_i32NodeId = rq.m_i32NodeId;
 			rs.m_iDnsId = getpid();
-			SetAlive(rq.m_i32NodeId);
+			moRouteTable.KeepAlive(rq.m_i32NodeId);
 			pack_length = rs.Pack(pack_buffer,DNS_CRS_BUFFER_LEN*2);
 			m_DnsServer.SendData(fd,pack_buffer,pack_length);
 			break;
@@ -439,7 +689,8 @@ void CDNSChildWorker::DealCrsData(int fd, char *buffer, int length)
 			rq.UnPack(buffer,length);
 			rs.m_i32NodeId = rq.m_i32NodeId;
 			rs.m_iDnsId = getpid();
-			RemoveHall(rq.m_i32NodeId);
+			moRouteTable.Remove(rq.m_i32NodeId);
+			FlushHallChange();
 			pack_length = rs.Pack(pack_buffer,DNS_CRS_BUFFER_LEN*2);
 			m_DnsServer.SendData(fd,pack_buffer,pack_length);
 			break;
@@ -450,7 +701,7 @@ void CDNSChildWorker::DealCrsData(int fd, char *buffer, int length)
 			stru_DNS_CRS_MESSAGE rq;
 			stru_DCS_DNS_MESSAGE msg;
 			rq.UnPack(buffer,length);
-			SetAlive(rq.m_i32NodeId);
+			moRouteTable.KeepAlive(rq.m_i32NodeId);
 
 			msg.m_iDnsIp = htonl(m_pDnsConfig->server_ip);
 			msg.m_iDnsId = getpid();
@@ -459,7 +710,7 @@ void CDNSChildWorker::DealCrsData(int fd, char *buffer, int length)
 			pack_length = msg.Pack(pack_buffer,DNS_CRS_BUFFER_LEN*2);
 			if(rq.m_i32TargetNode >0)
 			{
-				toFd = GetFDByHallId(rq.m_i32TargetNode);
+				toFd = moRouteTable.GetFd(rq.m_i32TargetNode);
 			}
 			if(toFd > 0)
 			{
@@ -468,7 +719,17 @@ void CDNSChildWorker::DealCrsData(int fd, char *buffer, int length)
 			}
 			else
 			{
-				m_DnsServer.SendData(m_DcsNodeFd.miSocket, pack_buffer,pack_length);
+				//ĿķƬ顢ȫϢԴѡƬֻһƬ㲥
+				int liShard = PickShard(rq.m_i32TargetNode > 0 ? rq.m_i32TargetNode : rq.m_i32NodeId);
+				int liShardFd = GetShardFd(liShard);
+				if(liShardFd >= 0)
+				{
+					moShardBatch[liShard]->Push(liShardFd, pack_buffer, pack_length);
+				}
+				else
+				{
+					TRACE(3, "CDNSChildWorker::DealCrsData ûпõDCSƬϢfrom "<<rq.m_i32NodeId);
+				}
 				//TRACE(3, "CDNSChildWorker::DealCrsData transfer message from "<<rq.m_i32NodeId <<" to dcs");
 			}	
 
@@ -513,7 +774,7 @@ void CDNSChildWorker::DealDcsData(char *buffer, int length)
 			msg.UnPack(rq.m_cDataBuf,rq.m_iDatalen);
 			if(msg.m_i32TargetNode != 0)
 			{
-				int fd = GetFDByHallId(msg.m_i32TargetNode);
+				int fd = moRouteTable.GetFd(msg.m_i32TargetNode);
 				if(fd >0)
 				{
 					m_DnsServer.SendData(fd, rq.m_cDataBuf,rq.m_iDatalen);
@@ -533,7 +794,9 @@ void CDNSChildWorker::DealDcsData(char *buffer, int length)
 			}
 			else
 			{
-				m_DnsServer.SendAllData(rq.m_cDataBuf,rq.m_iDatalen);
+				STRU_BROADCAST_STAT loStat;
+				m_DnsServer.SendAllData(rq.m_cDataBuf,rq.m_iDatalen, &loStat);
+				TraceBroadcast("CDNSChildWorker::DealDcsData SendAllData", loStat);
 				//TRACE(3, "CDNSChildWorker::DealDcsData recv message buffer length "<<length);
 				//TRACE(3, "CDNSChildWorker::DealDcsData recv message from "<<msg.m_i32NodeId<<" To ChatRoomType "<<msg.m_i32TargetGroup);
 				//TRACE(3, "CDNSChildWorker::DealDcsData recv message len "<<msg.m_iDataLen);
@@ -550,124 +813,29 @@ void CDNSChildWorker::DealDcsData(char *buffer, int length)
 	//TRACE(1, "CDNSChildWorker::DealDcsData");
 }
 
-int CDNSChildWorker::SetAlive(uint32 hallId ,PSTRU_DNS_NODE_INFO phall)
-{
-
-	int liRet = -1;
-	CAutoLock lock(mSection);
-	std::map<uint32,PSTRU_DNS_NODE_INFO>::iterator it = mHallList.find(hallId);
-	try{
-		if(it != mHallList.end())
-		{
-			it->second->m_iTimeStamp = CTimeBase::get_current_time();
-			liRet = 0;
-
-			if(phall != NULL)
-			{
-				it->second->fd = phall->fd;
-				delete phall;
-			}
-		}
-		else
-		{
-			if(phall != NULL)
-			{
-				it = mHallList.begin();
-				while(it != mHallList.end())
-				{
-					//
-					if(it->second->fd == phall->fd)
-					{
-						mHallList.erase(it);
-						break;
-					}
-					it++;
-				}
-				mHallList[hallId] = phall;
-				liRet = 0;
-			}
-		}
-	}
-	catch(...)
-	{
-		liRet = -1;
-		TRACE(1, "CDNSChildWorker::SetAlive catch ");
-	}
-
-	return liRet;
-}
-
-int CDNSChildWorker::GetFDByHallId(uint32 hallId)
-{
-	int liRet = -1;
-	CAutoLock lock(mSection);
-	std::map<uint32,PSTRU_DNS_NODE_INFO>::iterator it = mHallList.find(hallId);
-	if(it != mHallList.end())
-	{
-
-		liRet = it->second->fd;
-
-	}
-	return liRet;
-}
-
-int CDNSChildWorker::RemoveHall(uint32 hallid)
+int CDNSChildWorker::SendByChatRootType(uint32 type,const char *buffer, const uint32 length)
 {
-	int liRet = -1;
-	CAutoLock lock(mSection);
-	std::map<uint32,PSTRU_DNS_NODE_INFO>::iterator it = mHallList.find(hallid);
-	try
-	{
-		if(it != mHallList.end())
-		{
-			delete it->second;
-			mHallList.erase(it);
-			liRet = 0;
-		}
-	}
-	catch(...)
-	{
-		liRet = -1;
-	}
+	int liRet = 0;
+	std::vector<int> loFdList;
+	moRouteTable.GetGroupFd(type, loFdList);
+	//ֻһΰдͬһݿ
+	STRU_BROADCAST_STAT loStat;
+	m_DnsServer.Broadcast(loFdList, buffer, length, &loStat);
+	TraceBroadcast("CDNSChildWorker::SendByChatRootType", loStat);
 	return liRet;
-
 }
 
-int CDNSChildWorker::CheckTimeOut()
+void CDNSChildWorker::TraceBroadcast(const char *apName, const STRU_BROADCAST_STAT &aoStat)
 {
-	int liRet = -1;
-	uint64 time_now = CTimeBase::get_current_time();
-	CAutoLock lock(mSection);
-	std::map<uint32,PSTRU_DNS_NODE_INFO>::iterator it = mHallList.begin();
-	while(it != mHallList.end())
+	if(aoStat.miSkipCount > 0)
 	{
-		if(time_now > it->second->m_iTimeStamp + CRS_DNS_TIMEOUT*1000)
-		{
-			delete it->second;
-			TRACE(1, "CDNSChildWorker::CheckTimeOut hallId "<<it->first<<" Timeout");
-			mHallList.erase(it++);
-			continue;
-		}
-		it++;
+		TRACE(1, apName<<" ӡĿ: "<<aoStat.miTargetCount<<" : "<<aoStat.miSkipCount
+			<<" ʱ(us): "<<aoStat.mui64CostTime);
 	}
-	return liRet;
-}
-
-int CDNSChildWorker::SendByChatRootType(uint32 type,const char *buffer, const uint32 length)
-{
-	int liRet = 0;
-	CAutoLock lock(mSection);
-	std::map<uint32,PSTRU_DNS_NODE_INFO>::iterator it = mHallList.begin();
-	while(it != mHallList.end())
+	else
 	{
-		if(it->second->m_i32GroupId == type)
-		{
-			m_DnsServer.SendData(it->second->fd, buffer,length);
-			//TRACE(3, "CDNSChildWorker::SendByChatRootType hallId "<<it->first<<" ChatRootType " <<it->second->m_i32GroupId);
-		}
-		it++;
+		TRACE(5, apName<<" Ŀ: "<<aoStat.miTargetCount<<" ʱ(us): "<<aoStat.mui64CostTime);
 	}
-	return liRet;
 }
 
 void CDNSChildWorker::DealDcsDataComplete(int rtn_op, int fd, CBasePack* pack)
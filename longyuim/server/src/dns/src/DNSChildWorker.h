@@ -6,23 +6,23 @@
 #include "FileStream.h"
 #include "DNSInclude.h"
 #include "DNSConfig.h"
-#include "NetEpoll.h"
+#include "NetEpollGroup.h"
 #include "DNSDealData.h"
 #include "ThreadGroup.h"
-#include <map>
+#include "DNSRouteTable.h"
+#include "ConsistentHash.h"
+#include "DNSForwardBatch.h"
 
 //ʱΪ120
 #define KEEP_LIVE_TIME_OUT	120
 //ʱʱ5
 #define CRS_DNS_TIMEOUT		300
-
-typedef struct stru_DNS_NODE_INFO
-{
-	int fd;
-	uint32 m_i32NodeId;
-	uint64 m_i32GroupId;
-	uint64 m_iTimeStamp;
-}STRU_DNS_NODE_INFO ,*PSTRU_DNS_NODE_INFO;
+//ûʱʱ̵߳ȴʱ䣬ʱ˳
+#define DEF_BATCH_IDLE_WAIT_MS	1000
+//DCSƬӻDNSշҪͨӴ
+#define DEF_DCS_SOCKET_BUFFER_LEN	(256*1024)
+//ʱȴÿƬɵʱ䣬
+#define DEF_DCS_CONNECT_WAIT_MS	1000
 
 class CDNSChildWorker : public sigslot::has_slots<>
 {
@@ -34,13 +34,14 @@ public:
 	void SetConfig(CDNSConfig *apDnsConfig);
 	void Run();
 
-	static unsigned int CheckNetEvent(STRU_THREAD_CONTEXT& apContext);
-	static unsigned int DealSendEvent(STRU_THREAD_CONTEXT& apContext);
-	static unsigned int DealRecvEvent(STRU_THREAD_CONTEXT& apContext);
-
 private:
 	bool InitDnsServer();
 	bool InitDcsNode();
+	//һDCSƬϺEPOLLȴaiWaitMs
+	//ʱfalse´εüȷ
+	bool ConnectShard(unsigned int aiShard, int aiWaitMs = 0);
+	//Ǩ߸նϿƬĴûϵķƬϺעᲢȫͬ
+	void CheckShard();
 	void Dump();
 	void TimeOutWork();
 	void OnDealErrorFd(int fd);
@@ -52,27 +53,56 @@ private:
 	void KeepLive();
 	void Login();
 	void Logout();
+	void LoginShard(unsigned int aiShard);
+	//Ƭȫһñ־úƬ
+	void SyncHalls(unsigned int aiShard);
+	//ƬϿ̵߳ãԭĴ¼ķƬ
+	void MoveHalls(unsigned int aiDeadShard);
+	//ѻ۵Ĵ仯ķƬ
+	void FlushHallChange();
+	void SendHallDelta(int fd, std::vector<STRU_DNS_HALL_CHANGE> &aoList, bool abReset);
+	//Ŀ÷Ƭûп÷Ƭ-1
+	inline int PickShard(uint32 hallId)
+	{
+		return moShardRing.GetNode(hallId, mbShardAlive);
+	}
+	//ƬfdƬ÷-1
+	int GetShardFd(int aiShard);
+	//fdĸƬӣǷ-1
+	int GetShardIndex(int fd);
+	//ȵʱûʱȵһϢ
+	static unsigned int FlushBatchThread(STRU_THREAD_CONTEXT& apContext);
+	//Ҫȶ΢룬û-1
+	int64 GetBatchWaitTime();
 public:
 	CDNSConfig *m_pDnsConfig;
-	CNetEpoll m_DnsServer;
+	CNetEpollGroup m_DnsServer;
 	CNetSocket *m_pDnsListenFd;
-	CNetEpoll m_DcsNode;
-	CNetSocket m_DcsNodeFd;
+	//DCSƬֻһDCSʱΪdcs_ip:dcs_port
+	std::vector<STRU_NODE_ADDR> moShardAddr;
+	std::vector<CNetSocket*> moShardSocket;
+	bool mbShardAlive[DEF_MAX_CLUSTER_NODE];
+	CConsistentHash moShardRing;
+	//ÿƬϢϲ
+	std::vector<CDNSForwardBatch*> moShardBatch;
+	//һϢʱѶʱ߳
+	CQueueNotify moBatchNotify;
+	//ϴDumpʱƬӵsend
+	std::vector<uint64> moShardSendCall;
 	CDNSDealData m_DNSDealData;
 	uint32 m_iMaxFd;
 	uint64 m_i64LastDumpTime;
 	uint64 m_i64LastKeepLive;
 	uint64 m_i64LastLogTime;
-	uint64 m_i64LastCheckTimeOut;
 	CThreadGroup m_ThreadManager;
 private:
-	std::map<uint32,PSTRU_DNS_NODE_INFO> mHallList;
-	int SetAlive(uint32 hallId ,PSTRU_DNS_NODE_INFO phall = NULL);
-	int GetFDByHallId(uint32 hallid);
-	int CheckTimeOut();
-	int RemoveHall(uint32 hallid);
-	CCriticalSection mSection;
+	//·ɣתѯ
+	CDNSRouteTable moRouteTable;
+	//仯ȡͷʹУ֤ͬһƬϵȺ˳
+	CCriticalSection moHallChangeSection;
 	int SendByChatRootType(uint32 type,const char *buffer, const uint32 length);
+	//㲥ͳƣӱʱ1
+	void TraceBroadcast(const char *apName, const STRU_BROADCAST_STAT &aoStat);
 };
 
 #endif //_DNS_CHILD_WORKER_H_
@@ -1,13 +1,19 @@
 
 
 #include "DNSConfig.h"
+#include "NetSocket.h"
 
 CDNSConfig::CDNSConfig()
 {
 	server_ip = 0;
 	server_port = 0;
+	reactor_thread_count = 1;
+	send_queue_max_bytes = DEF_SEND_QUEUE_MAX_BYTES;
+	send_queue_max_count = DEF_SEND_QUEUE_MAX_COUNT;
+	send_queue_policy = SEND_POLICY_DROP_NEWEST;
 	dcs_ip = 0;
 	dcs_port = 0;
+	dcs_batch_window_us = 0;
 }
 
 CDNSConfig::~CDNSConfig()
@@ -41,6 +47,18 @@ bool CDNSConfig::parse_value(const char* key, const char* value)
 		return true;
 	}
 
+	if (!strcmp(key, "dcs_shard_list")) 
+	{
+		dcs_shard_list = value;
+		return true;
+	}
+
+	if (!strcmp(key, "dcs_batch_window_us")) 
+	{
+		dcs_batch_window_us = (unsigned int)strtoul(value, NULL, 0);
+		return true;
+	}
+
 	if (!strcmp(key, "max_connect_time")) 
 	{
 		max_connect_time = (unsigned short)strtol(value, NULL, 0);
@@ -77,6 +95,38 @@ bool CDNSConfig::parse_value(const char* key, const char* value)
 		return true;
 	}
 
+	if (!strcmp(key, "reactor_thread_count")) 
+	{
+		reactor_thread_count = (unsigned short)strtol(value, NULL, 0);
+		if(0 == reactor_thread_count)
+		{
+			reactor_thread_count = 1;
+		}
+		return true;
+	}
+
+	if (!strcmp(key, "send_queue_max_bytes")) 
+	{
+		send_queue_max_bytes = (int)strtol(value, NULL, 0);
+		return true;
+	}
+
+	if (!strcmp(key, "send_queue_max_count")) 
+	{
+		send_queue_max_count = (int)strtol(value, NULL, 0);
+		return true;
+	}
+
+	if (!strcmp(key, "send_queue_policy")) 
+	{
+		send_queue_policy = (int)strtol(value, NULL, 0);
+		if(send_queue_policy < SEND_POLICY_DROP_NEWEST || send_queue_policy > SEND_POLICY_COALESCE)
+		{
+			send_queue_policy = SEND_POLICY_DROP_NEWEST;
+		}
+		return true;
+	}
+
 	return true;
 }
 
@@ -19,12 +19,23 @@ public:
 	unsigned short server_port;
 	unsigned int dcs_ip;
 	unsigned short dcs_port;
+	//DCSƬĵַ"ip:port,ip:port"Ϊʱֻdcs_ip:dcs_port
+	string dcs_shard_list;
+	//DCSϢϲȴʱ䴰ڣ΢룬0ʾϲ
+	unsigned int dcs_batch_window_us;
 	unsigned short max_connect_time;
 	unsigned short max_bind_time;
 	unsigned short max_process_size;
 	unsigned short max_file_size;
 	unsigned int log_file_update_time;
 	unsigned int dump_info_time;
+	//練Ӧ(epoll߳)1ΪӦ
+	unsigned short reactor_thread_count;
+	//ÿӷб޶0ʾ
+	int send_queue_max_bytes;
+	int send_queue_max_count;
+	//޶ʱĴ 0 1 2Ͽ 3Ϣͺϲ
+	int send_queue_policy;
 };
 
 #endif//_DNS_CONFIG_H_
@@ -0,0 +1,146 @@
+#include "DNSForwardBatch.h"
+
+static uint64 GetMicroTime()
+{
+	struct timespec loTime;
+	clock_gettime(CLOCK_MONOTONIC, &loTime);
+	return (uint64)loTime.tv_sec * 1000000 + loTime.tv_nsec / 1000;
+}
+
+CDNSForwardBatch::CDNSForwardBatch()
+{
+	m_pServer = NULL;
+	m_pNotify = NULL;
+	miWindowUs = 0;
+	miFd = -1;
+	mui64FirstTime = 0;
+	mui64PushTimeSum = 0;
+}
+
+CDNSForwardBatch::~CDNSForwardBatch()
+{
+
+}
+
+void CDNSForwardBatch::Init(CNetEpollGroup *apServer, uint32 aiDnsIp, uint32 aiDnsId, uint32 aiWindowUs,
+	CQueueNotify *apNotify /* = NULL */)
+{
+	ASSERT(apServer != NULL);
+	m_pServer = apServer;
+	m_pNotify = apNotify;
+	moBatch.m_iDnsIp = aiDnsIp;
+	moBatch.m_iDnsId = aiDnsId;
+	miWindowUs = aiWindowUs;
+}
+
+bool CDNSForwardBatch::Push(int fd, const char *buffer, int length)
+{
+	CAutoLock lock(moSection);
+	++moStat.mui64MsgCount;
+	int liItemLen = sizeof(uint16) + length;
+	//ϲһװʱֱӷеȷ֤˳
+	if(0 == miWindowUs || liItemLen > DCS_DNS_BATCH_BUFFER_LEN)
+	{
+		if(moBatch.m_iCount > 0)
+		{
+			SendBatch(moStat.mui64UrgentFlush);
+		}
+		return m_pServer->SendData(fd, buffer, length);
+	}
+	if(moBatch.m_iCount > 0)
+	{
+		if(fd != miFd)
+		{
+			SendBatch(moStat.mui64UrgentFlush);
+		}
+		else if(moBatch.m_iDatalen + liItemLen > DCS_DNS_BATCH_BUFFER_LEN)
+		{
+			SendBatch(moStat.mui64SizeFlush);
+		}
+	}
+
+	uint64 lui64Now = GetMicroTime();
+	bool lbFirst = (0 == moBatch.m_iCount);
+	if(lbFirst)
+	{
+		miFd = fd;
+		mui64FirstTime = lui64Now;
+		mui64PushTimeSum = 0;
+	}
+	uint16 lui16Len = (uint16)length;
+	char *lpItem = moBatch.m_cDataBuf + moBatch.m_iDatalen;
+	memcpy(lpItem, &lui16Len, sizeof(uint16));
+	memcpy(lpItem + sizeof(uint16), buffer, length);
+	moBatch.m_iDatalen += liItemLen;
+	++moBatch.m_iCount;
+	mui64PushTimeSum += lui64Now;
+	//ʱ߳ûʱһֱȣһϢſʼʱ
+	if(lbFirst && m_pNotify != NULL)
+	{
+		m_pNotify->Notify();
+	}
+	return true;
+}
+
+void CDNSForwardBatch::FlushExpired()
+{
+	CAutoLock lock(moSection);
+	if(moBatch.m_iCount > 0 && GetMicroTime() >= mui64FirstTime + miWindowUs)
+	{
+		SendBatch(moStat.mui64TimerFlush);
+	}
+}
+
+int64 CDNSForwardBatch::GetWaitTime()
+{
+	CAutoLock lock(moSection);
+	if(0 == moBatch.m_iCount)
+	{
+		return -1;
+	}
+	uint64 lui64Now = GetMicroTime();
+	uint64 lui64Expire = mui64FirstTime + miWindowUs;
+	return lui64Now >= lui64Expire ? 0 : (int64)(lui64Expire - lui64Now);
+}
+
+void CDNSForwardBatch::Flush()
+{
+	CAutoLock lock(moSection);
+	if(moBatch.m_iCount > 0)
+	{
+		SendBatch(moStat.mui64UrgentFlush);
+	}
+}
+
+void CDNSForwardBatch::GetStat(STRU_FORWARD_BATCH_STAT &aoStat)
+{
+	CAutoLock lock(moSection);
+	aoStat = moStat;
+	moStat = STRU_FORWARD_BATCH_STAT();
+}
+
+void CDNSForwardBatch::SendBatch(uint64 &aui64Reason)
+{
+	char lszBuffer[DEF_BUFFER_LEN];
+	int liLength = moBatch.Pack(lszBuffer, DEF_BUFFER_LEN);
+	if(liLength > 0)
+	{
+		m_pServer->SendData(miFd, lszBuffer, liLength);
+	}
+	else
+	{
+		TRACE(1, "CDNSForwardBatch::SendBatch ʧܡ: "<<moBatch.m_iCount<<" : "<<moBatch.m_iDatalen);
+	}
+
+	uint64 lui64Now = GetMicroTime();
+	uint64 lui64MaxWait = lui64Now - mui64FirstTime;
+	moStat.mui64WaitTime += lui64Now * moBatch.m_iCount - mui64PushTimeSum;
+	if(lui64MaxWait > moStat.mui64MaxWaitTime)
+	{
+		moStat.mui64MaxWaitTime = lui64MaxWait;
+	}
+	++moStat.mui64BatchCount;
+	++aui64Reason;
+	moBatch.m_iCount = 0;
+	moBatch.m_iDatalen = 0;
+}
@@ -0,0 +1,74 @@
+/********************************************************************
+	file base:	DNSForwardBatch
+	file ext:	h
+
+	purpose:	DNSһDCSƬϢϲ
+				Ϣ׷ӵװ¡ȴʱ䴰ڻҪʱ
+				СĴӺsend
+*********************************************************************/
+#ifndef _DNS_FORWARD_BATCH_H_
+#define _DNS_FORWARD_BATCH_H_
+
+#include "include.h"
+#include "CriticalSection.h"
+#include "NetEpollGroup.h"
+#include "dcs_dns.h"
+
+//ϲͳƣGetStatȡ
+struct STRU_FORWARD_BATCH_STAT
+{
+	STRU_FORWARD_BATCH_STAT()
+	{
+		memset(this, 0, sizeof(STRU_FORWARD_BATCH_STAT));
+	}
+	//תϢ
+	uint64 mui64MsgCount;
+	uint64 mui64BatchCount;
+	//ԭֵķװ¡ʱ䴰ڵڡ
+	uint64 mui64SizeFlush;
+	uint64 mui64TimerFlush;
+	uint64 mui64UrgentFlush;
+	//Ϣȴʱʱ䣬΢
+	uint64 mui64WaitTime;
+	uint64 mui64MaxWaitTime;
+};
+
+class CDNSForwardBatch
+{
+public:
+	CDNSForwardBatch();
+	~CDNSForwardBatch();
+
+	//aiDnsIpֽaiWindowUsΪ0ʱϲϢֱӷ
+	//apNotifyڿһϢʱѶʱ̣߳ΪNULL
+	void Init(CNetEpollGroup *apServer, uint32 aiDnsIp, uint32 aiDnsId, uint32 aiWindowUs,
+		CQueueNotify *apNotify = NULL);
+	//һðPACK_DCS_DNS_MESSAGEװ»fdʱȷе
+	bool Push(int fd, const char *buffer, int length);
+	//ȴʱ䴰ڵɶʱ̵߳
+	void FlushExpired();
+	//ڻж΢룬ѵڷ0û-1
+	int64 GetWaitTime();
+	//ͬһƬư֮ǰãȺ˳
+	void Flush();
+	void GetStat(STRU_FORWARD_BATCH_STAT &aoStat);
+
+private:
+	//÷moSectionaui64ReasonΪӦԭļ
+	void SendBatch(uint64 &aui64Reason);
+
+private:
+	CCriticalSection moSection;
+	CNetEpollGroup *m_pServer;
+	CQueueNotify *m_pNotify;
+	uint32 miWindowUs;
+	//Ҫfd
+	int miFd;
+	//һϢʱȫϢʱ֮ͣʱ΢
+	uint64 mui64FirstTime;
+	uint64 mui64PushTimeSum;
+	stru_DCS_DNS_BATCH moBatch;
+	STRU_FORWARD_BATCH_STAT moStat;
+};
+
+#endif //_DNS_FORWARD_BATCH_H_
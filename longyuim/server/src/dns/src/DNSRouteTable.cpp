@@ -0,0 +1,400 @@
+#include "DNSRouteTable.h"
+#include <sched.h>
+
+/************************************************************************/
+/*
+CRouteEpoch
+*/
+/************************************************************************/
+CRouteEpoch::CRouteEpoch()
+{
+	miEpoch = 0;
+	miReader[0] = 0;
+	miReader[1] = 0;
+}
+
+CRouteEpoch::~CRouteEpoch()
+{
+	for(unsigned int i = 0; i < moRetired.size(); ++i)
+	{
+		moRetired[i].mpFree(moRetired[i].mpData);
+	}
+	moRetired.clear();
+}
+
+void CRouteEpoch::Retire(void *apData, void (*apFree)(void *))
+{
+	STRU_ROUTE_RETIRED loRetired;
+	loRetired.mpData = apData;
+	loRetired.mpFree = apFree;
+	moRetired.push_back(loRetired);
+}
+
+int CRouteEpoch::Reclaim()
+{
+	if(moRetired.empty())
+	{
+		return 0;
+	}
+	std::vector<STRU_ROUTE_RETIRED> loRetired;
+	loRetired.swap(moRetired);
+	//л֮Ķֻܿ
+	uint32 liOld = __sync_fetch_and_add(&miEpoch, 1);
+	while(miReader[liOld & 1] != 0)
+	{
+		sched_yield();
+	}
+	for(unsigned int i = 0; i < loRetired.size(); ++i)
+	{
+		loRetired[i].mpFree(loRetired[i].mpData);
+	}
+	return loRetired.size();
+}
+
+/************************************************************************/
+/*
+CDNSRouteTable
+*/
+/************************************************************************/
+CDNSRouteTable::CDNSRouteTable() : moHall(moEpoch), moGroup(moEpoch)
+{
+	miTimeOut = 0;
+	moHallTimer.OnTimeOut.connect(this, &CDNSRouteTable::OnHallTimeOut);
+}
+
+CDNSRouteTable::~CDNSRouteTable()
+{
+	moHallTimer.OnTimeOut.disconnect(this);
+	CAutoLock lock(moSection);
+	std::vector<PSTRU_DNS_NODE_INFO> loHallList;
+	moHall.GetValues(loHallList);
+	for(unsigned int i = 0; i < loHallList.size(); ++i)
+	{
+		delete loHallList[i];
+	}
+	std::vector<PSTRU_DNS_GROUP_LIST> loGroupList;
+	moGroup.GetValues(loGroupList);
+	for(unsigned int i = 0; i < loGroupList.size(); ++i)
+	{
+		free(loGroupList[i]);
+	}
+}
+
+void CDNSRouteTable::Init(unsigned int aiTimeOut)
+{
+	miTimeOut = aiTimeOut;
+	//ʱ
+	moHallTimer.Init(CTimingWheel::GetMonotonicTime(), 1000);
+}
+
+int CDNSRouteTable::Login(uint32 hallId, int fd, uint64 groupId)
+{
+	if(0 == hallId || fd < 0)
+	{
+		TRACE(1, "CDNSRouteTable::Login hallId = "<<hallId<<" fd = "<<fd);
+		return -1;
+	}
+	uint64 lui64Now = CTimingWheel::GetMonotonicTime();
+	CAutoLock lock(moSection);
+	//fdԭǱĴ˵ѾϿfdӸ
+	uint32 liOwner = GetFdOwner(fd);
+	if(liOwner != 0 && liOwner != hallId)
+	{
+		PSTRU_DNS_NODE_INFO lpOld = moHall.Find(liOwner);
+		if(lpOld != NULL)
+		{
+			TRACE(3, "CDNSRouteTable::Login fdãɾɴhallId = "<<liOwner<<" fd = "<<fd);
+			DropHall(lpOld);
+		}
+	}
+
+	PSTRU_DNS_NODE_INFO lpHall = moHall.Find(hallId);
+	if(lpHall != NULL)
+	{
+		if(lpHall->fd != fd)
+		{
+			if(GetFdOwner(lpHall->fd) == hallId)
+			{
+				SetFdOwner(lpHall->fd, 0);
+			}
+			lpHall->fd = fd;
+			SetFdOwner(fd, hallId);
+		}
+		if(lpHall->m_i32GroupId != groupId)
+		{
+			DelMember(lpHall->m_i32GroupId, lpHall);
+			lpHall->m_i32GroupId = groupId;
+			AddMember(groupId, lpHall);
+		}
+		lpHall->m_iTimeStamp = lui64Now;
+		return 0;
+	}
+
+	lpHall = new STRU_DNS_NODE_INFO;
+	lpHall->fd = fd;
+	lpHall->m_i32NodeId = hallId;
+	lpHall->m_i32GroupId = groupId;
+	lpHall->m_iTimeStamp = lui64Now;
+	lpHall->moTimer.mui64Data = hallId;
+	moHall.Set(hallId, lpHall);
+	SetFdOwner(fd, hallId);
+	AddMember(groupId, lpHall);
+	moHallTimer.Arm(&lpHall->moTimer, miTimeOut);
+	AddHallChange(hallId, 1);
+	return 0;
+}
+
+int CDNSRouteTable::Remove(uint32 hallId)
+{
+	CAutoLock lock(moSection);
+	PSTRU_DNS_NODE_INFO lpHall = moHall.Find(hallId);
+	if(NULL == lpHall)
+	{
+		return -1;
+	}
+	DropHall(lpHall);
+	return 0;
+}
+
+int CDNSRouteTable::RemoveByFd(int fd)
+{
+	CAutoLock lock(moSection);
+	uint32 liOwner = GetFdOwner(fd);
+	if(0 == liOwner)
+	{
+		return -1;
+	}
+	PSTRU_DNS_NODE_INFO lpHall = moHall.Find(liOwner);
+	if(NULL == lpHall)
+	{
+		SetFdOwner(fd, 0);
+		return -1;
+	}
+	TRACE(3, "CDNSRouteTable::RemoveByFd ӶϿɾhallId = "<<liOwner<<" fd = "<<fd);
+	DropHall(lpHall);
+	return 0;
+}
+
+int CDNSRouteTable::CheckTimeOut()
+{
+	CAutoLock lock(moSection);
+	int liCount = moHallTimer.Advance(CTimingWheel::GetMonotonicTime());
+	moEpoch.Reclaim();
+	return liCount;
+}
+
+void CDNSRouteTable::Dump()
+{
+	CAutoLock lock(moSection);
+	TRACE(2, "CDNSRouteTable::Dump : "<<moHall.GetCount()<<" : "<<moHall.GetCapacity()
+		<<" : "<<moGroup.GetCount()<<" : "<<moEpoch.GetRetiredCount());
+}
+
+int CDNSRouteTable::PopHallChange(std::vector<STRU_DNS_HALL_CHANGE> &aoList)
+{
+	CAutoLock lock(moSection);
+	int liCount = moHallChange.size();
+	aoList.insert(aoList.end(), moHallChange.begin(), moHallChange.end());
+	moHallChange.clear();
+	return liCount;
+}
+
+int CDNSRouteTable::GetHallList(std::vector<uint32> &aoList)
+{
+	CAutoLock lock(moSection);
+	std::vector<PSTRU_DNS_NODE_INFO> loHallList;
+	moHall.GetValues(loHallList);
+	for(unsigned int i = 0; i < loHallList.size(); ++i)
+	{
+		aoList.push_back(loHallList[i]->m_i32NodeId);
+	}
+	return loHallList.size();
+}
+
+int CDNSRouteTable::KeepAlive(uint32 hallId)
+{
+	CRouteReadGuard loGuard(moEpoch);
+	PSTRU_DNS_NODE_INFO lpHall = moHall.Find(hallId);
+	if(NULL == lpHall)
+	{
+		return -1;
+	}
+	lpHall->m_iTimeStamp = CTimingWheel::GetMonotonicTime();
+	return 0;
+}
+
+int CDNSRouteTable::GetFd(uint32 hallId)
+{
+	CRouteReadGuard loGuard(moEpoch);
+	PSTRU_DNS_NODE_INFO lpHall = moHall.Find(hallId);
+	if(NULL == lpHall)
+	{
+		return -1;
+	}
+	return lpHall->fd;
+}
+
+int CDNSRouteTable::GetGroupFd(uint64 groupId, std::vector<int> &aoFdList)
+{
+	CRouteReadGuard loGuard(moEpoch);
+	PSTRU_DNS_GROUP_LIST lpList = moGroup.Find(groupId);
+	if(NULL == lpList)
+	{
+		return 0;
+	}
+	unsigned int liCount = lpList->miCount;
+	RING_BARRIER();
+	for(unsigned int i = 0; i < liCount; ++i)
+	{
+		aoFdList.push_back((int)lpList->mpNode[i]->fd);
+	}
+	return liCount;
+}
+
+void CDNSRouteTable::OnHallTimeOut(STRU_TIMER_NODE *apNode)
+{
+	uint32 hallId = (uint32)apNode->mui64Data;
+	PSTRU_DNS_NODE_INFO lpHall = moHall.Find(hallId);
+	if(NULL == lpHall || &lpHall->moTimer != apNode)
+	{
+		return;
+	}
+	//ֻʱʱûʱͰʣʱع
+	uint64 lui64Now = CTimingWheel::GetMonotonicTime();
+	uint64 lui64Expire = lpHall->m_iTimeStamp + miTimeOut;
+	if(lui64Now < lui64Expire)
+	{
+		moHallTimer.Arm(apNode, (unsigned int)(lui64Expire - lui64Now));
+		return;
+	}
+	TRACE(1, "CDNSRouteTable::OnHallTimeOut hallId "<<hallId<<" Timeout");
+	DropHall(lpHall);
+}
+
+void CDNSRouteTable::DropHall(PSTRU_DNS_NODE_INFO apHall)
+{
+	moHall.Erase(apHall->m_i32NodeId);
+	moHallTimer.Cancel(&apHall->moTimer);
+	if(GetFdOwner(apHall->fd) == apHall->m_i32NodeId)
+	{
+		SetFdOwner(apHall->fd, 0);
+	}
+	DelMember(apHall->m_i32GroupId, apHall);
+	AddHallChange(apHall->m_i32NodeId, 0);
+	moEpoch.Retire(apHall, CRouteEpoch::FreeObject<STRU_DNS_NODE_INFO>);
+}
+
+void CDNSRouteTable::AddMember(uint64 groupId, PSTRU_DNS_NODE_INFO apHall)
+{
+	//0ת
+	if(0 == groupId)
+	{
+		return;
+	}
+	PSTRU_DNS_GROUP_LIST lpOld = moGroup.Find(groupId);
+	if(lpOld != NULL && lpOld->miCount < lpOld->miCapacity)
+	{
+		lpOld->mpNode[lpOld->miCount] = apHall;
+		RING_BARRIER();
+		++lpOld->miCount;
+		return;
+	}
+	//ʱ2
+	unsigned int liCount = (NULL == lpOld) ? 0 : lpOld->miCount;
+	PSTRU_DNS_GROUP_LIST lpNew = NewGroupList(liCount < 4 ? 8 : liCount * 2);
+	if(liCount > 0)
+	{
+		memcpy(lpNew->mpNode, lpOld->mpNode, sizeof(PSTRU_DNS_NODE_INFO) * liCount);
+	}
+	lpNew->mpNode[liCount] = apHall;
+	lpNew->miCount = liCount + 1;
+	moGroup.Set(groupId, lpNew);
+	if(lpOld != NULL)
+	{
+		moEpoch.Retire(lpOld, free);
+	}
+}
+
+void CDNSRouteTable::DelMember(uint64 groupId, PSTRU_DNS_NODE_INFO apHall)
+{
+	if(0 == groupId)
+	{
+		return;
+	}
+	PSTRU_DNS_GROUP_LIST lpOld = moGroup.Find(groupId);
+	if(NULL == lpOld)
+	{
+		return;
+	}
+	unsigned int liIndex = 0;
+	while(liIndex < lpOld->miCount && lpOld->mpNode[liIndex] != apHall)
+	{
+		++liIndex;
+	}
+	if(liIndex == lpOld->miCount)
+	{
+		return;
+	}
+	if(1 == lpOld->miCount)
+	{
+		moGroup.Erase(groupId);
+	}
+	else
+	{
+		PSTRU_DNS_GROUP_LIST lpNew = NewGroupList(lpOld->miCapacity);
+		lpNew->miCount = lpOld->miCount - 1;
+		memcpy(lpNew->mpNode, lpOld->mpNode, sizeof(PSTRU_DNS_NODE_INFO) * liIndex);
+		memcpy(lpNew->mpNode + liIndex, lpOld->mpNode + liIndex + 1,
+			sizeof(PSTRU_DNS_NODE_INFO) * (lpOld->miCount - liIndex - 1));
+		moGroup.Set(groupId, lpNew);
+	}
+	moEpoch.Retire(lpOld, free);
+}
+
+void CDNSRouteTable::AddHallChange(uint32 hallId, uint8 aiOp)
+{
+	STRU_DNS_HALL_CHANGE loChange;
+	loChange.miHallId = hallId;
+	loChange.miOp = aiOp;
+	moHallChange.push_back(loChange);
+}
+
+void CDNSRouteTable::SetFdOwner(int fd, uint32 hallId)
+{
+	if(fd < 0)
+	{
+		return;
+	}
+	if((unsigned int)fd >= moFdOwner.size())
+	{
+		if(0 == hallId)
+		{
+			return;
+		}
+		unsigned int liSize = moFdOwner.size() * 2;
+		if(liSize <= (unsigned int)fd)
+		{
+			liSize = fd + 1024;
+		}
+		moFdOwner.resize(liSize, 0);
+	}
+	moFdOwner[fd] = hallId;
+}
+
+uint32 CDNSRouteTable::GetFdOwner(int fd)
+{
+	if(fd < 0 || (unsigned int)fd >= moFdOwner.size())
+	{
+		return 0;
+	}
+	return moFdOwner[fd];
+}
+
+PSTRU_DNS_GROUP_LIST CDNSRouteTable::NewGroupList(unsigned int aiCapacity)
+{
+	PSTRU_DNS_GROUP_LIST lpList = (PSTRU_DNS_GROUP_LIST)malloc(sizeof(STRU_DNS_GROUP_LIST)
+		+ sizeof(PSTRU_DNS_NODE_INFO) * aiCapacity);
+	lpList->miCount = 0;
+	lpList->miCapacity = aiCapacity;
+	return lpList;
+}
@@ -0,0 +1,385 @@
+/********************************************************************
+	file base:	DNSRouteTable
+	file ext:	h
+
+	purpose:	DNS·ɱ
+				ID->ڵ㡢ID->ԱбÿѰַϣfd->IDðfd±顣
+				ѯ߽ʱڵǰԪļϼ1뿪ʱ1дժµڴ
+				ȹҵблԪȾɼԪĶȫ뿪ͷš
+				¼˳ʱдУֻʱʱʱʱ
+				ٱȽʱûھͰʣʱعҡ
+*********************************************************************/
+#ifndef _DNS_ROUTE_TABLE_H_
+#define _DNS_ROUTE_TABLE_H_
+
+#include "include.h"
+#include "sigslot.h"
+#include "CriticalSection.h"
+#include "TimingWheel.h"
+#include "RingQueue.h"
+#include <vector>
+
+//ϣС
+#define DEF_ROUTE_HASH_SIZE 1024
+
+typedef struct stru_DNS_NODE_INFO
+{
+	volatile int fd;
+	uint32 m_i32NodeId;
+	uint64 m_i32GroupId;
+	//һʱ
+	volatile uint64 m_iTimeStamp;
+	//ʱʱmui64DataΪID
+	STRU_TIMER_NODE moTimer;
+}STRU_DNS_NODE_INFO ,*PSTRU_DNS_NODE_INFO;
+
+//Աֻĩβ׷ӣдԱټӼֻǰmiCount
+//ɾʱһµķ
+typedef struct stru_DNS_GROUP_LIST
+{
+	volatile unsigned int miCount;
+	unsigned int miCapacity;
+	PSTRU_DNS_NODE_INFO mpNode[1];
+}STRU_DNS_GROUP_LIST ,*PSTRU_DNS_GROUP_LIST;
+
+//仯DNS֪ͨDCSƬ
+struct STRU_DNS_HALL_CHANGE
+{
+	uint32 miHallId;
+	//1¼ 0˳ͬDCS_HALL_DELTA_*
+	uint8 miOp;
+};
+
+//յڴ
+struct STRU_ROUTE_RETIRED
+{
+	void *mpData;
+	void (*mpFree)(void *);
+};
+
+/************************************************************************/
+/*
+Ԫ߲д߻ʱȴɼԪĶ뿪
+*/
+/************************************************************************/
+class CRouteEpoch
+{
+public:
+	CRouteEpoch();
+	~CRouteEpoch();
+
+	inline uint32 ReadLock()
+	{
+		for(;;)
+		{
+			uint32 liEpoch = miEpoch;
+			__sync_fetch_and_add(&miReader[liEpoch & 1], 1);
+			//Ӽ֮Ԫû䣬длʱһܿ
+			if(liEpoch == miEpoch)
+			{
+				return liEpoch;
+			}
+			__sync_fetch_and_sub(&miReader[liEpoch & 1], 1);
+		}
+	}
+	inline void ReadUnlock(uint32 aiEpoch)
+	{
+		__sync_fetch_and_sub(&miReader[aiEpoch & 1], 1);
+	}
+
+	//дߵã÷
+	//ժµڴһReclaimʱͷ
+	void Retire(void *apData, void (*apFree)(void *));
+	//лԪȾɼԪĶ뿪ͷлǰժµڴ棬ͷŸ
+	int Reclaim();
+	inline unsigned int GetRetiredCount(){ return moRetired.size(); }
+
+	template <class T>
+	static void FreeObject(void *apData)
+	{
+		delete (T*)apData;
+	}
+
+private:
+	volatile uint32 miEpoch;
+	volatile int miReader[2];
+	std::vector<STRU_ROUTE_RETIRED> moRetired;
+};
+
+//߽롢뿪÷ͬCAutoLock
+class CRouteReadGuard
+{
+public:
+	CRouteReadGuard(CRouteEpoch &aoEpoch) : moEpoch(aoEpoch)
+	{
+		miEpoch = aoEpoch.ReadLock();
+	}
+	~CRouteReadGuard()
+	{
+		moEpoch.ReadUnlock(miEpoch);
+	}
+private:
+	CRouteEpoch &moEpoch;
+	uint32 miEpoch;
+};
+
+inline uint32 RouteHash(uint32 aiKey)
+{
+	aiKey ^= aiKey >> 16;
+	aiKey *= 0x85ebca6b;
+	aiKey ^= aiKey >> 13;
+	aiKey *= 0xc2b2ae35;
+	aiKey ^= aiKey >> 16;
+	return aiKey;
+}
+
+inline uint32 RouteHash(uint64 aiKey)
+{
+	aiKey ^= aiKey >> 33;
+	aiKey *= 0xff51afd7ed558ccdULL;
+	aiKey ^= aiKey >> 33;
+	aiKey *= 0xc4ceb9fe1a85ec53ULL;
+	aiKey ^= aiKey >> 33;
+	return (uint32)aiKey;
+}
+
+/************************************************************************/
+/*
+Ѱַϣ̽
+0ʾղۣɾֵֻNULLͬһãʱ
+FindCRouteReadGuardڵãдߵã÷
+ʱ±巢ɱԪ
+*/
+/************************************************************************/
+template <class KEY, class VALUE>
+class CRouteHash
+{
+	struct STRU_SLOT
+	{
+		volatile KEY mKey;
+		VALUE * volatile mpValue;
+	};
+	struct STRU_TABLE
+	{
+		uint32 miMask;
+		STRU_SLOT *mpSlot;
+	};
+
+public:
+	CRouteHash(CRouteEpoch &aoEpoch) : moEpoch(aoEpoch)
+	{
+		mpTable = NewTable(DEF_ROUTE_HASH_SIZE);
+		miUsed = 0;
+		miCount = 0;
+	}
+	~CRouteHash()
+	{
+		FreeTable(mpTable);
+	}
+
+	inline VALUE* Find(KEY aKey)
+	{
+		STRU_TABLE *lpTable = mpTable;
+		RING_BARRIER();
+		uint32 liIndex = RouteHash(aKey) & lpTable->miMask;
+		for(;;)
+		{
+			STRU_SLOT &loSlot = lpTable->mpSlot[liIndex];
+			KEY liKey = loSlot.mKey;
+			if(liKey == aKey)
+			{
+				RING_BARRIER();
+				return loSlot.mpValue;
+			}
+			if(0 == liKey)
+			{
+				return NULL;
+			}
+			liIndex = (liIndex + 1) & lpTable->miMask;
+		}
+	}
+
+	//ԭֵ
+	VALUE* Set(KEY aKey, VALUE *apValue)
+	{
+		ASSERT(aKey != 0 && apValue != NULL);
+		//ò(ɾ)3/4֤̽ղ
+		if((miUsed + 1) * 4 > (mpTable->miMask + 1) * 3)
+		{
+			Rehash();
+		}
+		STRU_SLOT *lpSlot = Probe(mpTable, aKey);
+		if(lpSlot->mKey == aKey)
+		{
+			VALUE *lpOld = lpSlot->mpValue;
+			lpSlot->mpValue = apValue;
+			if(NULL == lpOld)
+			{
+				++miCount;
+			}
+			return lpOld;
+		}
+		//дֵٷ
+		lpSlot->mpValue = apValue;
+		RING_BARRIER();
+		lpSlot->mKey = aKey;
+		++miUsed;
+		++miCount;
+		return NULL;
+	}
+
+	//ɾֵ
+	VALUE* Erase(KEY aKey)
+	{
+		STRU_SLOT *lpSlot = Probe(mpTable, aKey);
+		if(lpSlot->mKey != aKey || NULL == lpSlot->mpValue)
+		{
+			return NULL;
+		}
+		VALUE *lpOld = lpSlot->mpValue;
+		lpSlot->mpValue = NULL;
+		--miCount;
+		return lpOld;
+	}
+
+	void GetValues(std::vector<VALUE*> &aoList)
+	{
+		for(uint32 i = 0; i <= mpTable->miMask; ++i)
+		{
+			VALUE *lpValue = mpTable->mpSlot[i].mpValue;
+			if(lpValue != NULL)
+			{
+				aoList.push_back(lpValue);
+			}
+		}
+	}
+
+	inline unsigned int GetCount(){ return miCount; }
+	inline unsigned int GetCapacity(){ return mpTable->miMask + 1; }
+
+private:
+	//ؼڵĲۣûʱصһղ
+	static STRU_SLOT* Probe(STRU_TABLE *apTable, KEY aKey)
+	{
+		uint32 liIndex = RouteHash(aKey) & apTable->miMask;
+		for(;;)
+		{
+			STRU_SLOT *lpSlot = &apTable->mpSlot[liIndex];
+			if(lpSlot->mKey == aKey || 0 == lpSlot->mKey)
+			{
+				return lpSlot;
+			}
+			liIndex = (liIndex + 1) & apTable->miMask;
+		}
+	}
+
+	void Rehash()
+	{
+		//ؽز1/4
+		uint32 liSize = RoundUpPower2((miCount + 1) * 4);
+		if(liSize < DEF_ROUTE_HASH_SIZE)
+		{
+			liSize = DEF_ROUTE_HASH_SIZE;
+		}
+		STRU_TABLE *lpNew = NewTable(liSize);
+		for(uint32 i = 0; i <= mpTable->miMask; ++i)
+		{
+			STRU_SLOT &loSlot = mpTable->mpSlot[i];
+			if(loSlot.mpValue != NULL)
+			{
+				STRU_SLOT *lpSlot = Probe(lpNew, loSlot.mKey);
+				lpSlot->mKey = loSlot.mKey;
+				lpSlot->mpValue = loSlot.mpValue;
+			}
+		}
+		STRU_TABLE *lpOld = mpTable;
+		RING_BARRIER();
+		mpTable = lpNew;
+		miUsed = miCount;
+		moEpoch.Retire(lpOld, FreeTable);
+	}
+
+	static STRU_TABLE* NewTable(uint32 aiSize)
+	{
+		STRU_TABLE *lpTable = new STRU_TABLE;
+		lpTable->miMask = aiSize - 1;
+		lpTable->mpSlot = new STRU_SLOT[aiSize];
+		memset((void*)lpTable->mpSlot, 0, sizeof(STRU_SLOT) * aiSize);
+		return lpTable;
+	}
+
+	static void FreeTable(void *apData)
+	{
+		STRU_TABLE *lpTable = (STRU_TABLE*)apData;
+		delete [] lpTable->mpSlot;
+		delete lpTable;
+	}
+
+private:
+	CRouteEpoch &moEpoch;
+	STRU_TABLE * volatile mpTable;
+	//òɾ
+	unsigned int miUsed;
+	unsigned int miCount;
+};
+
+/************************************************************************/
+/*
+·ɱ
+*/
+/************************************************************************/
+class CDNSRouteTable : public sigslot::has_slots<>
+{
+public:
+	CDNSRouteTable();
+	~CDNSRouteTable();
+
+	//aiTimeOut û㳬ʱ
+	void Init(unsigned int aiTimeOut);
+
+	//¼д
+	//¼Ѵʱfdͷ飻fdԭ¼ɾ
+	int Login(uint32 hallId, int fd, uint64 groupId);
+	int Remove(uint32 hallId);
+	//ӶϿʱɾfdϵĴ
+	int RemoveByFd(int fd);
+	//ƽʱʱֲڴ棬سʱĴ
+	int CheckTimeOut();
+	void Dump();
+	//ȡ¼˳۵Ĵ仯˳׷ӵaoList
+	int PopHallChange(std::vector<STRU_DNS_HALL_CHANGE> &aoList);
+	//ȫIDDCSȫͬ
+	int GetHallList(std::vector<uint32> &aoList);
+
+	//²
+	int KeepAlive(uint32 hallId);
+	int GetFd(uint32 hallId);
+	//ȡȫԱfdظ
+	int GetGroupFd(uint64 groupId, std::vector<int> &aoFdList);
+	inline unsigned int GetHallCount(){ return moHall.GetCount(); }
+
+private:
+	void OnHallTimeOut(STRU_TIMER_NODE *apNode);
+	//ȫժԪ
+	void DropHall(PSTRU_DNS_NODE_INFO apHall);
+	void AddMember(uint64 groupId, PSTRU_DNS_NODE_INFO apHall);
+	void DelMember(uint64 groupId, PSTRU_DNS_NODE_INFO apHall);
+	void AddHallChange(uint32 hallId, uint8 aiOp);
+	void SetFdOwner(int fd, uint32 hallId);
+	uint32 GetFdOwner(int fd);
+	static PSTRU_DNS_GROUP_LIST NewGroupList(unsigned int aiCapacity);
+
+private:
+	CRouteEpoch moEpoch;
+	CRouteHash<uint32, STRU_DNS_NODE_INFO> moHall;
+	CRouteHash<uint64, STRU_DNS_GROUP_LIST> moGroup;
+	//fd->ID0ʾûУֻд߷
+	std::vector<uint32> moFdOwner;
+	//дڼ£ⷢͣʱȥ
+	std::vector<STRU_DNS_HALL_CHANGE> moHallChange;
+	CCriticalSection moSection;
+	CTimingWheel moHallTimer;
+	unsigned int miTimeOut;
+};
+
+#endif //_DNS_ROUTE_TABLE_H_
@@ -58,3 +58,38 @@ int stru_DCS_DNS_MESSAGE::Serialize(CStandardSerialize &aoStandardSerialize)
 	return 1;
 }
 
+int stru_DCS_DNS_HALL_DELTA::Serialize(CStandardSerialize &aoStandardSerialize)
+{
+	aoStandardSerialize.Serialize(m_iDnsIp);
+	aoStandardSerialize.Serialize(m_iDnsId);
+	aoStandardSerialize.Serialize(m_iReset);
+	aoStandardSerialize.Serialize(m_iCount);
+	if(m_iCount > DCS_HALL_DELTA_MAX_COUNT)
+	{
+		return -1;
+	}
+	for(uint16 i = 0; i < m_iCount; ++i)
+	{
+		aoStandardSerialize.Serialize(m_iHallId[i]);
+		aoStandardSerialize.Serialize(m_iOp[i]);
+	}
+	return 1;
+}
+
+int stru_DCS_PEER_LOGIN_RQ::Serialize(CStandardSerialize &aoStandardSerialize)
+{
+	aoStandardSerialize.Serialize(m_iShardIndex);
+	aoStandardSerialize.Serialize(m_iShardCount);
+	return 1;
+}
+
+int stru_DCS_DNS_BATCH::Serialize(CStandardSerialize &aoStandardSerialize)
+{
+	aoStandardSerialize.Serialize(m_iDnsIp);
+	aoStandardSerialize.Serialize(m_iDnsId);
+	aoStandardSerialize.Serialize(m_iCount);
+	aoStandardSerialize.Serialize(m_iDatalen);
+	aoStandardSerialize.Serialize(m_cDataBuf,m_iDatalen,DCS_DNS_BATCH_BUFFER_LEN);
+	return 1;
+}
+